@@ -0,0 +1,270 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace allocator {
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  Pool<BLOCK_SIZE, BLOCKS>::Pool() :
+      freeList(0), fresh(0), used(0), highWaterMark(0), failures(0)
+  {
+  }
+
+  /**
+   * @brief Takes a block from the pool, returns 0 if the pool is exhausted.
+   * @note  The never used blocks are handed out in order, so the free list
+   *        doesn't need to be built at construction.
+   */
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  void* Pool<BLOCK_SIZE, BLOCKS>::allocate()
+  {
+    critical::Section section;
+    void* block;
+
+    if (freeList != 0) {
+      block = freeList;
+      freeList = freeList->next;
+    } else if (fresh < BLOCKS) {
+      block = &storage[fresh * BLOCK_SIZE];
+      fresh++;
+    } else {
+      failures++;
+      return 0;
+    }
+
+    used++;
+
+    if (used > highWaterMark) {
+      highWaterMark = used;
+    }
+
+    return block;
+  }
+
+  /**
+   * @brief Gives <block> back to the pool.
+   * @note  The block must have been allocated from this pool.
+   */
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  void Pool<BLOCK_SIZE, BLOCKS>::release(void* const block)
+  {
+    critical::Section section;
+
+    Block* const released = static_cast<Block*>(block);
+
+    released->next = freeList;
+    freeList = released;
+    used--;
+  }
+
+  /**
+   * @brief Returns true if <block> lies in the storage of this pool.
+   */
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  bool Pool<BLOCK_SIZE, BLOCKS>::owns(void const* const block) const
+  {
+    return (static_cast<u8 const*>(block) >= storage) &&
+        (static_cast<u8 const*>(block) < storage + sizeof(storage));
+  }
+
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  u16 Pool<BLOCK_SIZE, BLOCKS>::getUsed() const
+  {
+    return used;
+  }
+
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  u16 Pool<BLOCK_SIZE, BLOCKS>::getHighWaterMark() const
+  {
+    return highWaterMark;
+  }
+
+  /**
+   * @brief Returns the number of requests that found the pool exhausted.
+   */
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  u32 Pool<BLOCK_SIZE, BLOCKS>::getFailures() const
+  {
+    return failures;
+  }
+
+  /**
+   * @brief Prints a "size blocks used high-water failures" line.
+   */
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  template<typename OUTPUT>
+  void Pool<BLOCK_SIZE, BLOCKS>::dump() const
+  {
+    typedef text::Writer<OUTPUT> TEXT;
+
+    TEXT::print(BLOCK_SIZE);
+    TEXT::print(" ");
+    TEXT::print(BLOCKS);
+    TEXT::print(" ");
+    TEXT::print(used);
+    TEXT::print(" ");
+    TEXT::print(highWaterMark);
+    TEXT::print(" ");
+    TEXT::print(failures);
+    TEXT::print("\r\n");
+  }
+
+  void* Heap<>::allocate(u32 const)
+  {
+    return 0;
+  }
+
+  bool Heap<>::release(void* const)
+  {
+    return false;
+  }
+
+  template<typename OUTPUT>
+  void Heap<>::dump() const
+  {
+  }
+
+  /**
+   * @brief Takes a block from the smallest pool that can hold <size> bytes
+   *        and isn't exhausted, returns 0 if there is none.
+   * @note  The pools must be listed by increasing block size.
+   */
+  template<typename POOL, typename... POOLS>
+  void* Heap<POOL, POOLS...>::allocate(u32 const size)
+  {
+    if (size <= POOL::SIZE) {
+      void* const block = pool.allocate();
+
+      if (block != 0) {
+        return block;
+      }
+    }
+
+    return next.allocate(size);
+  }
+
+  /**
+   * @brief Gives <block> back to the pool that owns it.
+   * @note  Returns false if no pool of the heap owns the block.
+   */
+  template<typename POOL, typename... POOLS>
+  bool Heap<POOL, POOLS...>::release(void* const block)
+  {
+    if (pool.owns(block)) {
+      pool.release(block);
+      return true;
+    }
+
+    return next.release(block);
+  }
+
+  /**
+   * @brief Returns the smallest size class, its statistics can be queried.
+   */
+  template<typename POOL, typename... POOLS>
+  POOL& Heap<POOL, POOLS...>::getPool()
+  {
+    return pool;
+  }
+
+  /**
+   * @brief Returns the heap made of the remaining size classes.
+   */
+  template<typename POOL, typename... POOLS>
+  Heap<POOLS...>& Heap<POOL, POOLS...>::getNext()
+  {
+    return next;
+  }
+
+  /**
+   * @brief Prints the statistics of every size class, one per line.
+   */
+  template<typename POOL, typename... POOLS>
+  template<typename OUTPUT>
+  void Heap<POOL, POOLS...>::dump() const
+  {
+    pool.template dump<OUTPUT>();
+    next.template dump<OUTPUT>();
+  }
+
+  template<u32 SIZE>
+  Arena<SIZE>::Arena() :
+      offset(0), highWaterMark(0), failures(0)
+  {
+  }
+
+  /**
+   * @brief Takes <size> bytes aligned to <alignment> (a power of 2, up to
+   *        8) from the arena, returns 0 if they don't fit.
+   */
+  template<u32 SIZE>
+  void* Arena<SIZE>::allocate(u32 const size, u32 const alignment)
+  {
+    critical::Section section;
+
+    u32 const start = (offset + alignment - 1) & ~(alignment - 1);
+
+    if ((start > SIZE) || (size > SIZE - start)) {
+      failures++;
+      return 0;
+    }
+
+    offset = start + size;
+
+    if (offset > highWaterMark) {
+      highWaterMark = offset;
+    }
+
+    return &storage[start];
+  }
+
+  /**
+   * @brief Frees everything that was allocated from the arena.
+   */
+  template<u32 SIZE>
+  void Arena<SIZE>::reset()
+  {
+    critical::Section section;
+
+    offset = 0;
+  }
+
+  template<u32 SIZE>
+  u32 Arena<SIZE>::getUsed() const
+  {
+    return offset;
+  }
+
+  template<u32 SIZE>
+  u32 Arena<SIZE>::getHighWaterMark() const
+  {
+    return highWaterMark;
+  }
+
+  /**
+   * @brief Returns the number of requests that didn't fit.
+   */
+  template<u32 SIZE>
+  u32 Arena<SIZE>::getFailures() const
+  {
+    return failures;
+  }
+}  // namespace allocator
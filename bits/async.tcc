@@ -0,0 +1,749 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace async {
+  Operation::Operation() :
+      state(SUCCEEDED), continuation(0), context(0)
+  {
+  }
+
+  /**
+   * @brief Returns true if the operation has completed, or never started.
+   */
+  bool Operation::isDone() const
+  {
+    return state != PENDING;
+  }
+
+  /**
+   * @brief Returns true if the operation completed with an error.
+   */
+  bool Operation::hasFailed() const
+  {
+    return state == FAILED;
+  }
+
+  /**
+   * @brief Registers a function to be called, from the interrupt context,
+   *        when the operation completes.
+   * @note  Returns false, without registering it, if the operation has
+   *        already completed.
+   */
+  bool Operation::then(Continuation const function, void* const argument)
+  {
+    critical::Section section;
+
+    if (state != PENDING) {
+      return false;
+    }
+
+    continuation = function;
+    context = argument;
+
+    return true;
+  }
+
+  /**
+   * @brief Marks the operation as pending.
+   * @note  Used by the asynchronous peripheral classes.
+   */
+  void Operation::start()
+  {
+    continuation = 0;
+    state = PENDING;
+  }
+
+  /**
+   * @brief Marks the operation as completed and calls its continuation.
+   * @note  Used by the asynchronous peripheral classes.
+   */
+  void Operation::complete(bool const success)
+  {
+    Continuation function;
+    void* argument;
+
+    {
+      critical::Section section;
+
+      state = success ? SUCCEEDED : FAILED;
+      function = continuation;
+      argument = context;
+      continuation = 0;
+    }
+
+    if (function != 0) {
+      function(argument);
+    }
+  }
+
+  /*****************************************************************************
+   *                                   USART
+   ****************************************************************************/
+
+  template<usart::Address U>
+  Operation Usart<U>::operation;
+
+  template<usart::Address U>
+  u8 const* Usart<U>::data;
+
+  template<usart::Address U>
+  u16 Usart<U>::remaining;
+
+  /**
+   * @brief Unmasks the USART interrupt.
+   * @note  The USART must be already clocked and configured.
+   */
+  template<usart::Address U>
+  void Usart<U>::initialize()
+  {
+    Port::unmaskInterrupts();
+  }
+
+  /**
+   * @brief Feeds the transmitter.
+   * @note  Must be called from the USART interrupt handler.
+   */
+  template<usart::Address U>
+  void Usart<U>::onInterrupt()
+  {
+    if ((remaining == 0) || !Port::canSendDataYet()) {
+      return;
+    }
+
+    Port::sendData(*data);
+    data++;
+    remaining--;
+
+    if (remaining == 0) {
+      Port::disableTxIrq();
+      operation.complete(true);
+    }
+  }
+
+  /**
+   * @brief Starts sending <size> bytes from <buffer>.
+   * @note  The operation completes when the last byte is handed to the
+   *        transmitter. The buffer must stay valid until then.
+   * @note  Must not be called while a previous write is pending.
+   */
+  template<usart::Address U>
+  Operation& Usart<U>::write(u8 const* const buffer, u16 const size)
+  {
+    operation.start();
+
+    if (size == 0) {
+      operation.complete(true);
+      return operation;
+    }
+
+    data = buffer;
+    remaining = size;
+
+    Port::enableTxIrq();
+
+    return operation;
+  }
+
+  /*****************************************************************************
+   *                                    I2C
+   ****************************************************************************/
+
+  template<i2c::Address I>
+  Operation I2c<I>::operation;
+
+  template<i2c::Address I>
+  u8 I2c<I>::step;
+
+  template<i2c::Address I>
+  u8 I2c<I>::slave;
+
+  template<i2c::Address I>
+  u8 I2c<I>::reg;
+
+  template<i2c::Address I>
+  u8* I2c<I>::data;
+
+  template<i2c::Address I>
+  u16 I2c<I>::remaining;
+
+  /**
+   * @brief Unmasks the I2C interrupts and enables the error interrupt.
+   * @note  The I2C must be already clocked and configured as master.
+   */
+  template<i2c::Address I>
+  void I2c<I>::initialize()
+  {
+    Bus::enableErrorInterrupt();
+    Bus::unmaskInterrupts();
+  }
+
+  /**
+   * @brief Advances the register read state machine.
+   * @note  Must be called from the I2C event interrupt handler.
+   */
+  template<i2c::Address I>
+  void I2c<I>::onEventInterrupt()
+  {
+    switch (step) {
+      case SELECT_FOR_WRITE:
+        if (Bus::hasSentStart()) {
+          Bus::sendAddress(slave, i2c::operation::WRITE);
+          step = SEND_REGISTER;
+        }
+        break;
+      case SEND_REGISTER:
+        if (Bus::hasAddressTransmitted()) {
+          Bus::clearAddressFlag();
+          Bus::sendData(reg);
+          step = RESTART;
+        }
+        break;
+      case RESTART:
+        if (Bus::hasTranferFinished()) {
+          Bus::sendStart();
+          step = SELECT_FOR_READ;
+        }
+        break;
+      case SELECT_FOR_READ:
+        if (Bus::hasSentStart()) {
+          Bus::sendAddress(slave, i2c::operation::READ);
+
+          if (remaining == 1) {
+            Bus::disableACK();
+          }
+
+          step = START_READING;
+        }
+        break;
+      case START_READING:
+        if (Bus::hasAddressTransmitted()) {
+          Bus::clearAddressFlag();
+
+          if (remaining == 1) {
+            Bus::sendStop();
+          }
+
+          Bus::enableBufferInterrupt();
+          step = READ;
+        }
+        break;
+      case READ:
+        if (Bus::hasReceivedData()) {
+          // The last byte is being received, NACK it and release the bus
+          if (remaining == 2) {
+            Bus::disableACK();
+            Bus::sendStop();
+          }
+
+          *data = Bus::getData();
+          data++;
+          remaining--;
+
+          if (remaining == 0) {
+            finish(true);
+          }
+        }
+        break;
+    }
+  }
+
+  /**
+   * @brief Aborts the transaction in flight.
+   * @note  Must be called from the I2C error interrupt handler.
+   */
+  template<i2c::Address I>
+  void I2c<I>::onErrorInterrupt()
+  {
+    Bus::sendStop();
+
+    // The error flags are cleared by writing 0, the other flags are read only
+    reinterpret_cast<i2c::Registers*>(I)->SR1 = 0;
+
+    if (!operation.isDone()) {
+      finish(false);
+    }
+  }
+
+  /**
+   * @brief Starts reading <size> bytes from the register <address> of the
+   *        <slave> device into <buffer>.
+   * @note  The operation fails if the slave doesn't acknowledge.
+   * @note  Must not be called while a previous read is pending.
+   */
+  template<i2c::Address I>
+  Operation& I2c<I>::read(
+      u8 const address,
+      u8 const registerAddress,
+      u8* const buffer,
+      u16 const size)
+  {
+    operation.start();
+
+    if (size == 0) {
+      operation.complete(true);
+      return operation;
+    }
+
+    slave = address;
+    reg = registerAddress;
+    data = buffer;
+    remaining = size;
+    step = SELECT_FOR_WRITE;
+
+    Bus::enableACK();
+    Bus::enableEventInterrupt();
+    Bus::sendStart();
+
+    return operation;
+  }
+
+  /**
+   * @brief Disables the transfer interrupts and completes the operation.
+   */
+  template<i2c::Address I>
+  void I2c<I>::finish(bool const success)
+  {
+    Bus::disableBufferInterrupt();
+    Bus::disableEventInterrupt();
+
+    operation.complete(success);
+  }
+
+#ifndef STM32F1XX
+  /*****************************************************************************
+   *                               DMA (F2/F4)
+   ****************************************************************************/
+
+  template<dma::common::Address D, dma::stream::Address S>
+  Operation DmaCopy<D, S>::operation;
+
+  /**
+   * @brief Enables the DMA clock and unmasks the stream interrupt.
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  void DmaCopy<D, S>::initialize()
+  {
+    Stream::enableClock();
+    Stream::unmaskInterrupts();
+  }
+
+  /**
+   * @brief Completes the copy.
+   * @note  Must be called from the DMA stream interrupt handler.
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  void DmaCopy<D, S>::onInterrupt()
+  {
+    if (Stream::hasTransferCompleteOccurred()) {
+      Stream::clearTransferCompleteFlag();
+      operation.complete(true);
+    } else if (Stream::hasTransferErrorOccurred()) {
+      Stream::clearTransferErrorFlag();
+      operation.complete(false);
+    }
+  }
+
+  /**
+   * @brief Starts copying <words> 32-bit words from <source> to
+   *        <destination>.
+   * @note  Both buffers must be word aligned and reachable by the DMA (not
+   *        in the CCM).
+   * @note  Must not be called while a previous copy is pending.
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  Operation& DmaCopy<D, S>::copy(
+      u32* const destination,
+      u32 const* const source,
+      u16 const words)
+  {
+    operation.start();
+
+    if (words == 0) {
+      operation.complete(true);
+      return operation;
+    }
+
+    Stream::disablePeripheral();
+
+    while (Stream::isEnabled()) {
+    }
+
+    Stream::clearTransferCompleteFlag();
+    Stream::clearTransferErrorFlag();
+    Stream::clearHalfTransferFlag();
+    Stream::clearFifoErrorFlag();
+    Stream::clearDirectModeErrorFlag();
+
+    // In memory to memory mode the source is behind the peripheral port
+    Stream::configure(
+        dma::stream::cr::dmeie::DIRECT_MODE_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::teie::TRANSFER_ERROR_INTERRUPT_ENABLED,
+        dma::stream::cr::htie::HALF_TRANSFER_INTERRUPT_DISABLED,
+        dma::stream::cr::tcie::TRANSFER_COMPLETE_INTERRUPT_ENABLED,
+        dma::stream::cr::pfctrl::DMA_FLOW_CONTROLLER,
+        dma::stream::cr::dir::MEMORY_TO_MEMORY,
+        dma::stream::cr::circ::CIRCULAR_MODE_DISABLED,
+        dma::stream::cr::pinc::PERIPHERAL_INCREMENT_MODE_ENABLED,
+        dma::stream::cr::minc::MEMORY_INCREMENT_MODE_ENABLED,
+        dma::stream::cr::psize::PERIPHERAL_SIZE_32BITS,
+        dma::stream::cr::msize::MEMORY_SIZE_32BITS,
+        dma::stream::cr::pincos::PERIPHERAL_INCREMENT_OFFSET_SIZE_PSIZE,
+        dma::stream::cr::pl::PRIORITY_LEVEL_LOW,
+        dma::stream::cr::dbm::DOUBLE_BUFFER_MODE_DISABLED,
+        dma::stream::cr::ct::CURRENT_TARGET_MEMORY_0,
+        dma::stream::cr::pburst::PERIPHERAL_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::mburst::MEMORY_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::chsel::CHANNEL_0);
+
+    // The direct mode isn't allowed in memory to memory transfers
+    Stream::configureFIFO(
+        dma::stream::fcr::fth::FIFO_THRESHOLD_SELECTION_FULL,
+        dma::stream::fcr::dmdis::DIRECT_MODE_DISABLED,
+        dma::stream::fcr::feie::FIFO_ERROR_INTERRUPT_DISABLED);
+
+    Stream::setPeripheralAddress(const_cast<u32*>(source));
+    Stream::setMemory0Address(destination);
+    Stream::setNumberOfTransactions(words);
+
+    Stream::enablePeripheral();
+
+    return operation;
+  }
+#endif // !STM32F1XX
+
+  /*****************************************************************************
+   *                                   FLASH
+   ****************************************************************************/
+
+  /**
+   * @brief Enables the end of operation and the error interrupts.
+   */
+  void Flash::initialize()
+  {
+    FLASH::enableInterrupts();
+  }
+
+  /**
+   * @brief Programs the next unit, or completes the operation.
+   * @note  Must be called from the FLASH interrupt handler.
+   */
+  void Flash::onInterrupt()
+  {
+    State& s = state();
+    bool const failed = FLASH::getErrors() != 0;
+
+    if (!failed && !FLASH::hasOperationEnded()) {
+      return;
+    }
+
+    FLASH::clearFlags();
+
+    if (!failed && (s.remaining != 0)) {
+      writeNext();
+      return;
+    }
+
+    FLASH::endOperation();
+    s.operation.complete(!failed);
+  }
+
+#ifdef STM32F1XX
+  /**
+   * @brief Starts erasing the page that contains <address>.
+   * @note  Must not be called while a previous operation is pending.
+   */
+  Operation& Flash::erasePage(u32 const address)
+  {
+    State& s = state();
+
+    s.operation.start();
+    s.remaining = 0;
+
+    FLASH::wait();
+    FLASH::clearFlags();
+    FLASH::startPageErase(address);
+
+    return s.operation;
+  }
+#else // STM32F1XX
+  /**
+   * @brief Starts erasing the sector number <sector>.
+   * @note  Must not be called while a previous operation is pending.
+   */
+  Operation& Flash::eraseSector(u8 const sector)
+  {
+    State& s = state();
+
+    s.operation.start();
+    s.remaining = 0;
+
+    FLASH::wait();
+    FLASH::clearFlags();
+    FLASH::startSectorErase(sector);
+
+    return s.operation;
+  }
+#endif // STM32F1XX
+
+  /**
+   * @brief Starts programming <size> bytes of <data> at <address>.
+   * @note  <address> and <size> must be multiples of the programming unit,
+   *        otherwise the operation fails right away.
+   * @note  <data> must stay valid until the operation completes.
+   * @note  Must not be called while a previous operation is pending.
+   */
+  Operation& Flash::program(
+      u32 const address,
+      void const* const data,
+      u32 const size)
+  {
+    State& s = state();
+    u8 const unit = FLASH::getProgrammingUnit();
+
+    s.operation.start();
+
+    if ((address % unit != 0) || (size % unit != 0)) {
+      s.operation.complete(false);
+      return s.operation;
+    }
+
+    if (size == 0) {
+      s.operation.complete(true);
+      return s.operation;
+    }
+
+    s.address = address;
+    s.data = static_cast<u8 const*>(data);
+    s.remaining = size;
+
+    FLASH::wait();
+    FLASH::clearFlags();
+    FLASH::beginProgramming();
+    writeNext();
+
+    return s.operation;
+  }
+
+  /**
+   * @brief Starts programming the next unit.
+   */
+  void Flash::writeNext()
+  {
+    State& s = state();
+    u8 const unit = FLASH::getProgrammingUnit();
+
+    FLASH::writeUnit(s.address, s.data);
+
+    s.address += unit;
+    s.data += unit;
+    s.remaining -= unit;
+  }
+
+  Flash::State& Flash::state()
+  {
+    static State s;
+
+    return s;
+  }
+
+  /*****************************************************************************
+   *                                   Timer
+   ****************************************************************************/
+
+  template<typename DELAY>
+  Operation Timer<DELAY>::operation;
+
+  template<typename DELAY>
+  delay::Alarm Timer<DELAY>::alarm;
+
+  /**
+   * @brief Starts an operation that completes after <ticks> ticks of the
+   *        DELAY timer.
+   * @note  A pending sleep is restarted, and keeps its continuation.
+   */
+  template<typename DELAY>
+  Operation& Timer<DELAY>::sleep(u32 const ticks)
+  {
+    // The old alarm must not complete the restarted operation
+    DELAY::cancel(alarm);
+
+    if (operation.isDone()) {
+      operation.start();
+    }
+
+    DELAY::start(alarm, ticks, expire, 0);
+
+    return operation;
+  }
+
+  template<typename DELAY>
+  void Timer<DELAY>::expire(void*)
+  {
+    operation.complete(true);
+  }
+
+#ifdef __cpp_impl_coroutine
+  /*****************************************************************************
+   *                                Coroutines
+   ****************************************************************************/
+
+  u8 (&FramePool::frames())[ASYNC_FRAMES][ASYNC_FRAME_SIZE]
+  {
+    static u8 pool[ASYNC_FRAMES][ASYNC_FRAME_SIZE] __attribute__((aligned(8)));
+
+    return pool;
+  }
+
+  u32& FramePool::used()
+  {
+    static u32 mask;
+
+    return mask;
+  }
+
+  /**
+   * @brief Takes a free frame from the pool.
+   * @note  Returns 0 if the frame is too big, or if the pool is exhausted.
+   */
+  void* FramePool::allocate(std::size_t const size)
+  {
+    if (size > ASYNC_FRAME_SIZE) {
+      return 0;
+    }
+
+    critical::Section section;
+
+    for (u8 i = 0; i < ASYNC_FRAMES; i++) {
+      if ((used() & (1 << i)) == 0) {
+        used() |= 1 << i;
+
+        return frames()[i];
+      }
+    }
+
+    return 0;
+  }
+
+  /**
+   * @brief Gives a frame back to the pool.
+   */
+  void FramePool::release(void* const frame)
+  {
+    critical::Section section;
+
+    u32 const index =
+        (static_cast<u8*>(frame) - frames()[0]) / ASYNC_FRAME_SIZE;
+
+    used() &= ~(1 << index);
+  }
+
+  Coroutine::Coroutine(bool const started) :
+      started(started)
+  {
+  }
+
+  /**
+   * @brief Returns false if the coroutine couldn't get a frame.
+   */
+  bool Coroutine::hasStarted() const
+  {
+    return started;
+  }
+
+  Coroutine Coroutine::promise_type::get_return_object()
+  {
+    return Coroutine(true);
+  }
+
+  Coroutine Coroutine::promise_type::get_return_object_on_allocation_failure()
+  {
+    return Coroutine(false);
+  }
+
+  std::suspend_never Coroutine::promise_type::initial_suspend() noexcept
+  {
+    return std::suspend_never();
+  }
+
+  // The frame is released as soon as the coroutine returns
+  std::suspend_never Coroutine::promise_type::final_suspend() noexcept
+  {
+    return std::suspend_never();
+  }
+
+  void Coroutine::promise_type::return_void()
+  {
+  }
+
+  void Coroutine::promise_type::unhandled_exception()
+  {
+  }
+
+  void* Coroutine::promise_type::operator new(std::size_t const size) noexcept
+  {
+    return FramePool::allocate(size);
+  }
+
+  void Coroutine::promise_type::operator delete(void* const frame)
+  {
+    FramePool::release(frame);
+  }
+
+  Awaiter::Awaiter(Operation& operation) :
+      operation(operation)
+  {
+  }
+
+  bool Awaiter::await_ready() const
+  {
+    return operation.isDone();
+  }
+
+  /**
+   * @brief Suspends the coroutine until the operation completes, unless it
+   *        completed in the meantime.
+   */
+  bool Awaiter::await_suspend(std::coroutine_handle<> handle)
+  {
+    return operation.then(resume, handle.address());
+  }
+
+  /**
+   * @brief Returns true if the operation succeeded.
+   */
+  bool Awaiter::await_resume() const
+  {
+    return !operation.hasFailed();
+  }
+
+  void Awaiter::resume(void* handle)
+  {
+    std::coroutine_handle<>::from_address(handle).resume();
+  }
+
+  Awaiter operator co_await(Operation& operation)
+  {
+    return Awaiter(operation);
+  }
+#endif // __cpp_impl_coroutine
+}  // namespace async
@@ -0,0 +1,160 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace benchmark {
+#ifndef __arm__
+  /**
+   * @brief Returns the monotonic clock, in nanoseconds.
+   * @note  Wraps around every ~4.3 seconds.
+   */
+  u32 HostCounter::getCycleCount()
+  {
+    timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return u32(now.tv_sec) * 1000000000U + u32(now.tv_nsec);
+  }
+#endif // !__arm__
+
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  typename Suite<COUNTER, RUNS, MAX_KERNELS>::Entry
+  Suite<COUNTER, RUNS, MAX_KERNELS>::entries[MAX_KERNELS];
+
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  u8 Suite<COUNTER, RUNS, MAX_KERNELS>::size;
+
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  u32 Suite<COUNTER, RUNS, MAX_KERNELS>::samples[RUNS];
+
+  /**
+   * @brief Used to measure the call overhead.
+   */
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  void Suite<COUNTER, RUNS, MAX_KERNELS>::empty()
+  {
+  }
+
+  /**
+   * @brief Registers a kernel.
+   * @note  Returns false if there are already MAX_KERNELS kernels.
+   */
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  bool Suite<COUNTER, RUNS, MAX_KERNELS>::add(
+      char const* const name,
+      Kernel const kernel)
+  {
+    if (size == MAX_KERNELS) {
+      return false;
+    }
+
+    entries[size].name = name;
+    entries[size].kernel = kernel;
+    size++;
+
+    return true;
+  }
+
+  /**
+   * @brief Measures a single execution of <kernel>.
+   */
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  u32 Suite<COUNTER, RUNS, MAX_KERNELS>::sample(Kernel const kernel)
+  {
+    u32 const start = COUNTER::getCycleCount();
+
+    kernel();
+
+    return COUNTER::getCycleCount() - start;
+  }
+
+  /**
+   * @brief Runs <kernel> RUNS times (after a warm up run), and returns the
+   *        minimum, median and maximum cost, minus the call overhead.
+   */
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  Result Suite<COUNTER, RUNS, MAX_KERNELS>::measure(Kernel const kernel)
+  {
+    u32 overhead = sample(empty);
+
+    for (u16 i = 0; i < RUNS; i++) {
+      u32 const cost = sample(empty);
+
+      if (cost < overhead) {
+        overhead = cost;
+      }
+    }
+
+    kernel();
+
+    // Insertion sort, RUNS is small
+    for (u16 i = 0; i < RUNS; i++) {
+      u32 const cost = sample(kernel);
+      u32 const value = cost > overhead ? cost - overhead : 0;
+      u16 j = i;
+
+      while ((j > 0) && (samples[j - 1] > value)) {
+        samples[j] = samples[j - 1];
+        j--;
+      }
+
+      samples[j] = value;
+    }
+
+    Result result;
+
+    result.minimum = samples[0];
+    result.median = samples[RUNS / 2];
+    result.maximum = samples[RUNS - 1];
+
+    return result;
+  }
+
+  /**
+   * @brief Measures every registered kernel, and sends the results as CSV
+   *        through OUTPUT (e.g. USART1).
+   */
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS>
+  template<typename OUTPUT>
+  void Suite<COUNTER, RUNS, MAX_KERNELS>::run()
+  {
+    typedef text::Writer<OUTPUT> TEXT;
+
+    TEXT::print("kernel,runs,min,median,max\r\n");
+
+    for (u8 i = 0; i < size; i++) {
+      Result const result = measure(entries[i].kernel);
+
+      TEXT::print(entries[i].name);
+      TEXT::print(",");
+      TEXT::print(RUNS);
+      TEXT::print(",");
+      TEXT::print(result.minimum);
+      TEXT::print(",");
+      TEXT::print(result.median);
+      TEXT::print(",");
+      TEXT::print(result.maximum);
+      TEXT::print("\r\n");
+    }
+  }
+}  // namespace benchmark
@@ -33,4 +33,31 @@ namespace bkp {
   {
     RCC::disableClocks<rcc::apb1enr::BKP>();
   }
+
+  /**
+   * @brief Writes the backup data register <index>, 0 to 9 map to DR1..DR10
+   *        and 10 to 41 to DR11..DR42 (high-density, XL-density and
+   *        connectivity line devices only).
+   * @note  The backup domain write access must be enabled.
+   */
+  void Functions::writeData(u8 const index, u16 const data)
+  {
+    if (index < 10) {
+      BKP_REGS->DR1[index] = data;
+    } else {
+      BKP_REGS->DR2[index - 10] = data;
+    }
+  }
+
+  /**
+   * @brief Reads the backup data register <index>, see writeData().
+   */
+  u16 Functions::readData(u8 const index)
+  {
+    if (index < 10) {
+      return BKP_REGS->DR1[index];
+    }
+
+    return BKP_REGS->DR2[index - 10];
+  }
 } // namespace bkp
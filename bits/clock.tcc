@@ -23,6 +23,7 @@
 
 #include "peripheral/pwr.hpp"
 #include "cfunctions.hpp"
+#include "pll.hpp"
 
 namespace clk {
   /****************************************************************************
@@ -124,9 +125,45 @@ namespace clk {
    *                                                                          *
    ****************************************************************************/
 #ifdef USING_PLL
+#ifdef USING_PLL_SOLVER
+  static_assert(u32(__TARGET_SYSTEM) <= u32(pll::SYSTEM_MAX),
+      "The target system clock exceeds the maximum of this family.");
+  enum {
+#if defined USING_USB || \
+    defined USING_EXACT_48MHZ
+    __EXACT_48MHZ = 1
+#else // USING_USB || USING_EXACT_48MHZ
+    __EXACT_48MHZ = 0
+#endif // USING_USB || USING_EXACT_48MHZ
+  };
+#endif // USING_PLL_SOLVER
 #ifdef STM32F1XX
 #ifndef CONNECTIVITY_LINE
 #ifdef VALUE_LINE
+#ifdef USING_PLL_SOLVER
+  enum {
+    __PLL_INPUT = __PLLSRC ==
+    rcc::cfgr::pllsrc::
+    USE_HSI_CLOCK_OVER_2_AS_PLL_SOURCE ?
+    HSI :
+    HSE,
+    __PLL_MAX_DIVIDER = __PLLSRC ==
+    rcc::cfgr::pllsrc::
+    USE_HSI_CLOCK_OVER_2_AS_PLL_SOURCE ?
+    1 :
+    16
+  };
+  enum {
+    __PLL_SOLUTION = pll::solve(__PLL_INPUT, __TARGET_SYSTEM,
+        __PLL_MAX_DIVIDER, __EXACT_48MHZ)
+  };
+  static_assert(__PLL_SOLUTION != 0,
+      "The target system clock can't be reached with this PLL source.");
+  enum {
+    __PREDIV1 = pll::divider(__PLL_SOLUTION),
+    __PLLMUL = pll::multiplier(__PLL_SOLUTION)
+  };
+#endif // USING_PLL_SOLVER
   static_assert((__PREDIV1 >= 1) && (__PREDIV1 <= 16),
       "PREDIV1 must be between 1 and 16 (inclusive)");
   enum {
@@ -141,6 +178,30 @@ namespace clk {
         0)
   };
 #else // VALUE_LINE
+#ifdef USING_PLL_SOLVER
+  enum {
+    __PLL_INPUT = __PLLSRC ==
+    rcc::cfgr::pllsrc::
+    USE_HSI_CLOCK_OVER_2_AS_PLL_SOURCE ?
+    (HSI / 2) :
+    HSE,
+    __PLL_MAX_DIVIDER = __PLLSRC ==
+    rcc::cfgr::pllsrc::
+    USE_HSI_CLOCK_OVER_2_AS_PLL_SOURCE ?
+    1 :
+    2
+  };
+  enum {
+    __PLL_SOLUTION = pll::solve(__PLL_INPUT, __TARGET_SYSTEM,
+        __PLL_MAX_DIVIDER, __EXACT_48MHZ)
+  };
+  static_assert(__PLL_SOLUTION != 0,
+      "The target system clock can't be reached with this PLL source.");
+  enum {
+    __PLLXTPRE = pll::divider(__PLL_SOLUTION) - 1,
+    __PLLMUL = pll::multiplier(__PLL_SOLUTION)
+  };
+#endif // USING_PLL_SOLVER
   static_assert((__PLLXTPRE >= 0) && (__PLLXTPRE <= 1),
       "PLLXTPRE can only take two values: 0 or 1");
   enum {
@@ -168,6 +229,34 @@ namespace clk {
         __PLL2MUL + 2
     ) / __PREDIV2,
   };
+#ifdef USING_PLL_SOLVER
+  enum {
+    __PLL_INPUT = __PLLSRC ==
+    rcc::cfgr::pllsrc::
+    USE_HSI_CLOCK_OVER_2_AS_PLL_SOURCE ?
+    (HSI / 2) :
+    (__PREDIV1SRC ==
+        rcc::cfgr2::prediv1src::
+        USE_PLL2_AS_PREDIV1_INPUT ?
+        u32(__PLL2) :
+        u32(HSE)),
+    __PLL_MAX_DIVIDER = __PLLSRC ==
+    rcc::cfgr::pllsrc::
+    USE_HSI_CLOCK_OVER_2_AS_PLL_SOURCE ?
+    1 :
+    16
+  };
+  enum {
+    __PLL_SOLUTION = pll::solve(__PLL_INPUT, __TARGET_SYSTEM,
+        __PLL_MAX_DIVIDER, __EXACT_48MHZ)
+  };
+  static_assert(__PLL_SOLUTION != 0,
+      "The target system clock can't be reached with this PLL source.");
+  enum {
+    __PREDIV1 = pll::divider(__PLL_SOLUTION),
+    __PLLMUL = pll::multiplier(__PLL_SOLUTION)
+  };
+#endif // USING_PLL_SOLVER
 
   enum {
     _PLLSRC =
@@ -190,12 +279,23 @@ namespace clk {
                 0)))
   };
 
+  static_assert(((__PLLMUL >= 4) && (__PLLMUL <= 9)) || (__PLLMUL == 13),
+      "PLLMUL must be between 4 and 9 (inclusive), or 13 for x6.5");
+  enum {
+    PLL = __PLLMUL == 13 ? _PLLSRC * 13 / 2 : _PLLSRC * __PLLMUL,
+    // The register field holds 13 for x6.5, and the multiplier - 2 otherwise
+    __PLLMUL_FIELD = __PLLMUL == 13 ? 13 : __PLLMUL - 2
+  };
 #endif // !CONNECTIVITY_LINE
+#ifndef CONNECTIVITY_LINE
   static_assert((__PLLMUL >= 2) && (__PLLMUL <= 16),
       "PLLMUL must be between 2 and 16 (inclusive)");
   enum {
-    PLL = _PLLSRC * __PLLMUL
+    PLL = _PLLSRC * __PLLMUL,
+    // The register field holds the multiplier - 2
+    __PLLMUL_FIELD = __PLLMUL - 2
   };
+#endif // !CONNECTIVITY_LINE
 #ifdef VALUE_LINE
   static_assert(PLL <= 24000000,
       "The PLL clock can't exceed 24 MHz");
@@ -216,6 +316,19 @@ namespace clk {
         HSI :
         0)
   };
+#ifdef USING_PLL_SOLVER
+  enum {
+    __PLL_SOLUTION = pll::solve(_PLLSRC, __TARGET_SYSTEM, __EXACT_48MHZ)
+  };
+  static_assert(__PLL_SOLUTION != 0,
+      "The target system clock can't be reached with this PLL source.");
+  enum {
+    __PLLM = pll::m(__PLL_SOLUTION),
+    __PLLN = pll::n(__PLL_SOLUTION),
+    __PLLP = pll::p(__PLL_SOLUTION),
+    __PLLQ = pll::q(__PLL_SOLUTION)
+  };
+#endif // USING_PLL_SOLVER
   static_assert((__PLLM >= 2) && (__PLLM <= 63),
       "PLLM must be between 2 and 63 (inclusive).");
   static_assert((__PLLN >= 64) && (__PLLN <= 432),
@@ -283,6 +396,13 @@ enum {
  *                              BUS PRESCALERS                              *
  *                                                                          *
  ****************************************************************************/
+#ifdef USING_PLL_SOLVER
+enum {
+  __HPRE = 0,
+  __PPRE1 = pll::prescaler(SYSTEM, pll::APB1_MAX),
+  __PPRE2 = pll::prescaler(SYSTEM, pll::APB2_MAX),
+};
+#endif // USING_PLL_SOLVER
 #ifdef STM32F1XX
 enum {
   AHB = SYSTEM / cPow<2, __HPRE>::value,
@@ -324,6 +444,11 @@ static_assert(APB2 <= 84000000,
 #ifdef USING_USB
 #if not defined STM32F2XX && \
     not defined STM32F4XX
+#ifdef USING_PLL_SOLVER
+enum {
+  __USBPRE = pll::usbPrescaler(PLL)
+};
+#endif // USING_PLL_SOLVER
 enum {
   USB = PLL * 2 / (2 + __USBPRE)
 };
@@ -576,6 +701,12 @@ static_assert(MCO2 <= 100000000,
  *                        FLASH MEMORY ACCESS LATENCY                       *
  *                                                                          *
  ****************************************************************************/
+#if defined USING_PLL_SOLVER && \
+    not defined VALUE_LINE
+flash::acr::latency::States const __LATENCY =
+    flash::acr::latency::States(
+        pll::latency(SYSTEM) << flash::acr::latency::POSITION);
+#endif // USING_PLL_SOLVER && !VALUE_LINE
 #if defined STM32F1XX && \
     not defined VALUE_LINE
 static_assert((SYSTEM < 24000000) ||
@@ -670,22 +801,22 @@ void initialize()
 #ifdef VALUE_LINE
   RCC::configurePll<
   __PLLSRC,
-  __PLLMUL,
-  __PREDIV1
+  __PLLMUL_FIELD,
+  __PREDIV1 - 1
   >();
 #else // VALUE_LINE
 #ifndef CONNECTIVITY_LINE
   RCC::configurePll<
   __PLLSRC,
   __PLLXTPRE,
-  __PLLMUL
+  __PLLMUL_FIELD
   >();
 #else // !CONNECTIVITY_LINE
   RCC::configurePll<
   __PLLSRC,
-  __PLLMUL,
-  __PREDIV1,
-  __PREDIV2,
+  __PLLMUL_FIELD,
+  __PREDIV1 - 1,
+  __PREDIV2 - 1,
   __PLL2MUL,
 #ifdef USING_I2S_PLL
   __PLL3MUL,
@@ -41,4 +41,278 @@ namespace crc {
     RCC::disableClocks<rcc::ahbenr::CRC>();
 #endif // !STM32F1XX
   }
+
+  /**
+   * @brief Restarts the computation from 0xFFFFFFFF.
+   */
+  void Functions::reset()
+  {
+    CRC_REGS->CR = cr::reset::MASK;
+  }
+
+  /**
+   * @brief Feeds one word to the unit.
+   */
+  void Functions::write(u32 const word)
+  {
+    CRC_REGS->DR = word;
+  }
+
+  /**
+   * @brief Returns the CRC of the words fed since the last reset.
+   */
+  u32 Functions::read()
+  {
+    return CRC_REGS->DR;
+  }
+
+  /**
+   * @brief Feeds <words> words read from <data>, which may be unaligned.
+   * @note  Can be called repeatedly to process a block in several parts.
+   */
+  void Functions::write(void const* const data, u32 const words)
+  {
+    if ((u32(reinterpret_cast<uintptr_t>(data)) & 3) == 0) {
+      u32 const* word = static_cast<u32 const*>(data);
+      u32 const* const end = word + words;
+
+      while (word < end) {
+        CRC_REGS->DR = *word++;
+      }
+    } else {
+      u8 const* bytes = static_cast<u8 const*>(data);
+      u8 const* const end = bytes + 4 * words;
+
+      while (bytes < end) {
+        CRC_REGS->DR = load(bytes);
+        bytes += 4;
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the unit result continued in software over the last
+   *        <size> (0 to 3) bytes of the block.
+   */
+  u32 Functions::finish(void const* const data, u8 const size)
+  {
+    u8 const* const bytes = static_cast<u8 const*>(data);
+    u32 crc = read();
+
+    for (u8 i = 0; i < size; i++) {
+      crc ^= u32(bytes[i]) << 24;
+
+      for (u8 bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x80000000) ? (crc << 1) ^ POLYNOMIAL : crc << 1;
+      }
+    }
+
+    return crc;
+  }
+
+  /**
+   * @brief Returns the native CRC of <size> bytes at <data>.
+   */
+  u32 Functions::compute(void const* const data, u32 const size)
+  {
+    reset();
+    write(data, size / 4);
+
+    return finish(static_cast<u8 const*>(data) + (size & ~3), size & 3);
+  }
+
+  /**
+   * @brief Returns the standard (zlib, Ethernet FCS) CRC-32 of <size> bytes
+   *        at <data>.
+   * @note  The unit works MSB first, the input words and the result are bit
+   *        reversed to get the reflected CRC, then complemented.
+   */
+  u32 Functions::computeCrc32(void const* const data, u32 const size)
+  {
+    u8 const* bytes = static_cast<u8 const*>(data);
+    u8 const* const end = bytes + (size & ~3);
+
+    reset();
+
+    while (bytes < end) {
+      CRC_REGS->DR = reverse(load(bytes));
+      bytes += 4;
+    }
+
+    u32 crc = reverse(read());
+
+    for (u8 i = 0; i < (size & 3); i++) {
+      crc ^= bytes[i];
+
+      for (u8 bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) ? (crc >> 1) ^ REFLECTED_POLYNOMIAL : crc >> 1;
+      }
+    }
+
+    return ~crc;
+  }
+
+  u32 Functions::reverse(u32 const word)
+  {
+    u32 reversed;
+
+    asm ("rbit %0, %1" : "=r" (reversed) : "r" (word));
+
+    return reversed;
+  }
+
+  /**
+   * @brief Reads a little endian word at any alignment.
+   */
+  u32 Functions::load(u8 const* const bytes)
+  {
+    return bytes[0] + (bytes[1] << 8) + (bytes[2] << 16) +
+        (u32(bytes[3]) << 24);
+  }
+
+#ifndef STM32F1XX
+  template<dma::common::Address D, dma::stream::Address S>
+  u8 const* Dma<D, S>::position;
+
+  template<dma::common::Address D, dma::stream::Address S>
+  u32 Dma<D, S>::remaining;
+
+  template<dma::common::Address D, dma::stream::Address S>
+  u8 Dma<D, S>::trailing;
+
+  /**
+   * @brief Enables the CRC and DMA clocks.
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  void Dma<D, S>::initialize()
+  {
+    Functions::enableClock();
+    Stream::enableClock();
+  }
+
+  /**
+   * @brief Starts feeding <size> bytes at <data> to the unit.
+   * @note  <data> must be reachable by the DMA (not in the CCM). An
+   *        unaligned block is read byte by byte, and packed in words by the
+   *        stream FIFO.
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  void Dma<D, S>::start(void const* const data, u32 const size)
+  {
+    position = static_cast<u8 const*>(data);
+    remaining = size & ~3;
+    trailing = size & 3;
+
+    Functions::reset();
+
+    startChunk();
+  }
+
+  /**
+   * @brief Returns true until the whole block has been fed to the unit.
+   * @note  Must be polled, it also chains the transfers of blocks larger
+   *        than a single DMA transfer.
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  bool Dma<D, S>::isBusy()
+  {
+    if (Stream::isEnabled()) {
+      return true;
+    }
+
+    if (remaining != 0) {
+      startChunk();
+
+      return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Returns the native CRC of the block, see CRC::compute().
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  u32 Dma<D, S>::getResult()
+  {
+    return Functions::finish(position, trailing);
+  }
+
+  /**
+   * @brief Returns the native CRC of <size> bytes at <data>, fed by the CPU
+   *        below THRESHOLD bytes, by the DMA otherwise.
+   */
+  template<dma::common::Address D, dma::stream::Address S>
+  u32 Dma<D, S>::compute(void const* const data, u32 const size)
+  {
+    if (size < THRESHOLD) {
+      return Functions::compute(data, size);
+    }
+
+    start(data, size);
+
+    while (isBusy()) {
+    }
+
+    return getResult();
+  }
+
+  template<dma::common::Address D, dma::stream::Address S>
+  void Dma<D, S>::startChunk()
+  {
+    bool const aligned =
+        (u32(reinterpret_cast<uintptr_t>(position)) & 3) == 0;
+    // The number of transactions is a 16-bit count of source items
+    u32 const limit = aligned ? 0xFFFF * 4 : 0xFFFC;
+    u32 const bytes = remaining < limit ? remaining : limit;
+
+    if (bytes == 0) {
+      return;
+    }
+
+    Stream::clearTransferCompleteFlag();
+    Stream::clearTransferErrorFlag();
+    Stream::clearHalfTransferFlag();
+    Stream::clearFifoErrorFlag();
+    Stream::clearDirectModeErrorFlag();
+
+    // In memory to memory mode the source is behind the peripheral port
+    Stream::configure(
+        dma::stream::cr::dmeie::DIRECT_MODE_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::teie::TRANSFER_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::htie::HALF_TRANSFER_INTERRUPT_DISABLED,
+        dma::stream::cr::tcie::TRANSFER_COMPLETE_INTERRUPT_DISABLED,
+        dma::stream::cr::pfctrl::DMA_FLOW_CONTROLLER,
+        dma::stream::cr::dir::MEMORY_TO_MEMORY,
+        dma::stream::cr::circ::CIRCULAR_MODE_DISABLED,
+        dma::stream::cr::pinc::PERIPHERAL_INCREMENT_MODE_ENABLED,
+        dma::stream::cr::minc::MEMORY_INCREMENT_MODE_DISABLED,
+        aligned ?
+            dma::stream::cr::psize::PERIPHERAL_SIZE_32BITS :
+            dma::stream::cr::psize::PERIPHERAL_SIZE_8BITS,
+        dma::stream::cr::msize::MEMORY_SIZE_32BITS,
+        dma::stream::cr::pincos::PERIPHERAL_INCREMENT_OFFSET_SIZE_PSIZE,
+        dma::stream::cr::pl::PRIORITY_LEVEL_LOW,
+        dma::stream::cr::dbm::DOUBLE_BUFFER_MODE_DISABLED,
+        dma::stream::cr::ct::CURRENT_TARGET_MEMORY_0,
+        dma::stream::cr::pburst::PERIPHERAL_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::mburst::MEMORY_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::chsel::CHANNEL_0);
+
+    // The direct mode isn't allowed in memory to memory transfers
+    Stream::configureFIFO(
+        dma::stream::fcr::fth::FIFO_THRESHOLD_SELECTION_FULL,
+        dma::stream::fcr::dmdis::DIRECT_MODE_DISABLED,
+        dma::stream::fcr::feie::FIFO_ERROR_INTERRUPT_DISABLED);
+
+    Stream::setPeripheralAddress(const_cast<u8*>(position));
+    Stream::setMemory0Address(const_cast<u32*>(&CRC_REGS->DR));
+    Stream::setNumberOfTransactions(aligned ? bytes / 4 : bytes);
+
+    position += bytes;
+    remaining -= bytes;
+
+    Stream::enablePeripheral();
+  }
+#endif // !STM32F1XX
 }  // namespace crc
@@ -33,4 +33,320 @@ namespace cryp {
   {
     RCC::disableClocks<rcc::ahb2enr::CRYP>();
   }
+
+  /**
+   * @brief Loads the AES key, 16, 24 or 32 bytes according to <KEYSIZE>.
+   * @note  The processor must be stopped.
+   */
+  void Functions::setAesKey(void const* const key, cr::keysize::States KEYSIZE)
+  {
+    u8 const words = 4 + 2 * (KEYSIZE >> cr::keysize::POSITION);
+
+    // The shorter keys are right aligned in K0L..K3R
+    setKey(8 - words, static_cast<u8 const*>(key), words);
+
+    CRYP_REGS->CR = (CRYP_REGS->CR & ~cr::keysize::MASK) + KEYSIZE;
+  }
+
+  /**
+   * @brief Loads the 8 bytes DES key.
+   * @note  The processor must be stopped.
+   */
+  void Functions::setDesKey(void const* const key)
+  {
+    setKey(2, static_cast<u8 const*>(key), 2);
+  }
+
+  /**
+   * @brief Loads the 24 bytes TDES key (K1, K2, K3).
+   * @note  The processor must be stopped.
+   */
+  void Functions::setTripleDesKey(void const* const key)
+  {
+    setKey(2, static_cast<u8 const*>(key), 6);
+  }
+
+  /**
+   * @brief Loads the <size> bytes IV (CBC) or initial counter block (CTR),
+   *        16 bytes for AES, 8 bytes for DES/TDES.
+   * @note  The processor must be stopped.
+   */
+  void Functions::setInitializationVector(void const* const iv, u8 const size)
+  {
+    u8 const* const bytes = static_cast<u8 const*>(iv);
+    u32 volatile* const words = &CRYP_REGS->IVR[0].L;
+
+    for (u8 i = 0; i < size / 4; i++) {
+      words[i] = (u32(bytes[4 * i]) << 24) + (bytes[4 * i + 1] << 16) +
+          (bytes[4 * i + 2] << 8) + bytes[4 * i + 3];
+    }
+  }
+
+  /**
+   * @brief Flushes the FIFOs and enables the processor in the
+   *        <ALGOMODE>/<ALGODIR> mode.
+   * @note  The AES ECB/CBC decryption needs the key schedule to be run
+   *        backwards, the processor is first run in key preparation mode.
+   */
+  void Functions::start(
+      cr::algomode::States ALGOMODE,
+      cr::algodir::States ALGODIR)
+  {
+    u32 const keysize = CRYP_REGS->CR & cr::keysize::MASK;
+
+    CRYP_REGS->CR = keysize;
+
+    if ((ALGODIR == cr::algodir::DECRYPT) &&
+        ((ALGOMODE == cr::algomode::AES_ECB) ||
+            (ALGOMODE == cr::algomode::AES_CBC))) {
+      CRYP_REGS->CR = keysize + cr::algomode::AES_KEY_PREPARATION +
+          cr::crypen::MASK;
+
+      while (CRYP_REGS->SR & sr::busy::MASK) {
+      }
+    }
+
+    CRYP_REGS->CR = keysize + cr::datatype::_8_BIT_DATA + ALGOMODE + ALGODIR;
+    CRYP_REGS->CR |= cr::fflush::MASK;
+    CRYP_REGS->CR |= cr::crypen::MASK;
+  }
+
+  /**
+   * @brief Encrypts or decrypts <size> bytes from <input> to <output>,
+   *        <output> may be <input>.
+   * @note  The ECB/CBC sizes must be multiples of getBlockSize(), only the
+   *        last CTR block may be partial.
+   */
+  void Functions::process(
+      void const* const input,
+      void* const output,
+      u32 size)
+  {
+    u8 const* in = static_cast<u8 const*>(input);
+    u8* out = static_cast<u8*>(output);
+    u8 const blockSize = getBlockSize();
+
+    for (; size >= blockSize; size -= blockSize) {
+      processBlock(in, out);
+      in += blockSize;
+      out += blockSize;
+    }
+
+    if (size != 0) {
+      u8 block[AES_BLOCK_SIZE] = { 0 };
+
+      for (u8 i = 0; i < size; i++) {
+        block[i] = in[i];
+      }
+
+      processBlock(block, block);
+
+      for (u8 i = 0; i < size; i++) {
+        out[i] = block[i];
+      }
+    }
+  }
+
+  /**
+   * @brief Disables the processor once the last block is out, the IV
+   *        registers then hold the chaining state.
+   */
+  void Functions::stop()
+  {
+    while (CRYP_REGS->SR & sr::busy::MASK) {
+    }
+
+    CRYP_REGS->CR &= ~cr::crypen::MASK;
+  }
+
+  /**
+   * @brief Returns the block size of the selected algorithm, in bytes.
+   */
+  u8 Functions::getBlockSize()
+  {
+    return (CRYP_REGS->CR & cr::algomode::MASK) >= cr::algomode::AES_ECB ?
+        AES_BLOCK_SIZE : DES_BLOCK_SIZE;
+  }
+
+  /**
+   * @brief Writes the <bytes> as <words> big endian words, starting at the
+   *        key register <first> (K0L is 0, K3R is 7).
+   */
+  void Functions::setKey(u8 const first, u8 const* const bytes, u8 const words)
+  {
+    u32 volatile* const registers = &CRYP_REGS->KR[0].L;
+
+    for (u8 i = 0; i < words; i++) {
+      registers[first + i] = (u32(bytes[4 * i]) << 24) +
+          (bytes[4 * i + 1] << 16) + (bytes[4 * i + 2] << 8) +
+          bytes[4 * i + 3];
+    }
+  }
+
+  /**
+   * @brief Pushes one block in the input FIFO, and pops the result.
+   * @note  The 8-bit data type swaps the bytes, the words are read and
+   *        written little endian.
+   */
+  void Functions::processBlock(u8 const* const input, u8* const output)
+  {
+    u8 const words = getBlockSize() / 4;
+
+    for (u8 i = 0; i < words; i++) {
+      while ((CRYP_REGS->SR & sr::ifnf::MASK) == 0) {
+      }
+
+      CRYP_REGS->DR = input[4 * i] + (input[4 * i + 1] << 8) +
+          (input[4 * i + 2] << 16) + (u32(input[4 * i + 3]) << 24);
+    }
+
+    for (u8 i = 0; i < words; i++) {
+      while ((CRYP_REGS->SR & sr::ofne::MASK) == 0) {
+      }
+
+      u32 const word = CRYP_REGS->DOUT;
+
+      output[4 * i] = word;
+      output[4 * i + 1] = word >> 8;
+      output[4 * i + 2] = word >> 16;
+      output[4 * i + 3] = word >> 24;
+    }
+  }
+
+  /**
+   * @brief Enables the CRYP and DMA clocks.
+   */
+  void Dma::initialize()
+  {
+    Functions::enableClock();
+    InStream::enableClock();
+    OutStream::enableClock();
+  }
+
+  /**
+   * @brief Starts processing <size> bytes from <input> to <output>, in the
+   *        mode selected by CRYP::start().
+   * @note  Both buffers must be word aligned, reachable by the DMA (not in
+   *        the CCM), and <size> a multiple of the block size. <output> may
+   *        be <input>.
+   */
+  void Dma::start(u32 const* const input, u32* const output, u32 const size)
+  {
+    Transfer& current = transfer();
+
+    current.input = input;
+    current.output = output;
+    current.remaining = size / 4;
+
+    startChunk();
+  }
+
+  /**
+   * @brief Returns true until the last block has been written out.
+   * @note  Must be polled, it also chains the transfers of buffers larger
+   *        than a single DMA transfer.
+   */
+  bool Dma::isBusy()
+  {
+    if (OutStream::isEnabled()) {
+      return true;
+    }
+
+    if (transfer().remaining != 0) {
+      startChunk();
+
+      return true;
+    }
+
+    CRYP_REGS->DMACR = 0;
+
+    return false;
+  }
+
+  Dma::Transfer& Dma::transfer()
+  {
+    static Transfer current;
+
+    return current;
+  }
+
+  void Dma::startChunk()
+  {
+    Transfer& current = transfer();
+    // 16-bit count of words, kept a multiple of the AES block
+    u32 const words = current.remaining < 0xFFF0 ? current.remaining : 0xFFF0;
+
+    if (words == 0) {
+      return;
+    }
+
+    CRYP_REGS->DMACR = 0;
+
+    InStream::clearTransferCompleteFlag();
+    InStream::clearTransferErrorFlag();
+    InStream::clearHalfTransferFlag();
+    InStream::clearFifoErrorFlag();
+    InStream::clearDirectModeErrorFlag();
+    OutStream::clearTransferCompleteFlag();
+    OutStream::clearTransferErrorFlag();
+    OutStream::clearHalfTransferFlag();
+    OutStream::clearFifoErrorFlag();
+    OutStream::clearDirectModeErrorFlag();
+
+    InStream::configure(
+        dma::stream::cr::dmeie::DIRECT_MODE_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::teie::TRANSFER_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::htie::HALF_TRANSFER_INTERRUPT_DISABLED,
+        dma::stream::cr::tcie::TRANSFER_COMPLETE_INTERRUPT_DISABLED,
+        dma::stream::cr::pfctrl::DMA_FLOW_CONTROLLER,
+        dma::stream::cr::dir::MEMORY_TO_PERIPHERAL,
+        dma::stream::cr::circ::CIRCULAR_MODE_DISABLED,
+        dma::stream::cr::pinc::PERIPHERAL_INCREMENT_MODE_DISABLED,
+        dma::stream::cr::minc::MEMORY_INCREMENT_MODE_ENABLED,
+        dma::stream::cr::psize::PERIPHERAL_SIZE_32BITS,
+        dma::stream::cr::msize::MEMORY_SIZE_32BITS,
+        dma::stream::cr::pincos::PERIPHERAL_INCREMENT_OFFSET_SIZE_PSIZE,
+        dma::stream::cr::pl::PRIORITY_LEVEL_HIGH,
+        dma::stream::cr::dbm::DOUBLE_BUFFER_MODE_DISABLED,
+        dma::stream::cr::ct::CURRENT_TARGET_MEMORY_0,
+        dma::stream::cr::pburst::PERIPHERAL_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::mburst::MEMORY_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::chsel::CHANNEL_2);
+
+    OutStream::configure(
+        dma::stream::cr::dmeie::DIRECT_MODE_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::teie::TRANSFER_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::htie::HALF_TRANSFER_INTERRUPT_DISABLED,
+        dma::stream::cr::tcie::TRANSFER_COMPLETE_INTERRUPT_DISABLED,
+        dma::stream::cr::pfctrl::DMA_FLOW_CONTROLLER,
+        dma::stream::cr::dir::PERIPHERAL_TO_MEMORY,
+        dma::stream::cr::circ::CIRCULAR_MODE_DISABLED,
+        dma::stream::cr::pinc::PERIPHERAL_INCREMENT_MODE_DISABLED,
+        dma::stream::cr::minc::MEMORY_INCREMENT_MODE_ENABLED,
+        dma::stream::cr::psize::PERIPHERAL_SIZE_32BITS,
+        dma::stream::cr::msize::MEMORY_SIZE_32BITS,
+        dma::stream::cr::pincos::PERIPHERAL_INCREMENT_OFFSET_SIZE_PSIZE,
+        dma::stream::cr::pl::PRIORITY_LEVEL_VERY_HIGH,
+        dma::stream::cr::dbm::DOUBLE_BUFFER_MODE_DISABLED,
+        dma::stream::cr::ct::CURRENT_TARGET_MEMORY_0,
+        dma::stream::cr::pburst::PERIPHERAL_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::mburst::MEMORY_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::chsel::CHANNEL_2);
+
+    InStream::setPeripheralAddress(&CRYP_REGS->DR);
+    InStream::setMemory0Address(const_cast<u32*>(current.input));
+    InStream::setNumberOfTransactions(words);
+    OutStream::setPeripheralAddress(&CRYP_REGS->DOUT);
+    OutStream::setMemory0Address(current.output);
+    OutStream::setNumberOfTransactions(words);
+
+    current.input += words;
+    current.output += words;
+    current.remaining -= words;
+
+    // The output stream must be ready before the first block comes out
+    OutStream::enablePeripheral();
+    InStream::enablePeripheral();
+    CRYP_REGS->DMACR = dmacr::dien::MASK + dmacr::doen::MASK;
+  }
 }  // namespace cryp
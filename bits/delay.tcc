@@ -0,0 +1,297 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace delay {
+  Alarm::Alarm() :
+      next(0), deadline(0), callback(0), context(0), pending(false)
+  {
+  }
+
+  /**
+   * @brief Returns true if the alarm is waiting for its deadline.
+   */
+  bool Alarm::isPending() const
+  {
+    return pending;
+  }
+
+  /**
+   * @brief Returns the time, in timer ticks, at which the alarm expires.
+   */
+  u32 Alarm::getDeadline() const
+  {
+    return deadline;
+  }
+
+  template<tim::Address TIMER, u32 RESOLUTION>
+  u32 volatile Functions<TIMER, RESOLUTION>::overflows;
+
+  template<tim::Address TIMER, u32 RESOLUTION>
+  Alarm* Functions<TIMER, RESOLUTION>::queue;
+
+  /**
+   * @brief Configures the timer as a free running counter at RESOLUTION Hz.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::initialize()
+  {
+    Timer::enableClock();
+
+    Timer::configureBasicCounter(
+        tim::cr1::cen::COUNTER_DISABLED,
+        tim::cr1::udis::UPDATE_EVENT_ENABLED,
+        tim::cr1::urs::UPDATE_REQUEST_SOURCE_OVERFLOW_UNDERFLOW,
+        tim::cr1::opm::DONT_STOP_COUNTER_AT_NEXT_UPDATE_EVENT,
+        tim::cr1::arpe::AUTO_RELOAD_UNBUFFERED);
+
+    Timer::setPrescaler(Timer::FREQUENCY / RESOLUTION - 1);
+    Timer::setAutoReload(0xFFFF);
+    Timer::setCounter(0);
+    Timer::generateUpdate();  // Loads the prescaler
+
+    Timer::clearUpdateFlag();
+    Timer::clearCompare1Flag();
+    Timer::enableUpdateInterrupt();
+    Timer::unmaskInterrupts();
+    Timer::startCounter();
+  }
+
+  /**
+   * @brief Counts the overflows and fires the expired alarms.
+   * @note  Must be called from the timer interrupt handler.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::onInterrupt()
+  {
+    if (Timer::hasUpdateEventOccurred()) {
+      critical::Section section;
+
+      Timer::clearUpdateFlag();
+      overflows = overflows + 1;
+    }
+
+    if (Timer::hasCompare1EventOccurred()) {
+      Timer::clearCompare1Flag();
+    }
+
+    while (true) {
+      Callback callback;
+      void* context;
+
+      {
+        critical::Section section;
+
+        Alarm* const alarm = queue;
+
+        if ((alarm == 0) || (s32(alarm->deadline - getTime()) > 0)) {
+          break;
+        }
+
+        queue = alarm->next;
+        callback = alarm->callback;
+        context = alarm->context;
+        alarm->pending = false;
+      }
+
+      if (callback != 0) {
+        callback(context);
+      }
+    }
+
+    arm();
+  }
+
+  /**
+   * @brief Returns the number of timer ticks elapsed since initialize().
+   * @note  Wraps around every 2^32 ticks. Safe to call with the interrupts
+   *        disabled: an overflow whose interrupt is still pending is
+   *        accounted for.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  u32 Functions<TIMER, RESOLUTION>::getTime()
+  {
+    u32 high;
+    u16 low;
+    bool pending;
+
+    do {
+      high = overflows;
+      low = Timer::getCounter();
+      pending = Timer::hasUpdateEventOccurred();
+    } while (high != overflows);
+
+    if (pending) {
+      // The counter overflowed, but it hasn't been counted yet
+      low = Timer::getCounter();
+      high++;
+    }
+
+    return (high << 16) + low;
+  }
+
+  /**
+   * @brief Starts an alarm that expires after some timer ticks.
+   * @note  The callback may be null, the alarm can still be polled with
+   *        isPending(). Delays must be shorter than 2^31 ticks.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::start(
+      Alarm& alarm,
+      u32 const ticks,
+      Callback const callback,
+      void* const context)
+  {
+    critical::Section section;
+
+    startAt(alarm, getTime() + ticks, callback, context);
+  }
+
+  /**
+   * @brief Starts an alarm that expires at the given time, in timer ticks.
+   * @note  A deadline that already passed expires on the next interrupt.
+   *        A pending alarm is restarted.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::startAt(
+      Alarm& alarm,
+      u32 const deadline,
+      Callback const callback,
+      void* const context)
+  {
+    critical::Section section;
+
+    if (alarm.pending) {
+      unlink(alarm);
+    }
+
+    alarm.deadline = deadline;
+    alarm.callback = callback;
+    alarm.context = context;
+    alarm.pending = true;
+
+    // Keep the list sorted, alarms with the same deadline fire in FIFO order
+    Alarm** link = &queue;
+
+    while ((*link != 0) && (s32((*link)->deadline - deadline) <= 0)) {
+      link = &(*link)->next;
+    }
+
+    alarm.next = *link;
+    *link = &alarm;
+
+    if (queue == &alarm) {
+      arm();
+    }
+  }
+
+  /**
+   * @brief Cancels a pending alarm, its callback won't be called.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::cancel(Alarm& alarm)
+  {
+    critical::Section section;
+
+    if (alarm.pending) {
+      unlink(alarm);
+      alarm.pending = false;
+    }
+  }
+
+  /**
+   * @brief Sleeps the core for some timer ticks.
+   * @note  Other interrupts keep being serviced. Must be called from thread
+   *        mode, with the interrupts enabled.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::sleep(u32 const ticks)
+  {
+    sleepUntil(getTime() + ticks);
+  }
+
+  /**
+   * @brief Sleeps the core until the given time, in timer ticks.
+   * @note  Other interrupts keep being serviced. Must be called from thread
+   *        mode, with the interrupts enabled.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::sleepUntil(u32 const deadline)
+  {
+    Alarm alarm;
+
+    startAt(alarm, deadline, 0, 0);
+
+    while (true) {
+      // The flag is checked with the interrupts disabled, so the expiration
+      // can't sneak in between the check and the WFI. A pending interrupt
+      // still wakes the core up, and it's serviced when the section ends.
+      critical::Section section;
+
+      if (!alarm.pending) {
+        break;
+      }
+
+      SCB::waitForInterrupt();
+    }
+  }
+
+  /**
+   * @brief Removes a pending alarm from the list.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::unlink(Alarm& alarm)
+  {
+    Alarm** link = &queue;
+
+    while (*link != &alarm) {
+      link = &(*link)->next;
+    }
+
+    *link = alarm.next;
+  }
+
+  /**
+   * @brief Arms the compare channel with the earliest deadline.
+   * @note  Deadlines more than one counter period away are re-evaluated on
+   *        each overflow.
+   */
+  template<tim::Address TIMER, u32 RESOLUTION>
+  void Functions<TIMER, RESOLUTION>::arm()
+  {
+    critical::Section section;
+
+    if ((queue == 0) || (s32(queue->deadline - getTime()) > 0xFFFF)) {
+      Timer::disableCompare1Interrupt();
+      return;
+    }
+
+    Timer::setCompare1(u16(queue->deadline));
+    Timer::clearCompare1Flag();
+    Timer::enableCompare1Interrupt();
+
+    // The counter may have passed the compare value while it was written
+    if (s32(queue->deadline - getTime()) <= 0) {
+      Timer::generateCompare1Event();
+    }
+  }
+}  // namespace delay
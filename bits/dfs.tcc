@@ -0,0 +1,358 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "../include/peripheral/rcc.hpp"
+#include "../include/peripheral/flash.hpp"
+#include "../include/peripheral/pwr.hpp"
+
+namespace dfs {
+  /**
+   * @brief The operating point selected in clock.hpp.
+   */
+  constexpr OperatingPoint boot()
+  {
+    return OperatingPoint {
+      clk::__SW,
+#ifdef USING_PLL
+      clk::__SW == rcc::cfgr::sw::PLL_SELECTED_AS_SYSTEM_CLOCK ?
+          pll::pack(clk::__PLLM, clk::__PLLN, clk::__PLLP, clk::__PLLQ) :
+          0,
+#else // USING_PLL
+      0,
+#endif // USING_PLL
+      clk::__HPRE,
+      clk::__PPRE1,
+      clk::__PPRE2,
+      clk::SYSTEM
+    };
+  }
+
+  OperatingPoint& Functions::current()
+  {
+    static OperatingPoint point = boot();
+
+    return point;
+  }
+
+  Listener* Functions::listeners()
+  {
+    static Listener list[MAX_LISTENERS];
+
+    return list;
+  }
+
+  /**
+   * @brief Selects the flash wait states required at <system> Hz.
+   * @note  Assumes a supply voltage between 2.7 V and 3.6 V.
+   */
+  void Functions::setFlashLatency(u32 const system)
+  {
+    FLASH::setLatency(flash::acr::latency::States(
+        pll::latency(system) << flash::acr::latency::POSITION));
+
+    while ((FLASH_REGS->ACR & flash::acr::latency::MASK) !=
+        (u32(pll::latency(system)) << flash::acr::latency::POSITION)) {
+    }
+  }
+
+  /**
+   * @brief Calls every registered listener.
+   */
+  void Functions::notify()
+  {
+    for (u8 i = 0; i < MAX_LISTENERS; i++) {
+      if (listeners()[i] != 0) {
+        listeners()[i]();
+      }
+    }
+  }
+
+  /**
+   * @brief Switches the system to the <next> operating point.
+   * @note  The sequence is: start the HSE (if needed), raise the flash
+   *        latency, run from the HSI while the PLL, the regulator and the
+   *        bus prescalers are reconfigured, select the new clock source,
+   *        lower the flash latency and stop the HSE if it isn't used
+   *        anymore.
+   * @note  Returns false, without touching the clocks, if the HSE didn't
+   *        start.
+   * @note  Must not be called from an interrupt that a listener depends on.
+   */
+  bool Functions::switchTo(OperatingPoint const& next)
+  {
+    if (!apply(next)) {
+      return false;
+    }
+
+    notify();
+
+    return true;
+  }
+
+  /**
+   * @brief Reprograms the clocks of the active operating point.
+   * @note  Used after the STOP mode, which leaves the system running from
+   *        the HSI with the PLL and the HSE off. The frequencies don't
+   *        change, so the listeners aren't called.
+   */
+  bool Functions::restore()
+  {
+    OperatingPoint const point = current();
+
+    return apply(point);
+  }
+
+  /**
+   * @brief Returns true if the <point> runs from the HSE, directly or
+   *        through the PLL.
+   */
+  bool Functions::usesHse(OperatingPoint const& point)
+  {
+#if defined USING_HSE_CLOCK || \
+    defined USING_HSE_CRYSTAL
+    return (point.source ==
+        rcc::cfgr::sw::HSE_OSCILLATOR_SELECTED_AS_SYSTEM_CLOCK) ||
+        ((point.source == rcc::cfgr::sw::PLL_SELECTED_AS_SYSTEM_CLOCK) &&
+            (clk::__PLLSRC ==
+                rcc::pllcfgr::pllsrc::
+                USE_HSE_CLOCK_AS_PLL_CLOCK_SOURCE));
+#else // USING_HSE_CLOCK || USING_HSE_CRYSTAL
+    return false;
+#endif // USING_HSE_CLOCK || USING_HSE_CRYSTAL
+  }
+
+  /**
+   * @brief Programs the clock tree of the <next> operating point.
+   * @note  With an exact 48 MHz clock, the PLL keeps running for the
+   *        USB/SDIO/RNG when the system switches to the HSI or the HSE. It
+   *        is only stopped, and restarted with the same factors, if the
+   *        regulator scale has to change.
+   */
+  bool Functions::apply(OperatingPoint const& next)
+  {
+#ifdef USING_PLL
+    bool const keepPll =
+        (EXACT_48MHZ != 0) &&
+        (next.source != rcc::cfgr::sw::PLL_SELECTED_AS_SYSTEM_CLOCK) &&
+        RCC::isPllStable();
+#endif // USING_PLL
+#ifdef STM32F4XX
+    pwr::cr::vos::States const scale =
+        next.system > SCALE_2_MAX ?
+            pwr::cr::vos::SCALE_1_MODE :
+            pwr::cr::vos::SCALE_2_MODE;
+
+    PWR::enableClock();
+#endif // STM32F4XX
+
+#if defined USING_HSE_CLOCK || \
+    defined USING_HSE_CRYSTAL
+    if (usesHse(next)) {
+      RCC::enableHse();
+
+      u16 HseTimeoutCounter = 0;
+      do {
+        HseTimeoutCounter++;
+      } while ((HseTimeoutCounter != clk::__HSE_TIMEOUT) &&
+          (!RCC::isHseStable()));
+
+      if (!RCC::isHseStable()) {
+        return false;
+      }
+    }
+#endif // USING_HSE_CLOCK || USING_HSE_CRYSTAL
+
+    setFlashLatency(
+        next.system > current().system ?
+            next.system :
+            current().system);
+
+    RCC::enableHsi();
+
+    while (!RCC::isHsiStable()) {
+    }
+
+    RCC::setSystemClockSource(
+        rcc::cfgr::sw::HSI_OSCILLATOR_SELECTED_AS_SYSTEM_CLOCK);
+
+    while (!RCC::isSystemClockSourceStable()) {
+    }
+
+    // Any bus prescaler combination is legal at the HSI frequency
+    RCC::configurePrescalers(
+        next.hpre + 0b111,
+        next.ppre1 + 0b11,
+        next.ppre2 + 0b11);
+
+#ifdef STM32F4XX
+    // The regulator scale can only be changed while the PLL is off
+    if (PWR::getVoltageScaling() != scale) {
+      RCC::disablePll();
+
+      PWR::setVoltageScaling(scale);
+    }
+#endif // STM32F4XX
+
+#ifdef USING_PLL
+    if (!keepPll) {
+      RCC::disablePll();
+    }
+
+    if (next.source == rcc::cfgr::sw::PLL_SELECTED_AS_SYSTEM_CLOCK) {
+      RCC::configurePll(
+          clk::__PLLSRC,
+          pll::m(next.pll),
+          pll::n(next.pll),
+          pll::p(next.pll),
+          pll::q(next.pll));
+    }
+
+    if ((next.source == rcc::cfgr::sw::PLL_SELECTED_AS_SYSTEM_CLOCK) ||
+        keepPll) {
+      RCC::enablePll();
+
+      while (!RCC::isPllStable()) {
+      }
+
+#ifdef STM32F4XX
+      // VOSRDY only reports ready while the PLL is on and locked
+      while (!PWR::isVoltageScalingReady()) {
+      }
+#endif // STM32F4XX
+    }
+#endif // USING_PLL
+
+    RCC::setSystemClockSource(next.source);
+
+    while (!RCC::isSystemClockSourceStable()) {
+    }
+
+    setFlashLatency(next.system);
+
+#if defined USING_HSE_CLOCK || \
+    defined USING_HSE_CRYSTAL
+    // Stop the HSE, unless the PLL still runs from it for the 48 MHz clock
+#ifdef USING_PLL
+    if (!usesHse(next) &&
+        !(keepPll &&
+            (clk::__PLLSRC ==
+                rcc::pllcfgr::pllsrc::
+                USE_HSE_CLOCK_AS_PLL_CLOCK_SOURCE))) {
+      RCC::disableHse();
+    }
+#else // USING_PLL
+    if (!usesHse(next)) {
+      RCC::disableHse();
+    }
+#endif // USING_PLL
+#endif // USING_HSE_CLOCK || USING_HSE_CRYSTAL
+
+    current() = next;
+
+    return true;
+  }
+
+  /**
+   * @brief Returns the active operating point.
+   */
+  OperatingPoint const& Functions::getOperatingPoint()
+  {
+    return current();
+  }
+
+  u32 Functions::getSystemFrequency()
+  {
+    return current().system;
+  }
+
+  u32 Functions::getAhbFrequency()
+  {
+    return current().system >> current().hpre;
+  }
+
+  u32 Functions::getApb1Frequency()
+  {
+    return getAhbFrequency() >> current().ppre1;
+  }
+
+  u32 Functions::getApb2Frequency()
+  {
+    return getAhbFrequency() >> current().ppre2;
+  }
+
+  /**
+   * @brief Returns the APB1 timers clock, which is doubled when the APB1
+   *        prescaler isn't 1.
+   */
+  u32 Functions::getApb1TimerFrequency()
+  {
+    return getApb1Frequency() * (current().ppre1 == 0 ? 1 : 2);
+  }
+
+  /**
+   * @brief Returns the APB2 timers clock, which is doubled when the APB2
+   *        prescaler isn't 1.
+   */
+  u32 Functions::getApb2TimerFrequency()
+  {
+    return getApb2Frequency() * (current().ppre2 == 0 ? 1 : 2);
+  }
+
+  /**
+   * @brief Returns the SysTick clock (AHB / 8).
+   */
+  u32 Functions::getSysTickFrequency()
+  {
+    return getAhbFrequency() / 8;
+  }
+
+  /**
+   * @brief Registers a function that will be called after every operating
+   *        point switch.
+   * @note  Returns false if there are already MAX_LISTENERS listeners.
+   */
+  bool Functions::subscribe(Listener listener)
+  {
+    for (u8 i = 0; i < MAX_LISTENERS; i++) {
+      if (listeners()[i] == 0) {
+        listeners()[i] = listener;
+
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Removes a listener.
+   */
+  void Functions::unsubscribe(Listener listener)
+  {
+    for (u8 i = 0; i < MAX_LISTENERS; i++) {
+      if (listeners()[i] == listener) {
+        listeners()[i] = 0;
+      }
+    }
+  }
+}  // namespace dfs
@@ -0,0 +1,306 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace digest {
+  inline u32 rotateLeft(u32 const word, u8 const bits)
+  {
+    return (word << bits) | (word >> (32 - bits));
+  }
+
+  void Sha1::initialize(u32* const state)
+  {
+    state[0] = 0x67452301;
+    state[1] = 0xEFCDAB89;
+    state[2] = 0x98BADCFE;
+    state[3] = 0x10325476;
+    state[4] = 0xC3D2E1F0;
+  }
+
+  /**
+   * @brief Processes one 64 bytes block.
+   * @note  The message schedule is kept in a 16 words circular buffer.
+   */
+  void Sha1::compress(u32* const state, u8 const* const block)
+  {
+    u32 w[16];
+    u32 a = state[0];
+    u32 b = state[1];
+    u32 c = state[2];
+    u32 d = state[3];
+    u32 e = state[4];
+
+    for (u8 t = 0; t < 16; t++) {
+      w[t] = (u32(block[4 * t]) << 24) + (block[4 * t + 1] << 16) +
+          (block[4 * t + 2] << 8) + block[4 * t + 3];
+    }
+
+    for (u8 t = 0; t < 80; t++) {
+      u32 f, k;
+
+      if (t >= 16) {
+        w[t & 15] = rotateLeft(w[(t + 13) & 15] ^ w[(t + 8) & 15] ^
+            w[(t + 2) & 15] ^ w[t & 15], 1);
+      }
+
+      if (t < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (t < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (t < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+
+      u32 const temp = rotateLeft(a, 5) + f + e + k + w[t & 15];
+
+      e = d;
+      d = c;
+      c = rotateLeft(b, 30);
+      b = a;
+      a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+  }
+
+  void Md5::initialize(u32* const state)
+  {
+    state[0] = 0x67452301;
+    state[1] = 0xEFCDAB89;
+    state[2] = 0x98BADCFE;
+    state[3] = 0x10325476;
+  }
+
+  /**
+   * @brief Processes one 64 bytes block.
+   */
+  void Md5::compress(u32* const state, u8 const* const block)
+  {
+    static u32 const K[64] = {
+        0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE,
+        0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501,
+        0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE,
+        0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821,
+        0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA,
+        0xD62F105D, 0x02441453, 0xD8A1E681, 0xE7D3FBC8,
+        0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED,
+        0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A,
+        0xFFFA3942, 0x8771F681, 0x6D9D6122, 0xFDE5380C,
+        0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70,
+        0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05,
+        0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665,
+        0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039,
+        0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+        0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1,
+        0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391
+    };
+    static u8 const S[16] = {
+        7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21
+    };
+    u32 m[16];
+    u32 a = state[0];
+    u32 b = state[1];
+    u32 c = state[2];
+    u32 d = state[3];
+
+    for (u8 i = 0; i < 16; i++) {
+      m[i] = block[4 * i] + (block[4 * i + 1] << 8) +
+          (block[4 * i + 2] << 16) + (u32(block[4 * i + 3]) << 24);
+    }
+
+    for (u8 i = 0; i < 64; i++) {
+      u32 f;
+      u8 g;
+
+      if (i < 16) {
+        f = (b & c) | (~b & d);
+        g = i;
+      } else if (i < 32) {
+        f = (d & b) | (~d & c);
+        g = (5 * i + 1) & 15;
+      } else if (i < 48) {
+        f = b ^ c ^ d;
+        g = (3 * i + 5) & 15;
+      } else {
+        f = c ^ (b | ~d);
+        g = (7 * i) & 15;
+      }
+
+      f += a + K[i] + m[g];
+      a = d;
+      d = c;
+      c = b;
+      b += rotateLeft(f, S[(i >> 4) * 4 + (i & 3)]);
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+  }
+
+  template<typename ALGORITHM>
+  void Hash<ALGORITHM>::init()
+  {
+    ALGORITHM::initialize(state);
+    length = 0;
+  }
+
+  template<typename ALGORITHM>
+  void Hash<ALGORITHM>::update(void const* const data, u32 size)
+  {
+    u8 const* bytes = static_cast<u8 const*>(data);
+
+    while (size != 0) {
+      u32 const used = length % BLOCK_SIZE;
+      u32 const chunk =
+          size < BLOCK_SIZE - used ? size : BLOCK_SIZE - used;
+
+      for (u32 i = 0; i < chunk; i++) {
+        block[used + i] = bytes[i];
+      }
+
+      bytes += chunk;
+      size -= chunk;
+      length += chunk;
+
+      if (used + chunk == BLOCK_SIZE) {
+        ALGORITHM::compress(state, block);
+      }
+    }
+  }
+
+  /**
+   * @brief Pads the message, and writes the SIZE bytes of the digest to
+   *        <result>.
+   */
+  template<typename ALGORITHM>
+  void Hash<ALGORITHM>::final(u8* const result)
+  {
+    u32 const bits = length << 3;
+    u32 const high = length >> 29;
+    u32 used = length % BLOCK_SIZE;
+
+    block[used++] = 0x80;
+
+    if (used > BLOCK_SIZE - 8) {
+      while (used < BLOCK_SIZE) {
+        block[used++] = 0;
+      }
+
+      ALGORITHM::compress(state, block);
+      used = 0;
+    }
+
+    while (used < BLOCK_SIZE - 8) {
+      block[used++] = 0;
+    }
+
+    for (u8 i = 0; i < 4; i++) {
+      if (ALGORITHM::MSB_FIRST) {
+        block[BLOCK_SIZE - 8 + i] = high >> (24 - 8 * i);
+        block[BLOCK_SIZE - 4 + i] = bits >> (24 - 8 * i);
+      } else {
+        block[BLOCK_SIZE - 8 + i] = bits >> (8 * i);
+        block[BLOCK_SIZE - 4 + i] = high >> (8 * i);
+      }
+    }
+
+    ALGORITHM::compress(state, block);
+
+    for (u8 i = 0; i < SIZE; i++) {
+      u8 const shift = ALGORITHM::MSB_FIRST ? 24 - 8 * (i & 3) : 8 * (i & 3);
+
+      result[i] = state[i / 4] >> shift;
+    }
+  }
+
+  /**
+   * @brief Starts a HMAC with <size> bytes of <secret>.
+   * @note  Keys longer than a block are hashed first.
+   */
+  template<typename ALGORITHM>
+  void Hmac<ALGORITHM>::init(void const* const secret, u32 const size)
+  {
+    u8 const* const bytes = static_cast<u8 const*>(secret);
+    u8 i = 0;
+
+    if (size > BLOCK_SIZE) {
+      inner.init();
+      inner.update(secret, size);
+      inner.final(key);
+      i = SIZE;
+    } else {
+      for (; i < size; i++) {
+        key[i] = bytes[i];
+      }
+    }
+
+    for (; i < BLOCK_SIZE; i++) {
+      key[i] = 0;
+    }
+
+    u8 pad[BLOCK_SIZE];
+
+    for (i = 0; i < BLOCK_SIZE; i++) {
+      pad[i] = key[i] ^ 0x36;
+    }
+
+    inner.init();
+    inner.update(pad, BLOCK_SIZE);
+  }
+
+  template<typename ALGORITHM>
+  void Hmac<ALGORITHM>::update(void const* const data, u32 const size)
+  {
+    inner.update(data, size);
+  }
+
+  template<typename ALGORITHM>
+  void Hmac<ALGORITHM>::final(u8* const result)
+  {
+    u8 pad[BLOCK_SIZE];
+    u8 innerResult[SIZE];
+    Hash<ALGORITHM> outer;
+
+    inner.final(innerResult);
+
+    for (u8 i = 0; i < BLOCK_SIZE; i++) {
+      pad[i] = key[i] ^ 0x5C;
+    }
+
+    outer.init();
+    outer.update(pad, BLOCK_SIZE);
+    outer.update(innerResult, SIZE);
+    outer.final(result);
+  }
+}  // namespace digest
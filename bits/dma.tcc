@@ -320,7 +320,8 @@ namespace dma {
     template<dma::common::Address D, Address C>
     void Functions<D, C>::setPeripheralAddress(void volatile* const address)
     {
-      reinterpret_cast<Registers*>(D + C)->CPAR = u32(address);
+      reinterpret_cast<Registers*>(D + C)->CPAR =
+          u32(reinterpret_cast<uintptr_t>(address));
     }
 
     /**
@@ -329,7 +330,8 @@ namespace dma {
     template<dma::common::Address D, Address C>
     void Functions<D, C>::setPeripheralAddress(void* const address)
     {
-      reinterpret_cast<Registers*>(D + C)->CPAR = u32(address);
+      reinterpret_cast<Registers*>(D + C)->CPAR =
+          u32(reinterpret_cast<uintptr_t>(address));
     }
 
     /**
@@ -338,7 +340,8 @@ namespace dma {
     template<dma::common::Address D, Address C>
     void Functions<D, C>::setMemoryAddress(void* const address)
     {
-      reinterpret_cast<Registers*>(D + C)->CMAR = u32(address);
+      reinterpret_cast<Registers*>(D + C)->CMAR =
+          u32(reinterpret_cast<uintptr_t>(address));
     }
 
     /**
@@ -697,7 +700,8 @@ namespace dma {
     template<dma::common::Address D, Address S>
     void Functions<D, S>::setPeripheralAddress(void volatile* const address)
     {
-      reinterpret_cast<Registers*>(D + S)->PAR = u32(address);
+      reinterpret_cast<Registers*>(D + S)->PAR =
+          u32(reinterpret_cast<uintptr_t>(address));
     }
 
     /**
@@ -706,7 +710,8 @@ namespace dma {
     template<dma::common::Address D, Address S>
     void Functions<D, S>::setPeripheralAddress(void* const address)
     {
-      reinterpret_cast<Registers*>(D + S)->PAR = u32(address);
+      reinterpret_cast<Registers*>(D + S)->PAR =
+          u32(reinterpret_cast<uintptr_t>(address));
     }
 
     /**
@@ -715,7 +720,8 @@ namespace dma {
     template<dma::common::Address D, Address S>
     void Functions<D, S>::setMemory0Address(void* const address)
     {
-      reinterpret_cast<Registers*>(D + S)->M0AR = u32(address);
+      reinterpret_cast<Registers*>(D + S)->M0AR =
+          u32(reinterpret_cast<uintptr_t>(address));
     }
 
     /**
@@ -724,7 +730,41 @@ namespace dma {
     template<dma::common::Address D, Address S>
     void Functions<D, S>::setMemory1Address(void* const address)
     {
-      reinterpret_cast<Registers*>(D + S)->M1AR = u32(address);
+      reinterpret_cast<Registers*>(D + S)->M1AR =
+          u32(reinterpret_cast<uintptr_t>(address));
+    }
+
+    /**
+     * @brief Rejects, at compile time, the objects placed in the CCM.
+     */
+    template<dma::common::Address D, Address S>
+    template<typename T>
+    void Functions<D, S>::setPeripheralAddress(memory::Ccm<T>* const)
+    {
+      static_assert(sizeof(T) == 0,
+          "The DMA can't reach the CCM data RAM, use __DMARAM instead.");
+    }
+
+    /**
+     * @brief Rejects, at compile time, the objects placed in the CCM.
+     */
+    template<dma::common::Address D, Address S>
+    template<typename T>
+    void Functions<D, S>::setMemory0Address(memory::Ccm<T>* const)
+    {
+      static_assert(sizeof(T) == 0,
+          "The DMA can't reach the CCM data RAM, use __DMARAM instead.");
+    }
+
+    /**
+     * @brief Rejects, at compile time, the objects placed in the CCM.
+     */
+    template<dma::common::Address D, Address S>
+    template<typename T>
+    void Functions<D, S>::setMemory1Address(memory::Ccm<T>* const)
+    {
+      static_assert(sizeof(T) == 0,
+          "The DMA can't reach the CCM data RAM, use __DMARAM instead.");
     }
 
     /**
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace dwt {
+  /**
+   * @brief Enables the trace block and starts the cycle counter.
+   */
+  void Functions::enableCycleCounter()
+  {
+    *reinterpret_cast<u32 volatile*>(demcr::ADDRESS) |=
+        demcr::trcena::DWT_AND_ITM_ENABLED;
+
+    _DWT->CTRL |= ctrl::cyccntena::CYCLE_COUNTER_ENABLED;
+  }
+
+  /**
+   * @brief Stops the cycle counter.
+   */
+  void Functions::disableCycleCounter()
+  {
+    _DWT->CTRL &= ~ctrl::cyccntena::MASK;
+  }
+
+  /**
+   * @brief Returns the number of core clock cycles elapsed.
+   * @note  The counter wraps around every 2^32 cycles.
+   */
+  u32 Functions::getCycleCount()
+  {
+    return _DWT->CYCCNT;
+  }
+
+  /**
+   * @brief Clears the cycle counter.
+   */
+  void Functions::resetCycleCount()
+  {
+    _DWT->CYCCNT = 0;
+  }
+
+  /**
+   * @brief Returns the number of comparators implemented.
+   */
+  u8 Functions::getNumberOfComparators()
+  {
+    return (_DWT->CTRL & ctrl::numcomp::MASK) >> ctrl::numcomp::POSITION;
+  }
+
+  /**
+   * @brief Configures the comparator N.
+   * @note  <value> is an address, or a cycle count if CYCMATCH is set
+   *        (comparator 0 only). <ignoredBits> is the number of low bits
+   *        excluded from the comparison.
+   */
+  template<u8 N>
+  void Functions::configureComparator(
+      u32 const value,
+      u8 const ignoredBits,
+      function::function::States FUNCTION,
+      function::cycmatch::States CYCMATCH)
+  {
+    static_assert(N < COMPARATORS,
+        "There are only 4 comparators.");
+
+    _DWT->COMPARATOR[N].COMP = value;
+    _DWT->COMPARATOR[N].MASK = ignoredBits;
+    _DWT->COMPARATOR[N].FUNCTION = FUNCTION + CYCMATCH;
+  }
+
+  /**
+   * @brief Disables the comparator N.
+   */
+  template<u8 N>
+  void Functions::disableComparator()
+  {
+    static_assert(N < COMPARATORS,
+        "There are only 4 comparators.");
+
+    _DWT->COMPARATOR[N].FUNCTION = function::function::DISABLED;
+  }
+
+  /**
+   * @brief Returns true if the comparator N has matched since the last
+   *        call.
+   * @note  Reading the function register clears the flag.
+   */
+  template<u8 N>
+  bool Functions::hasComparatorMatched()
+  {
+    static_assert(N < COMPARATORS,
+        "There are only 4 comparators.");
+
+    return _DWT->COMPARATOR[N].FUNCTION & function::matched::MASK;
+  }
+}  // namespace dwt
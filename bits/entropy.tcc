@@ -0,0 +1,218 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace entropy {
+  template<u16 WORDS>
+  u32 volatile Pool<WORDS>::words[WORDS];
+
+  template<u16 WORDS>
+  u32 volatile Pool<WORDS>::head;
+
+  template<u16 WORDS>
+  u32 volatile Pool<WORDS>::tail;
+
+  template<u16 WORDS>
+  u32 Pool<WORDS>::last;
+
+  template<u16 WORDS>
+  bool Pool<WORDS>::primed;
+
+  template<u16 WORDS>
+  u32 volatile Pool<WORDS>::seedErrors;
+
+  template<u16 WORDS>
+  u32 volatile Pool<WORDS>::clockErrors;
+
+  template<u16 WORDS>
+  u32 volatile Pool<WORDS>::repetitions;
+
+  /**
+   * @brief Starts the generator and its interrupt.
+   * @note  The 48 MHz PLL output (PLLQ) clocks the RNG, it must be
+   *        configured.
+   */
+  template<u16 WORDS>
+  void Pool<WORDS>::initialize()
+  {
+    RNG::enableClock();
+
+    NVIC::enableIrq<
+        nvic::irqn::HASH_RNG
+    >();
+
+    primed = false;
+    RNG::startGenerator();
+    RNG::enableInterrupts();
+  }
+
+  /**
+   * @brief Checks the generator health and stores the new word.
+   * @note  Must be called from the HASH_RNG interrupt handler.
+   */
+  template<u16 WORDS>
+  void Pool<WORDS>::onInterrupt()
+  {
+    if (RNG::hasSeedErrorOccurred()) {
+      RNG::clearSeedErrorFlag();
+      seedErrors++;
+      restart();
+
+      return;
+    }
+
+    if (RNG::hasClockErrorOccurred()) {
+      RNG::clearClockErrorFlag();
+      clockErrors++;
+    }
+
+    if (!RNG::isDataReady()) {
+      return;
+    }
+
+    u32 const value = RNG::getValue<u32>();
+
+    if (!primed) {
+      last = value;
+      primed = true;
+
+      return;
+    }
+
+    if (value == last) {
+      repetitions++;
+      restart();
+
+      return;
+    }
+
+    last = value;
+
+    if (tail - head < WORDS) {
+      words[tail % WORDS] = value;
+      tail = tail + 1;
+    }
+
+    if (tail - head == WORDS) {
+      RNG::disableInterrupts();
+    }
+  }
+
+  /**
+   * @brief Takes one word from the pool, returns false if it's empty.
+   */
+  template<u16 WORDS>
+  bool Pool<WORDS>::getValue(u32& value)
+  {
+    if (tail == head) {
+      return false;
+    }
+
+    value = words[head % WORDS];
+    head = head + 1;
+
+    resume();
+
+    return true;
+  }
+
+  /**
+   * @brief Copies up to <size> random bytes to <buffer>, returns the number
+   *        of bytes copied, less than <size> if the pool ran dry.
+   */
+  template<u16 WORDS>
+  u32 Pool<WORDS>::fill(void* const buffer, u32 const size)
+  {
+    u8* const bytes = static_cast<u8*>(buffer);
+    u32 copied = 0;
+
+    while (copied < size) {
+      u32 value;
+
+      if (!getValue(value)) {
+        break;
+      }
+
+      for (u8 i = 0; (i < 4) && (copied < size); i++) {
+        bytes[copied++] = value;
+        value >>= 8;
+      }
+    }
+
+    return copied;
+  }
+
+  /**
+   * @brief Returns the number of words in the pool.
+   */
+  template<u16 WORDS>
+  u16 Pool<WORDS>::getAvailable()
+  {
+    return tail - head;
+  }
+
+  template<u16 WORDS>
+  u32 Pool<WORDS>::getSeedErrors()
+  {
+    return seedErrors;
+  }
+
+  template<u16 WORDS>
+  u32 Pool<WORDS>::getClockErrors()
+  {
+    return clockErrors;
+  }
+
+  /**
+   * @brief Returns the number of continuous test failures.
+   */
+  template<u16 WORDS>
+  u32 Pool<WORDS>::getRepetitions()
+  {
+    return repetitions;
+  }
+
+  /**
+   * @brief Restarts the generator, the next word is only used by the
+   *        continuous test.
+   * @note  Called from the interrupt handler.
+   */
+  template<u16 WORDS>
+  void Pool<WORDS>::restart()
+  {
+    RNG::stopGenerator();
+    primed = false;
+    RNG::startGenerator();
+  }
+
+  /**
+   * @brief Re-enables the refill once a word has been taken.
+   * @note  The interrupt handler modifies the control register too.
+   */
+  template<u16 WORDS>
+  void Pool<WORDS>::resume()
+  {
+    critical::Section section;
+
+    RNG::enableInterrupts();
+  }
+}  // namespace entropy
@@ -22,6 +22,11 @@
 #pragma once
 
 #include "../include/peripheral/rcc.hpp"
+#ifdef STM32F1XX
+#include "../include/peripheral/afio.hpp"
+#else // STM32F1XX
+#include "../include/peripheral/syscfg.hpp"
+#endif // STM32F1XX
 
 namespace eth {
   void Functions::enableClocks()
@@ -59,4 +64,843 @@ namespace eth {
     >();
 #endif // STM32F1XX
   }
+
+  /**
+   * @brief Selects the MII or RMII interface to the PHY.
+   * @note  Must be called while the MAC clocks are disabled.
+   */
+  void Functions::selectInterface(Interface const INTERFACE)
+  {
+#ifdef STM32F1XX
+    AFIO::enableClock();
+
+    if (INTERFACE == RMII) {
+      AFIO_REGS->MAPR |= afio::mapr::mii_rmii_sel::MASK;
+    } else {
+      AFIO_REGS->MAPR &= ~afio::mapr::mii_rmii_sel::MASK;
+    }
+#else // STM32F1XX
+    SYSCFG::enableClock();
+
+    if (INTERFACE == RMII) {
+      SYSCFG_REGS->PMC |= syscfg::pmc::mii_rmii_sel::MASK;
+    } else {
+      SYSCFG_REGS->PMC &= ~syscfg::pmc::mii_rmii_sel::MASK;
+    }
+#endif // STM32F1XX
+  }
+
+  /**
+   * @brief Resets the MAC and DMA registers.
+   * @note  Doesn't return until the PHY provides the RX/TX clocks.
+   */
+  void Functions::reset()
+  {
+    ETH_REGS->DMABMR |= dmabmr::sr::MASK;
+
+    while (ETH_REGS->DMABMR & dmabmr::sr::MASK) {
+    }
+  }
+
+  /**
+   * @brief Sets the MAC address used by the destination address filter.
+   */
+  void Functions::setMacAddress(u8 const (&address)[6])
+  {
+    ETH_REGS->MACA0HR = address[4] + (address[5] << 8);
+    ETH_REGS->MACA0LR = address[0] + (address[1] << 8) + (address[2] << 16) +
+        (u32(address[3]) << 24);
+  }
+
+  /**
+   * @brief Configures the MAC for a full/half duplex, 100/10 Mbit/s link.
+   */
+  void Functions::configureLink(bool const fullDuplex, bool const fast)
+  {
+    u32 maccr = ETH_REGS->MACCR & ~(maccr::dm::MASK + maccr::fes::MASK);
+
+    if (fullDuplex) {
+      maccr |= maccr::dm::MASK;
+    }
+
+    if (fast) {
+      maccr |= maccr::fes::MASK;
+    }
+
+    ETH_REGS->MACCR = maccr;
+  }
+
+  /**
+   * @brief Reads the register <reg> of the PHY at address <phy>, through
+   *        the MDIO interface.
+   */
+  u16 Functions::readPhyRegister(u8 const phy, u8 const reg)
+  {
+    while (ETH_REGS->MACMIIAR & macmiiar::mb::MASK) {
+    }
+
+    ETH_REGS->MACMIIAR = (phy << macmiiar::pa::POSITION) +
+        (reg << macmiiar::mr::POSITION) + getMdcDivider() +
+        macmiiar::mb::MASK;
+
+    while (ETH_REGS->MACMIIAR & macmiiar::mb::MASK) {
+    }
+
+    return ETH_REGS->MACMIIDR;
+  }
+
+  /**
+   * @brief Writes <value> to the register <reg> of the PHY at address
+   *        <phy>, through the MDIO interface.
+   */
+  void Functions::writePhyRegister(u8 const phy, u8 const reg, u16 const value)
+  {
+    while (ETH_REGS->MACMIIAR & macmiiar::mb::MASK) {
+    }
+
+    ETH_REGS->MACMIIDR = value;
+    ETH_REGS->MACMIIAR = (phy << macmiiar::pa::POSITION) +
+        (reg << macmiiar::mr::POSITION) + getMdcDivider() +
+        macmiiar::mw::MASK + macmiiar::mb::MASK;
+
+    while (ETH_REGS->MACMIIAR & macmiiar::mb::MASK) {
+    }
+  }
+
+  /**
+   * @brief Resets the PHY at address <phy>, and waits until it's done.
+   */
+  void Functions::resetPhy(u8 const phy)
+  {
+    writePhyRegister(phy, phy::BMCR, phy::bmcr::RESET);
+
+    while (readPhyRegister(phy, phy::BMCR) & phy::bmcr::RESET) {
+    }
+  }
+
+  /**
+   * @brief Restarts the auto-negotiation of the PHY at address <phy>.
+   * @note  Completes in the background, call updateLink() afterwards.
+   */
+  void Functions::startAutoNegotiation(u8 const phy)
+  {
+    writePhyRegister(
+        phy,
+        phy::BMCR,
+        phy::bmcr::AUTONEGOTIATION + phy::bmcr::RESTART_AUTONEGOTIATION);
+  }
+
+  /**
+   * @brief Reads the link state of the PHY at address <phy>, and configures
+   *        the MAC for the negotiated speed and duplex mode. Returns true
+   *        if the link is up.
+   * @note  Meant to be called on the PHY link change interrupt.
+   */
+  bool Functions::updateLink(u8 const phy)
+  {
+    // The link bit latches low, the first read clears it
+    readPhyRegister(phy, phy::BMSR);
+
+    u16 const bmsr = readPhyRegister(phy, phy::BMSR);
+
+    if (!(bmsr & phy::bmsr::LINK)) {
+      return false;
+    }
+
+    if (bmsr & phy::bmsr::AUTONEGOTIATION_COMPLETE) {
+      u16 const common =
+          readPhyRegister(phy, phy::ANAR) & readPhyRegister(phy, phy::ANLPAR);
+
+      if (common & phy::anar::_100_FULL_DUPLEX) {
+        configureLink(true, true);
+      } else if (common & phy::anar::_100_HALF_DUPLEX) {
+        configureLink(false, true);
+      } else if (common & phy::anar::_10_FULL_DUPLEX) {
+        configureLink(true, false);
+      } else {
+        configureLink(false, false);
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief MDC clock divider, the MDC must not exceed 2.5 MHz.
+   */
+  constexpr macmiiar::cr::States Functions::getMdcDivider()
+  {
+    return clk::AHB < 35000000 ? macmiiar::cr::HCLK_DIV_16 :
+        clk::AHB < 60000000 ? macmiiar::cr::HCLK_DIV_26 :
+        clk::AHB <= 100000000 ? macmiiar::cr::HCLK_DIV_42 :
+        clk::AHB <= 150000000 ? macmiiar::cr::HCLK_DIV_62 :
+        macmiiar::cr::HCLK_DIV_102;
+  }
+
+#ifndef STM32F1XX
+  /**
+   * @brief Starts the PTP clock at 0 s, with fine correction.
+   * @note  The MAC clocks must be enabled.
+   */
+  void Ptp::initialize()
+  {
+    // The target time interrupt isn't used
+    ETH_REGS->MACIMR |= macimr::tstim::MASK;
+
+    ETH_REGS->PTPTSCR = ptptscr::tse::MASK + ptptscr::tsssr::MASK +
+        ptptscr::tssarfe::MASK + ptptscr::tsptppsv2e::MASK;
+    ETH_REGS->PTPSSIR = INCREMENT;
+    ETH_REGS->PTPTSAR = getAddend();
+    ETH_REGS->PTPTSCR |= ptptscr::ttsaru::MASK;
+
+    waitUntilClear(ptptscr::ttsaru::MASK);
+
+    ETH_REGS->PTPTSCR |= ptptscr::tsfcu::MASK;
+
+    Timestamp const zero = { 0, 0 };
+
+    setTime(zero);
+  }
+
+  /**
+   * @brief Reads the PTP clock.
+   */
+  void Ptp::getTime(Timestamp& time)
+  {
+    // The seconds may roll over between both reads
+    do {
+      time.seconds = ETH_REGS->PTPTSHR;
+      time.nanoseconds = ETH_REGS->PTPTSLR & ptptslr::stss::MASK;
+    } while (time.seconds != ETH_REGS->PTPTSHR);
+  }
+
+  /**
+   * @brief Sets the PTP clock.
+   */
+  void Ptp::setTime(Timestamp const& time)
+  {
+    ETH_REGS->PTPTSHUR = time.seconds;
+    ETH_REGS->PTPTSLUR = time.nanoseconds;
+    ETH_REGS->PTPTSCR |= ptptscr::tssti::MASK;
+
+    waitUntilClear(ptptscr::tssti::MASK);
+  }
+
+  /**
+   * @brief Reads the PTP clock, in nanoseconds.
+   */
+  u64 Ptp::getNanoseconds()
+  {
+    Timestamp time;
+
+    getTime(time);
+
+    return u64(time.seconds) * 1000000000 + time.nanoseconds;
+  }
+
+  /**
+   * @brief Adds <offset> nanoseconds to the PTP clock (coarse correction).
+   * @note  In digital rollover mode, the nanoseconds to subtract are
+   *        written as their complement to 1 s, and only the seconds are
+   *        subtracted when there are no nanoseconds.
+   */
+  void Ptp::adjustTime(s64 const offset)
+  {
+    u64 const magnitude = offset < 0 ? u64(0) - u64(offset) : u64(offset);
+    u32 nanoseconds = magnitude % 1000000000;
+
+    if (offset < 0) {
+      if (nanoseconds != 0) {
+        nanoseconds = 1000000000 - nanoseconds;
+      }
+
+      nanoseconds |= ptptslur::tsupns::MASK;
+    }
+
+    ETH_REGS->PTPTSHUR = magnitude / 1000000000;
+    ETH_REGS->PTPTSLUR = nanoseconds;
+    ETH_REGS->PTPTSCR |= ptptscr::tsstu::MASK;
+
+    waitUntilClear(ptptscr::tsstu::MASK);
+  }
+
+  /**
+   * @brief Speeds up the PTP clock by <ppb> parts per billion (slows it
+   *        down if negative), relative to its nominal rate (fine
+   *        correction).
+   */
+  void Ptp::adjustFrequency(s32 const ppb)
+  {
+    u32 const addend = getAddend() + s64(getAddend()) * ppb / 1000000000;
+
+    waitUntilClear(ptptscr::ttsaru::MASK);
+
+    ETH_REGS->PTPTSAR = addend;
+    ETH_REGS->PTPTSCR |= ptptscr::ttsaru::MASK;
+  }
+
+  /**
+   * @brief Sets the PPS output frequency to 2^<exponent> Hz.
+   * @note  <exponent> ranges from 0 (1 Hz) to 15 (32768 Hz).
+   */
+  void Ptp::setPpsFrequency(u8 const exponent)
+  {
+    ETH_REGS->PTPPPSCR = exponent & ptpppscr::ppsfreq::MASK;
+  }
+
+  /**
+   * @brief Addend that runs the clock at 10^9 / INCREMENT updates per
+   *        second.
+   */
+  constexpr u32 Ptp::getAddend()
+  {
+    return (u64(1000000000) << 32) / INCREMENT / clk::AHB;
+  }
+
+  void Ptp::waitUntilClear(u32 const mask)
+  {
+    while (ETH_REGS->PTPTSCR & mask) {
+    }
+  }
+
+#endif // !STM32F1XX
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  Descriptor Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::rx[
+      RX_DESCRIPTORS] __DMARAM;
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  Descriptor Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::tx[
+      TX_DESCRIPTORS] __DMARAM;
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::buffers[
+      RX_BUFFERS][ETH_BUFFER_SIZE] __DMARAM;
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  void* Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::tags[
+      TX_DESCRIPTORS];
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::spares[
+      RX_BUFFERS];
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::spareCount;
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::rxHead;
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::txHead;
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::txTail;
+
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::txFree;
+
+  /**
+   * @brief Resets the MAC, builds the descriptor rings and starts the
+   *        transmission and the reception.
+   * @note  The link starts as 100 Mbit/s full duplex, see
+   *        Functions::updateLink().
+   * @note  The ETH interrupt must be unmasked in the NVIC by the user.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  void Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::initialize(
+      u8 const (&address)[6],
+      Interface const INTERFACE)
+  {
+    Functions::selectInterface(INTERFACE);
+    Functions::enableClocks();
+    Functions::reset();
+
+    for (u8 i = 0; i < RX_DESCRIPTORS; i++) {
+      rx[i].next = u32(reinterpret_cast<uintptr_t>(
+          &rx[(i + 1) % RX_DESCRIPTORS]));
+      arm(rx[i], buffers[i]);
+    }
+
+    spareCount = 0;
+
+    for (u8 i = RX_DESCRIPTORS; i < RX_BUFFERS; i++) {
+      spares[spareCount++] = i;
+    }
+
+    for (u8 i = 0; i < TX_DESCRIPTORS; i++) {
+      tx[i].status = tdes0::tch::MASK;
+      tx[i].next = u32(reinterpret_cast<uintptr_t>(
+          &tx[(i + 1) % TX_DESCRIPTORS]));
+      tags[i] = 0;
+    }
+
+    rxHead = 0;
+    txHead = 0;
+    txTail = 0;
+    txFree = TX_DESCRIPTORS;
+
+    ETH_REGS->MACCR =
+        maccr::ipco::MASK + maccr::dm::MASK + maccr::fes::MASK;
+    ETH_REGS->MACFFR = 0;
+    Functions::setMacAddress(address);
+
+    ETH_REGS->DMABMR = dmabmr::aab::MASK + dmabmr::usp::MASK +
+        (32 << dmabmr::rdp::POSITION) + (32 << dmabmr::pbl::POSITION) +
+#ifndef STM32F1XX
+        dmabmr::edfe::MASK +
+#endif // !STM32F1XX
+        dmabmr::fb::MASK;
+
+    ETH_REGS->DMARDLAR = u32(reinterpret_cast<uintptr_t>(rx));
+    ETH_REGS->DMATDLAR = u32(reinterpret_cast<uintptr_t>(tx));
+
+    // The checksum insertion needs the whole frame in the FIFO
+    ETH_REGS->DMAOMR =
+        dmaomr::rsf::MASK + dmaomr::tsf::MASK + dmaomr::osf::MASK;
+
+    ETH_REGS->DMAIER = dmaier::nise::MASK + dmaier::aise::MASK +
+        dmaier::rie::MASK + dmaier::tie::MASK + dmaier::rbuie::MASK +
+        dmaier::fbeie::MASK;
+
+    ETH_REGS->MACCR |= maccr::te::MASK;
+    ETH_REGS->DMAOMR |= dmaomr::ftf::MASK;
+
+    while (ETH_REGS->DMAOMR & dmaomr::ftf::MASK) {
+    }
+
+    ETH_REGS->DMAOMR |= dmaomr::st::MASK;
+    ETH_REGS->MACCR |= maccr::re::MASK;
+    ETH_REGS->DMAOMR |= dmaomr::sr::MASK;
+  }
+
+  /**
+   * @brief Stops the transmission and the reception.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  void Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::stop()
+  {
+    ETH_REGS->DMAOMR &= ~dmaomr::st::MASK;
+    ETH_REGS->MACCR &= ~maccr::re::MASK;
+    ETH_REGS->DMAOMR |= dmaomr::ftf::MASK;
+
+    while (ETH_REGS->DMAOMR & dmaomr::ftf::MASK) {
+    }
+
+    ETH_REGS->MACCR &= ~maccr::te::MASK;
+    ETH_REGS->DMAOMR &= ~dmaomr::sr::MASK;
+  }
+
+  /**
+   * @brief Clears the DMA interrupt flags and returns them (see
+   *        eth::dmasr), e.g. to wake the thread that calls receive() and
+   *        getSent().
+   * @note  Must be called from the ETH interrupt handler.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u32 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::onInterrupt()
+  {
+    u32 const status = ETH_REGS->DMASR;
+
+    ETH_REGS->DMASR = status & dmasr::FLAGS;
+
+    return status;
+  }
+
+  /**
+   * @brief Takes the next received frame, returns false if there is none,
+   *        or no spare buffer to arm in its place.
+   * @note  The frame size excludes the CRC. The buffer belongs to the
+   *        caller until it's given back with release().
+   * @note  Frames with errors are dropped.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  bool Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::receive(
+      Frame& frame)
+  {
+    for (;;) {
+      Descriptor& descriptor = rx[rxHead];
+      u32 const status = descriptor.status;
+      bool valid = (status & (rdes0::fs::MASK + rdes0::ls::MASK +
+          rdes0::es::MASK)) == rdes0::fs::MASK + rdes0::ls::MASK;
+
+      if (status & rdes0::own::MASK) {
+        return false;
+      }
+
+#ifndef STM32F1XX
+      if ((status & rdes0::pce::MASK) &&
+          (descriptor.extended & (rdes4::iphe::MASK + rdes4::ippe::MASK))) {
+        valid = false;
+      }
+#endif // !STM32F1XX
+
+      u8 spare = 0;
+
+      if (valid && !takeSpare(spare)) {
+        return false;
+      }
+
+      if (valid) {
+        frame.data = reinterpret_cast<u8*>(descriptor.buffer1);
+        frame.size = ((status & rdes0::fl::MASK) >> rdes0::fl::POSITION) - 4;
+#ifndef STM32F1XX
+        frame.timestamped = status & rdes0::tsv::MASK;
+        frame.timestamp.seconds = descriptor.timestampHigh;
+        frame.timestamp.nanoseconds = descriptor.timestampLow;
+#endif // !STM32F1XX
+
+        arm(descriptor, buffers[spare]);
+      } else {
+        arm(descriptor, reinterpret_cast<u8*>(descriptor.buffer1));
+      }
+
+      rxHead = (rxHead + 1) % RX_DESCRIPTORS;
+
+      // Resumes the reception if it was suspended for lack of descriptors
+      ETH_REGS->DMARPDR = 0;
+
+      if (valid) {
+        return true;
+      }
+    }
+  }
+
+  /**
+   * @brief Gives back the buffer of a received frame, returns false if
+   *        <data> isn't a buffer handed by receive(), or was already given
+   *        back.
+   * @note  May be called from an interrupt handler.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  bool Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::release(
+      u8* const data)
+  {
+    uintptr_t const offset = reinterpret_cast<uintptr_t>(data) -
+        reinterpret_cast<uintptr_t>(buffers[0]);
+
+    if ((offset >= sizeof(buffers)) || (offset % ETH_BUFFER_SIZE != 0)) {
+      return false;
+    }
+
+    u8 const index = offset / ETH_BUFFER_SIZE;
+    LOCK lock;
+
+    for (u8 i = 0; i < RX_DESCRIPTORS; i++) {
+      if (rx[i].buffer1 == u32(reinterpret_cast<uintptr_t>(data))) {
+        return false;
+      }
+    }
+
+    for (u8 i = 0; i < spareCount; i++) {
+      if (spares[i] == index) {
+        return false;
+      }
+    }
+
+    spares[spareCount++] = index;
+
+    return true;
+  }
+
+  /**
+   * @brief Queues a frame made of <count> segments, returns false if there
+   *        aren't enough free descriptors, or a segment isn't sendable.
+   * @note  The segments data must stay untouched until getSent() returns
+   *        <tag>.
+   * @note  If <timestamp> is true, the PTP time of the transmission is
+   *        captured (F2/F4).
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  bool Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::send(
+      Segment const* const segments,
+      u8 const count,
+      void* const tag,
+      bool const timestamp)
+  {
+    u8 const first = txHead;
+
+#ifdef STM32F1XX
+    (void) timestamp;
+
+#endif // STM32F1XX
+    if ((count == 0) || (count > txFree)) {
+      return false;
+    }
+
+    for (u8 i = 0; i < count; i++) {
+      if (segments[i].size > tdes1::tbs1::MASK) {
+        return false;
+      }
+#ifndef STM32F1XX
+
+      if (!MEMORY::isDmaReachable(segments[i].data)) {
+        return false;
+      }
+#endif // !STM32F1XX
+    }
+
+    for (u8 i = 0; i < count; i++) {
+      Descriptor& descriptor = tx[txHead];
+      u32 status = tdes0::tch::MASK +
+          tdes0::cic::IP_HEADER_PAYLOAD_AND_PSEUDO_HEADER;
+
+      if (i == 0) {
+        status |= tdes0::fs::MASK;
+#ifndef STM32F1XX
+
+        if (timestamp) {
+          status |= tdes0::ttse::MASK;
+        }
+#endif // !STM32F1XX
+      }
+
+      if (i == count - 1) {
+        status |= tdes0::ls::MASK + tdes0::ic::MASK;
+      }
+
+      // The first descriptor is handed to the DMA last
+      if (i != 0) {
+        status |= tdes0::own::MASK;
+      }
+
+      descriptor.buffer1 = u32(reinterpret_cast<uintptr_t>(segments[i].data));
+      descriptor.control = segments[i].size;
+      descriptor.status = status;
+      tags[txHead] = i == count - 1 ? tag : 0;
+
+      txHead = (txHead + 1) % TX_DESCRIPTORS;
+    }
+
+    txFree -= count;
+
+    __sync_synchronize();
+
+    tx[first].status |= tdes0::own::MASK;
+
+    __sync_synchronize();
+
+    // Resumes the transmission if it was suspended
+    ETH_REGS->DMATPDR = 0;
+
+    return true;
+  }
+
+  /**
+   * @brief Reclaims the descriptors of the sent frames, returns true and the
+   *        <tag> of the next sent frame, or false if there is none.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  bool Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::getSent(
+      void*& tag)
+  {
+    return reclaim(tag) != 0;
+  }
+#ifndef STM32F1XX
+
+  /**
+   * @brief Same as getSent(void*&), also returns the PTP time of the
+   *        transmission if the frame was sent with a timestamp request.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  bool Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::getSent(
+      void*& tag,
+      bool& timestamped,
+      Timestamp& timestamp)
+  {
+    Descriptor const* const last = reclaim(tag);
+
+    if (last == 0) {
+      return false;
+    }
+
+    timestamped = last->status & tdes0::ttss::MASK;
+    timestamp.seconds = last->timestampHigh;
+    timestamp.nanoseconds = last->timestampLow;
+
+    return true;
+  }
+#endif // !STM32F1XX
+
+  /**
+   * @brief Returns the number of TX descriptors, hence segments, available.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  u8 Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::
+      getFreeTxDescriptors()
+  {
+    return txFree;
+  }
+
+  /**
+   * @brief Frees the descriptors of the next sent frame, returns its last
+   *        descriptor and <tag>, or 0 if there is none.
+   * @note  The descriptor content stays valid until the next send().
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  Descriptor const*
+  Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::reclaim(void*& tag)
+  {
+    while (txFree < TX_DESCRIPTORS) {
+      Descriptor const& descriptor = tx[txTail];
+
+      if (descriptor.status & tdes0::own::MASK) {
+        return 0;
+      }
+
+      tag = tags[txTail];
+      txTail = (txTail + 1) % TX_DESCRIPTORS;
+      txFree++;
+
+      if (descriptor.status & tdes0::ls::MASK) {
+        return &descriptor;
+      }
+    }
+
+    return 0;
+  }
+
+  /**
+   * @brief Takes a spare RX buffer, returns false if there is none left.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  bool Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::takeSpare(
+      u8& index)
+  {
+    LOCK lock;
+
+    if (spareCount == 0) {
+      return false;
+    }
+
+    index = spares[--spareCount];
+
+    return true;
+  }
+
+  /**
+   * @brief Hands <buffer> to the DMA through <descriptor>.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK
+  >
+  void Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, LOCK>::arm(
+      Descriptor& descriptor,
+      u8* const buffer)
+  {
+    descriptor.buffer1 = u32(reinterpret_cast<uintptr_t>(buffer));
+    descriptor.control = rdes1::rch::MASK + ETH_BUFFER_SIZE;
+
+    __sync_synchronize();
+
+    descriptor.status = rdes0::own::MASK;
+  }
 }  // namespace eth
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace executor {
+  Task::Task(Work const work, void* const context, u8 const priority) :
+      work(work), context(context), priority(priority), queued(0)
+  {
+  }
+
+  /**
+   * @brief Returns true if the task is waiting in its queue.
+   */
+  bool Task::isQueued() const
+  {
+    return queued != 0;
+  }
+
+  /**
+   * @brief Returns the priority level of the task, 0 is the highest.
+   */
+  u8 Task::getPriority() const
+  {
+    return priority;
+  }
+
+  template<u8 PRIORITIES, u8 DEPTH>
+  typename Functions<PRIORITIES, DEPTH>::Queue
+  Functions<PRIORITIES, DEPTH>::queues[PRIORITIES];
+
+  /**
+   * @brief Gives the PendSV exception the lowest priority.
+   */
+  template<u8 PRIORITIES, u8 DEPTH>
+  void Functions<PRIORITIES, DEPTH>::initialize()
+  {
+    SCB::setPendSVPriority(0xFF);
+  }
+
+  /**
+   * @brief Runs the queued tasks, highest priority first, until all the
+   *        queues are empty.
+   * @note  Must be called from the PendSV exception handler.
+   */
+  template<u8 PRIORITIES, u8 DEPTH>
+  void Functions<PRIORITIES, DEPTH>::onPendSVInterrupt()
+  {
+    u8 priority = 0;
+
+    while (priority < PRIORITIES) {
+      Task* const task = pop(queues[priority]);
+
+      if (task == 0) {
+        priority++;
+        continue;
+      }
+
+      // The work may post its own task again
+      task->queued = 0;
+      task->work(task->context);
+
+      priority = 0;
+    }
+  }
+
+  /**
+   * @brief Queues <task> and requests the PendSV exception.
+   * @note  Safe to call from any interrupt and from thread mode.
+   * @note  Returns false if the task was already queued, if its priority
+   *        level doesn't exist or if its queue is full.
+   */
+  template<u8 PRIORITIES, u8 DEPTH>
+  bool Functions<PRIORITIES, DEPTH>::post(Task& task)
+  {
+    if (task.priority >= PRIORITIES) {
+      return false;
+    }
+
+    if (__sync_lock_test_and_set(&task.queued, 1) != 0) {
+      return false;
+    }
+
+    Queue& queue = queues[task.priority];
+    u32 tail;
+
+    // Reserve a slot, producers of higher priority may race for it
+    do {
+      tail = queue.tail;
+
+      if (tail - queue.head >= DEPTH) {
+        __sync_lock_release(&task.queued);
+        return false;
+      }
+    } while (!__sync_bool_compare_and_swap(&queue.tail, tail, tail + 1));
+
+    queue.slots[tail & (DEPTH - 1)] = &task;
+
+    u8 const depth = tail + 1 - queue.head;
+    u8 mark;
+
+    do {
+      mark = queue.highWaterMark;
+
+      if (depth <= mark) {
+        break;
+      }
+    } while (!__sync_bool_compare_and_swap(&queue.highWaterMark, mark, depth));
+
+    SCB::setPendSVPending();
+
+    return true;
+  }
+
+  /**
+   * @brief Returns the maximum number of tasks that were waiting at the
+   *        same time in the queue of <priority>.
+   */
+  template<u8 PRIORITIES, u8 DEPTH>
+  u8 Functions<PRIORITIES, DEPTH>::getHighWaterMark(u8 const priority)
+  {
+    return queues[priority].highWaterMark;
+  }
+
+  /**
+   * @brief Resets the high-water marks of all the queues.
+   */
+  template<u8 PRIORITIES, u8 DEPTH>
+  void Functions<PRIORITIES, DEPTH>::clearHighWaterMarks()
+  {
+    for (u8 priority = 0; priority < PRIORITIES; priority++) {
+      queues[priority].highWaterMark = 0;
+    }
+  }
+
+  /**
+   * @brief Takes the oldest task out of <queue>.
+   * @note  Returns 0 if the queue is empty, or if its oldest slot is
+   *        reserved but not yet written: the producer requests the PendSV
+   *        again once it's done.
+   */
+  template<u8 PRIORITIES, u8 DEPTH>
+  Task* Functions<PRIORITIES, DEPTH>::pop(Queue& queue)
+  {
+    u32 const head = queue.head;
+
+    if (head == queue.tail) {
+      return 0;
+    }
+
+    Task* const task = queue.slots[head & (DEPTH - 1)];
+
+    if (task == 0) {
+      return 0;
+    }
+
+    queue.slots[head & (DEPTH - 1)] = 0;
+    queue.head = head + 1;
+
+    return task;
+  }
+}  // namespace executor
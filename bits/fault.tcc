@@ -0,0 +1,192 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace fault {
+  /**
+   * @brief Gives write access to the record storage and routes the
+   *        MemManage, BusFault and UsageFault exceptions to their own
+   *        handlers.
+   * @note  The backup domain write access stays enabled.
+   */
+  void Functions::initialize()
+  {
+    PWR::enableClock();
+#ifdef STM32F1XX
+    BKP::enableClock();
+#else
+    RCC::enableClocks<rcc::ahb1enr::BKPSRAM>();
+#endif // STM32F1XX
+    // Sets DBP, see clk::initialize()
+    PWR::enableBackupDomainWriteProtection();
+
+    SCB::enableMemoryManagementFault();
+    SCB::enableBusFault();
+    SCB::enableUsageFault();
+  }
+
+  template<typename T>
+  u32 Stack<T>::words[STACK_WORDS];
+
+  /**
+   * @brief Copies the stored record to <record>, returns false if there's no
+   *        valid record.
+   * @note  The words that didn't fit in the storage are left at 0.
+   */
+  bool Functions::getRecord(Record& record)
+  {
+    u32 words[CAPACITY];
+
+    for (u8 i = 0; i < CAPACITY; i++) {
+      words[i] = load(i);
+    }
+
+    return Decoder::decode(words, CAPACITY, record);
+  }
+
+  bool Functions::hasRecord()
+  {
+    Record record;
+
+    return getRecord(record);
+  }
+
+  void Functions::clearRecord()
+  {
+    store(0, 0);
+  }
+
+  /**
+   * @brief Captures the fault record and resets the system.
+   * @note  Called by the handlers defined with FAULT_HANDLER(), on the fault
+   *        stack.
+   */
+  void Functions::onFault(u32 const* frame, u32 const excReturn)
+  {
+    capture(frame, excReturn);
+
+    SCB::resetSystem();
+  }
+
+  /**
+   * @brief Captures the fault record, then lets STACK report the stack
+   *        guard violation, or resets the system on any other fault.
+   * @note  Called by the handlers defined with FAULT_STACK_GUARD_HANDLER(),
+   *        on the fault stack.
+   */
+  template<typename STACK>
+  void Functions::onStackGuardFault(u32 const* frame, u32 const excReturn)
+  {
+    u32 const pc = capture(frame, excReturn);
+
+    STACK::onMemoryManagementFault(pc);
+  }
+
+  /**
+   * @brief Stores the record of the fault, returns the faulting PC (0 if
+   *        the frame couldn't be read).
+   */
+  u32 Functions::capture(u32 const* frame, u32 const excReturn)
+  {
+    Record record = Record();
+    u32 ipsr;
+
+    asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+
+    record.exception = ipsr & 0x1FF;
+    record.sp = u32(reinterpret_cast<uintptr_t>(frame));
+    record.excReturn = excReturn;
+    record.cfsr = SCB::getFaultStatus();
+    record.hfsr = SCB::getHardFaultStatus();
+    record.mmfar = SCB::getMemoryManagementFaultAddress();
+    record.bfar = SCB::getBusFaultAddress();
+
+    // Bit 2 of EXC_RETURN selects the PSP, bit 4 a frame without FPU state
+    bool const onMainStack = (excReturn & (1 << 2)) == 0;
+    u8 const frameWords = (excReturn & (1 << 4)) ? 8 : 26;
+    bool const stacked = (record.cfsr &
+        (scb::cfsr::mstkerr::MASK + scb::cfsr::stkerr::MASK)) == 0;
+
+    if (stacked && (!onMainStack || ((frame >= &__stack_start__) &&
+        (frame + frameWords <= &__stack_end__)))) {
+      record.r0 = frame[0];
+      record.r1 = frame[1];
+      record.r2 = frame[2];
+      record.r3 = frame[3];
+      record.r12 = frame[4];
+      record.lr = frame[5];
+      record.pc = frame[6];
+      record.xpsr = frame[7];
+
+      if (onMainStack) {
+        for (u32 const* word = frame + frameWords;
+            (word < &__stack_end__) && (record.depth < BACKTRACE_DEPTH);
+            word++) {
+          if (isReturnAddress(*word)) {
+            record.backtrace[record.depth++] = *word;
+          }
+        }
+      }
+    }
+
+    Decoder::seal(record, CAPACITY);
+
+    u32 const* const words = reinterpret_cast<u32 const*>(&record);
+
+    for (u8 i = 0; i < CAPACITY; i++) {
+      store(i, words[i]);
+    }
+
+    return record.pc;
+  }
+
+  bool Functions::isReturnAddress(u32 const word)
+  {
+    return ((word & 1) != 0) &&
+        (word >= alias::FLASH) &&
+        (word < alias::FLASH + CODE_SIZE);
+  }
+
+#ifdef STM32F1XX
+  void Functions::store(u8 const index, u32 const word)
+  {
+    BKP::writeData(2 * index, word);
+    BKP::writeData(2 * index + 1, word >> 16);
+  }
+
+  u32 Functions::load(u8 const index)
+  {
+    return BKP::readData(2 * index) +
+        (u32(BKP::readData(2 * index + 1)) << 16);
+  }
+#else
+  void Functions::store(u8 const index, u32 const word)
+  {
+    reinterpret_cast<u32 volatile*>(alias::BKPSRAM)[index] = word;
+  }
+
+  u32 Functions::load(u8 const index)
+  {
+    return reinterpret_cast<u32 volatile*>(alias::BKPSRAM)[index];
+  }
+#endif // STM32F1XX
+}  // namespace fault
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+namespace fault {
+  /**
+   * @brief Fills the header of <record>, only its first <words> words will
+   *        be stored.
+   */
+  void Decoder::seal(Record& record, u32 const words)
+  {
+    record.magic = MAGIC;
+    record.words = words;
+    record.checksum = getChecksum(reinterpret_cast<u32 const*>(&record), words);
+  }
+
+  /**
+   * @brief Decodes the <count> stored words into <record>, returns false if
+   *        they don't hold a valid record.
+   * @note  The words that weren't stored are left at 0.
+   */
+  bool Decoder::decode(u32 const* words, u32 const count, Record& record)
+  {
+    u32* const fields = reinterpret_cast<u32*>(&record);
+
+    record = Record();
+
+    if ((count < HEADER_WORDS) ||
+        (words[0] != MAGIC) ||
+        (words[1] < HEADER_WORDS) ||
+        (words[1] > count) ||
+        (words[1] > RECORD_WORDS) ||
+        (words[2] != getChecksum(words, words[1]))) {
+      return false;
+    }
+
+    for (u32 i = 0; i < words[1]; i++) {
+      fields[i] = words[i];
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Returns the name of the exception number <exception>.
+   */
+  char const* Decoder::getExceptionName(u32 const exception)
+  {
+    static char const* const names[] = {
+        "HardFault", "MemManage", "BusFault", "UsageFault"
+    };
+
+    if ((exception < 3) || (exception > 6)) {
+      return "?";
+    }
+
+    return names[exception - 3];
+  }
+
+  /**
+   * @brief Returns the name of the fault cause <bit>, as numbered by
+   *        getCauses(), or 0 if the bit isn't a cause.
+   */
+  char const* Decoder::getCauseName(u8 const bit)
+  {
+    // CFSR bits 0 - 25, then HFSR VECTTBL and FORCED
+    static char const* const names[] = {
+        "IACCVIOL", "DACCVIOL", 0, "MUNSTKERR",
+        "MSTKERR", "MLSPERR", 0, 0,
+        "IBUSERR", "PRECISERR", "IMPRECISERR", "UNSTKERR",
+        "STKERR", "LSPERR", 0, 0,
+        "UNDEFINSTR", "INVSTATE", "INVPC", "NOCP",
+        0, 0, 0, 0,
+        "UNALIGNED", "DIVBYZERO", 0, 0,
+        0, 0, "VECTTBL", "FORCED"
+    };
+
+    return bit < 32 ? names[bit] : 0;
+  }
+
+  /**
+   * @brief Returns the causes of the fault as a bit mask: the CFSR fault
+   *        bits (MMARVALID and BFARVALID excluded), with the HFSR VECTTBL and
+   *        FORCED bits in bits 30 and 31.
+   */
+  u32 Decoder::getCauses(Record const& record)
+  {
+    return (record.cfsr & 0x030F3F3B) +
+        ((record.hfsr & (1 << 1)) << 29) +
+        ((record.hfsr & (1 << 30)) << 1);
+  }
+
+  /**
+   * @brief Prints <record> through OUTPUT, one field per line.
+   */
+  template<typename OUTPUT>
+  void Decoder::dump(Record const& record)
+  {
+    typedef text::Writer<OUTPUT> TEXT;
+
+    static char const* const names[] = {
+        "pc ", "lr ", "xpsr ", "sp ", "exc_return ", "cfsr ", "hfsr ",
+        "mmfar ", "bfar ", "r0 ", "r1 ", "r2 ", "r3 ", "r12 "
+    };
+    u32 const* const words = &record.pc;
+    u32 const causes = getCauses(record);
+
+    TEXT::print(getExceptionName(record.exception));
+    TEXT::print("\r\n");
+
+    for (u8 i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+      TEXT::print(names[i]);
+      TEXT::printHex(words[i]);
+      TEXT::print("\r\n");
+    }
+
+    for (u8 bit = 0; bit < 32; bit++) {
+      if (causes & (u32(1) << bit)) {
+        TEXT::print("cause ");
+        TEXT::print(getCauseName(bit));
+        TEXT::print("\r\n");
+      }
+    }
+
+    for (u8 i = 0; (i < record.depth) && (i < BACKTRACE_DEPTH); i++) {
+      TEXT::print("#");
+      TEXT::print(u32(i));
+      TEXT::print(" ");
+      TEXT::printHex(record.backtrace[i]);
+      TEXT::print("\r\n");
+    }
+  }
+
+  /**
+   * @brief Returns the complement of the sum of the first <size> words,
+   *        the checksum word excluded.
+   */
+  u32 Decoder::getChecksum(u32 const* words, u32 const size)
+  {
+    u32 sum = 0;
+
+    for (u32 i = 0; i < size; i++) {
+      if (i != 2) {
+        sum += words[i];
+      }
+    }
+
+    return ~sum;
+  }
+}  // namespace fault
@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "../include/bitband.hpp"
+
 namespace flash {
 
 #ifndef VALUE_LINE
@@ -166,6 +168,56 @@ namespace flash {
     >()) = 0;
   }
 
+  /**
+   * @brief Flushes the data cache.
+   * @note  The data cache is disabled during the reset and then restored.
+   */
+  void Functions::resetDataCache()
+  {
+    bool const enabled = FLASH_REGS->ACR & acr::dcen::MASK;
+
+    disableDataCache();
+
+    *(u32 volatile*) (bitband::peripheral<
+        ADDRESS + flash::acr::OFFSET,
+        flash::acr::dcrst::POSITION
+    >()) = 1;
+    *(u32 volatile*) (bitband::peripheral<
+        ADDRESS + flash::acr::OFFSET,
+        flash::acr::dcrst::POSITION
+    >()) = 0;
+
+    if (enabled) {
+      enableDataCache();
+    }
+  }
+
+  /**
+   * @brief Flushes the instruction cache, e.g. after reprogramming the
+   *        flash or changing the latency.
+   * @note  The instruction cache is disabled during the reset and then
+   *        restored.
+   */
+  void Functions::resetInstructionCache()
+  {
+    bool const enabled = FLASH_REGS->ACR & acr::icen::MASK;
+
+    disableInstructionCache();
+
+    *(u32 volatile*) (bitband::peripheral<
+        ADDRESS + flash::acr::OFFSET,
+        flash::acr::icrst::POSITION
+    >()) = 1;
+    *(u32 volatile*) (bitband::peripheral<
+        ADDRESS + flash::acr::OFFSET,
+        flash::acr::icrst::POSITION
+    >()) = 0;
+
+    if (enabled) {
+      enableInstructionCache();
+    }
+  }
+
   /**
    * @brief Configures the flash memory access.
    * @note  Overrides the old configuration.
@@ -179,4 +231,487 @@ namespace flash {
     FLASH_REGS->ACR = LATENCY + PRFTEN + DCEN + ICEN;
   }
 #endif // STM32F1XX
+
+  /**
+   * @brief Unlocks the program/erase control register.
+   */
+  void Functions::unlock()
+  {
+    if (FLASH_REGS->CR & cr::lock::MASK) {
+      FLASH_REGS->KEYR = KEY1;
+      FLASH_REGS->KEYR = KEY2;
+    }
+  }
+
+  /**
+   * @brief Locks the program/erase control register.
+   * @note  Until the next reset, only the key sequence can unlock it again.
+   */
+  void Functions::lock()
+  {
+    FLASH_REGS->CR |= cr::lock::MASK;
+  }
+
+  /**
+   * @brief Returns true if the program/erase control register is locked.
+   */
+  bool Functions::isLocked()
+  {
+    return FLASH_REGS->CR & cr::lock::MASK;
+  }
+
+  /**
+   * @brief Returns true if a program/erase operation is in progress.
+   */
+  bool Functions::isBusy()
+  {
+    return FLASH_REGS->SR & sr::bsy::MASK;
+  }
+
+  /**
+   * @brief Returns true if an operation has ended since the flags were
+   *        cleared.
+   * @note  On the F2/F4 this flag is only set when the interrupts are
+   *        enabled.
+   */
+  bool Functions::hasOperationEnded()
+  {
+    return FLASH_REGS->SR & sr::eop::MASK;
+  }
+
+  /**
+   * @brief Returns the error flags of the last operations.
+   */
+  u32 Functions::getErrors()
+  {
+    return FLASH_REGS->SR & sr::ERRORS;
+  }
+
+  /**
+   * @brief Clears the end of operation and the error flags.
+   */
+  void Functions::clearFlags()
+  {
+    FLASH_REGS->SR = sr::eop::MASK + sr::ERRORS;
+  }
+
+  /**
+   * @brief Waits until the current operation ends, returns false if it
+   *        ended with an error.
+   */
+  bool Functions::wait()
+  {
+    while (isBusy()) {
+    }
+
+    return getErrors() == 0;
+  }
+
+  /**
+   * @brief Enables the end of operation and the error interrupts.
+   */
+  void Functions::enableInterrupts()
+  {
+    FLASH_REGS->CR |= cr::eopie::MASK + cr::errie::MASK;
+  }
+
+  /**
+   * @brief Disables the end of operation and the error interrupts.
+   */
+  void Functions::disableInterrupts()
+  {
+    FLASH_REGS->CR &= ~(cr::eopie::MASK + cr::errie::MASK);
+  }
+
+  /**
+   * @brief Returns the number of bytes written by each programming
+   *        operation.
+   */
+  u8 Functions::getProgrammingUnit()
+  {
+#ifdef STM32F1XX
+    return 2;
+#else // STM32F1XX
+    return 1 << (parallelism() >> cr::psize::POSITION);
+#endif // STM32F1XX
+  }
+
+  /**
+   * @brief Enters the programming mode, every write to the flash memory
+   *        will start a programming operation.
+   * @note  The flash must be unlocked.
+   */
+  void Functions::beginProgramming()
+  {
+#ifdef STM32F1XX
+    FLASH_REGS->CR |= cr::pg::MASK;
+#else // STM32F1XX
+    FLASH_REGS->CR &= ~cr::psize::MASK;
+    FLASH_REGS->CR |= cr::pg::MASK + parallelism();
+#endif // STM32F1XX
+  }
+
+  /**
+   * @brief Programs one unit (see getProgrammingUnit()) of <data> at
+   *        <address>.
+   * @note  <address> must be aligned to the unit, <data> can be unaligned.
+   * @note  Must be called in programming mode, with the flash not busy.
+   */
+  void Functions::writeUnit(u32 const address, u8 const* const data)
+  {
+#ifdef STM32F1XX
+    *(u16 volatile*) address = data[0] + (data[1] << 8);
+#else // STM32F1XX
+    switch (parallelism()) {
+      case cr::psize::X8:
+        *(u8 volatile*) address = data[0];
+        break;
+      case cr::psize::X16:
+        *(u16 volatile*) address = data[0] + (data[1] << 8);
+        break;
+      case cr::psize::X32:
+        *(u32 volatile*) address =
+            data[0] + (data[1] << 8) + (data[2] << 16) + (data[3] << 24);
+        break;
+      case cr::psize::X64:
+        // Both words make up a single programming operation
+        *(u32 volatile*) address =
+            data[0] + (data[1] << 8) + (data[2] << 16) + (data[3] << 24);
+        *(u32 volatile*) (address + 4) =
+            data[4] + (data[5] << 8) + (data[6] << 16) + (data[7] << 24);
+        break;
+    }
+#endif // STM32F1XX
+  }
+
+  /**
+   * @brief Leaves the programming/erase mode.
+   * @note  On F2/F4 devices the instruction and data caches are reset after
+   *        an erase, they may still hold the old contents.
+   */
+  void Functions::endOperation()
+  {
+#ifdef STM32F1XX
+    FLASH_REGS->CR &= ~(cr::pg::MASK + cr::per::MASK + cr::mer::MASK);
+#else // STM32F1XX
+    bool const erased = FLASH_REGS->CR & (cr::ser::MASK + cr::mer::MASK);
+
+    FLASH_REGS->CR &=
+        ~(cr::pg::MASK + cr::ser::MASK + cr::mer::MASK + cr::snb::MASK);
+
+    if (erased) {
+      resetInstructionCache();
+      resetDataCache();
+    }
+#endif // STM32F1XX
+  }
+
+  /**
+   * @brief Programs <size> bytes of <data> at <address>, returns false on
+   *        error.
+   * @note  <address> and <size> must be multiples of the programming unit
+   *        (see getProgrammingUnit()), and the destination must be erased.
+   * @note  The flash must be unlocked.
+   */
+  bool Functions::program(
+      u32 const address,
+      void const* const data,
+      u32 const size)
+  {
+    u8 const unit = getProgrammingUnit();
+    u8 const* source = static_cast<u8 const*>(data);
+    bool success = true;
+
+    if ((address % unit != 0) || (size % unit != 0)) {
+      return false;
+    }
+
+    wait();
+    clearFlags();
+    beginProgramming();
+
+    for (u32 offset = 0; offset < size; offset += unit) {
+      writeUnit(address + offset, source + offset);
+
+      if (!wait()) {
+        success = false;
+        break;
+      }
+    }
+
+    endOperation();
+
+    return success;
+  }
+
+  /**
+   * @brief Starts erasing the whole flash memory.
+   * @note  On the F4 dual bank devices only the first bank is erased.
+   * @note  The flash must be unlocked.
+   */
+  void Functions::startMassErase()
+  {
+#ifdef STM32F1XX
+    FLASH_REGS->CR |= cr::mer::MASK;
+#else // STM32F1XX
+    FLASH_REGS->CR &= ~cr::psize::MASK;
+    FLASH_REGS->CR |= cr::mer::MASK + parallelism();
+#endif // STM32F1XX
+    FLASH_REGS->CR |= cr::strt::MASK;
+  }
+
+  /**
+   * @brief Erases the whole flash memory, returns false on error.
+   * @note  The code calling this function must run from RAM.
+   */
+  bool Functions::eraseAll()
+  {
+    bool success;
+
+    wait();
+    clearFlags();
+    startMassErase();
+    success = wait();
+    endOperation();
+
+    return success;
+  }
+
+#ifdef STM32F1XX
+  /**
+   * @brief Starts erasing the page that contains <address>.
+   * @note  The flash must be unlocked.
+   */
+  void Functions::startPageErase(u32 const address)
+  {
+    FLASH_REGS->CR |= cr::per::MASK;
+    FLASH_REGS->AR = address;
+    FLASH_REGS->CR |= cr::strt::MASK;
+  }
+
+  /**
+   * @brief Erases the page that contains <address>, returns false on error.
+   * @note  The flash must be unlocked.
+   */
+  bool Functions::erasePage(u32 const address)
+  {
+    bool success;
+
+    wait();
+    clearFlags();
+    startPageErase(address);
+    success = wait();
+    endOperation();
+
+    return success;
+  }
+
+  /**
+   * @brief Allows writing the option bytes.
+   * @note  The flash must be unlocked first. The write access is revoked
+   *        when the flash is locked.
+   */
+  void Functions::unlockOptionBytes()
+  {
+    // The option bytes use the same key sequence as the flash
+    FLASH_REGS->OPTKEYR = KEY1;
+    FLASH_REGS->OPTKEYR = KEY2;
+  }
+
+  /**
+   * @brief Erases all the option bytes, returns false on error.
+   * @note  This enables the readout protection, unless the RDP byte is
+   *        programmed back to 0xA5. The new values are loaded at the next
+   *        reset.
+   */
+  bool Functions::eraseOptionBytes()
+  {
+    bool success;
+
+    wait();
+    clearFlags();
+    FLASH_REGS->CR |= cr::opter::MASK;
+    FLASH_REGS->CR |= cr::strt::MASK;
+    success = wait();
+    FLASH_REGS->CR &= ~cr::opter::MASK;
+
+    return success;
+  }
+
+  /**
+   * @brief Programs the option byte number <index>, returns false on error.
+   * @note  The option bytes must be erased first, the complement byte is
+   *        generated by the hardware.
+   */
+  bool Functions::programOptionByte(u8 const index, u8 const value)
+  {
+    bool success;
+
+    wait();
+    clearFlags();
+    FLASH_REGS->CR |= cr::optpg::MASK;
+    *(u16 volatile*) (ob::ADDRESS + 2 * index) = value;
+    success = wait();
+    FLASH_REGS->CR &= ~cr::optpg::MASK;
+
+    return success;
+  }
+
+  /**
+   * @brief Returns the option byte number <index>, as stored in the flash.
+   */
+  u8 Functions::getOptionByte(u8 const index)
+  {
+    return *(u8 const volatile*) (ob::ADDRESS + 2 * index);
+  }
+#else // STM32F1XX
+  /**
+   * @brief Selects the program/erase parallelism.
+   * @note  Must match the supply voltage range, X64 requires the external
+   *        VPP supply.
+   */
+  void Functions::setParallelism(cr::psize::States const PSIZE)
+  {
+    parallelism() = PSIZE;
+  }
+
+  /**
+   * @brief Returns the program/erase parallelism, X32 by default.
+   */
+  cr::psize::States Functions::getParallelism()
+  {
+    return parallelism();
+  }
+
+  /**
+   * @brief Starts erasing the sector number <sector>.
+   * @note  Sectors 12 to 23 belong to the second bank.
+   * @note  The flash must be unlocked. Call endOperation() once the erase
+   *        has ended, it also resets the caches.
+   */
+  void Functions::startSectorErase(u8 const sector)
+  {
+    // The second bank sectors are numbered from 16 in the SNB field
+    u8 const snb = sector < SECTORS_PER_BANK ? sector : sector + 4;
+
+    FLASH_REGS->CR &= ~(cr::snb::MASK + cr::psize::MASK);
+    FLASH_REGS->CR |= cr::ser::MASK + (snb << cr::snb::POSITION) +
+        parallelism();
+    FLASH_REGS->CR |= cr::strt::MASK;
+  }
+
+  /**
+   * @brief Erases the sector number <sector>, returns false on error.
+   * @note  The flash must be unlocked.
+   */
+  bool Functions::eraseSector(u8 const sector)
+  {
+    bool success;
+
+    wait();
+    clearFlags();
+    startSectorErase(sector);
+    success = wait();
+    endOperation();
+
+    return success;
+  }
+
+  /**
+   * @brief Returns the number of the sector that contains <address>.
+   */
+  constexpr u8 Functions::getSector(u32 const address)
+  {
+    return (address - MEMORY) / BANK_SIZE * SECTORS_PER_BANK +
+        getSectorInBank((address - MEMORY) % BANK_SIZE);
+  }
+
+  /**
+   * @brief Returns the start address of the sector number <sector>.
+   */
+  constexpr u32 Functions::getSectorAddress(u8 const sector)
+  {
+    return MEMORY + sector / SECTORS_PER_BANK * BANK_SIZE +
+        getSectorOffset(sector % SECTORS_PER_BANK);
+  }
+
+  /**
+   * @brief Returns the size in bytes of the sector number <sector>.
+   */
+  constexpr u32 Functions::getSectorSize(u8 const sector)
+  {
+    return sector % SECTORS_PER_BANK < 4 ? 16 * 1024 :
+        sector % SECTORS_PER_BANK == 4 ? 64 * 1024 : 128 * 1024;
+  }
+
+  /**
+   * @brief Allows writing the option control register.
+   */
+  void Functions::unlockOptionBytes()
+  {
+    if (FLASH_REGS->OPTCR & optcr::optlock::MASK) {
+      FLASH_REGS->OPTKEYR = OPTKEY1;
+      FLASH_REGS->OPTKEYR = OPTKEY2;
+    }
+  }
+
+  /**
+   * @brief Locks the option control register.
+   */
+  void Functions::lockOptionBytes()
+  {
+    FLASH_REGS->OPTCR |= optcr::optlock::MASK;
+  }
+
+  /**
+   * @brief Returns the option control register, which holds the current
+   *        option bytes.
+   */
+  u32 Functions::getOptionBytes()
+  {
+    return FLASH_REGS->OPTCR;
+  }
+
+  /**
+   * @brief Programs the option bytes, returns false on error.
+   * @note  <value> uses the layout of the option control register, the
+   *        lock and start bits are ignored. The new values are loaded at the
+   *        next reset.
+   * @note  Setting the readout protection to LEVEL_2 is irreversible.
+   */
+  bool Functions::programOptionBytes(u32 const value)
+  {
+    wait();
+    clearFlags();
+
+    FLASH_REGS->OPTCR =
+        value & ~(optcr::optlock::MASK + optcr::optstrt::MASK);
+    FLASH_REGS->OPTCR |= optcr::optstrt::MASK;
+
+    return wait();
+  }
+
+  constexpr u8 Functions::getSectorInBank(u32 const offset)
+  {
+    return offset < 0x10000 ? offset / (16 * 1024) :
+        offset < 0x20000 ? 4 : 4 + offset / (128 * 1024);
+  }
+
+  constexpr u32 Functions::getSectorOffset(u8 const sector)
+  {
+    return sector < 4 ? sector * 16 * 1024 :
+        sector == 4 ? 0x10000 : (sector - 4) * 128 * 1024;
+  }
+
+  /**
+   * @brief The parallelism, cached because the control register may be
+   *        locked when it's selected.
+   */
+  cr::psize::States& Functions::parallelism()
+  {
+    static cr::psize::States PSIZE = cr::psize::X32;
+
+    return PSIZE;
+  }
+#endif // STM32F1XX
 }  // namespace flash
@@ -33,4 +33,302 @@ namespace hash {
   {
     RCC::disableClocks<rcc::ahb2enr::HASH>();
   }
-} // namespace hash
+
+  /**
+   * @brief Starts a new <ALGO> digest, the previous one is discarded.
+   */
+  void Functions::init(cr::algo::States ALGO)
+  {
+    state() = State();
+
+    HASH_REGS->CR = cr::datatype::_8_BIT_DATA + cr::mode::HASH_MODE + ALGO +
+        cr::init::MASK;
+  }
+
+  /**
+   * @brief Starts a new <ALGO> HMAC with the <size> bytes <key>.
+   * @note  The key is referenced, not copied, until final().
+   */
+  void Functions::init(
+      cr::algo::States ALGO,
+      void const* const key,
+      u32 const size)
+  {
+    state() = State();
+
+    HASH_REGS->CR = cr::datatype::_8_BIT_DATA + cr::mode::HMAC_MODE + ALGO +
+        (size > 64 ? cr::lkey::LONG_KEY : cr::lkey::SHORT_KEY) +
+        cr::init::MASK;
+
+    // Inner hash key
+    update(key, size);
+    calculate();
+    waitWhileBusy();
+
+    state().key = static_cast<u8 const*>(key);
+    state().keySize = size;
+  }
+
+  /**
+   * @brief Feeds <size> bytes of the message.
+   * @note  The bytes that don't fill a word are held until the next call.
+   */
+  void Functions::update(void const* const data, u32 size)
+  {
+    State& current = state();
+    u8 const* bytes = static_cast<u8 const*>(data);
+
+    while ((current.partialSize != 0) && (size != 0)) {
+      current.partial += u32(*bytes++) << (8 * current.partialSize);
+      size--;
+
+      if (++current.partialSize == 4) {
+        HASH_REGS->DIN = current.partial;
+        current.partial = 0;
+        current.partialSize = 0;
+      }
+    }
+
+    for (; size >= 4; size -= 4) {
+      HASH_REGS->DIN = bytes[0] + (bytes[1] << 8) + (bytes[2] << 16) +
+          (u32(bytes[3]) << 24);
+      bytes += 4;
+    }
+
+    for (; size != 0; size--) {
+      current.partial += u32(*bytes++) << (8 * current.partialSize++);
+    }
+  }
+
+  /**
+   * @brief Completes the digest and writes it to <result>, SHA1_SIZE or
+   *        MD5_SIZE bytes.
+   */
+  void Functions::final(u8* const result)
+  {
+    State& current = state();
+
+    calculate();
+
+    if (current.key != 0) {
+      // Outer hash key
+      waitWhileBusy();
+      update(current.key, current.keySize);
+      calculate();
+      current.key = 0;
+    }
+
+    while ((HASH_REGS->SR & sr::dcis::MASK) == 0) {
+    }
+
+    u8 const words =
+        (HASH_REGS->CR & cr::algo::MASK) == cr::algo::MD5 ? 4 : 5;
+
+    for (u8 i = 0; i < words; i++) {
+      u32 const word = HASH_REGS->HR[i];
+
+      result[4 * i] = word >> 24;
+      result[4 * i + 1] = word >> 16;
+      result[4 * i + 2] = word >> 8;
+      result[4 * i + 3] = word;
+    }
+  }
+
+  /**
+   * @brief Saves the context of the ongoing digest.
+   */
+  void Functions::save(Context& context)
+  {
+    waitWhileBusy();
+
+    context.imr = HASH_REGS->IMR;
+    context.str = HASH_REGS->STR;
+    context.cr = HASH_REGS->CR;
+
+    for (u8 i = 0; i < csr::SIZE; i++) {
+      context.csr[i] = HASH_REGS->CSR[i];
+    }
+
+    context.state = state();
+  }
+
+  /**
+   * @brief Resumes the digest saved in <context>.
+   */
+  void Functions::restore(Context const& context)
+  {
+    HASH_REGS->IMR = context.imr;
+    HASH_REGS->STR = context.str;
+    HASH_REGS->CR = context.cr;
+    HASH_REGS->CR = context.cr | cr::init::MASK;
+
+    for (u8 i = 0; i < csr::SIZE; i++) {
+      HASH_REGS->CSR[i] = context.csr[i];
+    }
+
+    state() = context.state;
+  }
+
+  State& Functions::state()
+  {
+    static State current;
+
+    return current;
+  }
+
+  /**
+   * @brief Writes the held bytes as the last word and starts the digest
+   *        calculation.
+   */
+  void Functions::calculate()
+  {
+    State& current = state();
+    u32 const nblw = 8 * current.partialSize;
+
+    HASH_REGS->STR = nblw;
+
+    if (current.partialSize != 0) {
+      HASH_REGS->DIN = current.partial;
+    }
+
+    HASH_REGS->STR = nblw + str::dcal::MASK;
+
+    current.partial = 0;
+    current.partialSize = 0;
+  }
+
+  void Functions::waitWhileBusy()
+  {
+    while (HASH_REGS->SR & sr::busy::MASK) {
+    }
+  }
+#ifdef STM32F4XX
+
+  /**
+   * @brief Enables the HASH and DMA clocks.
+   */
+  void Dma::initialize()
+  {
+    Functions::enableClock();
+    Stream::enableClock();
+  }
+
+  /**
+   * @brief Starts feeding <size> bytes at <data> to the ongoing digest.
+   * @note  <data> must be reachable by the DMA (not in the CCM). The digest
+   *        is completed by HASH::final() once isBusy() returns false.
+   */
+  void Dma::start(void const* const data, u32 const size)
+  {
+    Transfer& current = transfer();
+    u8 const* bytes = static_cast<u8 const*>(data);
+    u8 const partialSize = Functions::state().partialSize;
+    u32 head = 0;
+
+    // Completes the held word first, the DMA only writes whole words
+    if (partialSize != 0) {
+      head = size < 4u - partialSize ? size : 4u - partialSize;
+      Functions::update(bytes, head);
+    }
+
+    current.position = bytes + head;
+    current.remaining = (size - head) & ~3;
+    current.trailing = (size - head) & 3;
+
+    HASH_REGS->CR |= cr::dmae::MASK + cr::mdmat::MASK;
+
+    startChunk();
+  }
+
+  /**
+   * @brief Returns true until the whole buffer has been fed.
+   * @note  Must be polled, it also chains the transfers of buffers larger
+   *        than a single DMA transfer.
+   */
+  bool Dma::isBusy()
+  {
+    Transfer& current = transfer();
+
+    if (Stream::isEnabled()) {
+      return true;
+    }
+
+    if (current.remaining != 0) {
+      startChunk();
+
+      return true;
+    }
+
+    HASH_REGS->CR &= ~(cr::dmae::MASK + cr::mdmat::MASK);
+
+    Functions::update(current.position, current.trailing);
+    current.trailing = 0;
+
+    return false;
+  }
+
+  Dma::Transfer& Dma::transfer()
+  {
+    static Transfer current;
+
+    return current;
+  }
+
+  void Dma::startChunk()
+  {
+    Transfer& current = transfer();
+    bool const aligned =
+        (u32(reinterpret_cast<uintptr_t>(current.position)) & 3) == 0;
+    // The number of transactions counts the 32-bit peripheral writes
+    u32 const bytes =
+        current.remaining < 0xFFFF * 4 ? current.remaining : 0xFFFF * 4;
+
+    if (bytes == 0) {
+      return;
+    }
+
+    Stream::clearTransferCompleteFlag();
+    Stream::clearTransferErrorFlag();
+    Stream::clearHalfTransferFlag();
+    Stream::clearFifoErrorFlag();
+    Stream::clearDirectModeErrorFlag();
+
+    // An unaligned buffer is read byte by byte, and packed by the FIFO
+    Stream::configure(
+        dma::stream::cr::dmeie::DIRECT_MODE_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::teie::TRANSFER_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::htie::HALF_TRANSFER_INTERRUPT_DISABLED,
+        dma::stream::cr::tcie::TRANSFER_COMPLETE_INTERRUPT_DISABLED,
+        dma::stream::cr::pfctrl::DMA_FLOW_CONTROLLER,
+        dma::stream::cr::dir::MEMORY_TO_PERIPHERAL,
+        dma::stream::cr::circ::CIRCULAR_MODE_DISABLED,
+        dma::stream::cr::pinc::PERIPHERAL_INCREMENT_MODE_DISABLED,
+        dma::stream::cr::minc::MEMORY_INCREMENT_MODE_ENABLED,
+        dma::stream::cr::psize::PERIPHERAL_SIZE_32BITS,
+        aligned ?
+            dma::stream::cr::msize::MEMORY_SIZE_32BITS :
+            dma::stream::cr::msize::MEMORY_SIZE_8BITS,
+        dma::stream::cr::pincos::PERIPHERAL_INCREMENT_OFFSET_SIZE_PSIZE,
+        dma::stream::cr::pl::PRIORITY_LEVEL_LOW,
+        dma::stream::cr::dbm::DOUBLE_BUFFER_MODE_DISABLED,
+        dma::stream::cr::ct::CURRENT_TARGET_MEMORY_0,
+        dma::stream::cr::pburst::PERIPHERAL_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::mburst::MEMORY_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::chsel::CHANNEL_2);
+
+    Stream::configureFIFO(
+        dma::stream::fcr::fth::FIFO_THRESHOLD_SELECTION_FULL,
+        dma::stream::fcr::dmdis::DIRECT_MODE_DISABLED,
+        dma::stream::fcr::feie::FIFO_ERROR_INTERRUPT_DISABLED);
+
+    Stream::setPeripheralAddress(&HASH_REGS->DIN);
+    Stream::setMemory0Address(const_cast<u8*>(current.position));
+    Stream::setNumberOfTransactions(bytes / 4);
+
+    current.position += bytes;
+    current.remaining -= bytes;
+
+    Stream::enablePeripheral();
+  }
+#endif // STM32F4XX
+}  // namespace hash
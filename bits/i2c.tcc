@@ -22,6 +22,7 @@
 #pragma once
 
 #include "bitband.hpp"
+#include "../include/core/nvic.hpp"
 
 namespace i2c {
   /**
@@ -320,6 +321,198 @@ namespace i2c {
     >());
   }
 
+  /**
+   * @brief Returns true while a requested stop condition hasn't been sent.
+   */
+  template<Address I>
+  bool Standard<I>::isStopPending()
+  {
+    return *(bool volatile*) (bitband::peripheral<
+        I + cr1::OFFSET,
+        cr1::stop::POSITION
+    >());
+  }
+
+  /**
+   * @brief Returns true if the last byte/address wasn't acknowledged.
+   */
+  template<Address I>
+  bool Standard<I>::hasAcknowledgeFailed()
+  {
+    return *(bool volatile*) (bitband::peripheral<
+        I + sr1::OFFSET,
+        sr1::af::POSITION
+    >());
+  }
+
+  /**
+   * @brief Clears the acknowledge failure flag.
+   */
+  template<Address I>
+  void Standard<I>::clearAcknowledgeFailedFlag()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + sr1::OFFSET,
+        sr1::af::POSITION
+    >()) = 0;
+  }
+
+  /**
+   * @brief Clears the address sent flag.
+   * @note  The flag is cleared by reading SR1 followed by SR2.
+   */
+  template<Address I>
+  void Standard<I>::clearAddressFlag()
+  {
+    reinterpret_cast<Registers*>(I)->SR1;
+    reinterpret_cast<Registers*>(I)->SR2;
+  }
+
+  /**
+   * @brief Enables the DMA requests on TxE/RxNE.
+   */
+  template<Address I>
+  void Standard<I>::enableDmaRequests()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::dmaen::POSITION
+    >()) = 1;
+  }
+
+  /**
+   * @brief Disables the DMA requests.
+   */
+  template<Address I>
+  void Standard<I>::disableDmaRequests()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::dmaen::POSITION
+    >()) = 0;
+  }
+
+  /**
+   * @brief Enables the event interrupt (SB, ADDR, BTF, STOPF, ...).
+   */
+  template<Address I>
+  void Standard<I>::enableEventInterrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::itevten::POSITION
+    >()) = 1;
+  }
+
+  /**
+   * @brief Disables the event interrupt.
+   */
+  template<Address I>
+  void Standard<I>::disableEventInterrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::itevten::POSITION
+    >()) = 0;
+  }
+
+  /**
+   * @brief Enables the error interrupt (BERR, ARLO, AF, OVR, ...).
+   */
+  template<Address I>
+  void Standard<I>::enableErrorInterrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::iterren::POSITION
+    >()) = 1;
+  }
+
+  /**
+   * @brief Disables the error interrupt.
+   */
+  template<Address I>
+  void Standard<I>::disableErrorInterrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::iterren::POSITION
+    >()) = 0;
+  }
+
+  /**
+   * @brief Enables the buffer interrupt (TXE and RXNE), the event interrupt
+   *        must be enabled too.
+   */
+  template<Address I>
+  void Standard<I>::enableBufferInterrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::itbufen::POSITION
+    >()) = 1;
+  }
+
+  /**
+   * @brief Disables the buffer interrupt.
+   */
+  template<Address I>
+  void Standard<I>::disableBufferInterrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        I + cr2::OFFSET,
+        cr2::itbufen::POSITION
+    >()) = 0;
+  }
+
+  /**
+   * @brief Unmasks the I2C event and error interrupts.
+   */
+  template<Address I>
+  void Standard<I>::unmaskInterrupts()
+  {
+    switch (I) {
+      case I2C1:
+        NVIC::enableIrq<nvic::irqn::I2C1_EV>();
+        NVIC::enableIrq<nvic::irqn::I2C1_ER>();
+        break;
+      case I2C2:
+        NVIC::enableIrq<nvic::irqn::I2C2_EV>();
+        NVIC::enableIrq<nvic::irqn::I2C2_ER>();
+        break;
+#ifndef STM32F1XX
+      case I2C3:
+        NVIC::enableIrq<nvic::irqn::I2C3_EV>();
+        NVIC::enableIrq<nvic::irqn::I2C3_ER>();
+        break;
+#endif // !STM32F1XX
+    }
+  }
+
+  /**
+   * @brief Masks the I2C event and error interrupts.
+   */
+  template<Address I>
+  void Standard<I>::maskInterrupts()
+  {
+    switch (I) {
+      case I2C1:
+        NVIC::disableIrq<nvic::irqn::I2C1_EV>();
+        NVIC::disableIrq<nvic::irqn::I2C1_ER>();
+        break;
+      case I2C2:
+        NVIC::disableIrq<nvic::irqn::I2C2_EV>();
+        NVIC::disableIrq<nvic::irqn::I2C2_ER>();
+        break;
+#ifndef STM32F1XX
+      case I2C3:
+        NVIC::disableIrq<nvic::irqn::I2C3_EV>();
+        NVIC::disableIrq<nvic::irqn::I2C3_ER>();
+        break;
+#endif // !STM32F1XX
+    }
+  }
+
   /**
    * @brief Writes a value to a slave device register.
    */
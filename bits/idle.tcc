@@ -0,0 +1,134 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace idle {
+  template<u32 TICK_FREQUENCY, u32 RTC_FREQUENCY, u32 MIN_SLEEP_TICKS>
+  u32 Functions<TICK_FREQUENCY, RTC_FREQUENCY, MIN_SLEEP_TICKS>::residue;
+
+  /**
+   * @brief Routes the RTC wakeup timer to the EXTI line 22 and enables its
+   *        interrupt.
+   * @note  The RTC must already be clocked and initialized.
+   */
+  template<u32 TICK_FREQUENCY, u32 RTC_FREQUENCY, u32 MIN_SLEEP_TICKS>
+  void Functions<TICK_FREQUENCY, RTC_FREQUENCY, MIN_SLEEP_TICKS>::initialize()
+  {
+    PWR::enableClock();
+
+    EXTI22::enableHardwareInterruptByRisingEdge();
+    EXTI22::clearPendingFlag();
+
+    NVIC::enableIrq<
+        nvic::irqn::RTC_WKUP
+    >();
+  }
+
+  /**
+   * @brief Clears the wakeup timer flags.
+   * @note  Must be called from the RTC_WKUP interrupt handler.
+   */
+  template<u32 TICK_FREQUENCY, u32 RTC_FREQUENCY, u32 MIN_SLEEP_TICKS>
+  void Functions<TICK_FREQUENCY, RTC_FREQUENCY, MIN_SLEEP_TICKS>::
+  onWakeupInterrupt()
+  {
+    RTC::clearWakeupTimerFlag();
+    EXTI22::clearPendingFlag();
+  }
+
+  /**
+   * @brief Idles the core until the next interrupt.
+   * @note  If no timer is due in the next MIN_SLEEP_TICKS, the core sleeps
+   *        in the STOP mode and true is returned, otherwise it just waits
+   *        for an interrupt (sleep mode).
+   * @note  Must be called from thread mode, with the interrupts enabled.
+   */
+  template<u32 TICK_FREQUENCY, u32 RTC_FREQUENCY, u32 MIN_SLEEP_TICKS>
+  bool Functions<TICK_FREQUENCY, RTC_FREQUENCY, MIN_SLEEP_TICKS>::enter()
+  {
+    // The interrupts stay pending until the clocks and the time base are
+    // restored, but they still wake the core up
+    critical::Section section;
+
+    u32 const counts = toSleepCounts(
+        Systime::getIdleTicks(MAX_SLEEP_TICKS),
+        MIN_SLEEP_TICKS,
+        TICK_FREQUENCY,
+        WAKEUP_FREQUENCY);
+
+    if (counts == 0) {
+      SCB::waitForInterrupt();
+      return false;
+    }
+
+    RTC::startWakeupTimer(rtc::cr::wucksel::RTC_DIV16, counts - 1);
+
+    u32 const before = RTC::getTimestamp();
+
+    STK::disableCounter();
+
+    PWR::enterStopMode(
+        pwr::cr::ldps::VOLTAGE_REGULATOR_IN_LOW_POWER_MODE_DURING_STOP_MODE);
+
+    DFS::restore();
+    RTC::waitForSynchronization();
+
+    u32 slept = counts;
+
+    if (!RTC::hasWakeupTimerExpired()) {
+      // Another interrupt woke the core up, measure with the calendar
+      u32 const frequency = RTC::getTimestampFrequency();
+      u32 const units = elapsed(
+          before,
+          RTC::getTimestamp(),
+          SECONDS_PER_DAY * frequency);
+
+      slept = toCounts(units, frequency, WAKEUP_FREQUENCY);
+
+      if (slept > counts) {
+        slept = counts;
+      }
+    }
+
+    RTC::stopWakeupTimer();
+    RTC::clearWakeupTimerFlag();
+    EXTI22::clearPendingFlag();
+
+    compensate(slept);
+
+    STK::enableCounter();
+
+    return true;
+  }
+
+  /**
+   * @brief Advances the time base by <counts> wakeup timer periods, the
+   *        fraction of a tick is carried to the next compensation.
+   */
+  template<u32 TICK_FREQUENCY, u32 RTC_FREQUENCY, u32 MIN_SLEEP_TICKS>
+  void Functions<TICK_FREQUENCY, RTC_FREQUENCY, MIN_SLEEP_TICKS>::compensate(
+      u32 const counts)
+  {
+    Systime::advance(
+        toTicks(counts, TICK_FREQUENCY, WAKEUP_FREQUENCY, residue));
+  }
+}  // namespace idle
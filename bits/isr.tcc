@@ -0,0 +1,129 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace isr {
+  template<nvic::irqn::E IRQ, typename T, void (T::*HANDLER)()>
+  T* Trampoline<IRQ, T, HANDLER>::object;
+
+  /**
+   * @brief Forwards the interrupt to the attached object.
+   */
+  template<nvic::irqn::E IRQ, typename T, void (T::*HANDLER)()>
+  void Trampoline<IRQ, T, HANDLER>::call()
+  {
+    (object->*HANDLER)();
+  }
+
+  /**
+   * @brief The vector table in SRAM.
+   */
+  Handler* Functions::table()
+  {
+    __attribute__ ((aligned(ALIGNMENT)))
+    static Handler vectors[VECTORS];
+
+    return vectors;
+  }
+
+  /**
+   * @brief The vector table that was active before the relocation.
+   */
+  Handler const*& Functions::original()
+  {
+    static Handler const* vectors = 0;
+
+    return vectors;
+  }
+
+  /**
+   * @brief Copies the active vector table (including the system exceptions)
+   *        to SRAM, and makes the copy the active table.
+   * @note  Call it before enabling the interrupts, or with the interrupts
+   *        disabled.
+   */
+  void Functions::relocate()
+  {
+    if (isRelocated()) {
+      return;
+    }
+
+    original() = reinterpret_cast<Handler const*>(SCB::getVectorTable());
+
+    for (u8 i = 0; i < VECTORS; i++) {
+      table()[i] = original()[i];
+    }
+
+    SCB::setVectorTable(table());
+  }
+
+  /**
+   * @brief Returns true if the SRAM vector table is active.
+   */
+  bool Functions::isRelocated()
+  {
+    return SCB::getVectorTable() == u32(reinterpret_cast<uintptr_t>(table()));
+  }
+
+  /**
+   * @brief Makes <handler> service the IRQ interrupt.
+   * @note  The vector table must be relocated first.
+   */
+  template<nvic::irqn::E IRQ>
+  void Functions::attach(Handler const handler)
+  {
+    static_assert(SYSTEM_VECTORS + IRQ < VECTORS,
+        "This IRQ is out of the vector table.");
+
+    table()[SYSTEM_VECTORS + IRQ] = handler;
+  }
+
+  /**
+   * @brief Makes object.HANDLER() service the IRQ interrupt.
+   * @note  The vector table must be relocated first.
+   */
+  template<nvic::irqn::E IRQ, typename T, void (T::*HANDLER)()>
+  void Functions::attach(T& object)
+  {
+    Trampoline<IRQ, T, HANDLER>::object = &object;
+
+    attach<IRQ>(&Trampoline<IRQ, T, HANDLER>::call);
+  }
+
+  /**
+   * @brief Restores the IRQ handler of the original vector table.
+   */
+  template<nvic::irqn::E IRQ>
+  void Functions::detach()
+  {
+    attach<IRQ>(original()[SYSTEM_VECTORS + IRQ]);
+  }
+
+  /**
+   * @brief Returns the handler currently servicing the IRQ interrupt.
+   */
+  template<nvic::irqn::E IRQ>
+  Handler Functions::getHandler()
+  {
+    return table()[SYSTEM_VECTORS + IRQ];
+  }
+}  // namespace isr
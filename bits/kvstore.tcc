@@ -0,0 +1,639 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace kvstore {
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u8 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::active;
+
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u32 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::sequence;
+
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u32 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::next;
+
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  typename Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::Slot
+  Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::index[SLOTS];
+
+  /**
+   * @brief Loads the active region, or formats the store if no region holds
+   *        a valid header.
+   * @note  Returns false if the store couldn't be formatted.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::initialize()
+  {
+    bool found = false;
+
+    for (u8 region = 0; region < REGIONS; region++) {
+      u32 const volatile* header =
+          reinterpret_cast<u32 const volatile*>(getRegionAddress(region));
+
+      // The sequence number may wrap around
+      if ((header[0] == MAGIC) &&
+          (!found || (s32(header[1] - sequence) > 0))) {
+        found = true;
+        active = region;
+        sequence = header[1];
+      }
+    }
+
+    if (found) {
+      load();
+      return true;
+    }
+
+    // Blank store, the compaction formats the first region
+    active = REGIONS - 1;
+    sequence = 0;
+    clear();
+
+    return compact();
+  }
+
+  /**
+   * @brief Returns true if <key> holds a value.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::has(u16 const key)
+  {
+    Slot const* const slot = find(key);
+
+    return (slot != 0) && (slot->key == key) && (slot->address != 0);
+  }
+
+  /**
+   * @brief Returns the size in bytes of the value of <key>, 0 if the key
+   *        doesn't hold a value.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u16 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::getSize(
+      u16 const key)
+  {
+    if (!has(key)) {
+      return 0;
+    }
+
+    return reinterpret_cast<Header const volatile*>(find(key)->address)->size;
+  }
+
+  /**
+   * @brief Copies up to <size> bytes of the value of <key> into <buffer>,
+   *        returns the number of bytes copied.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u16 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::get(
+      u16 const key,
+      void* const buffer,
+      u16 const size)
+  {
+    u16 length = getSize(key);
+    u8 const volatile* source;
+    u8* destination = static_cast<u8*>(buffer);
+
+    if (length > size) {
+      length = size;
+    }
+
+    if (length != 0) {
+      source = reinterpret_cast<u8 const volatile*>(
+          find(key)->address + ALIGNMENT);
+
+      for (u16 i = 0; i < length; i++) {
+        destination[i] = source[i];
+      }
+    }
+
+    return length;
+  }
+
+  /**
+   * @brief Stores <size> bytes of <data> as the value of <key>, returns
+   *        false on error.
+   * @note  The key 0xFFFF is reserved.
+   * @note  Compacts the store if the active region is full.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::set(
+      u16 const key,
+      void const* const data,
+      u16 const size)
+  {
+    if ((key == ERASED) || (size >= REMOVED)) {
+      return false;
+    }
+
+    return append(key, size, data);
+  }
+
+  /**
+   * @brief Removes the value of <key>, returns false on error.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::remove(
+      u16 const key)
+  {
+    if (!has(key)) {
+      return true;
+    }
+
+    return append(key, REMOVED, 0);
+  }
+
+  /**
+   * @brief Returns the number of bytes left in the active region.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u32 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::getFree()
+  {
+    return getRegionAddress(active) + REGION_SIZE - next;
+  }
+
+  /**
+   * @brief Returns true if less than a quarter of the active region is
+   *        free, and the compaction would reclaim at least another quarter.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::needsCompaction()
+  {
+    return (getFree() < REGION_SIZE / 4) && (getGarbage() >= REGION_SIZE / 4);
+  }
+
+  /**
+   * @brief Copies the live records into the next region and activates it,
+   *        returns false on error.
+   * @note  The active region is left untouched until the new one is
+   *        complete, a power cut during the compaction loses nothing.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::compact()
+  {
+    u8 const target = (active + 1) % REGIONS;
+    u32 address = getRegionAddress(target) + ALIGNMENT;
+    bool success;
+
+    DRIVER::unlock();
+
+    success = erase(target);
+
+    for (u16 i = 0; success && (i < SLOTS); i++) {
+      if ((index[i].key != ERASED) && (index[i].address != 0)) {
+        u32 const size = getRecordSize(index[i].address);
+
+        success = DRIVER::program(
+            address,
+            reinterpret_cast<void const*>(index[i].address),
+            size);
+        address += size;
+      }
+    }
+
+    if (success) {
+      // The header activates the region, it goes last
+      u32 const header[2] = { MAGIC, sequence + 1 };
+
+      success = DRIVER::program(getRegionAddress(target), header, ALIGNMENT);
+    }
+
+    DRIVER::lock();
+
+    if (!success) {
+      return false;
+    }
+
+    active = target;
+    sequence++;
+    load();
+
+    return true;
+  }
+
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  constexpr u32 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::align(
+      u32 const size)
+  {
+    return (size + ALIGNMENT - 1) & ~u32(ALIGNMENT - 1);
+  }
+
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  constexpr u32
+  Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::getRegionAddress(
+      u8 const region)
+  {
+    return ADDRESS + region * REGION_SIZE;
+  }
+
+  /**
+   * @brief FNV-1a hash of the key, the size and the data of a record.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u32 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::getChecksum(
+      u16 const key,
+      u16 const size,
+      u8 const* data)
+  {
+    u8 const head[4] = { u8(key), u8(key >> 8), u8(size), u8(size >> 8) };
+    u16 const length = size == REMOVED ? 0 : size;
+    u32 hash = 2166136261u;
+
+    for (u8 i = 0; i < sizeof(head); i++) {
+      hash = (hash ^ head[i]) * 16777619u;
+    }
+
+    for (u16 i = 0; i < length; i++) {
+      hash = (hash ^ data[i]) * 16777619u;
+    }
+
+    return hash;
+  }
+
+  /**
+   * @brief Returns the size of the record stored at <address>, including
+   *        its header, padding and commit words.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u32 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::getRecordSize(
+      u32 const address)
+  {
+    u16 const size = reinterpret_cast<Header const volatile*>(address)->size;
+
+    return 2 * ALIGNMENT + align(size == REMOVED ? 0 : size);
+  }
+
+  /**
+   * @brief Returns the number of bytes of the active region taken by
+   *        superseded, removed or torn records.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  u32 Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::getGarbage()
+  {
+    u32 garbage = next - getRegionAddress(active) - ALIGNMENT;
+
+    for (u16 i = 0; i < SLOTS; i++) {
+      if ((index[i].key != ERASED) && (index[i].address != 0)) {
+        garbage -= getRecordSize(index[i].address);
+      }
+    }
+
+    return garbage;
+  }
+
+  /**
+   * @brief Returns the slot of <key>, or the empty slot where it would be
+   *        inserted, or 0 if the index is full.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  typename Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::Slot*
+  Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::find(u16 const key)
+  {
+    // Fibonacci hashing, the upper bits are the best mixed
+    u16 i = (key * 2654435769u) >> 16;
+
+    for (u16 probes = 0; probes < SLOTS; probes++) {
+      i &= SLOTS - 1;
+
+      if ((index[i].key == key) || (index[i].key == ERASED)) {
+        return &index[i];
+      }
+
+      i++;
+    }
+
+    return 0;
+  }
+
+  /**
+   * @brief Empties the index.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  void Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::clear()
+  {
+    for (u16 i = 0; i < SLOTS; i++) {
+      index[i].key = ERASED;
+      index[i].address = 0;
+    }
+  }
+
+  /**
+   * @brief Erases the sectors/pages of <region>.
+   * @note  The flash must be unlocked.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::erase(
+      u8 const region)
+  {
+    u32 const end = getRegionAddress(region) + REGION_SIZE;
+
+#ifdef STM32F1XX
+    for (u32 page = getRegionAddress(region); page < end;
+        page += flash::PAGE_SIZE) {
+      if (!DRIVER::erasePage(page)) {
+        return false;
+      }
+    }
+#else // STM32F1XX
+    for (u32 address = getRegionAddress(region); address < end;
+        address += DRIVER::getSectorSize(DRIVER::getSector(address))) {
+      if (!DRIVER::eraseSector(DRIVER::getSector(address))) {
+        return false;
+      }
+    }
+#endif // STM32F1XX
+
+    return true;
+  }
+
+  /**
+   * @brief Appends a record to the active region and indexes it.
+   * @note  A record that fails to program still takes its space.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  bool Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::append(
+      u16 const key,
+      u16 const size,
+      void const* const data)
+  {
+    u8 const* const bytes = static_cast<u8 const*>(data);
+    u32 const length = size == REMOVED ? 0 : size;
+    u32 const whole = length & ~u32(ALIGNMENT - 1);
+    u32 const record = 2 * ALIGNMENT + align(length);
+    Slot* slot = find(key);
+    Header header;
+    u32 commit[2];
+    u32 address;
+    bool success;
+
+    if ((slot == 0) || (record > REGION_SIZE - ALIGNMENT)) {
+      return false;
+    }
+
+    if (record > getFree()) {
+      if (!compact()) {
+        return false;
+      }
+
+      slot = find(key);
+
+      if ((slot == 0) || (record > getFree())) {
+        return false;
+      }
+    }
+
+    header.key = key;
+    header.size = size;
+    header.checksum = getChecksum(key, size, bytes);
+    commit[0] = COMMITTED;
+    commit[1] = header.checksum;
+
+    address = next;
+    next += record;
+
+    DRIVER::unlock();
+
+    success = DRIVER::program(address, &header, ALIGNMENT);
+
+    if (success && (whole != 0)) {
+      success = DRIVER::program(address + ALIGNMENT, bytes, whole);
+    }
+
+    if (success && (whole != length)) {
+      u8 tail[ALIGNMENT];
+
+      for (u8 i = 0; i < ALIGNMENT; i++) {
+        tail[i] = whole + i < length ? bytes[whole + i] : 0xFF;
+      }
+
+      success = DRIVER::program(address + ALIGNMENT + whole, tail, ALIGNMENT);
+    }
+
+    // The commit words make the record valid, they go last
+    if (success) {
+      success = DRIVER::program(
+          address + ALIGNMENT + align(length),
+          commit,
+          ALIGNMENT);
+    }
+
+    DRIVER::lock();
+
+    if (!success) {
+      return false;
+    }
+
+    slot->key = key;
+    slot->address = size == REMOVED ? 0 : address;
+
+    return true;
+  }
+
+  /**
+   * @brief Rebuilds the index from the log of the active region.
+   */
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER
+  >
+  void Store<ADDRESS, REGION_SIZE, REGIONS, SLOTS, DRIVER>::load()
+  {
+    u32 const end = getRegionAddress(active) + REGION_SIZE;
+    u32 address = getRegionAddress(active) + ALIGNMENT;
+
+    clear();
+
+    while (address + 2 * ALIGNMENT <= end) {
+      Header const volatile& header =
+          *reinterpret_cast<Header const volatile*>(address);
+      u16 const key = header.key;
+      u16 const size = header.size;
+      u32 const checksum = header.checksum;
+      u32 const length = size == REMOVED ? 0 : size;
+      u32 const volatile* commit;
+
+      // End of the log
+      if ((key == ERASED) && (size == ERASED) && (checksum == 0xFFFFFFFF)) {
+        break;
+      }
+
+      // Torn header, nothing after it can be trusted
+      if ((key == ERASED) || (size == ERASED) ||
+          (2 * ALIGNMENT + align(length) > end - address)) {
+        address = end;
+        break;
+      }
+
+      commit = reinterpret_cast<u32 const volatile*>(
+          address + ALIGNMENT + align(length));
+
+      if ((commit[0] == COMMITTED) && (commit[1] == checksum) &&
+          (getChecksum(key, size,
+              reinterpret_cast<u8 const*>(address + ALIGNMENT)) ==
+              checksum)) {
+        Slot* const slot = find(key);
+
+        if (slot != 0) {
+          slot->key = key;
+          slot->address = size == REMOVED ? 0 : address;
+        }
+      }
+
+      address += 2 * ALIGNMENT + align(length);
+    }
+
+    next = address;
+  }
+}  // namespace kvstore
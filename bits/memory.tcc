@@ -0,0 +1,78 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+extern "C" {
+  extern u32 __ramfunc_load__;
+  extern u32 __ramfunc_start__;
+  extern u32 __ramfunc_end__;
+#ifdef STM32F4XX
+  extern u32 __ccmram_load__;
+  extern u32 __ccmram_start__;
+  extern u32 __ccmram_end__;
+#endif // STM32F4XX
+  extern u32 __dmaram_start__;
+  extern u32 __dmaram_end__;
+}
+
+namespace memory {
+  /**
+   * @brief Copies the .ramfunc (and .ccmram) sections from flash and zeroes
+   *        the .dmaram section.
+   * @note  Must be executed from flash, before any placed object is used.
+   */
+  void Functions::initializeSections()
+  {
+    u32 const* source;
+    u32* destination;
+
+    source = &__ramfunc_load__;
+    for (destination = &__ramfunc_start__;
+        destination < &__ramfunc_end__;) {
+      *destination++ = *source++;
+    }
+
+#ifdef STM32F4XX
+    source = &__ccmram_load__;
+    for (destination = &__ccmram_start__;
+        destination < &__ccmram_end__;) {
+      *destination++ = *source++;
+    }
+#endif // STM32F4XX
+
+    for (destination = &__dmaram_start__;
+        destination < &__dmaram_end__;) {
+      *destination++ = 0;
+    }
+  }
+
+#ifndef STM32F1XX
+  /**
+   * @brief Returns true if the DMA controllers can access <address>.
+   */
+  bool Functions::isDmaReachable(void const volatile* const address)
+  {
+    return memory::isDmaReachable(
+        u32(reinterpret_cast<uintptr_t>(address)));
+  }
+#endif // !STM32F1XX
+}  // namespace memory
@@ -22,5 +22,75 @@
 #pragma once
 
 namespace mpu {
-// TODO MPU function implementations.
+  /**
+   * @brief Enables the MPU.
+   * @note  With the default map enabled, privileged accesses outside the
+   *        configured regions follow the default memory map, the regions then
+   *        only need to describe the exceptions to it (e.g. a stack guard).
+   */
+  void Functions::enable(
+      control::privdefena::States PRIVDEFENA,
+      control::hfnmiena::States HFNMIENA)
+  {
+    _MPU->CR = control::enable::MPU_ENABLED + PRIVDEFENA + HFNMIENA;
+
+    asm volatile ("dsb");
+    asm volatile ("isb");
+  }
+
+  /**
+   * @brief Disables the MPU, waits for the outstanding accesses first.
+   */
+  void Functions::disable()
+  {
+    asm volatile ("dmb");
+
+    _MPU->CR = control::enable::MPU_DISABLED;
+  }
+
+  /**
+   * @brief Returns the number of implemented regions, 0 if there's no MPU.
+   */
+  u8 Functions::getRegionCount()
+  {
+    return (_MPU->TYPER & typer::dregion::MASK) >> typer::dregion::POSITION;
+  }
+
+  /**
+   * @brief Configures and enables <region>.
+   * @note  <address> must be aligned to the region size. Each bit of
+   *        <subregions> disables one eighth of the region (256 bytes
+   *        regions and above). Higher numbered regions take precedence where
+   *        regions overlap.
+   */
+  void Functions::configureRegion(
+      u8 const region,
+      u32 const address,
+      rasr::size::States SIZE,
+      rasr::ap::States AP,
+      rasr::xn::States XN,
+      rasr::attributes::States ATTRIBUTES,
+      u8 const subregions)
+  {
+    _MPU->RNR = region;
+    _MPU->RASR = rasr::enable::REGION_DISABLED;
+    _MPU->RBAR = address & rbar::addr::MASK;
+    _MPU->RASR = rasr::enable::REGION_ENABLED + SIZE + AP + XN + ATTRIBUTES +
+        (u32(subregions) << rasr::srd::POSITION);
+
+    asm volatile ("dsb");
+    asm volatile ("isb");
+  }
+
+  /**
+   * @brief Disables <region>.
+   */
+  void Functions::disableRegion(u8 const region)
+  {
+    _MPU->RNR = region;
+    _MPU->RASR = rasr::enable::REGION_DISABLED;
+
+    asm volatile ("dsb");
+    asm volatile ("isb");
+  }
 }  // namespace mpu
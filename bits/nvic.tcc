@@ -56,4 +56,126 @@ namespace nvic {
     reinterpret_cast<Registers*>(ADDRESS)->IPR[I >> 2] |=
         P << (8 * (I % 4));
   }
+
+  template<typename...>
+  struct List {
+  };
+
+  /**
+   * Looks up the preemption priority declared for the IRQ I.
+   */
+  template<irqn::E I, typename... E>
+  struct Find;
+
+  template<irqn::E I>
+  struct Find<I> {
+      enum {
+        COUNT = 0,
+        PREEMPTION = 0
+      };
+  };
+
+  template<irqn::E I, typename H, typename... T>
+  struct Find<I, H, T...> {
+      enum {
+        MATCH = (!H::IS_DEPENDENCY) && (int(H::IRQN) == int(I)),
+        COUNT = MATCH + Find<I, T...>::COUNT,
+        PREEMPTION = MATCH ?
+            int(H::PREEMPTION_LEVEL) :
+            int(Find<I, T...>::PREEMPTION)
+      };
+  };
+
+  /**
+   * Counts the IRQs declared with the same preemption and subpriority.
+   */
+  template<u8 P, u8 S, typename... E>
+  struct CountLevel;
+
+  template<u8 P, u8 S>
+  struct CountLevel<P, S> {
+      enum {
+        COUNT = 0
+      };
+  };
+
+  template<u8 P, u8 S, typename H, typename... T>
+  struct CountLevel<P, S, H, T...> {
+      enum {
+        COUNT = ((!H::IS_DEPENDENCY) &&
+            (H::PREEMPTION_LEVEL == P) &&
+            (H::SUBPRIORITY_LEVEL == S)) +
+            CountLevel<P, S, T...>::COUNT
+      };
+  };
+
+  /**
+   * Checks every entry of the table, and programs its priority.
+   */
+  template<u8 BITS, typename ALL, typename... E>
+  struct Program;
+
+  template<u8 BITS, typename... ALL>
+  struct Program<BITS, List<ALL...> > {
+      static inline void write()
+      {
+      }
+  };
+
+  template<u8 BITS, typename... ALL, typename H, typename... T>
+  struct Program<BITS, List<ALL...>, H, T...> {
+      static_assert(H::IS_DEPENDENCY ||
+          (H::PREEMPTION_LEVEL < (1 << BITS)),
+          "The preemption priority doesn't fit in the preemption bits.");
+      static_assert(H::IS_DEPENDENCY ||
+          (H::SUBPRIORITY_LEVEL < (1 << (PRIORITY_BITS - BITS))),
+          "The subpriority doesn't fit in the subpriority bits.");
+      static_assert(H::IS_DEPENDENCY ||
+          (Find<irqn::E(H::IRQN), ALL...>::COUNT == 1),
+          "An IRQ has been declared more than once.");
+      static_assert(H::IS_DEPENDENCY ||
+          (CountLevel<
+              H::PREEMPTION_LEVEL,
+              H::SUBPRIORITY_LEVEL,
+              ALL...
+          >::COUNT == 1),
+          "Two IRQs share the same priority level.");
+      static_assert(!H::IS_DEPENDENCY ||
+          ((Find<irqn::E(H::IRQN), ALL...>::COUNT == 1) &&
+              (Find<irqn::E(H::DEPENDENT), ALL...>::COUNT == 1)),
+          "Both IRQs of a Precedes relation must have a declared priority.");
+      // The subpriority only orders pending IRQs, it doesn't preempt
+      static_assert(!H::IS_DEPENDENCY ||
+          (int(Find<irqn::E(H::IRQN), ALL...>::PREEMPTION) <
+              int(Find<irqn::E(H::DEPENDENT), ALL...>::PREEMPTION)),
+          "An ISR can't preempt the ISR that depends on it.");
+
+      static inline void write()
+      {
+        if (!H::IS_DEPENDENCY) {
+          reinterpret_cast<u8 volatile*>(
+              reinterpret_cast<Registers*>(ADDRESS)->IPR)[H::IRQN] =
+              ((H::PREEMPTION_LEVEL << (PRIORITY_BITS - BITS)) +
+                  H::SUBPRIORITY_LEVEL) << (8 - PRIORITY_BITS);
+        }
+
+        Program<BITS, List<ALL...>, T...>::write();
+      }
+  };
+
+  /**
+   * @brief Programs the priority grouping and every declared priority.
+   * @note  Call it once at init, before enabling the IRQs.
+   */
+  template<u8 PREEMPTION_BITS, typename... ENTRIES>
+  void PriorityTable<PREEMPTION_BITS, ENTRIES...>::apply()
+  {
+    static_assert(PREEMPTION_BITS <= PRIORITY_BITS,
+        "There are only 4 priority bits.");
+
+    SCB::setPriorityGrouping(scb::aircr::prigroup::States(
+        (7 - PREEMPTION_BITS) << scb::aircr::prigroup::POSITION));
+
+    Program<PREEMPTION_BITS, List<ENTRIES...>, ENTRIES...>::write();
+  }
 }  // namespace nvic
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace profile {
+  template<typename COUNTER, u8 SLOTS>
+  Record Profiler<COUNTER, SLOTS>::records[SLOTS];
+
+  /**
+   * @brief Records the moment the IRQ is requested, e.g. when a DMA
+   *        transfer is started.
+   */
+  template<typename COUNTER, u8 SLOTS>
+  template<nvic::irqn::E IRQ>
+  void Profiler<COUNTER, SLOTS>::markRequest()
+  {
+    static_assert(IRQ < SLOTS,
+        "This IRQ doesn't fit in the profiler table.");
+
+    records[IRQ].request = COUNTER::getCycleCount();
+    records[IRQ].pending = true;
+  }
+
+  /**
+   * @brief Records the entry of the IRQ handler.
+   */
+  template<typename COUNTER, u8 SLOTS>
+  template<nvic::irqn::E IRQ>
+  void Profiler<COUNTER, SLOTS>::enter()
+  {
+    static_assert(IRQ < SLOTS,
+        "This IRQ doesn't fit in the profiler table.");
+
+    Record& record = records[IRQ];
+
+    record.entry = COUNTER::getCycleCount();
+
+    // Any counter value is a valid timestamp, 0 included
+    if (record.pending) {
+      record.latency = record.entry - record.request;
+      record.pending = false;
+    }
+  }
+
+  /**
+   * @brief Records the exit of the IRQ handler.
+   */
+  template<typename COUNTER, u8 SLOTS>
+  template<nvic::irqn::E IRQ>
+  void Profiler<COUNTER, SLOTS>::exit()
+  {
+    Record& record = records[IRQ];
+
+    record.duration = COUNTER::getCycleCount() - record.entry;
+
+    if ((record.count == 0) || (record.duration < record.minimum)) {
+      record.minimum = record.duration;
+    }
+
+    if (record.duration > record.maximum) {
+      record.maximum = record.duration;
+    }
+
+    record.count++;
+  }
+
+  /**
+   * @brief Returns the record of the IRQ number <irq>.
+   */
+  template<typename COUNTER, u8 SLOTS>
+  Record const& Profiler<COUNTER, SLOTS>::getRecord(u8 const irq)
+  {
+    return records[irq];
+  }
+
+  /**
+   * @brief Clears every record.
+   */
+  template<typename COUNTER, u8 SLOTS>
+  void Profiler<COUNTER, SLOTS>::clear()
+  {
+    for (u8 i = 0; i < SLOTS; i++) {
+      records[i] = Record();
+    }
+  }
+
+  /**
+   * @brief Sends the table, as text, through OUTPUT (e.g. USART1).
+   * @note  One line per executed IRQ:
+   *        "irq count duration minimum maximum latency".
+   * @note  Busy waits on OUTPUT::canSendDataYet().
+   */
+  template<typename COUNTER, u8 SLOTS>
+  template<typename OUTPUT>
+  void Profiler<COUNTER, SLOTS>::dump()
+  {
+    typedef text::Writer<OUTPUT> TEXT;
+
+    TEXT::print("irq count duration minimum maximum latency\r\n");
+
+    for (u8 i = 0; i < SLOTS; i++) {
+      Record const record = records[i];
+
+      if (record.count == 0) {
+        continue;
+      }
+
+      TEXT::print(i);
+      TEXT::print(" ");
+      TEXT::print(record.count);
+      TEXT::print(" ");
+      TEXT::print(record.duration);
+      TEXT::print(" ");
+      TEXT::print(record.minimum);
+      TEXT::print(" ");
+      TEXT::print(record.maximum);
+      TEXT::print(" ");
+      TEXT::print(record.latency);
+      TEXT::print("\r\n");
+    }
+  }
+}  // namespace profile
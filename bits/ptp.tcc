@@ -0,0 +1,198 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace ptp {
+  Servo::Servo(
+      u32 const stepThreshold,
+      s32 const maxFrequency,
+      s32 const kp,
+      s32 const ki) :
+      stepThreshold(stepThreshold), maxFrequency(maxFrequency), kp(kp),
+      ki(ki), integral(0), frequency(0), started(false)
+  {
+  }
+
+  /**
+   * @brief Feeds the <offset> of the local clock to the master, in
+   *        nanoseconds, and returns the correction to apply.
+   * @note  The first sample, and any sample beyond the step threshold,
+   *        request a step, the frequency correction is then kept.
+   */
+  Servo::Action Servo::sample(s64 const offset)
+  {
+    s64 const limit = s64(maxFrequency) * 1024;
+    bool const step =
+        !started || (offset > stepThreshold) || (-offset > stepThreshold);
+
+    started = true;
+
+    if (step) {
+      // The offset is gone after the step, only the rate error remains
+      return STEP;
+    }
+
+    // Clamped, so a long outage doesn't wind the integral up
+    integral -= s64(ki) * offset;
+
+    if (integral > limit) {
+      integral = limit;
+    } else if (integral < -limit) {
+      integral = -limit;
+    }
+
+    s64 correction = (integral - s64(kp) * offset) / 1024;
+
+    if (correction > maxFrequency) {
+      correction = maxFrequency;
+    } else if (correction < -maxFrequency) {
+      correction = -maxFrequency;
+    }
+
+    frequency = correction;
+
+    return ADJUST;
+  }
+
+  /**
+   * @brief Returns the frequency correction, in parts per billion.
+   */
+  s32 Servo::getFrequency() const
+  {
+    return frequency;
+  }
+
+  /**
+   * @brief Forgets the servo history, the next sample steps the clock.
+   */
+  void Servo::reset()
+  {
+    integral = 0;
+    frequency = 0;
+    started = false;
+  }
+
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  u64 Discipline<SYSTIME, CLOCK, LOCK>::referenceMicroseconds;
+
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  u64 Discipline<SYSTIME, CLOCK, LOCK>::referenceNanoseconds;
+
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  s32 Discipline<SYSTIME, CLOCK, LOCK>::rate;
+
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  u8 Discipline<SYSTIME, CLOCK, LOCK>::samples;
+
+  /**
+   * @brief Reads both clocks at once, and updates the reference point and
+   *        the rate.
+   * @note  The rate is averaged over a few samples, call it at a steady
+   *        pace, e.g. every second.
+   */
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  void Discipline<SYSTIME, CLOCK, LOCK>::sample()
+  {
+    u64 microseconds, nanoseconds;
+
+    {
+      LOCK lock;
+
+      microseconds = SYSTIME::getMicroseconds();
+      nanoseconds = CLOCK::getNanoseconds();
+    }
+
+    if (samples != 0) {
+      s64 const elapsed = microseconds - referenceMicroseconds;
+
+      if (elapsed > 0) {
+        s64 const drift =
+            s64(nanoseconds - referenceNanoseconds) - elapsed * 1000;
+        s32 const measured = drift * 1000000 / elapsed;
+
+        if (samples == 1) {
+          rate = measured;
+        } else {
+          rate += (measured - rate) / 4;
+        }
+      }
+    }
+
+    if (samples < 2) {
+      samples++;
+    }
+
+    referenceMicroseconds = microseconds;
+    referenceNanoseconds = nanoseconds;
+  }
+
+  /**
+   * @brief Drops the reference point, e.g. after the CLOCK was stepped.
+   */
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  void Discipline<SYSTIME, CLOCK, LOCK>::reset()
+  {
+    samples = 0;
+    rate = 0;
+  }
+
+  /**
+   * @brief Returns true once the rate has been measured.
+   */
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  bool Discipline<SYSTIME, CLOCK, LOCK>::isSynchronized()
+  {
+    return samples >= 2;
+  }
+
+  /**
+   * @brief Returns how fast the CLOCK runs relative to the SYSTIME, in parts
+   *        per billion.
+   */
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  s32 Discipline<SYSTIME, CLOCK, LOCK>::getRate()
+  {
+    return rate;
+  }
+
+  /**
+   * @brief Converts a SYSTIME timestamp, in microseconds, to CLOCK
+   *        nanoseconds.
+   * @note  Only meaningful once isSynchronized() returns true.
+   */
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  u64 Discipline<SYSTIME, CLOCK, LOCK>::convert(u64 const microseconds)
+  {
+    s64 const elapsed = microseconds - referenceMicroseconds;
+
+    return referenceNanoseconds + elapsed * 1000 + elapsed * rate / 1000000;
+  }
+
+  /**
+   * @brief Returns the current CLOCK time, in nanoseconds, from the SYSTIME.
+   */
+  template<typename SYSTIME, typename CLOCK, typename LOCK>
+  u64 Discipline<SYSTIME, CLOCK, LOCK>::getNanoseconds()
+  {
+    return convert(SYSTIME::getMicroseconds());
+  }
+}  // namespace ptp
@@ -23,6 +23,7 @@
 
 #include "../include/bitband.hpp"
 #include "../include/peripheral/rcc.hpp"
+#include "../include/core/scb.hpp"
 
 namespace pwr {
   void Functions::enableClock()
@@ -50,4 +51,84 @@ namespace pwr {
         cr::dbp::POSITION
     >()) = 0;
   }
+
+  /**
+   * @brief Stops all the clocks of the 1.2 V domain until an EXTI line
+   *        interrupt (or event) wakes the core up.
+   * @note  The core wakes up running from the HSI oscillator, the PLL and
+   *        the HSE must be restarted (see DFS::restore()).
+   * @note  The PWR clock must be enabled.
+   */
+  void Functions::enterStopMode(cr::ldps::States LPDS)
+  {
+    PWR_REGS->CR = (PWR_REGS->CR & ~(cr::pdds::MASK + cr::ldps::MASK)) +
+        cr::pdds::ENTER_STOP_MODE_DURING_CPU_DEEPSLEEP + LPDS +
+        cr::cwuf::CLEARS_THE_WAKEUP_FLAG;
+
+    SCB::setSleepMode(scb::scr::sleepdeep::DEEP_SLEEP);
+    SCB::waitForInterrupt();
+    SCB::setSleepMode(scb::scr::sleepdeep::SLEEP);
+  }
+#ifndef STM32F1XX
+
+  /**
+   * @brief Keeps the backup SRAM content in standby and VBAT modes.
+   * @note  The backup domain write access must be enabled.
+   */
+  void Functions::enableBackupRegulator()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        ADDRESS + csr::OFFSET,
+        csr::bre::POSITION
+    >()) = 1;
+
+    while (!*(bool volatile*) (bitband::peripheral<
+        ADDRESS + csr::OFFSET,
+        csr::brr::POSITION
+    >())) {
+    }
+  }
+
+  void Functions::disableBackupRegulator()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        ADDRESS + csr::OFFSET,
+        csr::bre::POSITION
+    >()) = 0;
+  }
+#endif // !STM32F1XX
+#ifdef STM32F4XX
+
+  /**
+   * @brief Selects the main regulator output voltage.
+   * @note  Scale 2 limits the system clock to 144 MHz.
+   * @note  The PWR clock must be enabled.
+   */
+  void Functions::setVoltageScaling(cr::vos::States VOS)
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        ADDRESS + cr::OFFSET,
+        cr::vos::POSITION
+    >()) = VOS >> cr::vos::POSITION;
+  }
+
+  /**
+   * @brief Returns the selected regulator output voltage.
+   */
+  cr::vos::States Functions::getVoltageScaling()
+  {
+    return cr::vos::States(PWR_REGS->CR & cr::vos::MASK);
+  }
+
+  /**
+   * @brief Returns true if the regulator has reached the selected voltage.
+   */
+  bool Functions::isVoltageScalingReady()
+  {
+    return *(bool volatile*) (bitband::peripheral<
+        ADDRESS + csr::OFFSET,
+        csr::vosrdy::POSITION
+    >());
+  }
+#endif // STM32F4XX
 }  // namespace pwr
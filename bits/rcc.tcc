@@ -815,6 +815,27 @@ namespace rcc {
             ;
   }
 
+  /**
+   * @brief Configures the main PLL at run time.
+   * @note  The PLL circuitry must be off during configuration!
+   * @note  The arguments aren't checked, see pll::solve().
+   */
+  void Functions::configurePll(
+      pllcfgr::pllsrc::States PLLSRC,
+      u8 const m,
+      u16 const n,
+      u8 const p,
+      u8 const q)
+  {
+    RCC_REGS->PLLCFGR =
+        (m << pllcfgr::pllm::POSITION) +
+            (n << pllcfgr::plln::POSITION) +
+            (((p / 2) - 1) << pllcfgr::pllp::POSITION) +
+            (q << pllcfgr::pllq::POSITION) +
+            PLLSRC
+            ;
+  }
+
   /**
    * @brief Configures the various I2S PLL prescalers and multipliers.
    * @note  The PLL circuitry must be off during configuration!
@@ -871,6 +892,26 @@ namespace rcc {
             ;
   }
 
+  /**
+   * @brief Configures the AHB and APB bus prescalers at run time.
+   * @note  Arguments are register values, the RTC prescaler isn't modified.
+   */
+  void Functions::configurePrescalers(
+      u8 const hpre,
+      u8 const ppre1,
+      u8 const ppre2)
+  {
+    RCC_REGS->CFGR =
+        (RCC_REGS->CFGR &
+            ~(cfgr::hpre::MASK +
+                cfgr::ppre1::MASK +
+                cfgr::ppre2::MASK)) +
+            (hpre << cfgr::hpre::POSITION) +
+            (ppre1 << cfgr::ppre1::POSITION) +
+            (ppre2 << cfgr::ppre2::POSITION)
+            ;
+  }
+
   template<
       cfgr::mco1::States MCO1,
       cfgr::mco2::States MCO2,
@@ -83,12 +83,13 @@ namespace rng {
 
   /**
    * @brief Gets a random number.
-   * @note  User should check if the random number is valid first.
+   * @note  User should check if the random number is valid first, a new
+   *        value is ready about 40 RNG clock cycles after the previous read.
    */
   template<typename T>
   T Functions::getValue()
   {
-    return *(T*) (ADDRESS + dr::OFFSET);
+    return *(T volatile*) (ADDRESS + dr::OFFSET);
   }
 
   /**
@@ -105,7 +106,7 @@ namespace rng {
    */
   bool Functions::isSeedValid()
   {
-    return (RNG_REGS->SR & sr::secs::SEED_OK);
+    return (RNG_REGS->SR & sr::secs::MASK) == sr::secs::SEED_OK;
   }
 
   /**
@@ -113,7 +114,25 @@ namespace rng {
    */
   bool Functions::isClockValid()
   {
-    return (RNG_REGS->SR & sr::cecs::CLOCK_OK);
+    return (RNG_REGS->SR & sr::cecs::MASK) == sr::cecs::CLOCK_OK;
+  }
+
+  /**
+   * @brief Returns true if a seed error was detected since the flag was
+   *        cleared.
+   */
+  bool Functions::hasSeedErrorOccurred()
+  {
+    return RNG_REGS->SR & sr::seis::MASK;
+  }
+
+  /**
+   * @brief Returns true if a clock error was detected since the flag was
+   *        cleared.
+   */
+  bool Functions::hasClockErrorOccurred()
+  {
+    return RNG_REGS->SR & sr::ceis::MASK;
   }
 
   /**
@@ -126,7 +145,7 @@ namespace rng {
   }
 
   /**
-   * @brief Clears the seed error flag.
+   * @brief Clears the clock error flag.
    */
   void Functions::clearClockErrorFlag()
   {
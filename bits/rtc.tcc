@@ -450,4 +450,113 @@ namespace rtc {
 
 		resume();
 	}
+
+	/**
+	 * @brief Starts the wakeup timer, it expires every <reload> + 1 periods
+	 * 		  of the clock selected by <WUCKSEL>.
+	 * @note  The wakeup timer interrupt is enabled, it's routed to the
+	 * 		  EXTI line 22 and it can wake the core up from the STOP mode.
+	 */
+	void Functions::startWakeupTimer(cr::wucksel::Selections WUCKSEL, u16 const reload)
+	{
+		wpunlock();
+
+		RTC_REGS->CR &= ~(cr::wute::MASK | cr::rtcirq::WAKEUP_TIMER_MASK);
+
+		/* Wait until the wakeup timer can be configured */
+		while (getStatus<isr::Flags::WAKEUPTIMER_WRITE_FLAG>() == false) {
+		}
+
+		RTC_REGS->WUTR = reload;
+		RTC_REGS->CR = (RTC_REGS->CR & ~cr::wucksel::MASK) | WUCKSEL;
+
+		clearStatusFlag<isr::Flags::WAKEUP_TIMER_FLAG>();
+
+		RTC_REGS->CR |= cr::wute::MASK | cr::rtcirq::WAKEUP_TIMER_MASK;
+
+		wplock();
+	}
+
+	/**
+	 * @brief Stops the wakeup timer and disables its interrupt.
+	 */
+	void Functions::stopWakeupTimer()
+	{
+		wpunlock();
+
+		RTC_REGS->CR &= ~(cr::wute::MASK | cr::rtcirq::WAKEUP_TIMER_MASK);
+
+		wplock();
+	}
+
+	/**
+	 * @brief Returns true if the wakeup timer has expired.
+	 */
+	bool Functions::hasWakeupTimerExpired()
+	{
+		return getStatus<isr::Flags::WAKEUP_TIMER_FLAG>();
+	}
+
+	/**
+	 * @brief Clears the wakeup timer flag.
+	 */
+	void Functions::clearWakeupTimerFlag()
+	{
+		clearStatusFlag<isr::Flags::WAKEUP_TIMER_FLAG>();
+	}
+
+	/**
+	 * @brief Waits until the calendar shadow registers are updated.
+	 * @note  Must be called after a wake up from the STOP mode, before
+	 * 		  reading the calendar.
+	 */
+	void Functions::waitForSynchronization()
+	{
+		wpunlock();
+
+		syncwait();
+
+		wplock();
+	}
+
+	/**
+	 * @brief Returns the time of the day in 1 / getTimestampFrequency()
+	 * 		  seconds units.
+	 * @note  Reading SSR freezes the shadow registers until DR is read, so
+	 * 		  the sub second and the time values are coherent.
+	 */
+	u32 Functions::getTimestamp()
+	{
+#ifdef STM32F4XX
+		u32 const ssr = RTC_REGS->SSR & ssr::ss::MASK;
+#else
+		// The F2 RTC has no sub second register
+		u32 const ssr = 0;
+#endif // STM32F4XX
+		u32 const tr = RTC_REGS->TR & tr::TR_MASK;
+		u32 const units = getTimestampFrequency();
+
+		(void) RTC_REGS->DR;
+
+		u32 const seconds =
+				bcd2bin((tr & (tr::hu::MASK|tr::ht::MASK)) >> tr::hu::POSITION) * 3600 +
+				bcd2bin((tr & (tr::mnu::MASK|tr::mnt::MASK)) >> tr::mnu::POSITION) * 60 +
+				bcd2bin((tr & (tr::su::MASK|tr::st::MASK)) >> tr::su::POSITION);
+
+		return seconds * units + (units - 1 - ssr);
+	}
+
+	/**
+	 * @brief Returns the number of timestamp units per second, this is the
+	 * 		  synchronous prescaler division factor.
+	 * @note  1 on F2 devices, which lack the sub second register.
+	 */
+	u32 Functions::getTimestampFrequency()
+	{
+#ifdef STM32F4XX
+		return ((RTC_REGS->PRER & prer::predivs::MASK) >> prer::predivs::POSITION) + 1;
+#else
+		return 1;
+#endif // STM32F4XX
+	}
 }// namespace rtc
@@ -22,5 +22,190 @@
 #pragma once
 
 namespace scb {
-  // TODO SCB function implementations
+  /**
+   * @brief Returns true if the SysTick exception is pending.
+   */
+  bool Functions::isSysTickPending()
+  {
+    return _SCB->ICSR & icsr::pendstset::MASK;
+  }
+
+  /**
+   * @brief Requests the PendSV exception, it runs as soon as no exception
+   *        of higher priority is active.
+   */
+  void Functions::setPendSVPending()
+  {
+    _SCB->ICSR = icsr::pendsvset::MASK;
+  }
+
+  /**
+   * @brief Sets the PendSV exception priority, 0xFF is the lowest.
+   * @note  Only the PRIORITY_BITS upper bits are implemented.
+   */
+  void Functions::setPendSVPriority(u8 const priority)
+  {
+    _SCB->SHPR3 = (_SCB->SHPR3 & ~shpr3::pri_14::MASK) +
+        (u32(priority) << shpr3::pri_14::POSITION);
+  }
+
+  /**
+   * @brief Relocates the vector table.
+   * @note  The table must be aligned to its size rounded up to the next
+   *        power of 2 (minimum 128 bytes).
+   */
+  void Functions::setVectorTable(void const* const table)
+  {
+    _SCB->VTOR =
+        u32(reinterpret_cast<uintptr_t>(table)) & vtor::tbloff::MASK;
+
+    asm volatile ("dsb");
+  }
+
+  /**
+   * @brief Returns the address of the active vector table.
+   */
+  u32 Functions::getVectorTable()
+  {
+    return _SCB->VTOR;
+  }
+
+  /**
+   * @brief Splits the priority levels in preemption (group) priority and
+   *        subpriority bits.
+   */
+  void Functions::setPriorityGrouping(aircr::prigroup::States PRIGROUP)
+  {
+    _SCB->AIRCR =
+        (_SCB->AIRCR & ~(aircr::vectkey::MASK + aircr::prigroup::MASK)) +
+            aircr::vectkey::KEY + PRIGROUP;
+  }
+
+  /**
+   * @brief Puts the core to sleep until an interrupt becomes pending.
+   * @note  A pending interrupt also wakes the core up when PRIMASK is set,
+   *        in that case the handler runs after the interrupts are re-enabled.
+   */
+  void Functions::waitForInterrupt()
+  {
+    asm volatile ("dsb");
+    asm volatile ("wfi");
+  }
+
+  /**
+   * @brief Selects the low power mode entered by waitForInterrupt().
+   * @note  The deep sleep mode is further configured in the PWR peripheral.
+   */
+  void Functions::setSleepMode(scr::sleepdeep::States SLEEPDEEP)
+  {
+    _SCB->SCR = (_SCB->SCR & ~scr::sleepdeep::MASK) + SLEEPDEEP;
+  }
+
+  /**
+   * @brief Routes the MPU access violations to the MemManage handler
+   *        instead of escalating them to a HardFault.
+   */
+  void Functions::enableMemoryManagementFault()
+  {
+    _SCB->SHCRS |= 1 << shcsr::memfaultena::POSITION;
+  }
+
+  void Functions::disableMemoryManagementFault()
+  {
+    _SCB->SHCRS &= ~(1 << shcsr::memfaultena::POSITION);
+  }
+
+  /**
+   * @brief Returns the MemManage fault status byte of the CFSR.
+   * @note  Test against the cfsr::iaccviol, daccviol, mstkerr and mmarvalid
+   *        masks.
+   */
+  u8 Functions::getMemoryManagementFaultStatus()
+  {
+    return (_SCB->CFSR & cfsr::mmfsr::MASK) >> cfsr::mmfsr::POSITION;
+  }
+
+  /**
+   * @brief Clears the MemManage fault status bits (write 1 to clear).
+   */
+  void Functions::clearMemoryManagementFaultStatus()
+  {
+    _SCB->CFSR = cfsr::mmfsr::MASK;
+  }
+
+  /**
+   * @brief Returns the address of the faulting data access.
+   * @note  Only meaningful if the cfsr::mmarvalid status bit is set.
+   */
+  u32 Functions::getMemoryManagementFaultAddress()
+  {
+    return _SCB->MMAR;
+  }
+
+  /**
+   * @brief Routes the bus errors to the BusFault handler instead of
+   *        escalating them to a HardFault.
+   */
+  void Functions::enableBusFault()
+  {
+    _SCB->SHCRS |= 1 << shcsr::busfaultena::POSITION;
+  }
+
+  /**
+   * @brief Routes the usage faults (undefined instruction, invalid state,
+   *        ...) to the UsageFault handler instead of escalating them to a
+   *        HardFault.
+   */
+  void Functions::enableUsageFault()
+  {
+    _SCB->SHCRS |= 1 << shcsr::usgfaultena::POSITION;
+  }
+
+  /**
+   * @brief Returns the configurable fault status (MemManage, BusFault and
+   *        UsageFault status bytes).
+   */
+  u32 Functions::getFaultStatus()
+  {
+    return _SCB->CFSR;
+  }
+
+  u32 Functions::getHardFaultStatus()
+  {
+    return _SCB->HFSR;
+  }
+
+  /**
+   * @brief Returns the address of the faulting bus access.
+   * @note  Only meaningful if the BFARVALID status bit is set.
+   */
+  u32 Functions::getBusFaultAddress()
+  {
+    return _SCB->BFAR;
+  }
+
+  /**
+   * @brief Clears the configurable and the hard fault status bits.
+   */
+  void Functions::clearFaultStatus()
+  {
+    _SCB->CFSR = _SCB->CFSR;
+    _SCB->HFSR = _SCB->HFSR;
+  }
+
+  /**
+   * @brief Requests a system reset, the priority grouping is kept.
+   */
+  void Functions::resetSystem()
+  {
+    asm volatile ("dsb");
+
+    _SCB->AIRCR = aircr::vectkey::KEY + (_SCB->AIRCR & aircr::prigroup::MASK) +
+        aircr::sysresetreq::MASK;
+
+    asm volatile ("dsb");
+
+    while (true) {
+    }
+  }
 }  // namespace scb
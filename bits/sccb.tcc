@@ -356,4 +356,537 @@ namespace sccb {
       return false;
     }
   }
+
+#ifndef STM32F1XX
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  u8 Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::slave;
+
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  Register const* volatile Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::entry;
+
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  u16 volatile Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::remaining;
+
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  u16 volatile Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::failed;
+
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  bool volatile Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::acknowledged;
+
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  bool volatile Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::busy;
+
+  /**
+   * @brief Initializes the I2C peripheral and the DMA stream used by the SCCB.
+   * @note  The SDA/SCL pins must be configured by the user.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  void Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::initialize()
+  {
+    I2C::enableClock();
+
+    I2C::configure(
+        i2c::cr1::pe::PERIPHERAL_DISABLED,
+        i2c::cr1::enpec::PACKET_ERROR_CHECKING_DISABLED,
+        i2c::cr1::engc::GENERAL_CALL_DISABLED,
+        i2c::cr1::nostretch::CLOCK_STRETCHING_DISABLED,
+        i2c::cr2::iterren::ERROR_INTERRUPT_DISABLED,
+        i2c::cr2::itevten::EVENT_INTERRUPT_DISABLED,
+        i2c::cr2::itbufen::BUFFER_INTERRUPT_DISABLED,
+        i2c::cr2::dmaen::DMA_REQUEST_DISABLED,
+        i2c::cr2::last::NEXT_DMA_IS_NOT_THE_LAST_TRANSFER);
+
+    I2C::template configureClock<
+        (FREQUENCY > 100000 ?
+            i2c::ccr::f_s::FAST_MODE :
+            i2c::ccr::f_s::STANDARD_MODE),
+        i2c::ccr::duty::T_LOW_2_T_HIGH_1,
+        FREQUENCY
+    >();
+
+    DMA::enableClock();
+
+    DMA::configure(
+        dma::stream::cr::dmeie::DIRECT_MODE_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::teie::TRANSFER_ERROR_INTERRUPT_DISABLED,
+        dma::stream::cr::htie::HALF_TRANSFER_INTERRUPT_DISABLED,
+        dma::stream::cr::tcie::TRANSFER_COMPLETE_INTERRUPT_DISABLED,
+        dma::stream::cr::pfctrl::DMA_FLOW_CONTROLLER,
+        dma::stream::cr::dir::MEMORY_TO_PERIPHERAL,
+        dma::stream::cr::circ::CIRCULAR_MODE_DISABLED,
+        dma::stream::cr::pinc::PERIPHERAL_INCREMENT_MODE_DISABLED,
+        dma::stream::cr::minc::MEMORY_INCREMENT_MODE_ENABLED,
+        dma::stream::cr::psize::PERIPHERAL_SIZE_8BITS,
+        dma::stream::cr::msize::MEMORY_SIZE_8BITS,
+        dma::stream::cr::pincos::PERIPHERAL_INCREMENT_OFFSET_SIZE_PSIZE,
+        dma::stream::cr::pl::PRIORITY_LEVEL_MEDIUM,
+        dma::stream::cr::dbm::DOUBLE_BUFFER_MODE_DISABLED,
+        dma::stream::cr::ct::CURRENT_TARGET_MEMORY_0,
+        dma::stream::cr::pburst::PERIPHERAL_BURST_TRANSFER_SINGLE,
+        dma::stream::cr::mburst::MEMORY_BURST_TRANSFER_SINGLE,
+        DMA_CHANNEL);
+
+    DMA::setPeripheralAddress(
+        &reinterpret_cast<i2c::Registers*>(I2C_ADDRESS)->DR);
+
+    busy = false;
+
+    I2C::enablePeripheral();
+  }
+
+  /**
+   * @brief Sends a stop condition and waits until it's on the bus.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  void Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::stop()
+  {
+    I2C::sendStop();
+
+    while (I2C::isStopPending()) {
+    }
+  }
+
+  /**
+   * @brief Writes <value> in <registerAddress> on <slaveAddress> device.
+   * @note  Returns false if the device didn't acknowledge its address.
+   * @note  A missing ACK after the data bytes is ignored, as SCCB allows it.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  bool Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::writeSlaveRegister(
+      u8 const slaveAddress,
+      u8 const registerAddress,
+      u8 const value)
+  {
+    while (busy) {
+    }
+
+    I2C::sendStart();
+
+    while (!I2C::hasSentStart()) {
+    }
+
+    I2C::sendAddress(slaveAddress, i2c::operation::WRITE);
+
+    while (!I2C::hasAddressTransmitted()) {
+      if (I2C::hasAcknowledgeFailed()) {
+        I2C::clearAcknowledgeFailedFlag();
+        stop();
+        return false;
+      }
+    }
+
+    I2C::clearAddressFlag();
+
+    I2C::sendData(registerAddress);
+
+    while (!I2C::canSendData()) {
+    }
+
+    I2C::sendData(value);
+
+    while (!I2C::hasTranferFinished() && !I2C::hasAcknowledgeFailed()) {
+    }
+
+    I2C::clearAcknowledgeFailedFlag();
+    stop();
+
+    return true;
+  }
+
+  /**
+   * @brief Reads <registerAddress> from <slaveAddress> device.
+   * @note  Returns false if the device didn't acknowledge its address.
+   * @note  SCCB requires a stop condition between the register address write
+   *        and the data read, a repeated start can't be used.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  bool Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::readSlaveRegister(
+      u8 const slaveAddress,
+      u8 const registerAddress,
+      u8& value)
+  {
+    while (busy) {
+    }
+
+    I2C::sendStart();
+
+    while (!I2C::hasSentStart()) {
+    }
+
+    I2C::sendAddress(slaveAddress, i2c::operation::WRITE);
+
+    while (!I2C::hasAddressTransmitted()) {
+      if (I2C::hasAcknowledgeFailed()) {
+        I2C::clearAcknowledgeFailedFlag();
+        stop();
+        return false;
+      }
+    }
+
+    I2C::clearAddressFlag();
+
+    I2C::sendData(registerAddress);
+
+    while (!I2C::hasTranferFinished() && !I2C::hasAcknowledgeFailed()) {
+    }
+
+    I2C::clearAcknowledgeFailedFlag();
+    stop();
+
+    I2C::sendStart();
+
+    while (!I2C::hasSentStart()) {
+    }
+
+    I2C::sendAddress(slaveAddress, i2c::operation::READ);
+
+    while (!I2C::hasAddressTransmitted()) {
+      if (I2C::hasAcknowledgeFailed()) {
+        I2C::clearAcknowledgeFailedFlag();
+        stop();
+        return false;
+      }
+    }
+
+    // Single byte reception: NACK the byte and request the stop condition
+    // before clearing ADDR
+    I2C::disableACK();
+    I2C::clearAddressFlag();
+    I2C::sendStop();
+
+    while (!I2C::hasReceivedData()) {
+    }
+
+    value = I2C::getData();
+
+    while (I2C::isStopPending()) {
+    }
+
+    I2C::enableACK();
+
+    return true;
+  }
+
+  /**
+   * @brief Writes <size> registers from <table> on <slaveAddress> device.
+   * @note  This function doesn't block, the writes take place in the
+   *        background. Use isBusy() to check if all the writes are done.
+   * @note  <table> must remain valid until the writes are done.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  void Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::writeRegisterTable(
+      u8 const slaveAddress,
+      Register const* const table,
+      u16 const size)
+  {
+    if (size == 0) {
+      return;
+    }
+
+    while (busy) {
+    }
+
+    slave = slaveAddress;
+    entry = table;
+    remaining = size;
+    failed = 0;
+    acknowledged = false;
+    busy = true;
+
+    I2C::enableDmaRequests();
+    I2C::enableErrorInterrupt();
+    I2C::enableEventInterrupt();
+
+    I2C::sendStart();
+  }
+
+  /**
+   * @brief Returns true while a register table is being written.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  bool Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::isBusy()
+  {
+    return busy;
+  }
+
+  /**
+   * @brief Returns the number of table entries whose write failed.
+   * @note  A write fails when the device doesn't acknowledge its address.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  u16 Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::getNumberOfFailedWrites()
+  {
+    return failed;
+  }
+
+  /**
+   * @brief Starts the write of the next table entry, or finishes the table.
+   * @note  The stop condition takes a few bus clock cycles to be sent.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  void Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::startNextWrite()
+  {
+    while (I2C::isStopPending()) {
+    }
+
+    if (remaining != 0) {
+      acknowledged = false;
+      I2C::sendStart();
+    } else {
+      I2C::disableEventInterrupt();
+      I2C::disableErrorInterrupt();
+      I2C::disableDmaRequests();
+      busy = false;
+    }
+  }
+
+  /**
+   * @brief Sequences the table writes, call it on the I2C event interrupt.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  void Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::onEventInterrupt()
+  {
+    if (I2C::hasSentStart()) {
+      I2C::sendAddress(slave, i2c::operation::WRITE);
+    } else if (I2C::hasAddressTransmitted()) {
+      acknowledged = true;
+
+      DMA::clearTransferCompleteFlag();
+      DMA::clearHalfTransferFlag();
+      DMA::clearTransferErrorFlag();
+      DMA::clearFifoErrorFlag();
+      DMA::clearDirectModeErrorFlag();
+      DMA::setMemory0Address(const_cast<Register*>(entry));
+      DMA::setNumberOfTransactions(sizeof(Register));
+      DMA::enablePeripheral();
+
+      I2C::clearAddressFlag();
+    } else if (I2C::hasTranferFinished()) {
+      entry++;
+      remaining--;
+
+      I2C::sendStop();
+      startNextWrite();
+    }
+  }
+
+  /**
+   * @brief Handles the bus errors, call it on the I2C error interrupt.
+   * @note  A missing ACK after the slave address means the entry wasn't
+   *        written, a missing ACK after the data bytes is allowed by SCCB.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  void Hardware<
+      I2C_ADDRESS,
+      FREQUENCY,
+      DMA_ADDRESS,
+      DMA_STREAM,
+      DMA_CHANNEL
+  >::onErrorInterrupt()
+  {
+    reinterpret_cast<i2c::Registers*>(I2C_ADDRESS)->SR1 =
+        ~(i2c::sr1::berr::MASK |
+            i2c::sr1::arlo::MASK |
+            i2c::sr1::af::MASK |
+            i2c::sr1::ovr::MASK);
+
+    DMA::disablePeripheral();
+
+    if (!acknowledged) {
+      failed++;
+    }
+
+    entry++;
+    remaining--;
+
+    I2C::sendStop();
+    startNextWrite();
+  }
+#endif // !STM32F1XX
 }  // namespace sccb
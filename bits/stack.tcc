@@ -0,0 +1,164 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+extern "C" {
+  extern u32 __stack_start__;
+  extern u32 __stack_end__;
+}
+
+namespace stack {
+  /**
+   * @brief Returns the lowest usable address, right above the guard.
+   */
+  template<u32 GUARD_SIZE>
+  u32* Functions<GUARD_SIZE>::getBottom()
+  {
+    return &__stack_start__ + GUARD_SIZE / sizeof(u32);
+  }
+
+  /**
+   * @brief Paints the unused part of the main stack, from the guard up to
+   *        the current stack pointer.
+   * @note  Call it as early as possible, before installGuard().
+   */
+  template<u32 GUARD_SIZE>
+  void Functions<GUARD_SIZE>::paint()
+  {
+    u32 volatile* word = getBottom();
+    u32* top;
+
+    asm volatile ("mov %0, sp" : "=r" (top));
+
+    // No function call from here, its frame would be painted over
+    while (word < top) {
+      *word++ = PATTERN;
+    }
+  }
+
+  /**
+   * @brief Returns the usable size of the main stack in bytes, the guard
+   *        excluded.
+   */
+  template<u32 GUARD_SIZE>
+  u32 Functions<GUARD_SIZE>::getSize()
+  {
+    return (&__stack_end__ - getBottom()) * sizeof(u32);
+  }
+
+  /**
+   * @brief Returns the deepest usage of the main stack since paint(), in
+   *        bytes.
+   */
+  template<u32 GUARD_SIZE>
+  u32 Functions<GUARD_SIZE>::getHighWaterMark()
+  {
+    return getSize() - getUnused();
+  }
+
+  /**
+   * @brief Returns the number of bytes that have never been used since
+   *        paint().
+   * @note  0 means the stack reached the guard.
+   */
+  template<u32 GUARD_SIZE>
+  u32 Functions<GUARD_SIZE>::getUnused()
+  {
+    return getUnused(getBottom(), &__stack_end__);
+  }
+
+  /**
+   * @brief Makes the lowest GUARD_SIZE bytes of the main stack inaccessible
+   *        using the MPU <region>, an overflow triggers a MemManage fault
+   *        instead of silently corrupting the memory below.
+   * @note  Enables the MPU with the default memory map as background, so
+   *        the rest of the memory keeps its usual permissions.
+   */
+  template<u32 GUARD_SIZE>
+  void Functions<GUARD_SIZE>::installGuard(u8 const region)
+  {
+    MPU::configureRegion(
+        region,
+        u32(&__stack_start__),
+        mpu::toRegionSize(GUARD_SIZE),
+        mpu::rasr::ap::NO_ACCESS,
+        mpu::rasr::xn::EXECUTE_NEVER,
+        mpu::rasr::attributes::NORMAL_WB);
+
+    SCB::enableMemoryManagementFault();
+    MPU::enable();
+  }
+
+  /**
+   * @brief Fills [<begin>, <end>) with the PATTERN.
+   */
+  template<u32 GUARD_SIZE>
+  void Functions<GUARD_SIZE>::paint(u32* const begin, u32* const end)
+  {
+    for (u32 volatile* word = begin; word < end; word++) {
+      *word = PATTERN;
+    }
+  }
+
+  /**
+   * @brief Returns the number of bytes of the full-descending stack
+   *        [<begin>, <end>) that still hold the PATTERN.
+   */
+  template<u32 GUARD_SIZE>
+  u32 Functions<GUARD_SIZE>::getUnused(
+      u32 const* begin,
+      u32 const* const end)
+  {
+    u32 const* word = begin;
+
+    while ((word < end) && (*word == PATTERN)) {
+      word++;
+    }
+
+    return (word - begin) * sizeof(u32);
+  }
+
+  /**
+   * @brief Gathers the fault status and reports it to the user.
+   * @note  Called by the handler defined with STACK_GUARD_HANDLER(), on a
+   *        fresh main stack, or FAULT_STACK_GUARD_HANDLER(), on the fault
+   *        stack.
+   */
+  template<u32 GUARD_SIZE>
+  void Functions<GUARD_SIZE>::onMemoryManagementFault(u32 const pc)
+  {
+    u8 const status = SCB::getMemoryManagementFaultStatus();
+    u32 address = 0;
+
+    if (status & scb::cfsr::mmarvalid::MASK) {
+      address = SCB::getMemoryManagementFaultAddress();
+    }
+
+    SCB::clearMemoryManagementFaultStatus();
+
+    guardViolationHandler(pc, address, status);
+
+    // The user handler must not return
+    while (true) {
+    }
+  }
+}  // namespace stack
@@ -196,4 +196,19 @@ namespace stk {
 		enableCounter();
 	}
 
+	/**
+	 * @brief Recomputes the reload value, so the interrupt keeps firing at
+	 *        <frequency> (Hz) when the ticker clock is <tickerClock> (Hz).
+	 * @note  Use this after a run time clock change, TICKERCLOCK only holds
+	 *        the clock selected in clock.hpp.
+	 */
+
+	void Functions::setInterruptFrequency(
+			u32 const frequency,
+			u32 const tickerClock)
+	{
+		reloadSysTick(tickerClock / frequency - 1);
+		clearCurrentValue();
+	}
+
 }// namespace stk
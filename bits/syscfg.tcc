@@ -63,5 +63,40 @@ namespace syscfg {
 
     SYSCFG_REGS->EXTICR[LINE / 4] |= EXTICR << (4 * (LINE % 4));
   }
+
+  /**
+   * @brief Selects the memory aliased at address 0x00000000.
+   */
+  void Functions::remapMemory(memrmp::mem_mode::States MEM_MODE)
+  {
+    SYSCFG_REGS->MEMRMP &= ~memrmp::mem_mode::MASK;
+    SYSCFG_REGS->MEMRMP |= MEM_MODE;
+  }
+#ifdef STM32F4XX
+
+  /**
+   * @brief Swaps the addresses of the two flash banks, the bank mapped at
+   *        0x08000000 is also aliased at 0x00000000.
+   * @note  Dual bank devices only. The mapping returns to the default at
+   *        reset.
+   * @note  The code after the swap is fetched from the other bank, this
+   *        function must be called from RAM.
+   */
+  void Functions::swapFlashBanks()
+  {
+    SYSCFG_REGS->MEMRMP ^= memrmp::ufb_mode::MASK;
+
+    asm volatile ("dsb");
+    asm volatile ("isb");
+  }
+
+  /**
+   * @brief Returns true if the bank 2 is mapped at 0x08000000.
+   */
+  bool Functions::areFlashBanksSwapped()
+  {
+    return SYSCFG_REGS->MEMRMP & memrmp::ufb_mode::MASK;
+  }
+#endif // STM32F4XX
 }  // namespace syscfg
 
@@ -0,0 +1,334 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace systime {
+  Timer::Timer() :
+      next(0), previous(0), expiry(0), period(0), callback(0), context(0)
+  {
+  }
+
+  /**
+   * @brief Returns true if the timer is waiting in the wheel.
+   */
+  bool Timer::isScheduled() const
+  {
+    return previous != 0;
+  }
+
+  /**
+   * @brief Returns the tick at which the timer expires.
+   */
+  u64 Timer::getExpiry() const
+  {
+    return expiry;
+  }
+
+  template<u32 TICK_FREQUENCY>
+  u64 volatile Functions<TICK_FREQUENCY>::ticks;
+
+  template<u32 TICK_FREQUENCY>
+  Timer* Functions<TICK_FREQUENCY>::wheel[LEVELS][SLOTS];
+
+  /**
+   * @brief Configures the SysTick to interrupt at TICK_FREQUENCY.
+   * @note  The SysTick runs on AHB / 8.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::initialize()
+  {
+    STK::disableCounter();
+    STK::setTicks(STK::TICKERCLOCK / TICK_FREQUENCY);
+    STK::clearCurrentValue();
+    STK::selectClockDiv8();
+    STK::enableInterrupt();
+    STK::enableCounter();
+  }
+
+  /**
+   * @brief Advances the time base and fires the expired timers.
+   * @note  Must be called from the SysTick exception handler.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::onSysTickInterrupt()
+  {
+    u64 const now = ticks + 1;
+
+    ticks = now;
+
+    // Bring down the upper level slots that start at this tick
+    for (u8 level = 1; level < LEVELS; level++) {
+      if (((now >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) {
+        break;
+      }
+
+      cascade(level);
+    }
+
+    Timer** const slot = &wheel[0][now & SLOT_MASK];
+
+    while (*slot != 0) {
+      Timer& timer = **slot;
+
+      unlink(timer);
+
+      if (timer.expiry > now) {
+        insert(timer);
+        continue;
+      }
+
+      if (timer.period != 0) {
+        timer.expiry += timer.period;
+        insert(timer);
+      }
+
+      timer.callback(timer.context);
+    }
+  }
+
+  /**
+   * @brief Returns the number of ticks elapsed since initialize().
+   */
+  template<u32 TICK_FREQUENCY>
+  u64 Functions<TICK_FREQUENCY>::getTicks()
+  {
+    u64 now;
+
+    do {
+      now = ticks;
+    } while (now != ticks);
+
+    return now;
+  }
+
+  /**
+   * @brief Returns the number of microseconds elapsed since initialize().
+   * @note  Safe to call with the interrupts disabled, or from an interrupt
+   *        with higher priority than the SysTick: a wrap of the SysTick
+   *        whose interrupt is still pending is accounted for.
+   */
+  template<u32 TICK_FREQUENCY>
+  u64 Functions<TICK_FREQUENCY>::getMicroseconds()
+  {
+    u64 now;
+    u32 current;
+    bool pending;
+
+    do {
+      now = ticks;
+      current = STK::getCurrentValue();
+      pending = SCB::isSysTickPending();
+    } while (now != ticks);
+
+    if (pending) {
+      // The counter wrapped, but the tick hasn't been counted yet
+      current = STK::getCurrentValue();
+      now++;
+    }
+
+    u32 const reload = STK::getAutoReloadValue();
+
+    return now * MICROSECONDS_PER_TICK +
+        (reload - 1 - current) * MICROSECONDS_PER_TICK / reload;
+  }
+
+  /**
+   * @brief Schedules <timer> to call <callback>(<context>) in <delay>
+   *        ticks, and then every <period> ticks (0 = one-shot).
+   * @note  A scheduled timer is rescheduled.
+   * @note  A delay of 0 is treated as 1.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::schedule(
+      Timer& timer,
+      u32 const delay,
+      u32 const period,
+      Callback const callback,
+      void* const context)
+  {
+    critical::Section section;
+
+    if (timer.isScheduled()) {
+      unlink(timer);
+    }
+
+    timer.expiry = ticks + (delay == 0 ? 1 : delay);
+    timer.period = period;
+    timer.callback = callback;
+    timer.context = context;
+
+    insert(timer);
+  }
+
+  /**
+   * @brief Removes <timer> from the wheel, if it was scheduled.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::cancel(Timer& timer)
+  {
+    critical::Section section;
+
+    if (timer.isScheduled()) {
+      unlink(timer);
+    }
+  }
+
+  /**
+   * @brief Returns the number of ticks during which no timer can expire,
+   *        capped to <limit>.
+   * @note  The upper levels only give a lower bound: a timer waiting there
+   *        can't expire before its slot is cascaded.
+   */
+  template<u32 TICK_FREQUENCY>
+  u32 Functions<TICK_FREQUENCY>::getIdleTicks(u32 const limit)
+  {
+    critical::Section section;
+
+    u64 const now = ticks;
+    u64 earliest = now + limit;
+
+    for (u8 level = 0; level < LEVELS; level++) {
+      u8 const shift = SLOT_BITS * level;
+
+      for (u8 distance = 1; distance < SLOTS; distance++) {
+        u64 const start = ((now >> shift) + distance) << shift;
+
+        if (start >= earliest) {
+          break;
+        }
+
+        if (wheel[level][((now >> shift) + distance) & SLOT_MASK] != 0) {
+          earliest = start;
+          break;
+        }
+      }
+    }
+
+    return earliest - now;
+  }
+
+  /**
+   * @brief Advances the time base by <elapsed> ticks at once, e.g. after
+   *        the SysTick was stopped in a low power mode.
+   * @note  No timer may expire during those ticks (see getIdleTicks()),
+   *        only the ticks that cascade the upper levels are processed.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::advance(u32 elapsed)
+  {
+    critical::Section section;
+
+    while (elapsed != 0) {
+      // Skip to the tick that precedes the next cascade, or the last tick
+      u32 skip = SLOT_MASK - (ticks & SLOT_MASK);
+
+      if (skip > elapsed - 1) {
+        skip = elapsed - 1;
+      }
+
+      ticks = ticks + skip;
+      elapsed -= skip + 1;
+
+      onSysTickInterrupt();
+    }
+  }
+
+  /**
+   * @brief Links <timer> in the slot of the lowest level that can hold it.
+   * @note  Timers beyond the wheel range wait in the farthest slot, and are
+   *        re-inserted when that slot is cascaded.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::insert(Timer& timer)
+  {
+    u64 const now = ticks;
+    Timer** slot = 0;
+
+    if (timer.expiry <= now) {
+      slot = &wheel[0][now & SLOT_MASK];
+    } else {
+      for (u8 level = 0; level < LEVELS; level++) {
+        u8 const shift = SLOT_BITS * level;
+
+        if ((timer.expiry >> shift) - (now >> shift) < SLOTS) {
+          slot = &wheel[level][(timer.expiry >> shift) & SLOT_MASK];
+          break;
+        }
+      }
+
+      if (slot == 0) {
+        u8 const shift = SLOT_BITS * (LEVELS - 1);
+
+        slot = &wheel[LEVELS - 1][((now >> shift) + SLOTS - 1) & SLOT_MASK];
+      }
+    }
+
+    timer.next = *slot;
+    timer.previous = slot;
+
+    if (*slot != 0) {
+      (*slot)->previous = &timer.next;
+    }
+
+    *slot = &timer;
+  }
+
+  /**
+   * @brief Removes <timer> from its slot.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::unlink(Timer& timer)
+  {
+    *timer.previous = timer.next;
+
+    if (timer.next != 0) {
+      timer.next->previous = timer.previous;
+    }
+
+    timer.next = 0;
+    timer.previous = 0;
+  }
+
+  /**
+   * @brief Re-inserts the timers of the current slot of <level>, they end
+   *        up in the lower levels.
+   */
+  template<u32 TICK_FREQUENCY>
+  void Functions<TICK_FREQUENCY>::cascade(u8 const level)
+  {
+    Timer** const slot =
+        &wheel[level][(ticks >> (SLOT_BITS * level)) & SLOT_MASK];
+    Timer* timer = *slot;
+
+    *slot = 0;
+
+    while (timer != 0) {
+      Timer* const next = timer->next;
+
+      timer->next = 0;
+      timer->previous = 0;
+      insert(*timer);
+
+      timer = next;
+    }
+  }
+}  // namespace systime
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace text {
+  /**
+   * @brief Sends a null terminated string.
+   * @note  Busy waits on OUTPUT::canSendDataYet().
+   */
+  template<typename OUTPUT>
+  void Writer<OUTPUT>::print(char const* string)
+  {
+    while (*string != 0) {
+      while (!OUTPUT::canSendDataYet()) {
+      }
+
+      OUTPUT::sendData(*string++);
+    }
+  }
+
+  /**
+   * @brief Sends <number> in decimal.
+   */
+  template<typename OUTPUT>
+  void Writer<OUTPUT>::print(u32 number)
+  {
+    char digits[11];
+    u8 i = sizeof(digits) - 1;
+
+    digits[i] = 0;
+
+    do {
+      digits[--i] = '0' + number % 10;
+      number /= 10;
+    } while (number != 0);
+
+    print(&digits[i]);
+  }
+
+  /**
+   * @brief Sends <number> as 8 hexadecimal digits, prefixed with 0x.
+   */
+  template<typename OUTPUT>
+  void Writer<OUTPUT>::printHex(u32 number)
+  {
+    char digits[11];
+
+    digits[0] = '0';
+    digits[1] = 'x';
+    digits[10] = 0;
+
+    for (u8 i = 9; i > 1; i--) {
+      digits[i] = "0123456789ABCDEF"[number & 0xF];
+      number >>= 4;
+    }
+
+    print(digits);
+  }
+}  // namespace text
@@ -220,11 +220,36 @@ namespace tim {
     setPrescaler(PSC);
   }
 
+  /**
+   * @brief Configures the prescaler, so the counter counts in microseconds,
+   *        given the current timer clock frequency.
+   * @note  Use this variant after a run time clock change, FREQUENCY only
+   *        holds the timer clock selected in clock.hpp.
+   */
+  template<Address T>
+  void Functions<T>::setMicroSecondResolution(u32 const timerFrequency)
+  {
+    setPrescaler((timerFrequency / 1000000) - 1);
+  }
+
+  /**
+   * @brief Configures the prescaler, so the counter counts in miliseconds,
+   *        given the current timer clock frequency.
+   * @note  The timer clock must be lower than 65.536 MHz.
+   */
+  template<Address T>
+  void Functions<T>::setMiliSecondResolution(u32 const timerFrequency)
+  {
+    setPrescaler((timerFrequency / 1000) - 1);
+  }
+
   /**
    * @brief Waits for <N> counts.
    * @note  Timer must be configured to generate an update request only on
    *        overflow or underflow.
    * @note  If N = 0, the processor will be trapped in an infinite loop.
+   * @note  The core spins while waiting, see delay::Functions (delay.hpp)
+   *        for delays that let it sleep or run other code.
    */
   template<Address T>
   void Functions<T>::delay(u16 const N)
@@ -714,6 +739,76 @@ namespace tim {
     >());
   }
 
+  /**
+   * @brief Sets the value the counter is compared against on channel 1.
+   * @note  Not available on the basic timers (TIM6 and TIM7).
+   */
+  template<Address T>
+  void Functions<T>::setCompare1(u16 const value)
+  {
+    reinterpret_cast<Registers*>(T)->CCR1 = value;
+  }
+
+  /**
+   * @brief Enables the capture/compare 1 interrupt.
+   */
+  template<Address T>
+  void Functions<T>::enableCompare1Interrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        T + dier::OFFSET,
+        dier::cc1ie::POSITION
+    >()) = 1;
+  }
+
+  /**
+   * @brief Disables the capture/compare 1 interrupt.
+   */
+  template<Address T>
+  void Functions<T>::disableCompare1Interrupt()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        T + dier::OFFSET,
+        dier::cc1ie::POSITION
+    >()) = 0;
+  }
+
+  /**
+   * @brief Clears the capture/compare 1 interrupt flag.
+   */
+  template<Address T>
+  void Functions<T>::clearCompare1Flag()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        T + sr::OFFSET,
+        sr::cc1if::POSITION
+    >()) = 0;
+  }
+
+  /**
+   * @brief Returns true if the counter has matched the compare 1 register.
+   */
+  template<Address T>
+  bool Functions<T>::hasCompare1EventOccurred()
+  {
+    return *(bool volatile*) (bitband::peripheral<
+        T + sr::OFFSET,
+        sr::cc1if::POSITION
+    >());
+  }
+
+  /**
+   * @brief Forces a capture/compare 1 event by software.
+   */
+  template<Address T>
+  void Functions<T>::generateCompare1Event()
+  {
+    *(u32 volatile*) (bitband::peripheral<
+        T + egr::OFFSET,
+        egr::cc1g::POSITION
+    >()) = 1;
+  }
+
   /**
    * @brief Configures the timer to generate a periodic interrupt.
    * @note  This functions doesn't starts the counter.
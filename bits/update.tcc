@@ -0,0 +1,557 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+namespace update {
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  typename Engine<SLOT0, SLOT1, SLOT_SIZE>::Step volatile
+  Engine<SLOT0, SLOT1, SLOT_SIZE>::step;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  async::Operation* Engine<SLOT0, SLOT1, SLOT_SIZE>::operation;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::target;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::size;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::received;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::address;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::erasing;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u8 Engine<SLOT0, SLOT1, SLOT_SIZE>::buffers[2][UPDATE_BUFFER_SIZE];
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u16 Engine<SLOT0, SLOT1, SLOT_SIZE>::queued[2];
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u8 Engine<SLOT0, SLOT1, SLOT_SIZE>::head;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u8 Engine<SLOT0, SLOT1, SLOT_SIZE>::filling;
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u16 Engine<SLOT0, SLOT1, SLOT_SIZE>::filled;
+
+  /**
+   * @brief Starts the newest slot whose image passes the CRC check.
+   * @note  With the F4 bank swap, returns true once the running bank is
+   *        the one to boot. If the other bank holds the boot slot, BFB2
+   *        selects it and the device is reset. Otherwise, only returns
+   *        (false) if no slot holds a valid image.
+   * @note  Must be called before any interrupt is enabled.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::boot()
+  {
+    s8 const slot = getNewestSlot(true);
+
+#ifdef STM32F4XX
+    if (SWAP) {
+      SYSCFG::enableClock();
+
+      bool const swapped = SYSCFG::areFlashBanksSwapped();
+
+      if ((slot == 1) && setBootBank(!swapped)) {
+        SCB::resetSystem();
+      }
+
+      // Without any valid trailer, the running image is kept
+      setBootBank(swapped);
+
+      return true;
+    }
+#endif // STM32F4XX
+
+    if (slot < 0) {
+      return false;
+    }
+
+    start(getSlotAddress(slot));
+  }
+
+  /**
+   * @brief Returns the slot of the running image.
+   * @note  With the F4 bank swap, the running bank is always mapped at
+   *        slot 0. boot() and begin() make BFB2 select it, so slot 1 is
+   *        never the bank the device boots from.
+   * @note  The slot is the one holding this code, the vector table may have
+   *        been moved to RAM. Code running outside of the slots (a
+   *        bootloader) gets the slot boot() would start, the newest one
+   *        whose image passes the CRC check.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u8 Engine<SLOT0, SLOT1, SLOT_SIZE>::getRunningSlot()
+  {
+    u32 const code = u32(reinterpret_cast<uintptr_t>(&getRunningSlot));
+
+    if (SWAP) {
+      return 0;
+    }
+
+    if ((code >= SLOT0) && (code < SLOT0 + SLOT_SIZE)) {
+      return 0;
+    }
+
+    if ((code >= SLOT1) && (code < SLOT1 + SLOT_SIZE)) {
+      return 1;
+    }
+
+    return getNewestSlot(true) == 1 ? 1 : 0;
+  }
+
+  /**
+   * @brief Returns the start address of <slot>.
+   * @note  With the F4 bank swap, these are the addresses of the current
+   *        mapping.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::getSlotAddress(u8 const slot)
+  {
+    return slot == 0 ? SLOT0 : SLOT1;
+  }
+
+  /**
+   * @brief Returns true if <slot> holds a committed trailer.
+   * @note  The image isn't checked against its CRC.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::isValid(u8 const slot)
+  {
+    Trailer const volatile& trailer = getTrailer(slot);
+
+    return (trailer.magic == MAGIC) && (trailer.size != 0) &&
+        (trailer.size <= SLOT_SIZE - TRAILER_SIZE);
+  }
+
+  /**
+   * @brief Starts receiving an image of <bytes> bytes into the slot that
+   *        isn't running, returns false if it doesn't fit.
+   * @note  A transfer in progress is aborted.
+   * @note  With the F4 bank swap, also returns false if BFB2 can't be made
+   *        to select the running bank.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::begin(u32 const bytes)
+  {
+    abort();
+
+    if ((bytes == 0) || (bytes > SLOT_SIZE - TRAILER_SIZE)) {
+      return false;
+    }
+
+#ifdef STM32F4XX
+    if (SWAP) {
+      SYSCFG::enableClock();
+
+      // The bank about to be erased must not be the boot bank
+      if (!setBootBank(SYSCFG::areFlashBanksSwapped())) {
+        return false;
+      }
+    }
+#endif // STM32F4XX
+
+    target = getSlotAddress(getRunningSlot() ^ 1);
+    size = bytes;
+    received = 0;
+    address = target;
+    // The trailer goes first, the old image can't be booted anymore
+    erasing = getSectorStart(target + SLOT_SIZE - 1);
+    queued[0] = 0;
+    queued[1] = 0;
+    head = 0;
+    filling = 0;
+    filled = 0;
+
+    FLASH::unlock();
+    async::Flash::initialize();
+
+    step = ERASING;
+    poll();
+
+    return true;
+  }
+
+  /**
+   * @brief Takes up to <bytes> bytes of the image from <data>, returns the
+   *        number of bytes taken.
+   * @note  Returns 0 while both buffers wait to be programmed, or after a
+   *        failure.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::write(
+      void const* const data,
+      u32 const bytes)
+  {
+    u8 const* source = static_cast<u8 const*>(data);
+    u32 accepted = 0;
+
+    poll();
+
+    while (((step == ERASING) || (step == RECEIVING)) &&
+        (accepted < bytes) && (received < size) && (queued[filling] == 0)) {
+      u32 chunk = UPDATE_BUFFER_SIZE - filled;
+
+      if (chunk > bytes - accepted) {
+        chunk = bytes - accepted;
+      }
+
+      if (chunk > size - received) {
+        chunk = size - received;
+      }
+
+      for (u32 i = 0; i < chunk; i++) {
+        buffers[filling][filled + i] = source[accepted + i];
+      }
+
+      filled += chunk;
+      accepted += chunk;
+      received += chunk;
+
+      if ((filled == UPDATE_BUFFER_SIZE) || (received == size)) {
+        queue();
+      }
+    }
+
+    poll();
+
+    return accepted;
+  }
+
+  /**
+   * @brief Returns true while the slot is being erased or programmed.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::isBusy()
+  {
+    poll();
+
+    return (step == ERASING) ||
+        ((step == RECEIVING) && ((queued[0] != 0) || (queued[1] != 0)));
+  }
+
+  /**
+   * @brief Returns true if an erase or a programming operation failed.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::hasFailed()
+  {
+    return step == FAILED;
+  }
+
+  /**
+   * @brief Waits for the last chunk, checks the image against <crc> (zlib
+   *        CRC-32) and commits it, returns false on error.
+   * @note  The new image becomes the boot slot, it starts after the next
+   *        reset. With the F4 bank swap, BFB2 is pointed at its bank.
+   * @note  The trailer is programmed through async::Flash as well, the
+   *        FLASH interrupt must keep being serviced.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::finish(u32 const crc)
+  {
+    u8 const other = target == SLOT0 ? 1 : 0;
+    u32 trailer[TRAILER_SIZE / 4];
+    bool success;
+
+    while (isBusy()) {
+    }
+
+    if ((step != RECEIVING) || (received != size)) {
+      abort();
+      return false;
+    }
+
+    CRC::enableClock();
+
+    if (CRC::computeCrc32(reinterpret_cast<void const*>(target), size) != crc) {
+      abort();
+      return false;
+    }
+
+    trailer[0] = isValid(other) ? getTrailer(other).sequence + 1 : 1;
+    trailer[1] = size;
+    trailer[2] = crc;
+    trailer[3] = MAGIC;
+
+    // The units are programmed in order, the MAGIC word commits the image
+    operation = &async::Flash::program(
+        target + SLOT_SIZE - TRAILER_SIZE,
+        trailer,
+        TRAILER_SIZE);
+
+    while (!operation->isDone()) {
+    }
+
+    success = !operation->hasFailed();
+    operation = 0;
+
+    // The option bytes are programmed without the async::Flash interrupts
+    FLASH::disableInterrupts();
+    FLASH::lock();
+    step = IDLE;
+
+#ifdef STM32F4XX
+    if (SWAP && success) {
+      success = setBootBank(!SYSCFG::areFlashBanksSwapped());
+    }
+#endif // STM32F4XX
+
+    return success;
+  }
+
+  /**
+   * @brief Waits for the flash operation in progress and drops the
+   *        transfer.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  void Engine<SLOT0, SLOT1, SLOT_SIZE>::abort()
+  {
+    if (operation != 0) {
+      while (!operation->isDone()) {
+      }
+
+      operation = 0;
+    }
+
+    if (step != IDLE) {
+      FLASH::lock();
+      step = IDLE;
+    }
+  }
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  typename Engine<SLOT0, SLOT1, SLOT_SIZE>::Trailer const volatile&
+  Engine<SLOT0, SLOT1, SLOT_SIZE>::getTrailer(u8 const slot)
+  {
+    return *reinterpret_cast<Trailer const volatile*>(
+        getSlotAddress(slot) + SLOT_SIZE - TRAILER_SIZE);
+  }
+
+  /**
+   * @brief Returns true if <slot> holds a committed trailer, and its image
+   *        matches the CRC.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::isIntact(u8 const slot)
+  {
+    if (!isValid(slot)) {
+      return false;
+    }
+
+    CRC::enableClock();
+
+    return CRC::computeCrc32(
+        reinterpret_cast<void const*>(getSlotAddress(slot)),
+        getTrailer(slot).size) == getTrailer(slot).crc;
+  }
+
+  /**
+   * @brief Returns the valid slot with the highest sequence number, or -1
+   *        if none is valid.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  s8 Engine<SLOT0, SLOT1, SLOT_SIZE>::getNewestSlot(bool const CHECK_CRC)
+  {
+    bool const valid0 = CHECK_CRC ? isIntact(0) : isValid(0);
+    bool const valid1 = CHECK_CRC ? isIntact(1) : isValid(1);
+
+    if (valid0 && valid1) {
+      // The sequence number may wrap around
+      return s32(getTrailer(1).sequence - getTrailer(0).sequence) > 0 ? 1 : 0;
+    }
+
+    return valid0 ? 0 : valid1 ? 1 : -1;
+  }
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::getSectorStart(u32 const address)
+  {
+#ifdef STM32F1XX
+    return address & ~u32(flash::PAGE_SIZE - 1);
+#else // STM32F1XX
+    return FLASH::getSectorAddress(FLASH::getSector(address));
+#endif // STM32F1XX
+  }
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  u32 Engine<SLOT0, SLOT1, SLOT_SIZE>::getSectorSize(u32 const address)
+  {
+#ifdef STM32F1XX
+    (void) address;
+
+    return flash::PAGE_SIZE;
+#else // STM32F1XX
+    return FLASH::getSectorSize(FLASH::getSector(address));
+#endif // STM32F1XX
+  }
+
+  /**
+   * @brief Starts erasing the sector (page on the F1) at <address>.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  async::Operation& Engine<SLOT0, SLOT1, SLOT_SIZE>::startErase(
+      u32 const address)
+  {
+#ifdef STM32F1XX
+    return async::Flash::erasePage(address);
+#else // STM32F1XX
+    u8 sector = FLASH::getSector(address);
+
+#ifdef STM32F4XX
+    // The sector numbers address the physical banks
+    if (SWAP && SYSCFG::areFlashBanksSwapped()) {
+      sector = (sector + flash::SECTORS_PER_BANK) %
+          (2 * flash::SECTORS_PER_BANK);
+    }
+#endif // STM32F4XX
+
+    return async::Flash::eraseSector(sector);
+#endif // STM32F1XX
+  }
+
+  /**
+   * @brief Makes the BFB2 option bit select the bank 2 if <bank2> is true,
+   *        the bank 1 otherwise, returns false on error.
+   * @note  With BFB2 set, the system memory boot loader starts the bank 2,
+   *        mapped at 0x08000000, if it holds a valid stack pointer.
+   *        Otherwise, the bank 1 starts.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  bool Engine<SLOT0, SLOT1, SLOT_SIZE>::setBootBank(bool const bank2)
+  {
+#ifdef STM32F4XX
+    u32 const options = FLASH::getOptionBytes();
+    bool success;
+
+    if (((options & flash::optcr::bfb2::MASK) != 0) == bank2) {
+      return true;
+    }
+
+    FLASH::unlockOptionBytes();
+    success = FLASH::programOptionBytes(
+        bank2 ?
+            options | flash::optcr::bfb2::MASK :
+            options & ~u32(flash::optcr::bfb2::MASK));
+    FLASH::lockOptionBytes();
+
+    return success;
+#else // STM32F4XX
+    (void) bank2;
+
+    return true;
+#endif // STM32F4XX
+  }
+
+  /**
+   * @brief Pads the buffer being filled to the largest programming unit
+   *        and queues it.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  void Engine<SLOT0, SLOT1, SLOT_SIZE>::queue()
+  {
+    for (u16 i = filled; i % 8 != 0; i++) {
+      buffers[filling][i] = 0xFF;
+    }
+
+    queued[filling] = filled;
+    filling ^= 1;
+    filled = 0;
+  }
+
+  /**
+   * @brief Starts the next erase or programming operation once the previous
+   *        one has completed.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  void Engine<SLOT0, SLOT1, SLOT_SIZE>::poll()
+  {
+    if (operation != 0) {
+      if (!operation->isDone()) {
+        return;
+      }
+
+      bool const failed = operation->hasFailed();
+
+      operation = 0;
+
+      if (failed) {
+        step = FAILED;
+        return;
+      }
+
+      if (step == ERASING) {
+        u32 const last = getSectorStart(target + SLOT_SIZE - 1);
+        u32 const next =
+            erasing == last ? target : erasing + getSectorSize(erasing);
+
+        if ((next >= last) || (next >= target + size)) {
+          step = RECEIVING;
+        } else {
+          erasing = next;
+        }
+      } else {
+        address += queued[head];
+        queued[head] = 0;
+        head ^= 1;
+      }
+    }
+
+    if (step == ERASING) {
+      operation = &startErase(erasing);
+    } else if ((step == RECEIVING) && (queued[head] != 0)) {
+      operation = &async::Flash::program(
+          address,
+          buffers[head],
+          (queued[head] + 7) & ~7);
+    }
+  }
+
+  /**
+   * @brief Jumps to the image at <address>.
+   */
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  void Engine<SLOT0, SLOT1, SLOT_SIZE>::start(u32 const address)
+  {
+    u32 const volatile* const table =
+        reinterpret_cast<u32 const volatile*>(address);
+
+    _SCB->VTOR = address;
+
+    asm volatile ("dsb");
+
+    asm volatile (
+        "msr msp, %0\n\t"
+        "bx %1"
+        :
+        : "r" (table[0]), "r" (table[1]));
+
+    __builtin_unreachable();
+  }
+}  // namespace update
@@ -147,6 +147,20 @@ namespace usart {
     reinterpret_cast<Registers*>(A)->BRR = _BRR;
   }
 
+  /**
+   * @brief Sets the baud rate, given the current APB clock frequency.
+   * @note  Only valid for OVERSAMPLING_BY_16 configuration
+   * @note  Use this variant after a run time clock change, FREQUENCY only
+   *        holds the APB clock selected in clock.hpp.
+   */
+  template<Address A>
+  void Asynchronous<A>::setBaudRate(
+      u32 const baudRate,
+      u32 const busFrequency)
+  {
+    reinterpret_cast<Registers*>(A)->BRR = busFrequency / baudRate;
+  }
+
   /**
    * @brief Enable Transmit interrupt.
    */
@@ -0,0 +1,285 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2013 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+// DO NOT INCLUDE THIS FILE ANYWHERE. THIS DEMO IS JUST A REFERENCE TO BE USED
+// IN YOUR MAIN SOURCE FILE.
+////////////////////////////////////////////////////////////////////////////////
+// What does this demo do?
+// Starter benchmark suite, measures the cost (in core cycles) of some library
+// hot paths and prints the results as CSV through USART1 (PA9/PA10, 115200).
+//
+// + GPIO: BSRR write vs bitband write vs read-modify-write
+// + USART: byte TX, compile time vs run time baud rate computation
+// + DMA: stream full configuration vs re-arm
+// + I2C: SCCB register read (OV7670 on PB8/PB9)
+// + Servo: period ISR cost vs number of servos
+
+#define OV7670_SCCB_ADDRESS 0x21
+
+#include "clock.hpp"
+
+#include "core/dwt.hpp"
+
+#include "peripheral/gpio.hpp"
+#include "peripheral/usart.hpp"
+#include "peripheral/dma.hpp"
+
+#include "driver/sccb.hpp"
+#include "driver/servo.hpp"
+
+#include "benchmark.hpp"
+
+typedef PA9 U1TX;
+typedef PA10 U1RX;
+typedef PB8 SIO_C;
+typedef PB9 SIO_D;
+typedef PC13 LED;
+
+typedef DMA2_STREAM7 DMA_U1TX;
+
+typedef sccb::Hardware<
+    i2c::I2C1,
+    400000,
+    dma::common::DMA1,
+    dma::stream::STREAM_6,
+    dma::stream::cr::chsel::CHANNEL_1
+    > SCCB;
+
+typedef benchmark::Suite<DWT, 101> BENCHMARK;
+
+// Servo controllers of different sizes, the pins point to a dummy word
+u32 dummyPin;
+
+servo::Functions<tim::TIM6, 50, tim::TIM7, 1500, 1> Servo1;
+servo::Functions<tim::TIM6, 50, tim::TIM7, 1500, 4> Servo4;
+servo::Functions<tim::TIM6, 50, tim::TIM7, 1500, 8> Servo8;
+
+char message[] = "0123456789ABCDEF";
+u32 volatile baudRate = 115200;
+
+/* GPIO ***********************************************************************/
+void gpioBsrr()
+{
+  LED::setHigh();
+  LED::setLow();
+}
+
+void gpioBitband()
+{
+  *(u32 volatile*) (LED::OUT_ADDRESS) = 1;
+  *(u32 volatile*) (LED::OUT_ADDRESS) = 0;
+}
+
+void gpioReadModifyWrite()
+{
+  reinterpret_cast<gpio::Registers*>(gpio::GPIOC)->ODR |= 1 << 13;
+  reinterpret_cast<gpio::Registers*>(gpio::GPIOC)->ODR &= ~(1 << 13);
+}
+
+/* USART **********************************************************************/
+void usartSendByte()
+{
+  while (!USART1::canSendDataYet()) {
+  }
+
+  USART1::sendData('\0');
+}
+
+void usartCompileTimeBaudRate()
+{
+  USART1::setBaudRate<115200>();
+}
+
+void usartRunTimeBaudRate()
+{
+  USART1::setBaudRate(baudRate, USART1::FREQUENCY);
+}
+
+/* DMA ************************************************************************/
+void dmaArm()
+{
+  DMA_U1TX::disablePeripheral();
+  DMA_U1TX::configure(
+      dma::stream::cr::dmeie::DIRECT_MODE_ERROR_INTERRUPT_DISABLED,
+      dma::stream::cr::teie::TRANSFER_ERROR_INTERRUPT_DISABLED,
+      dma::stream::cr::htie::HALF_TRANSFER_INTERRUPT_DISABLED,
+      dma::stream::cr::tcie::TRANSFER_COMPLETE_INTERRUPT_DISABLED,
+      dma::stream::cr::pfctrl::DMA_FLOW_CONTROLLER,
+      dma::stream::cr::dir::MEMORY_TO_PERIPHERAL,
+      dma::stream::cr::circ::CIRCULAR_MODE_DISABLED,
+      dma::stream::cr::pinc::PERIPHERAL_INCREMENT_MODE_DISABLED,
+      dma::stream::cr::minc::MEMORY_INCREMENT_MODE_ENABLED,
+      dma::stream::cr::psize::PERIPHERAL_SIZE_8BITS,
+      dma::stream::cr::msize::MEMORY_SIZE_8BITS,
+      dma::stream::cr::pincos::PERIPHERAL_INCREMENT_OFFSET_SIZE_32BITS,
+      dma::stream::cr::pl::PRIORITY_LEVEL_MEDIUM,
+      dma::stream::cr::dbm::DOUBLE_BUFFER_MODE_DISABLED,
+      dma::stream::cr::ct::CURRENT_TARGET_MEMORY_0,
+      dma::stream::cr::pburst::PERIPHERAL_BURST_TRANSFER_SINGLE,
+      dma::stream::cr::mburst::MEMORY_BURST_TRANSFER_SINGLE,
+      dma::stream::cr::chsel::CHANNEL_4);
+  DMA_U1TX::setMemory0Address(&message);
+  DMA_U1TX::setPeripheralAddress(&USART1_REGS->DR);
+  DMA_U1TX::setNumberOfTransactions(sizeof(message));
+}
+
+void dmaRearm()
+{
+  DMA_U1TX::disablePeripheral();
+  DMA_U1TX::clearTransferCompleteFlag();
+  DMA_U1TX::setNumberOfTransactions(sizeof(message));
+}
+
+/* I2C ************************************************************************/
+void i2cReadRegister()
+{
+  u8 value;
+
+  SCCB::readSlaveRegister(OV7670_SCCB_ADDRESS, 0x0A, value);
+}
+
+/* Servo **********************************************************************/
+void servo1PeriodInterrupt()
+{
+  Servo1.onPeriodTimerInterrupt();
+}
+
+void servo4PeriodInterrupt()
+{
+  Servo4.onPeriodTimerInterrupt();
+}
+
+void servo8PeriodInterrupt()
+{
+  Servo8.onPeriodTimerInterrupt();
+}
+
+void initializeGpio()
+{
+  GPIOA::enableClock();
+  GPIOB::enableClock();
+  GPIOC::enableClock();
+
+  LED::setMode(gpio::moder::OUTPUT);
+
+  U1TX::setAlternateFunction(gpio::afr::USART1_3);
+  U1TX::setMode(gpio::moder::ALTERNATE);
+  U1RX::setAlternateFunction(gpio::afr::USART1_3);
+  U1RX::setMode(gpio::moder::ALTERNATE);
+
+  SIO_C::setAlternateFunction(gpio::afr::I2C);
+  SIO_C::setOutputMode(gpio::otyper::OPEN_DRAIN);
+  SIO_C::setPullMode(gpio::pupdr::PULL_UP);
+  SIO_C::setMode(gpio::moder::ALTERNATE);
+  SIO_D::setAlternateFunction(gpio::afr::I2C);
+  SIO_D::setOutputMode(gpio::otyper::OPEN_DRAIN);
+  SIO_D::setPullMode(gpio::pupdr::PULL_UP);
+  SIO_D::setMode(gpio::moder::ALTERNATE);
+}
+
+void initializeUsart()
+{
+  USART1::enableClock();
+  USART1::configure(
+      usart::cr1::rwu::RECEIVER_IN_ACTIVE_MODE,
+      usart::cr1::re::RECEIVER_DISABLED,
+      usart::cr1::te::TRANSMITTER_ENABLED,
+      usart::cr1::idleie::IDLE_INTERRUPT_DISABLED,
+      usart::cr1::rxneie::RXNE_ORE_INTERRUPT_DISABLED,
+      usart::cr1::tcie::TC_INTERRUPT_DISABLED,
+      usart::cr1::txeie::TXEIE_INTERRUPT_DISABLED,
+      usart::cr1::peie::PEIE_INTERRUPT_DISABLED,
+      usart::cr1::ps::EVEN_PARITY,
+      usart::cr1::pce::PARITY_CONTROL_DISABLED,
+      usart::cr1::wake::WAKE_ON_IDLE_LINE,
+      usart::cr1::m::START_8_DATA_N_STOP,
+      usart::cr1::ue::USART_ENABLED,
+      usart::cr1::over8::OVERSAMPLING_BY_16,
+      usart::cr2::stop::_1_STOP_BIT,
+      usart::cr3::eie::ERROR_INTERRUPT_DISABLED,
+      usart::cr3::hdsel::FULL_DUPLEX,
+      usart::cr3::dmar::RECEIVER_DMA_DISABLED,
+      usart::cr3::dmat::TRANSMITTER_DMA_DISABLED,
+      usart::cr3::rtse::RTS_HARDWARE_FLOW_DISABLED,
+      usart::cr3::ctse::CTS_HARDWARE_FLOW_DISABLED,
+      usart::cr3::ctsie::CTS_INTERRUPT_DISABLED,
+      usart::cr3::onebit::ONE_SAMPLE_BIT_METHOD);
+  USART1::setBaudRate<115200>();
+}
+
+void initializeServoControllers()
+{
+  Servo1.setPin(0, &dummyPin);
+  Servo1.initialize();
+
+  for (u8 i = 0; i < 4; i++) {
+    Servo4.setPin(i, &dummyPin);
+  }
+  Servo4.initialize();
+
+  for (u8 i = 0; i < 8; i++) {
+    Servo8.setPin(i, &dummyPin);
+  }
+  Servo8.initialize();
+}
+
+void initializePeripherals()
+{
+  initializeGpio();
+  initializeUsart();
+
+  DMA_U1TX::enableClock();
+  SCCB::initialize();
+
+  initializeServoControllers();
+
+  DWT::enableCycleCounter();
+}
+
+void registerKernels()
+{
+  BENCHMARK::add("gpio_bsrr", gpioBsrr);
+  BENCHMARK::add("gpio_bitband", gpioBitband);
+  BENCHMARK::add("gpio_rmw", gpioReadModifyWrite);
+  BENCHMARK::add("usart_send_byte", usartSendByte);
+  BENCHMARK::add("usart_baud_compile_time", usartCompileTimeBaudRate);
+  BENCHMARK::add("usart_baud_run_time", usartRunTimeBaudRate);
+  BENCHMARK::add("dma_arm", dmaArm);
+  BENCHMARK::add("dma_rearm", dmaRearm);
+  BENCHMARK::add("i2c_read_register", i2cReadRegister);
+  BENCHMARK::add("servo_period_isr_n1", servo1PeriodInterrupt);
+  BENCHMARK::add("servo_period_isr_n4", servo4PeriodInterrupt);
+  BENCHMARK::add("servo_period_isr_n8", servo8PeriodInterrupt);
+}
+
+int main()
+{
+  clk::initialize();
+
+  initializePeripherals();
+
+  registerKernels();
+
+  BENCHMARK::run<USART1>();
+
+  while (true) {
+  }
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2013 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+// DO NOT INCLUDE THIS FILE ANYWHERE. THIS DEMO IS JUST A REFERENCE TO BE USED
+// IN YOUR MAIN SOURCE FILE.
+////////////////////////////////////////////////////////////////////////////////
+// What does this demo do?
+// The OV7670 camera is configured through the I2C1 peripheral, instead of the
+// bit-banged SCCB. The whole register table is written in the background (I2C
+// event interrupt + DMA), the LED is turned on when the configuration is done.
+//
+// SCCB wiring: SIO_C -> PB8 (I2C1_SCL), SIO_D -> PB9 (I2C1_SDA)
+//
+// ** Don't forget to enable interrupts.
+
+// Camera
+#define OV7670_SCCB_ADDRESS 0x21
+
+#include "clock.hpp"
+
+#include "interrupt.hpp"
+
+#include "peripheral/gpio.hpp"
+
+typedef PB8 SIO_C;
+typedef PB9 SIO_D;
+
+typedef PA8 MCO1; // a.k.a. XCLK
+
+typedef PC13 LED;
+
+// SCCB (I2C1 + DMA1 Stream 6 Channel 1)
+#include "driver/sccb.hpp"
+
+typedef sccb::Hardware<
+    i2c::I2C1,
+    400000,
+    dma::common::DMA1,
+    dma::stream::STREAM_6,
+    dma::stream::cr::chsel::CHANNEL_1
+    > SCCB;
+
+// QCIF, YCbCr422
+sccb::Register const configuration[] = {
+    { 0x12, 0b00001000 }, // COM7: QCIF format
+    { 0x0C, 0b00001000 }, // COM3: Enable format scaling
+    { 0x11, 0b00000001 }, // CLKRC: Input clock / 2
+    { 0x3A, 0b00000100 }, // TSLB: UYVY output sequence
+    { 0x3D, 0b10001000 }, // COM13: Gamma and UV saturation enabled
+};
+
+void initializeGpio()
+{
+  GPIOA::enableClock();
+  GPIOB::enableClock();
+
+  // MCO (XCLK)
+  MCO1::setAlternateFunction(gpio::afr::SYSTEM);
+  MCO1::setMode(gpio::moder::ALTERNATE);
+
+  // SCCB
+  SIO_C::setAlternateFunction(gpio::afr::I2C);
+  SIO_C::setOutputMode(gpio::otyper::OPEN_DRAIN);
+  SIO_C::setPullMode(gpio::pupdr::PULL_UP);
+  SIO_C::setMode(gpio::moder::ALTERNATE);
+
+  SIO_D::setAlternateFunction(gpio::afr::I2C);
+  SIO_D::setOutputMode(gpio::otyper::OPEN_DRAIN);
+  SIO_D::setPullMode(gpio::pupdr::PULL_UP);
+  SIO_D::setMode(gpio::moder::ALTERNATE);
+
+  // LED
+  LED::enableClock();
+  LED::setMode(gpio::moder::OUTPUT);
+}
+
+void initializePeripherals()
+{
+  initializeGpio();
+
+  SCCB::initialize();
+  I2C1::unmaskInterrupts();
+}
+
+void loop()
+{
+  if (!SCCB::isBusy()) {
+    LED::setHigh();
+  }
+}
+
+int main()
+{
+  clk::initialize();
+
+  initializePeripherals();
+
+  // Returns immediately, the registers are written in the background
+  SCCB::writeRegisterTable(
+      OV7670_SCCB_ADDRESS,
+      configuration,
+      sizeof(configuration) / sizeof(configuration[0]));
+
+  while (true) {
+    loop();
+  }
+}
+
+void interrupt::I2C1_EV()
+{
+  SCCB::onEventInterrupt();
+}
+
+void interrupt::I2C1_ER()
+{
+  SCCB::onErrorInterrupt();
+}
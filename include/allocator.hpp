@@ -0,0 +1,158 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                     Fixed block pools and monotonic arenas
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "defs.hpp"
+#include "critical.hpp"
+#include "text.hpp"
+
+/**
+ * A Pool hands out blocks of a single size from static storage. Freed
+ * blocks are kept in an intrusive free list, so allocating and releasing
+ * are O(1) and the pool can't fragment. A Heap chains several pools, each
+ * request is served by the smallest size class that has a free block.
+ *
+ *   typedef allocator::Heap<
+ *       allocator::Pool<16, 64>,
+ *       allocator::Pool<64, 32>,
+ *       allocator::Pool<256, 8>
+ *   > MessageHeap;
+ *
+ *   MessageHeap messages;
+ *
+ *   void* block = messages.allocate(40);  // From the 64 bytes pool
+ *   messages.release(block);
+ *
+ * An Arena hands out memory of any size by bumping an offset, and is only
+ * freed as a whole with reset(), e.g. for the buffers of a request that are
+ * discarded together.
+ *
+ * Every allocator is protected by a critical section, it can be used from
+ * interrupt handlers, and keeps its usage high-water mark and its number of
+ * failed requests.
+ *
+ * allocator_cpp.hpp routes the global operator new/delete to a Heap.
+ */
+namespace allocator {
+  template<u16 BLOCK_SIZE, u16 BLOCKS>
+  class Pool {
+      static_assert(BLOCK_SIZE % 8 == 0,
+          "The block size must be a multiple of 8 to keep the alignment.");
+      static_assert(BLOCKS != 0, "The pool must have at least one block.");
+
+    public:
+      enum {
+        SIZE = BLOCK_SIZE,
+        COUNT = BLOCKS
+      };
+
+      inline Pool();
+
+      inline void* allocate();
+      inline void release(void* const);
+      inline bool owns(void const* const) const;
+
+      inline u16 getUsed() const;
+      inline u16 getHighWaterMark() const;
+      inline u32 getFailures() const;
+
+      template<typename OUTPUT>
+      inline void dump() const;
+
+    private:
+      Pool(Pool const&);
+      Pool& operator=(Pool const&);
+
+      struct Block {
+          Block* next;
+      };
+
+      u8 storage[BLOCKS * BLOCK_SIZE] __attribute__((aligned(8)));
+      Block* freeList;
+      u16 fresh;  // Blocks after this index have never been allocated
+      u16 used;
+      u16 highWaterMark;
+      u32 failures;
+  };
+
+  template<typename... POOLS>
+  class Heap;
+
+  template<>
+  class Heap<> {
+    public:
+      inline void* allocate(u32 const);
+      inline bool release(void* const);
+
+      template<typename OUTPUT>
+      inline void dump() const;
+  };
+
+  template<typename POOL, typename... POOLS>
+  class Heap<POOL, POOLS...> {
+    public:
+      inline void* allocate(u32 const);
+      inline bool release(void* const);
+
+      inline POOL& getPool();
+      inline Heap<POOLS...>& getNext();
+
+      template<typename OUTPUT>
+      inline void dump() const;
+
+    private:
+      POOL pool;
+      Heap<POOLS...> next;
+  };
+
+  template<u32 SIZE>
+  class Arena {
+      static_assert(SIZE % 8 == 0, "The arena size must be a multiple of 8.");
+
+    public:
+      inline Arena();
+
+      inline void* allocate(u32 const, u32 const = 8);
+      inline void reset();
+
+      inline u32 getUsed() const;
+      inline u32 getHighWaterMark() const;
+      inline u32 getFailures() const;
+
+    private:
+      Arena(Arena const&);
+      Arena& operator=(Arena const&);
+
+      u8 storage[SIZE] __attribute__((aligned(8)));
+      u32 offset;
+      u32 highWaterMark;
+      u32 failures;
+  };
+}  // namespace allocator
+
+#include "../bits/allocator.tcc"
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include "allocator.hpp"
+
+// IMPORTANT: Include this file in a source file once, it replaces the global
+// operator new/delete, so dynamic allocations are served by fixed block pools
+// instead of the newlib heap (_sbrk).
+
+/* Choose the size classes of the global heap ********************************/
+#ifndef GLOBAL_HEAP
+#define GLOBAL_HEAP allocator::Heap< \
+  allocator::Pool<16, 32>, \
+  allocator::Pool<64, 16>, \
+  allocator::Pool<256, 4> \
+>
+#endif // GLOBAL_HEAP
+/************************** Choose the size classes of the global heap */
+
+namespace allocator {
+  /**
+   * @brief This function is called when the global heap can't serve a
+   *        request, operator new doesn't return.
+   * @note  The user must define this function.
+   */
+  void outOfMemoryHandler(std::size_t size);
+
+  /**
+   * @brief The heap that backs operator new, its statistics can be queried
+   *        and dumped.
+   */
+  GLOBAL_HEAP& getGlobalHeap()
+  {
+    static GLOBAL_HEAP heap;
+
+    return heap;
+  }
+}  // namespace allocator
+
+void* operator new(std::size_t size)
+{
+  void* const block = allocator::getGlobalHeap().allocate(size);
+
+  if (block == 0) {
+    allocator::outOfMemoryHandler(size);
+
+    while (true) {
+    }
+  }
+
+  return block;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* block)
+{
+  if (block != 0) {
+    allocator::getGlobalHeap().release(block);
+  }
+}
+
+void operator delete[](void* block)
+{
+  operator delete(block);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* block, std::size_t)
+{
+  operator delete(block);
+}
+
+void operator delete[](void* block, std::size_t)
+{
+  operator delete(block);
+}
+#endif // __cpp_sized_deallocation
@@ -0,0 +1,286 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                    Interrupt driven asynchronous operations
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "critical.hpp"
+#include "delay.hpp"
+#include "peripheral/dma.hpp"
+#include "peripheral/flash.hpp"
+#include "peripheral/i2c.hpp"
+#include "peripheral/usart.hpp"
+
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#include <cstddef>
+#endif // __cpp_impl_coroutine
+
+/**
+ * Each asynchronous peripheral class owns an Operation that tracks its
+ * transaction in flight. The transaction is started from thread mode and
+ * driven by the peripheral interrupt, the user must call the onInterrupt()
+ * functions from the matching handlers.
+ *
+ *   typedef async::Usart<usart::USART2> ASYNC_USART2;
+ *
+ *   void onWritten(void* context) { ... }
+ *
+ *   ASYNC_USART2::write(buffer, size).then(onWritten, 0);
+ *
+ * When the compiler supports C++20 coroutines, an Operation can also be
+ * co_await-ed, so sequential code overlaps transfers on several
+ * peripherals without blocking:
+ *
+ *   async::Coroutine sample()
+ *   {
+ *     co_await ASYNC_I2C1::read(ADDRESS, REGISTER, buffer, 6);
+ *     co_await ASYNC_USART2::write(buffer, 6);
+ *     co_await async::Timer<DELAY>::sleep(1000);
+ *   }
+ *
+ * The coroutine frames come from a static pool of ASYNC_FRAMES frames of
+ * ASYNC_FRAME_SIZE bytes, the heap is never used. A coroutine that doesn't
+ * fit, or that finds the pool exhausted, doesn't start (see
+ * Coroutine::hasStarted()). The coroutines resume in the interrupt context
+ * that completed the operation.
+ */
+namespace async {
+  typedef void (*Continuation)(void*);
+
+  class Operation {
+    public:
+      inline Operation();
+
+      inline bool isDone() const;
+      inline bool hasFailed() const;
+      inline bool then(Continuation const, void* const);
+
+      inline void start();
+      inline void complete(bool const);
+
+    private:
+      enum State {
+        PENDING,
+        SUCCEEDED,
+        FAILED
+      };
+
+      u8 volatile state;
+      Continuation continuation;
+      void* context;
+  };
+
+  template<usart::Address U>
+  class Usart {
+    public:
+      static inline void initialize();
+      static inline void onInterrupt();
+
+      static inline Operation& write(u8 const* const, u16 const);
+
+    private:
+      Usart();
+
+      typedef usart::Asynchronous<U> Port;
+
+      static Operation operation;
+      static u8 const* data;
+      static u16 remaining;
+  };
+
+  template<i2c::Address I>
+  class I2c {
+    public:
+      static inline void initialize();
+      static inline void onEventInterrupt();
+      static inline void onErrorInterrupt();
+
+      static inline Operation& read(
+          u8 const,
+          u8 const,
+          u8* const,
+          u16 const);
+
+    private:
+      I2c();
+
+      typedef i2c::Standard<I> Bus;
+
+      enum Step {
+        SELECT_FOR_WRITE,
+        SEND_REGISTER,
+        RESTART,
+        SELECT_FOR_READ,
+        START_READING,
+        READ
+      };
+
+      static inline void finish(bool const);
+
+      static Operation operation;
+      static u8 step;
+      static u8 slave;
+      static u8 reg;
+      static u8* data;
+      static u16 remaining;
+  };
+
+#ifndef STM32F1XX
+  template<dma::common::Address D, dma::stream::Address S>
+  class DmaCopy {
+      static_assert(D == dma::common::DMA2,
+          "Only the DMA2 streams can do memory to memory transfers.");
+
+    public:
+      static inline void initialize();
+      static inline void onInterrupt();
+
+      static inline Operation& copy(u32* const, u32 const* const, u16 const);
+
+    private:
+      DmaCopy();
+
+      typedef dma::stream::Functions<D, S> Stream;
+
+      static Operation operation;
+  };
+#endif // !STM32F1XX
+
+  /**
+   * The flash must be unlocked before starting an operation, and the
+   * FLASH interrupt unmasked in the NVIC. Each EOP interrupt programs the
+   * next unit, the CPU keeps running between units as long as it doesn't
+   * fetch from the flash.
+   */
+  class Flash {
+    public:
+      static inline void initialize();
+      static inline void onInterrupt();
+
+#ifdef STM32F1XX
+      static inline Operation& erasePage(u32 const);
+#else // STM32F1XX
+      static inline Operation& eraseSector(u8 const);
+#endif // STM32F1XX
+      static inline Operation& program(u32 const, void const* const, u32 const);
+
+    private:
+      Flash();
+
+      struct State {
+          Operation operation;
+          u32 address;
+          u8 const* data;
+          u32 remaining;
+      };
+
+      static inline void writeNext();
+
+      static inline State& state();
+  };
+
+  template<typename DELAY>
+  class Timer {
+    public:
+      static inline Operation& sleep(u32 const);
+
+    private:
+      Timer();
+
+      static inline void expire(void*);
+
+      static Operation operation;
+      static delay::Alarm alarm;
+  };
+
+#ifdef __cpp_impl_coroutine
+#ifndef ASYNC_FRAMES
+#define ASYNC_FRAMES 4
+#endif // ASYNC_FRAMES
+#ifndef ASYNC_FRAME_SIZE
+#define ASYNC_FRAME_SIZE 256
+#endif // ASYNC_FRAME_SIZE
+
+  static_assert(ASYNC_FRAMES <= 32, "The frame pool holds at most 32 frames.");
+
+  class FramePool {
+    public:
+      static inline void* allocate(std::size_t const);
+      static inline void release(void* const);
+
+    private:
+      FramePool();
+
+      static inline u8 (&frames())[ASYNC_FRAMES][ASYNC_FRAME_SIZE];
+      static inline u32& used();
+  };
+
+  class Coroutine {
+    public:
+      struct promise_type {
+          inline Coroutine get_return_object();
+          static inline Coroutine get_return_object_on_allocation_failure();
+
+          inline std::suspend_never initial_suspend() noexcept;
+          inline std::suspend_never final_suspend() noexcept;
+          inline void return_void();
+          inline void unhandled_exception();
+
+          static inline void* operator new(std::size_t const) noexcept;
+          static inline void operator delete(void* const);
+      };
+
+      inline bool hasStarted() const;
+
+    private:
+      inline explicit Coroutine(bool const);
+
+      bool started;
+  };
+
+  class Awaiter {
+    public:
+      inline explicit Awaiter(Operation&);
+
+      inline bool await_ready() const;
+      inline bool await_suspend(std::coroutine_handle<>);
+      inline bool await_resume() const;
+
+    private:
+      static inline void resume(void*);
+
+      Operation& operation;
+  };
+
+  inline Awaiter operator co_await(Operation&);
+#endif // __cpp_impl_coroutine
+}  // namespace async
+
+#include "../bits/async.tcc"
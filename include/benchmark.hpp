@@ -0,0 +1,112 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                          Cycle counting benchmarks
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "defs.hpp"
+#include "text.hpp"
+
+#ifndef __arm__
+#include <time.h>
+#endif // !__arm__
+
+/**
+ * Runs registered kernels RUNS times each, and reports the minimum, median
+ * and maximum cost as CSV. The cost of calling an empty kernel is measured
+ * first and subtracted from every sample.
+ *
+ * The counter is a template parameter, any class with a static u32
+ * getCycleCount() function will do:
+ *
+ * + On target: DWT, after DWT::enableCycleCounter(). Units are core cycles.
+ * + On a host: benchmark::HostCounter. Units are nanoseconds.
+ *
+ *   typedef benchmark::Suite<DWT, 101> BENCHMARK;
+ *
+ *   BENCHMARK::add("gpio_bitband", toggleBitband);
+ *   BENCHMARK::add("gpio_rmw", toggleRmw);
+ *   BENCHMARK::run<USART1>();
+ *
+ * Output:
+ *
+ *   kernel,runs,min,median,max
+ *   gpio_bitband,101,2,2,4
+ *   gpio_rmw,101,5,5,7
+ *
+ * See the demo folder for a starter suite.
+ */
+namespace benchmark {
+  typedef void (*Kernel)();
+
+  struct Result {
+      u32 minimum;
+      u32 median;
+      u32 maximum;
+  };
+
+#ifndef __arm__
+  /**
+   * Host counter, based on the monotonic clock.
+   */
+  class HostCounter {
+    public:
+      static inline u32 getCycleCount();
+
+    private:
+      HostCounter();
+  };
+#endif // !__arm__
+
+  template<typename COUNTER, u16 RUNS, u8 MAX_KERNELS = 32>
+  class Suite {
+      static_assert(RUNS > 0, "At least one run is needed.");
+
+    public:
+      static inline bool add(char const* const, Kernel const);
+      static inline Result measure(Kernel const);
+
+      template<typename OUTPUT>
+      static inline void run();
+
+    private:
+      Suite();
+
+      struct Entry {
+          char const* name;
+          Kernel kernel;
+      };
+
+      static void empty();
+      static inline u32 sample(Kernel const);
+
+      static Entry entries[MAX_KERNELS];
+      static u8 size;
+      static u32 samples[RUNS];
+  };
+}  // namespace benchmark
+
+#include "../bits/benchmark.tcc"
@@ -163,6 +163,29 @@ namespace clk {
 
 #ifdef USING_PLL
 
+  /* Do you want the PLL parameters to be computed from a target frequency? ***/
+//#define USING_PLL_SOLVER
+  /******* Comment the macro above to answer no, otherwise your answer is yes */
+
+#ifdef USING_PLL_SOLVER
+  /*****************************************************************************
+   * The PLL multipliers/dividers, the bus prescalers and the flash latency
+   * are computed at compile time, ignore their grayed out areas below.
+   *
+   * The closest reachable frequency to the target is used.
+   *
+   * Insert the target system clock frequency (in Hz) *************************/
+  enum {
+    __TARGET_SYSTEM = 168000000
+  };
+  /****************************** Insert the target system clock (in Hz) above */
+
+  /* Must the USB/SDIO/RNG clock be exactly 48 MHz? ***************************/
+//#define USING_EXACT_48MHZ
+  /******* Comment the macro above to answer no, otherwise your answer is yes */
+  /* NOTE: USING_USB implies an exact 48 MHz clock. ***************************/
+#endif // USING_PLL_SOLVER
+
 #ifdef STM32F1XX
   /*****************************************************************************
    *
@@ -184,9 +207,11 @@ namespace clk {
    * HSE -------------> PREDIV1_OUTPUT
    *
    * Select the PREDIV1 source ************************************************/
+#ifndef USING_PLL_SOLVER
   enum {
     __PREDIV1 = 1
   };
+#endif // !USING_PLL_SOLVER
   /************************************************ Select the PREDIV1 source */
 #else // VALUE_LINE
   /*****************************************************************************
@@ -195,9 +220,11 @@ namespace clk {
    * HSE --------------------> PREDIV1_OUTPUT
    *
    * Select the PREDIV1 source ************************************************/
+#ifndef USING_PLL_SOLVER
   enum {
     __PLLXTPRE = 0
   };
+#endif // !USING_PLL_SOLVER
   /************************************************ Select the PREDIV1 source */
 #endif // VALUE_LINE
 #else // !CONNECTIVITY_LINE
@@ -225,9 +252,11 @@ namespace clk {
    * PLL2----+
    *
    * Select the PREDIV1 source ************************************************/
+#ifndef USING_PLL_SOLVER
   enum {
-    __PREDIV1 = 1
+    __PREDIV1 = 2
   };
+#endif // !USING_PLL_SOLVER
   rcc::cfgr2::prediv1src::States const __PREDIV1SRC =
   rcc::cfgr2::prediv1src::
   USE_PLL2_AS_PREDIV1_INPUT;
@@ -239,9 +268,15 @@ namespace clk {
    * PLLSRC ----------> PLL
    *
    * Select the PLL parameters ************************************************/
+#ifndef USING_PLL_SOLVER
   enum {
+#ifdef CONNECTIVITY_LINE
+    __PLLMUL = 4  // 4 to 9, or 13 for x6.5
+#else // CONNECTIVITY_LINE
     __PLLMUL = 2
+#endif // CONNECTIVITY_LINE
   };
+#endif // !USING_PLL_SOLVER
   /************************************************ Select the PLL paraneters */
 #else // STM32F1XX
   /****************************************************************************
@@ -268,12 +303,14 @@ namespace clk {
    *                                             1/PLLQ
    *
    * Define the PLL parameters below  *****************************************/
+#ifndef USING_PLL_SOLVER
   enum {
     __PLLM = 8,
     __PLLN = 336,
     __PLLP = 2,
     __PLLQ = 7
   };
+#endif // !USING_PLL_SOLVER
   /****************************************** Define the PLL parameters above */
 
 #endif // STM32F1XX
@@ -316,9 +353,11 @@ namespace clk {
    * PLL ------------------> USB
    *
    * Define the USB prescaler *************************************************/
+#ifndef USING_PLL_SOLVER
   enum {
     __USBPRE = 0
   };
+#endif // !USING_PLL_SOLVER
   /************************************************* Define the USB prescaler */
 
 #endif
@@ -446,11 +485,13 @@ namespace clk {
    *                          +----------->APB2CLK
    *
    * Define the prescaler parameters below ************************************/
+#ifndef USING_PLL_SOLVER
   enum {
     __HPRE = 0,
     __PPRE1 = 4,
     __PPRE2 = 2,
   };
+#endif // !USING_PLL_SOLVER
   /************************************ Define the prescaler parameters above */
 
 #ifdef STM32F1XX
@@ -520,9 +561,11 @@ namespace clk {
    ****************************************************************************/
 
   /* Select the flash memory access latency ***********************************/
+#ifndef USING_PLL_SOLVER
   flash::acr::latency::States const __LATENCY =
 //		  flash::acr::latency::ZERO_WAIT_STATE;
 		  flash::acr::latency::FIVE_WAIT_STATES;
+#endif // !USING_PLL_SOLVER
   /*********************************** Select the flash memory access latency */
   /* IMPORTANT: USING A LOW LATENCY AT HIGH CORE'S FREQUENCY MIGHT RESULT IN
    *            FLASH MEMORY ACCESS ERRORS AT RUN TIME. ***********************/
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "core/dwt.hpp"
 #include "core/fpu.hpp"
 #include "core/mpu.hpp"
 #include "core/nvic.hpp"
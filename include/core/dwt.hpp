@@ -0,0 +1,69 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                      Data Watchpoint and Trace Unit
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "../device_select.hpp"
+#include "../defs.hpp"
+
+#include "../../memorymap/dwt.hpp"
+
+// Low-level access to the registers
+#define _DWT reinterpret_cast<dwt::Registers*>(dwt::ADDRESS)
+
+// High-level functions
+namespace dwt {
+  class Functions {
+    public:
+      static inline void enableCycleCounter();
+      static inline void disableCycleCounter();
+      static inline u32 getCycleCount();
+      static inline void resetCycleCount();
+      static inline u8 getNumberOfComparators();
+
+      template<u8 N>
+      static inline void configureComparator(
+          u32 const,
+          u8 const,
+          dwt::function::function::States,
+          dwt::function::cycmatch::States);
+
+      template<u8 N>
+      static inline void disableComparator();
+
+      template<u8 N>
+      static inline bool hasComparatorMatched();
+
+    private:
+      Functions();
+  };
+}  // namespace dwt
+
+// High-level access to the peripheral
+typedef dwt::Functions DWT;
+
+#include "../../bits/dwt.tcc"
@@ -37,15 +37,45 @@
 
 // High-level functions
 namespace mpu {
+  constexpr u32 log2(u32 const x)
+  {
+    return x <= 1 ? 0 : 1 + log2(x >> 1);
+  }
+
+  /**
+   * @brief Returns the RASR size encoding of a <bytes> region.
+   * @note  <bytes> must be a power of 2, 32 bytes or more.
+   */
+  constexpr rasr::size::States toRegionSize(u32 const bytes)
+  {
+    return rasr::size::States((log2(bytes) - 1) << rasr::size::POSITION);
+  }
+
   class Functions {
     public:
-      // TODO MPU functions declaration
+      static inline void enable(
+          mpu::control::privdefena::States =
+              mpu::control::privdefena::DEFAULT_MAP_ENABLED_FOR_PRIVILEGED,
+          mpu::control::hfnmiena::States =
+              mpu::control::hfnmiena::MPU_DISABLED_DURING_FAULTS);
+      static inline void disable();
+      static inline u8 getRegionCount();
+      static inline void configureRegion(
+          u8 const,
+          u32 const,
+          mpu::rasr::size::States,
+          mpu::rasr::ap::States,
+          mpu::rasr::xn::States,
+          mpu::rasr::attributes::States =
+              mpu::rasr::attributes::NORMAL_WB,
+          u8 const = 0);
+      static inline void disableRegion(u8 const);
     private:
       Functions();
   };
 }  // namespace mpu
 
 // High-level access to the peripheral
-// TODO MPU high-level access
+typedef mpu::Functions MPU;
 
 #include "../../bits/mpu.tcc"
@@ -30,6 +30,7 @@
 #include "../device_select.hpp"
 #include "../defs.hpp"
 
+#include "scb.hpp"
 #include "../../memorymap/nvic.hpp"
 
 // Low-level access to the registers
@@ -56,6 +57,84 @@ namespace nvic {
     private:
       Functions();
   };
+
+  enum {
+    // The STM32 implement the 4 upper bits of each priority register
+    PRIORITY_BITS = 4
+  };
+
+  /**
+   * Declares the priority of an IRQ.
+   * @note  A lower number means a higher priority.
+   */
+  template<
+      nvic::irqn::E IRQ,
+      u8 PREEMPTION,
+      u8 SUBPRIORITY = 0
+  >
+  struct Priority {
+      enum {
+        IS_DEPENDENCY = 0,
+        IRQN = IRQ,
+        DEPENDENT = IRQ,
+        PREEMPTION_LEVEL = PREEMPTION,
+        SUBPRIORITY_LEVEL = SUBPRIORITY
+      };
+  };
+
+  /**
+   * Declares that the DEPENDENT ISR relies on the PROVIDER ISR (e.g. a
+   * driver on its DMA stream), so PROVIDER must be able to preempt it: its
+   * preemption priority must be strictly higher.
+   */
+  template<
+      nvic::irqn::E PROVIDER,
+      nvic::irqn::E DEPENDENT_IRQ
+  >
+  struct Precedes {
+      enum {
+        IS_DEPENDENCY = 1,
+        IRQN = PROVIDER,
+        DEPENDENT = DEPENDENT_IRQ,
+        PREEMPTION_LEVEL = 0,
+        SUBPRIORITY_LEVEL = 0
+      };
+  };
+
+  /**
+   * Declares every IRQ priority of the system in one place, e.g.:
+   *
+   *   typedef nvic::PriorityTable<
+   *       2,  // Bits of preemption priority, the rest are subpriority bits
+   *       nvic::Priority<nvic::irqn::DMA2_Stream7, 0>,
+   *       nvic::Priority<nvic::irqn::USART1, 1>,
+   *       nvic::Priority<nvic::irqn::TIM2, 2, 1>,
+   *       nvic::Priority<nvic::irqn::TIM3, 2, 0>,
+   *       nvic::Precedes<nvic::irqn::DMA2_Stream7, nvic::irqn::USART1>
+   *   > PRIORITIES;
+   *
+   *   PRIORITIES::apply();
+   *
+   * The table is checked at compile time: the levels must fit in the
+   * selected grouping, an IRQ can't be declared twice, two IRQs can't share
+   * the same level (preemption and subpriority) and each Precedes relation
+   * must hold.
+   */
+  template<
+      u8 PREEMPTION_BITS,
+      typename... ENTRIES
+  >
+  class PriorityTable {
+    public:
+      enum {
+        SUBPRIORITY_BITS = PRIORITY_BITS - PREEMPTION_BITS
+      };
+
+      static inline void apply();
+
+    private:
+      PriorityTable();
+  };
 }  // namespace nvic
 
 // High-level access to the perihperal
@@ -39,13 +39,32 @@
 namespace scb {
   class Functions {
     public:
-      // TODO SCB functions declaration
+      static inline bool isSysTickPending();
+      static inline void setPendSVPending();
+      static inline void setPendSVPriority(u8 const);
+      static inline void setVectorTable(void const* const);
+      static inline u32 getVectorTable();
+      static inline void setPriorityGrouping(scb::aircr::prigroup::States);
+      static inline void waitForInterrupt();
+      static inline void setSleepMode(scb::scr::sleepdeep::States);
+      static inline void enableMemoryManagementFault();
+      static inline void disableMemoryManagementFault();
+      static inline u8 getMemoryManagementFaultStatus();
+      static inline void clearMemoryManagementFaultStatus();
+      static inline u32 getMemoryManagementFaultAddress();
+      static inline void enableBusFault();
+      static inline void enableUsageFault();
+      static inline u32 getFaultStatus();
+      static inline u32 getHardFaultStatus();
+      static inline u32 getBusFaultAddress();
+      static inline void clearFaultStatus();
+      static inline void resetSystem() __attribute__((noreturn));
     private:
       Functions();
   };
 }  // namespace scb
 
 // High-level access to the peripheral
-// TODO SCB high-level access
+typedef scb::Functions SCB;
 
 #include "../../bits/scb.tcc"
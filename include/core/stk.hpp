@@ -62,6 +62,7 @@ namespace stk {
 //	  static inline void set1MsTicker();
 
 	  static inline void configurePeriodicInterrupt(u32 const);
+	  static inline void setInterruptFrequency(u32 const, u32 const);
 
 	  static inline u32 getAutoReloadValue();
 	  static inline void reloadSysTick(u32 const);
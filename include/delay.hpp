@@ -0,0 +1,121 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                        Non-blocking timer delays
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "critical.hpp"
+#include "core/scb.hpp"
+#include "peripheral/tim.hpp"
+
+/**
+ * A free running timer counts at RESOLUTION Hz, its overflows are counted by
+ * the update interrupt to extend the time base to 32 bits. Pending alarms
+ * are kept in a list sorted by deadline, the compare channel 1 is always
+ * armed with the earliest one, so many deadlines are multiplexed on a single
+ * timer and the core is only interrupted when one of them expires.
+ *
+ *   typedef delay::Functions<tim::TIM2, 1000000> DELAY;  // 1 us resolution
+ *
+ *   delay::Alarm alarm;
+ *
+ *   void onAlarm(void* context) { ... }
+ *
+ *   DELAY::initialize();
+ *   DELAY::start(alarm, 250, onAlarm, 0);  // Callback in 250 us
+ *   DELAY::sleep(40);  // The core sleeps (WFI) for 40 us
+ *
+ * The user must call DELAY::onInterrupt() from the timer interrupt handler
+ * (from both the update and the capture/compare handlers for TIM1 and TIM8).
+ * The callbacks run in that context.
+ */
+namespace delay {
+  typedef void (*Callback)(void*);
+
+  class Alarm {
+    public:
+      inline Alarm();
+
+      inline bool isPending() const;
+      inline u32 getDeadline() const;
+
+    private:
+      template<tim::Address, u32> friend class Functions;
+
+      Alarm* next;
+      u32 deadline;  // In timer ticks
+      Callback callback;
+      void* context;
+      bool volatile pending;
+  };
+
+  template<tim::Address TIMER, u32 RESOLUTION>
+  class Functions {
+      static_assert(TIMER != tim::TIM6 && TIMER != tim::TIM7,
+          "The basic timers don't have compare channels.");
+      static_assert(tim::Functions<TIMER>::FREQUENCY % RESOLUTION == 0,
+          "The resolution must divide the timer clock.");
+      static_assert(tim::Functions<TIMER>::FREQUENCY / RESOLUTION <= 65536,
+          "The resolution is too low for the timer prescaler.");
+
+    public:
+      static inline void initialize();
+      static inline void onInterrupt();
+
+      static inline u32 getTime();
+
+      static inline void start(
+          Alarm&,
+          u32 const,
+          Callback const,
+          void* const);
+      static inline void startAt(
+          Alarm&,
+          u32 const,
+          Callback const,
+          void* const);
+      static inline void cancel(Alarm&);
+
+      static inline void sleep(u32 const);
+      static inline void sleepUntil(u32 const);
+
+    private:
+      Functions();
+
+      typedef tim::Functions<TIMER> Timer;
+
+      static inline void unlink(Alarm&);
+      static inline void arm();
+
+      static u32 volatile overflows;
+      static Alarm* queue;
+  };
+}  // namespace delay
+
+#include "../bits/delay.tcc"
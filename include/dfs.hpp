@@ -0,0 +1,194 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                  Run time clock switching (frequency scaling)
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "clock.hpp"
+#include "pll.hpp"
+#include "peripheral/pwr.hpp"
+
+#ifndef STM32F1XX
+/**
+ * clk::initialize() brings the microcontroller to the operating point
+ * described in clock.hpp, all the FREQUENCY enums of the peripheral classes
+ * are derived from it. This module lets the application switch, at run time,
+ * between operating points, e.g. race at full speed and then drop to the HSI
+ * oscillator to save power.
+ *
+ * An operating point is built at compile time:
+ *
+ *   constexpr dfs::OperatingPoint FULL_SPEED = dfs::usePll<168000000>();
+ *   constexpr dfs::OperatingPoint LOW_POWER = dfs::useHsi();
+ *
+ * And selected at run time:
+ *
+ *   DFS::switchTo(LOW_POWER);
+ *
+ * After a switch the compile time FREQUENCY enums are no longer valid, the
+ * drivers that depend on a bus clock must be rescaled. Register a listener
+ * for each of them, the listeners are called after every switch:
+ *
+ *   void onClockChange()
+ *   {
+ *     USART1::setBaudRate(115200, DFS::getApb2Frequency());
+ *     TIM6::setMicroSecondResolution(DFS::getApb1TimerFrequency());
+ *     STK::setInterruptFrequency(1000, DFS::getSysTickFrequency());
+ *   }
+ *
+ *   DFS::subscribe(onClockChange);
+ */
+namespace dfs {
+  enum {
+    MAX_LISTENERS = 8,
+#ifdef STM32F4XX
+    // Highest system clock allowed in voltage scale 2
+    SCALE_2_MAX = 144000000,
+#endif // STM32F4XX
+#if defined USING_USB || \
+    defined USING_EXACT_48MHZ
+    EXACT_48MHZ = 1
+#else // USING_USB || USING_EXACT_48MHZ
+    EXACT_48MHZ = 0
+#endif // USING_USB || USING_EXACT_48MHZ
+  };
+
+  typedef void (*Listener)();
+
+  struct OperatingPoint {
+      rcc::cfgr::sw::States source;
+      u32 pll;  // pll::pack() solution, 0 if the PLL isn't used
+      u8 hpre;  // Power of 2 exponents, as in clock.hpp
+      u8 ppre1;
+      u8 ppre2;
+      u32 system;
+  };
+
+  /**
+   * @brief Builds an operating point, the bus prescalers are chosen to
+   *        respect the maximum APB frequencies.
+   */
+  constexpr OperatingPoint build(
+      rcc::cfgr::sw::States const source,
+      u32 const solution,
+      u32 const system)
+  {
+    return OperatingPoint {
+      source,
+      solution,
+      0,
+      pll::prescaler(system, pll::APB1_MAX),
+      pll::prescaler(system, pll::APB2_MAX),
+      system
+    };
+  }
+
+  /**
+   * @brief The HSI oscillator drives the system clock.
+   */
+  constexpr OperatingPoint useHsi()
+  {
+    return build(
+        rcc::cfgr::sw::HSI_OSCILLATOR_SELECTED_AS_SYSTEM_CLOCK,
+        0,
+        clk::HSI);
+  }
+
+#if defined USING_HSE_CLOCK || \
+    defined USING_HSE_CRYSTAL
+  /**
+   * @brief The HSE oscillator drives the system clock.
+   */
+  constexpr OperatingPoint useHse()
+  {
+    return build(
+        rcc::cfgr::sw::HSE_OSCILLATOR_SELECTED_AS_SYSTEM_CLOCK,
+        0,
+        clk::HSE);
+  }
+#endif // USING_HSE_CLOCK || USING_HSE_CRYSTAL
+
+#ifdef USING_PLL
+  /**
+   * @brief The PLL drives the system clock at <SYSTEM> Hz.
+   * @note  The PLL source is the one selected in clock.hpp.
+   * @note  If USB is used or USING_EXACT_48MHZ is defined, the 48 MHz
+   *        output is kept exact.
+   */
+  template<u32 SYSTEM>
+  constexpr OperatingPoint usePll()
+  {
+    static_assert(SYSTEM <= pll::SYSTEM_MAX,
+        "The system clock exceeds the maximum of this family.");
+    static_assert(pll::solve(clk::_PLLSRC, SYSTEM, EXACT_48MHZ) != 0,
+        "This system clock can't be reached with this PLL source.");
+
+    return build(
+        rcc::cfgr::sw::PLL_SELECTED_AS_SYSTEM_CLOCK,
+        pll::solve(clk::_PLLSRC, SYSTEM, EXACT_48MHZ),
+        pll::output(
+            clk::_PLLSRC,
+            pll::solve(clk::_PLLSRC, SYSTEM, EXACT_48MHZ)));
+  }
+#endif // USING_PLL
+
+  class Functions {
+    public:
+      static inline bool switchTo(OperatingPoint const&);
+      static inline bool restore();
+      static inline OperatingPoint const& getOperatingPoint();
+
+      static inline u32 getSystemFrequency();
+      static inline u32 getAhbFrequency();
+      static inline u32 getApb1Frequency();
+      static inline u32 getApb2Frequency();
+      static inline u32 getApb1TimerFrequency();
+      static inline u32 getApb2TimerFrequency();
+      static inline u32 getSysTickFrequency();
+
+      static inline bool subscribe(Listener);
+      static inline void unsubscribe(Listener);
+
+    private:
+      Functions();
+
+      static inline OperatingPoint& current();
+      static inline Listener* listeners();
+      static inline void setFlashLatency(u32 const);
+      static inline bool usesHse(OperatingPoint const&);
+      static inline bool apply(OperatingPoint const&);
+      static inline void notify();
+  };
+}  // namespace dfs
+
+// High-level access to the clock manager
+typedef dfs::Functions DFS;
+
+#include "../bits/dfs.tcc"
+#endif // !STM32F1XX
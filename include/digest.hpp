@@ -0,0 +1,115 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                      Software SHA-1, MD5 and HMAC digests
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "defs.hpp"
+
+/**
+ * Software implementation of the digests computed by the HASH peripheral,
+ * for the devices that lack it (F1, F205/F207, F405/F407). Each digest is an
+ * object, so any number of them can be computed at the same time:
+ *
+ *   digest::Hash<digest::Sha1> sha1;
+ *   u8 result[digest::Sha1::SIZE];
+ *
+ *   sha1.init();
+ *   sha1.update(header, sizeof(header));
+ *   sha1.update(payload, size);
+ *   sha1.final(result);
+ *
+ *   digest::Hmac<digest::Sha1> hmac;
+ *
+ *   hmac.init(key, sizeof(key));
+ *   hmac.update(message, size);
+ *   hmac.final(result);
+ *
+ * The results are the same bytes as the ones returned by HASH::final().
+ */
+namespace digest {
+  enum {
+    BLOCK_SIZE = 64
+  };
+
+  struct Sha1 {
+      enum {
+        SIZE = 20,
+        WORDS = 5,
+        // Byte order of the length and of the digest words
+        MSB_FIRST = 1
+      };
+
+      static inline void initialize(u32* const);
+      static inline void compress(u32* const, u8 const* const);
+  };
+
+  struct Md5 {
+      enum {
+        SIZE = 16,
+        WORDS = 4,
+        MSB_FIRST = 0
+      };
+
+      static inline void initialize(u32* const);
+      static inline void compress(u32* const, u8 const* const);
+  };
+
+  template<typename ALGORITHM>
+  class Hash {
+    public:
+      enum {
+        SIZE = ALGORITHM::SIZE
+      };
+
+      inline void init();
+      inline void update(void const* const, u32);
+      inline void final(u8* const);
+
+    private:
+      u32 state[ALGORITHM::WORDS];
+      u8 block[BLOCK_SIZE];
+      u32 length;
+  };
+
+  template<typename ALGORITHM>
+  class Hmac {
+    public:
+      enum {
+        SIZE = ALGORITHM::SIZE
+      };
+
+      inline void init(void const* const, u32 const);
+      inline void update(void const* const, u32 const);
+      inline void final(u8* const);
+
+    private:
+      Hash<ALGORITHM> inner;
+      u8 key[BLOCK_SIZE];
+  };
+}  // namespace digest
+
+#include "../bits/digest.tcc"
@@ -26,6 +26,8 @@
 
 #include "../peripheral/gpio.hpp"
 #include "../peripheral/tim.hpp"
+#include "../peripheral/i2c.hpp"
+#include "../peripheral/dma.hpp"
 
 namespace sccb {
   template<
@@ -68,6 +70,86 @@ namespace sccb {
     private:
       Functions();
   };
+
+  /**
+   * Register address/value pair, used to describe a device configuration.
+   */
+  struct Register {
+      u8 address;
+      u8 value;
+  };
+
+#ifndef STM32F1XX
+  /**
+   * This class implements the SCCB protocol on top of the I2C peripheral.
+   *
+   * SCCB differs from I2C in two ways:
+   * + The 9th bit of each byte is "don't care", the slave may not acknowledge
+   *   the written data, so a missing ACK after the data byte isn't an error.
+   * + A read is done as two separate transactions, a stop condition must be
+   *   sent between the register address write and the data read.
+   *
+   * Besides the blocking register access, a table of registers can be written
+   * in the background. Each entry is sent in its own write transaction, the
+   * I2C event interrupt sequences the start/address/stop conditions and the
+   * DMA stream <DMA_STREAM> feeds the register address and value bytes.
+   *
+   * The user must configure the SDA/SCL pins (alternate function, open drain)
+   * and must call the functions:
+   *
+   * + onEventInterrupt
+   * + onErrorInterrupt
+   *
+   * on the corresponding I2C interrupts.
+   *
+   * See the demo folder for an example.
+   */
+  template<
+      i2c::Address I2C_ADDRESS,
+      u32 FREQUENCY,
+      dma::common::Address DMA_ADDRESS,
+      dma::stream::Address DMA_STREAM,
+      dma::stream::cr::chsel::States DMA_CHANNEL
+  >
+  class Hardware {
+      static_assert(FREQUENCY <= 400000, "SCCB can't exceed 400 KHz.");
+
+      typedef i2c::Standard<I2C_ADDRESS> I2C;
+      typedef dma::stream::Functions<DMA_ADDRESS, DMA_STREAM> DMA;
+
+    public:
+      static inline void initialize();
+      static bool writeSlaveRegister(
+          u8 const slaveAddress,
+          u8 const registerAddress,
+          u8 const value);
+      static bool readSlaveRegister(
+          u8 const slaveAddress,
+          u8 const registerAddress,
+          u8& value);
+      static void writeRegisterTable(
+          u8 const slaveAddress,
+          Register const* const table,
+          u16 const size);
+      static inline bool isBusy();
+      static inline u16 getNumberOfFailedWrites();
+      static void onEventInterrupt();
+      static void onErrorInterrupt();
+
+    private:
+      Hardware();
+
+      static inline void stop();
+      static inline void startNextWrite();
+
+      static u8 slave;
+      static Register const* volatile entry;
+      static u16 volatile remaining;
+      static u16 volatile failed;
+      static bool volatile acknowledged;
+      static bool volatile busy;
+  };
+#endif // !STM32F1XX
 }
 
 #include "../../bits/sccb.tcc"
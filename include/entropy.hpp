@@ -0,0 +1,108 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                     Entropy pool refilled by the RNG interrupt
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+
+#ifndef STM32F1XX
+
+#include "defs.hpp"
+
+#include "critical.hpp"
+#include "core/nvic.hpp"
+#include "peripheral/rng.hpp"
+
+/**
+ * The RNG needs about 40 of its clock cycles per word. The pool keeps a ring
+ * of WORDS random words, refilled from the RNG interrupt, so that keys and
+ * nonces can be taken without waiting:
+ *
+ *   typedef entropy::Pool<64> ENTROPY;
+ *
+ *   void interrupt::HASH_RNG() { ENTROPY::onInterrupt(); }
+ *
+ *   ENTROPY::initialize();
+ *
+ *   u8 nonce[12];
+ *
+ *   if (ENTROPY::fill(nonce, sizeof(nonce)) == sizeof(nonce)) { ... }
+ *
+ * The refill stops while the ring is full, so the RNG doesn't keep
+ * interrupting.
+ *
+ * Health checks:
+ *
+ *  - Seed error: the generator is restarted, as required by the reference
+ *    manual.
+ *  - Clock error: the flag is cleared, the generation resumes by itself
+ *    once the RNG clock is fast enough again.
+ *  - Continuous test: a word equal to the previous one is discarded, and
+ *    the generator restarted. The first word after a (re)start is only used
+ *    for comparison.
+ *
+ * The error counters let the application decide when to stop trusting the
+ * generator.
+ */
+namespace entropy {
+  template<u16 WORDS>
+  class Pool {
+      static_assert((WORDS != 0) && ((WORDS & (WORDS - 1)) == 0),
+          "The pool size must be a power of 2.");
+
+    public:
+      static inline void initialize();
+      static inline void onInterrupt();
+
+      static inline bool getValue(u32&);
+      static inline u32 fill(void* const, u32 const);
+      static inline u16 getAvailable();
+
+      static inline u32 getSeedErrors();
+      static inline u32 getClockErrors();
+      static inline u32 getRepetitions();
+
+    private:
+      Pool();
+
+      static inline void restart();
+      static inline void resume();
+
+      static u32 volatile words[WORDS];
+      static u32 volatile head;  // Only written by the consumer
+      static u32 volatile tail;  // Only written by the interrupt
+      static u32 last;
+      static bool primed;
+      static u32 volatile seedErrors;
+      static u32 volatile clockErrors;
+      static u32 volatile repetitions;
+  };
+}  // namespace entropy
+
+#include "../bits/entropy.tcc"
+
+#endif // !STM32F1XX
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                  Run-to-completion executor on the PendSV
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "core/scb.hpp"
+
+/**
+ * Interrupt handlers should only acknowledge the hardware and post the
+ * heavy work as a task. The tasks are queued in one lock-free queue per
+ * priority level, and run to completion from the PendSV exception, which
+ * has the lowest interrupt priority: every interrupt preempts them, and
+ * the tasks never preempt each other.
+ *
+ * After each task the dispatcher restarts from the highest priority level
+ * (0), so urgent work posted meanwhile doesn't wait behind a backlog of
+ * lower priority work.
+ *
+ *   typedef executor::Functions<2, 8> EXECUTOR;  // 2 levels, 8 deep (2^n)
+ *
+ *   void sortPulses(void* context) { ... }
+ *
+ *   executor::Task sort(sortPulses, 0, 1);  // Static storage, priority 1
+ *
+ *   void interrupt::TIM6() { TIM6::clearUpdateFlag(); EXECUTOR::post(sort); }
+ *   // And from the PendSV exception handler (startup code):
+ *   EXECUTOR::onPendSVInterrupt();
+ *
+ *   EXECUTOR::initialize();
+ *
+ * A task can't be queued twice, posting a queued task is a no-op, so the
+ * queues never hold more entries than there are tasks. The high-water
+ * marks tell how deep each queue needed to be.
+ */
+namespace executor {
+  typedef void (*Work)(void*);
+
+  class Task {
+    public:
+      inline Task(Work const, void* const, u8 const);
+
+      inline bool isQueued() const;
+      inline u8 getPriority() const;
+
+    private:
+      template<u8, u8> friend class Functions;
+
+      Work work;
+      void* context;
+      u8 priority;  // 0 is the highest
+      u8 volatile queued;
+  };
+
+  template<u8 PRIORITIES, u8 DEPTH>
+  class Functions {
+      static_assert(PRIORITIES != 0,
+          "There must be at least one priority level.");
+      static_assert((DEPTH != 0) && ((DEPTH & (DEPTH - 1)) == 0),
+          "The queue depth must be a power of 2.");
+
+    public:
+      static inline void initialize();
+      static inline void onPendSVInterrupt();
+
+      static inline bool post(Task&);
+
+      static inline u8 getHighWaterMark(u8 const);
+      static inline void clearHighWaterMarks();
+
+    private:
+      Functions();
+
+      struct Queue {
+          Task* volatile slots[DEPTH];
+          u32 volatile head;  // Only written by the dispatcher
+          u32 volatile tail;  // Reserved by the producers
+          u8 volatile highWaterMark;
+      };
+
+      static inline Task* pop(Queue&);
+
+      static Queue queues[PRIORITIES];
+  };
+}  // namespace executor
+
+#include "../bits/executor.tcc"
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                          Fault post-mortem records
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "fault_record.hpp"
+#include "stack.hpp"
+#include "core/scb.hpp"
+#include "peripheral/pwr.hpp"
+#include "peripheral/rcc.hpp"
+#ifdef STM32F1XX
+#include "peripheral/bkp.hpp"
+#endif // STM32F1XX
+
+/**
+ * The fault handlers capture the exception frame, the fault status registers
+ * and a short backtrace into memory that survives a reset, then reset the
+ * system. On the next boot the record can be retrieved, reported and
+ * cleared:
+ *
+ *   FAULT_HANDLER(HardFault_Handler)  // Startup vector names
+ *   FAULT_HANDLER(MemManage_Handler)
+ *   FAULT_HANDLER(BusFault_Handler)
+ *   FAULT_HANDLER(UsageFault_Handler)
+ *
+ *   FAULT::initialize();
+ *
+ *   fault::Record record;
+ *
+ *   if (FAULT::getRecord(record)) {
+ *     fault::Decoder::dump<USART1>(record);
+ *     FAULT::clearRecord();
+ *   }
+ *
+ * With the main stack guard of stack.hpp, the fault handler owns the
+ * MemManage vector and chains to the guard report once the record is
+ * stored. Use this instead of FAULT_HANDLER(MemManage_Handler) and
+ * STACK_GUARD_HANDLER():
+ *
+ *   FAULT_STACK_GUARD_HANDLER(MemManage_Handler, STACK)
+ *
+ * The handlers run on their own stack of FAULT_STACK_SIZE bytes, so a
+ * record is still written after the main stack overflowed.
+ *
+ * The record lives at the start of the backup SRAM on F2/F4 devices. On F1
+ * devices it's split in the 16-bit backup data registers, starting at DR1,
+ * FAULT_BACKUP_REGISTERS sets how many can be used: only the first words of
+ * the record are kept if they are too few (e.g. 10 registers keep up to the
+ * PC). The record format is described in fault_record.hpp.
+ *
+ * The stacked registers are 0 if the frame couldn't be stacked, or lies out
+ * of the main stack (see stack.hpp for its linker symbols). The backtrace is
+ * made of the words above a main stack frame that look like return
+ * addresses (odd and in the flash), the spurious entries must be sorted out
+ * with the map file.
+ */
+
+#ifdef STM32F1XX
+#ifndef FAULT_BACKUP_REGISTERS
+// 10 on the low and medium density devices, 42 on the others
+#define FAULT_BACKUP_REGISTERS 10
+#endif // FAULT_BACKUP_REGISTERS
+#endif // STM32F1XX
+
+#ifndef FAULT_STACK_SIZE
+#define FAULT_STACK_SIZE 512
+#endif // FAULT_STACK_SIZE
+
+// Defines the fault exception handler <VECTOR>, it passes the exception
+// frame and the EXC_RETURN value to <TARGET> and moves the MSP to the fault
+// stack, the main stack may have overflowed
+#define FAULT_ENTRY(VECTOR, TARGET) \
+  extern "C" __attribute__((naked)) void VECTOR() \
+  { \
+    asm volatile ( \
+        "tst lr, #4\n\t" \
+        "ite eq\n\t" \
+        "mrseq r0, msp\n\t" \
+        "mrsne r0, psp\n\t" \
+        "mov r1, lr\n\t" \
+        "ldr r2, =%c1\n\t" \
+        "msr msp, r2\n\t" \
+        "b %c0\n\t" \
+        ".ltorg" \
+        : \
+        : "i" (TARGET), \
+          "i" (&fault::Stack<>::words[fault::STACK_WORDS])); \
+  }
+
+// Records the fault and resets the system
+#define FAULT_HANDLER(VECTOR) \
+  FAULT_ENTRY(VECTOR, &fault::Functions::onFault)
+
+// Records the fault, then reports the stack guard violations to STACK
+#define FAULT_STACK_GUARD_HANDLER(VECTOR, STACK) \
+  FAULT_ENTRY(VECTOR, &fault::Functions::onStackGuardFault<STACK>)
+
+namespace fault {
+  enum {
+    // Flash range searched for return addresses
+    CODE_SIZE = 0x200000,
+    STACK_WORDS = FAULT_STACK_SIZE / sizeof(u32),
+#ifdef STM32F1XX
+    CAPACITY = FAULT_BACKUP_REGISTERS / 2 < RECORD_WORDS ?
+        FAULT_BACKUP_REGISTERS / 2 : RECORD_WORDS
+#else
+    CAPACITY = RECORD_WORDS
+#endif // STM32F1XX
+  };
+
+  static_assert(u32(CAPACITY) >= u32(HEADER_WORDS),
+      "The record header needs at least 6 backup registers.");
+
+  /**
+   * The stack the fault handlers switch to.
+   */
+  template<typename = void>
+  struct Stack {
+      static u32 words[STACK_WORDS] __attribute__((aligned(8)));
+  };
+
+  class Functions {
+    public:
+      static inline void initialize();
+
+      static inline bool getRecord(Record&);
+      static inline bool hasRecord();
+      static inline void clearRecord();
+
+      static inline void onFault(u32 const*, u32 const)
+          __attribute__((noreturn));
+      template<typename STACK>
+      static inline void onStackGuardFault(u32 const*, u32 const)
+          __attribute__((noreturn));
+
+    private:
+      Functions();
+
+      static inline u32 capture(u32 const*, u32 const);
+      static inline bool isReturnAddress(u32 const);
+      static inline void store(u8 const, u32 const);
+      static inline u32 load(u8 const);
+  };
+}  // namespace fault
+
+// High-level access to the fault records
+typedef fault::Functions FAULT;
+
+#include "../bits/fault.tcc"
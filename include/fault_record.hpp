@@ -0,0 +1,114 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *
+ *                      Fault post-mortem record format
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "defs.hpp"
+
+#include "text.hpp"
+
+/**
+ * The record written by the fault handlers of fault.hpp, little endian 32-bit
+ * words:
+ *
+ *    0  MAGIC
+ *    1  Number of stored words
+ *    2  Checksum, ~(sum of the other stored words)
+ *    3  Active exception number (3 HardFault ... 6 UsageFault)
+ *    4  PC       5  LR       6  xPSR     (stacked)
+ *    7  Address of the exception frame (MSP or PSP)
+ *    8  EXC_RETURN
+ *    9  CFSR    10  HFSR    11  MMFAR   12  BFAR
+ *   13  R0      14  R1      15  R2      16  R3      17  R12  (stacked)
+ *   18  Number of backtrace entries
+ *   19+ Backtrace
+ *
+ * Nothing here touches a register, so the decoder also builds on the host,
+ * e.g. to read a dump of the backup SRAM taken with a debugger:
+ *
+ *   fault::Record record;
+ *
+ *   if (fault::Decoder::decode(words, count, record)) {
+ *     fault::Decoder::dump<CONSOLE>(record);
+ *   }
+ */
+namespace fault {
+  enum {
+    MAGIC = 0xFA017001,
+    BACKTRACE_DEPTH = 8
+  };
+
+  struct Record {
+      u32 magic;
+      u32 words;
+      u32 checksum;
+      u32 exception;
+      u32 pc;
+      u32 lr;
+      u32 xpsr;
+      u32 sp;
+      u32 excReturn;
+      u32 cfsr;
+      u32 hfsr;
+      u32 mmfar;
+      u32 bfar;
+      u32 r0;
+      u32 r1;
+      u32 r2;
+      u32 r3;
+      u32 r12;
+      u32 depth;
+      u32 backtrace[BACKTRACE_DEPTH];
+  };
+
+  enum {
+    RECORD_WORDS = sizeof(Record) / sizeof(u32),
+    // Magic, number of words and checksum
+    HEADER_WORDS = 3
+  };
+
+  class Decoder {
+    public:
+      static inline void seal(Record&, u32 const);
+      static inline bool decode(u32 const*, u32 const, Record&);
+
+      static inline char const* getExceptionName(u32 const);
+      static inline char const* getCauseName(u8 const);
+      static inline u32 getCauses(Record const&);
+
+      template<typename OUTPUT>
+      static inline void dump(Record const&);
+
+    private:
+      Decoder();
+
+      static inline u32 getChecksum(u32 const*, u32 const);
+  };
+}  // namespace fault
+
+#include "../bits/fault_record.tcc"
@@ -0,0 +1,179 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                     Tickless idle in the STOP mode
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "critical.hpp"
+#include "dfs.hpp"
+#include "systime.hpp"
+#include "core/nvic.hpp"
+#include "core/scb.hpp"
+#include "core/stk.hpp"
+#include "peripheral/exti.hpp"
+#include "peripheral/pwr.hpp"
+#include "peripheral/rtc.hpp"
+
+#ifndef STM32F1XX
+/**
+ * When the systime wheel has no timer due in the next MIN_SLEEP_TICKS, the
+ * idle manager stops the SysTick, programs the RTC wakeup timer for the
+ * idle period and enters the STOP mode with the regulator in low power
+ * mode. On wake up the clock tree is restored with DFS::restore() and the
+ * time base is advanced by the time spent in STOP, so the timers keep
+ * their deadlines.
+ *
+ *   typedef systime::Functions<1000> SYSTIME;
+ *   typedef idle::Functions<1000, clk::LSE, 10> IDLE;  // Naps of 10+ ms
+ *
+ *   SYSTIME::initialize();
+ *   IDLE::initialize();
+ *
+ *   while (true) {
+ *     IDLE::enter();
+ *   }
+ *
+ * The RTC must be clocked (USING_RTC) from RTC_FREQUENCY, the wakeup timer
+ * runs on RTC_FREQUENCY / 16. The user must call IDLE::onWakeupInterrupt()
+ * from the RTC_WKUP interrupt handler.
+ *
+ * The deadline arithmetic is done by the free functions below, which
+ * don't touch any register.
+ */
+namespace idle {
+  enum {
+    // Wakeup timer reload range
+    MAX_WAKEUP_COUNTS = 0x10000
+  };
+
+  /**
+   * @brief Converts ticks to wakeup timer counts, rounding down so the
+   *        core never wakes up after the deadline.
+   */
+  constexpr u32 toWakeupCounts(
+      u32 const ticks,
+      u32 const tickFrequency,
+      u32 const wakeupFrequency)
+  {
+    return u64(ticks) * wakeupFrequency / tickFrequency > MAX_WAKEUP_COUNTS ?
+        u32(MAX_WAKEUP_COUNTS) :
+        u32(u64(ticks) * wakeupFrequency / tickFrequency);
+  }
+
+  /**
+   * @brief Converts <units> of a clock running at <unitFrequency> to
+   *        wakeup timer counts, rounding down.
+   */
+  constexpr u32 toCounts(
+      u32 const units,
+      u32 const unitFrequency,
+      u32 const wakeupFrequency)
+  {
+    return u64(units) * wakeupFrequency / unitFrequency;
+  }
+
+  /**
+   * @brief Returns the wakeup timer counts to sleep when no timer is due in
+   *        the next <idle> ticks, one tick being kept to restart the clocks,
+   *        or 0 if <idle> is shorter than <minSleepTicks>.
+   */
+  constexpr u32 toSleepCounts(
+      u32 const idle,
+      u32 const minSleepTicks,
+      u32 const tickFrequency,
+      u32 const wakeupFrequency)
+  {
+    return idle < minSleepTicks ?
+        0 :
+        toWakeupCounts(idle - 1, tickFrequency, wakeupFrequency);
+  }
+
+  /**
+   * @brief Returns the units elapsed between two readings of a counter that
+   *        wraps around at <period>.
+   */
+  constexpr u32 elapsed(u32 const before, u32 const after, u32 const period)
+  {
+    return after >= before ? after - before : after + period - before;
+  }
+
+  /**
+   * @brief Converts <counts> wakeup timer periods to ticks, rounding down.
+   *        The remainder is kept in <residue> (in 1 / wakeupFrequency
+   *        ticks) and added to the next conversion, so nothing is lost.
+   */
+  inline u32 toTicks(
+      u32 const counts,
+      u32 const tickFrequency,
+      u32 const wakeupFrequency,
+      u32& residue)
+  {
+    u64 const scaled = u64(counts) * tickFrequency + residue;
+
+    residue = scaled % wakeupFrequency;
+
+    return scaled / wakeupFrequency;
+  }
+
+  template<u32 TICK_FREQUENCY, u32 RTC_FREQUENCY, u32 MIN_SLEEP_TICKS>
+  class Functions {
+      static_assert(MIN_SLEEP_TICKS >= 2,
+          "The idle manager needs at least 2 ticks to enter the STOP mode.");
+      static_assert(
+          toWakeupCounts(MIN_SLEEP_TICKS - 1, TICK_FREQUENCY,
+              RTC_FREQUENCY / 16) != 0,
+          "The minimum sleep is shorter than a wakeup timer period.");
+
+    public:
+      enum {
+        WAKEUP_FREQUENCY = RTC_FREQUENCY / 16,
+        // One tick is kept to restart the clocks
+        MAX_SLEEP_TICKS =
+        u64(MAX_WAKEUP_COUNTS) * TICK_FREQUENCY / WAKEUP_FREQUENCY + 1,
+        SECONDS_PER_DAY = 86400
+      };
+
+      static inline void initialize();
+      static inline void onWakeupInterrupt();
+
+      static inline bool enter();
+
+    private:
+      Functions();
+
+      typedef systime::Functions<TICK_FREQUENCY> Systime;
+
+      static inline void compensate(u32 const);
+
+      static u32 residue;  // Fraction of a tick, see toTicks()
+  };
+}  // namespace idle
+
+#include "../bits/idle.tcc"
+#endif // !STM32F1XX
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                   Relocatable vector table and handler binding
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "interrupt.hpp"
+#include "core/scb.hpp"
+#include "../memorymap/nvic.hpp"
+
+/**
+ * Two ways to bind a handler to an interrupt are offered.
+ *
+ * Compile time binding, the vector in flash points directly to the handler,
+ * no trampoline or dispatch is involved:
+ *
+ *   BIND_INTERRUPT(TIM6_DAC, SCCB::onEventInterrupt)
+ *   BIND_INTERRUPT_TO_OBJECT(TIM2, servo, onPeriodTimerInterrupt)
+ *
+ * Run time binding, the vector table is copied to SRAM and handlers can be
+ * swapped while the program runs:
+ *
+ *   ISR::relocate();
+ *   ISR::attach<nvic::irqn::TIM2>(someFunction);
+ *   ISR::attach<nvic::irqn::TIM2, Servo, &Servo::onPeriodTimerInterrupt>(servo);
+ *   ISR::detach<nvic::irqn::TIM2>();
+ *
+ * A member function handler goes through a single trampoline that loads the
+ * object pointer, the member function itself is resolved at compile time.
+ */
+
+// Defines the interrupt handler <VECTOR> as a direct call to <HANDLER>
+#define BIND_INTERRUPT(VECTOR, HANDLER) \
+  void interrupt::VECTOR() \
+  { \
+    HANDLER(); \
+  }
+
+// Defines the interrupt handler <VECTOR> as a direct call to OBJECT.MEMBER()
+#define BIND_INTERRUPT_TO_OBJECT(VECTOR, OBJECT, MEMBER) \
+  void interrupt::VECTOR() \
+  { \
+    (OBJECT).MEMBER(); \
+  }
+
+namespace isr {
+  /**
+   * @brief Returns the smallest power of 2 not below <size>.
+   */
+  constexpr u32 toPowerOfTwo(u32 const size, u32 const power = 1)
+  {
+    return power >= size ? power : toPowerOfTwo(size, 2 * power);
+  }
+
+  enum {
+    // Stack pointer + system exceptions
+    SYSTEM_VECTORS = 16,
+    // One past the last IRQ of the device, as listed in nvic::irqn
+#ifdef STM32F4XX
+    IRQS = nvic::irqn::FPU + 1,
+#elif defined STM32F2XX
+    IRQS = nvic::irqn::HASH_RNG + 1,
+#elif defined CONNECTIVITY_LINE
+    IRQS = nvic::irqn::OTG_FS + 1,
+#elif defined VALUE_LINE
+    IRQS = nvic::irqn::DMA2_Channel5 + 1,
+#else
+    IRQS = nvic::irqn::DMA2_Channel4_5 + 1,
+#endif
+    VECTORS = SYSTEM_VECTORS + IRQS,
+    // VTOR requires the table size rounded up to a power of 2
+    ALIGNMENT = toPowerOfTwo(VECTORS * 4)
+  };
+
+  typedef void (*Handler)();
+
+  // One trampoline per IRQ, objects of the same type can serve several IRQs
+  template<nvic::irqn::E IRQ, typename T, void (T::*HANDLER)()>
+  class Trampoline {
+    public:
+      static T* object;
+
+      static void call();
+  };
+
+  class Functions {
+    public:
+      static inline void relocate();
+      static inline bool isRelocated();
+
+      template<nvic::irqn::E IRQ>
+      static inline void attach(Handler const);
+
+      template<nvic::irqn::E IRQ, typename T, void (T::*HANDLER)()>
+      static inline void attach(T&);
+
+      template<nvic::irqn::E IRQ>
+      static inline void detach();
+
+      template<nvic::irqn::E IRQ>
+      static inline Handler getHandler();
+
+    private:
+      Functions();
+
+      static inline Handler* table();
+      static inline Handler const*& original();
+  };
+}  // namespace isr
+
+// High-level access to the vector table
+typedef isr::Functions ISR;
+
+#include "../bits/isr.tcc"
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                   Log-structured key-value store on flash
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "peripheral/flash.hpp"
+
+/**
+ * The store appends every update to a log that spans REGIONS regions of
+ * REGION_SIZE bytes, starting at ADDRESS. A region is a group of flash
+ * sectors (F2/F4) or pages (F1), so an update only programs a few bytes
+ * instead of rewriting a whole sector:
+ *
+ *   // Sectors 2 and 3 of the F4 (16 KB each)
+ *   typedef kvstore::Store<0x08008000, 0x4000, 2, 64> SETTINGS;
+ *
+ *   SETTINGS::initialize();
+ *
+ *   SETTINGS::set(GAIN, &gain, sizeof(gain));
+ *   SETTINGS::get(GAIN, &gain, sizeof(gain));
+ *
+ * Only one region is active at a time. When it fills up, the latest value
+ * of each key is copied into the next region, which is then activated by
+ * programming its header. The regions are used in turn, so the erase
+ * cycles are spread over all of them.
+ *
+ * Record layout, aligned to 8 bytes so any programming parallelism works:
+ *
+ *   | key | size | checksum | data + padding | COMMITTED | checksum |
+ *
+ * The commit word is programmed last, a record torn by a power cut is
+ * skipped when the log is loaded, and a region without header (interrupted
+ * compaction) is ignored. A header that can't be parsed seals the region,
+ * the next update will compact it.
+ *
+ * The keys are indexed in RAM by an open addressing hash table of SLOTS
+ * entries, each key ever stored since the last compaction takes one slot.
+ *
+ * The erases stall the CPU while it fetches from the same flash bank, call
+ * compact() from an idle point when needsCompaction() returns true, so
+ * set() doesn't have to.
+ *
+ * The functions aren't reentrant, and must not be used from interrupts.
+ *
+ * DRIVER programs and erases the flash, FLASH by default. The host tests
+ * use a model of the flash that injects power cuts (see test/kvstore.cpp).
+ */
+namespace kvstore {
+  enum {
+    ALIGNMENT = 8,
+    MAGIC = 0x4B56AC01,
+    COMMITTED = 0xC0AA17ED,
+    ERASED = 0xFFFF,
+    REMOVED = 0xFFFE
+  };
+
+  /**
+   * @brief Returns true if the first <regions> + 1 boundaries between the
+   *        regions, starting at <address>, fall on sector boundaries.
+   */
+  template<typename DRIVER>
+  constexpr bool isSectorAligned(
+      u32 const address,
+      u32 const regionSize,
+      u8 const regions)
+  {
+    return DRIVER::getSectorAddress(DRIVER::getSector(
+        address + regions * regionSize)) == address + regions * regionSize &&
+        (regions == 0 || isSectorAligned<DRIVER>(address, regionSize,
+            u8(regions - 1)));
+  }
+
+  template<
+      u32 ADDRESS,
+      u32 REGION_SIZE,
+      u8 REGIONS,
+      u16 SLOTS,
+      typename DRIVER = FLASH
+  >
+  class Store {
+      static_assert(REGIONS >= 2,
+          "The compaction needs at least two regions.");
+      static_assert((SLOTS != 0) && ((SLOTS & (SLOTS - 1)) == 0),
+          "The number of slots must be a power of 2.");
+#ifdef STM32F1XX
+      static_assert((ADDRESS % flash::PAGE_SIZE == 0) &&
+          (REGION_SIZE % flash::PAGE_SIZE == 0),
+          "The regions must be made of whole pages.");
+#else // STM32F1XX
+      static_assert(isSectorAligned<DRIVER>(ADDRESS, REGION_SIZE, REGIONS),
+          "The regions must start and end at sector boundaries.");
+#endif // STM32F1XX
+
+    public:
+      static inline bool initialize();
+
+      static inline bool has(u16 const);
+      static inline u16 getSize(u16 const);
+      static inline u16 get(u16 const, void* const, u16 const);
+      static inline bool set(u16 const, void const* const, u16 const);
+      static inline bool remove(u16 const);
+
+      static inline u32 getFree();
+      static inline bool needsCompaction();
+      static inline bool compact();
+
+    private:
+      Store();
+
+      struct Header {
+          u16 key;
+          u16 size;
+          u32 checksum;
+      };
+
+      static_assert(sizeof(Header) == ALIGNMENT,
+          "The record header must fill one alignment unit.");
+
+      struct Slot {
+          u16 key;
+          u32 address;  // 0 if the key was removed
+      };
+
+      static constexpr u32 align(u32 const);
+      static constexpr u32 getRegionAddress(u8 const);
+
+      static inline u32 getChecksum(u16 const, u16 const, u8 const*);
+      static inline u32 getRecordSize(u32 const);
+      static inline u32 getGarbage();
+      static inline Slot* find(u16 const);
+      static inline void clear();
+      static inline bool erase(u8 const);
+      static inline bool append(u16 const, u16 const, void const* const);
+      static inline void load();
+
+      static u8 active;
+      static u32 sequence;
+      static u32 next;
+      static Slot index[SLOTS];
+  };
+}  // namespace kvstore
+
+#include "../bits/kvstore.tcc"
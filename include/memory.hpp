@@ -0,0 +1,147 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                        Code and data memory placement
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "../memorymap/common.hpp"
+
+/**
+ * Placement convention, the linker script must provide these output sections
+ * (and the symbols used by MEMORY::initializeSections()):
+ *
+ *   .ramfunc : Code executed from SRAM, free of flash wait states. Loaded in
+ *              flash, copied to SRAM at startup.
+ *              __ramfunc_load__, __ramfunc_start__, __ramfunc_end__
+ *   .ccmram  : Data in the F4 core coupled memory (64 KB at 0x10000000),
+ *              only reachable by the CPU. Loaded in flash, copied at startup.
+ *              __ccmram_load__, __ccmram_start__, __ccmram_end__
+ *   .dmaram  : DMA buffers and descriptors in SRAM, word aligned. Zeroed at
+ *              startup.
+ *              __dmaram_start__, __dmaram_end__
+ *
+ * e.g. (GNU ld, F4):
+ *
+ *   .ramfunc : ALIGN(4) {
+ *     __ramfunc_start__ = .; *(.ramfunc*) . = ALIGN(4); __ramfunc_end__ = .;
+ *   } > ram AT > rom
+ *   __ramfunc_load__ = LOADADDR(.ramfunc);
+ *
+ *   .ccmram : ALIGN(4) {
+ *     __ccmram_start__ = .; *(.ccmram*) . = ALIGN(4); __ccmram_end__ = .;
+ *   } > ccm AT > rom
+ *   __ccmram_load__ = LOADADDR(.ccmram);
+ *
+ *   .dmaram (NOLOAD) : ALIGN(4) {
+ *     __dmaram_start__ = .; *(.dmaram*) . = ALIGN(4); __dmaram_end__ = .;
+ *   } > ram
+ *
+ * MEMORY::initializeSections() must be called before any placed object is
+ * used, ideally right after the .data/.bss initialization of the startup
+ * code.
+ */
+
+// Executes from SRAM, calls to flash functions are made through a long call
+#define __RAMFUNC __attribute__((section(".ramfunc"), noinline, long_call))
+
+// Lives in the core coupled memory, the DMA can't access it. The object is
+// always wrapped in memory::Ccm<>, so the DMA functions can reject it:
+//   __CCMRAM(u8[256]) buffer;
+#define __CCMRAM(...) \
+  __attribute__((section(".ccmram"))) memory::Ccm<__VA_ARGS__>
+
+// Lives in SRAM, reachable by the DMA
+#define __DMARAM __attribute__((section(".dmaram"), aligned(4)))
+
+namespace memory {
+#ifndef STM32F1XX
+  enum {
+    CCM_SIZE = 0x10000
+  };
+
+  /**
+   * @brief Returns true if <address> is reachable by the DMA controllers.
+   */
+#ifdef STM32F4XX
+  constexpr bool isDmaReachable(u32 const address)
+  {
+    return (address < alias::CCMDATARAM) ||
+        (address >= alias::CCMDATARAM + CCM_SIZE);
+  }
+#else // STM32F4XX
+  constexpr bool isDmaReachable(u32 const)
+  {
+    // The F2 devices have no CCM
+    return true;
+  }
+#endif // STM32F4XX
+
+  /**
+   * Wrapper for the objects placed in the CCM by __CCMRAM(), it lets the DMA
+   * functions reject them at compile time:
+   *
+   *   __CCMRAM(u8[256]) buffer;
+   *
+   *   DMA2_STREAM7::setMemory0Address(&buffer);  // Doesn't compile
+   *
+   * The wrapped object is reached with *buffer or buffer->, pointers taken
+   * that way escape the check and can be tested with isDmaReachable().
+   */
+  template<typename T>
+  struct Ccm {
+      T object;
+
+      T& operator*()
+      {
+        return object;
+      }
+
+      T* operator->()
+      {
+        return &object;
+      }
+  };
+#endif // !STM32F1XX
+
+  class Functions {
+    public:
+      static inline void initializeSections();
+#ifndef STM32F1XX
+      static inline bool isDmaReachable(void const volatile* const);
+#endif // !STM32F1XX
+
+    private:
+      Functions();
+  };
+}  // namespace memory
+
+// High-level access to the memory placement functions
+typedef memory::Functions MEMORY;
+
+#include "../bits/memory.tcc"
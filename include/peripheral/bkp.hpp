@@ -43,6 +43,8 @@ namespace bkp {
     public:
       static inline void enableClock();
       static inline void disableClock();
+      static inline void writeData(u8 const, u16 const);
+      static inline u16 readData(u8 const);
 
     private:
       Functions();
@@ -31,20 +31,99 @@
 
 #include "../defs.hpp"
 #include "../../memorymap/crc.hpp"
+#ifndef STM32F1XX
+#include "dma.hpp"
+#endif // !STM32F1XX
 
 // Low-level access to the registers
 #define CRC_REGS reinterpret_cast<crc::Registers *>(crc::ADDRESS)
 
-// High-level functions
+/**
+ * The CRC unit computes the CRC-32 polynomial 0x04C11DB7, starting from
+ * 0xFFFFFFFF, over 32-bit words shifted MSB first and without a final XOR.
+ *
+ *   CRC::compute(data, size);       // Native result
+ *   CRC::computeCrc32(data, size);  // Same as the zlib/Ethernet CRC-32
+ *
+ * The unit only takes whole words, the trailing bytes (size % 4) are
+ * processed in software from the unit result. The words are read little
+ * endian, and may be unaligned.
+ *
+ * Large blocks can be fed by a DMA2 stream in memory to memory mode (F2/F4
+ * only), leaving the CPU free meanwhile:
+ *
+ *   typedef crc::Dma<dma::common::DMA2, dma::stream::STREAM_0> CRC_DMA;
+ *
+ *   CRC_DMA::initialize();
+ *   CRC_DMA::start(image, size);
+ *   while (CRC_DMA::isBusy()) { ... }
+ *   CRC_DMA::getResult();
+ *
+ *   CRC_DMA::compute(image, size);  // Blocking, small blocks use the CPU
+ *
+ * The zlib compatible result needs the input bits reversed, which the DMA
+ * can't do, so computeCrc32() is always fed by the CPU.
+ */
 namespace crc {
+  enum {
+    POLYNOMIAL = 0x04C11DB7,
+    // Bit reversed polynomial, as used by zlib
+    REFLECTED_POLYNOMIAL = 0xEDB88320
+  };
+
   class Functions {
     public:
       static inline void enableClock();
       static inline void disableClock();
 
+      static inline void reset();
+      static inline void write(u32 const);
+      static inline u32 read();
+      static inline void write(void const* const, u32 const);
+      static inline u32 finish(void const* const, u8 const);
+
+      static inline u32 compute(void const* const, u32 const);
+      static inline u32 computeCrc32(void const* const, u32 const);
+
     private:
       Functions();
+
+      static inline u32 reverse(u32 const);
+      static inline u32 load(u8 const* const);
+  };
+
+#ifndef STM32F1XX
+  template<dma::common::Address D, dma::stream::Address S>
+  class Dma {
+      static_assert(D == dma::common::DMA2,
+          "Only the DMA2 streams can do memory to memory transfers.");
+
+    public:
+      enum {
+        // Below this size the CPU is faster than setting up the DMA
+        THRESHOLD = 256
+      };
+
+      static inline void initialize();
+
+      static inline void start(void const* const, u32 const);
+      static inline bool isBusy();
+      static inline u32 getResult();
+
+      static inline u32 compute(void const* const, u32 const);
+
+    private:
+      Dma();
+
+      typedef dma::stream::Functions<D, S> Stream;
+
+      static inline void startChunk();
+
+      static u8 const* position;
+      static u32 remaining;
+      static u8 trailing;
   };
+#endif // !STM32F1XX
 }  // namespace crc
 
 // High-level access to the peripheral
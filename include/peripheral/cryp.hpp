@@ -33,24 +33,106 @@
 
 #include "../defs.hpp"
 #include "../../memorymap/cryp.hpp"
+#include "dma.hpp"
 
-// Low-level access to the registers
+// Low-level access to the registers, the host tests define it beforehand to
+// point to a model of the peripheral
+#ifndef CRYP_REGS
 #define CRYP_REGS reinterpret_cast<cryp::Registers *>(cryp::ADDRESS)
+#endif // CRYP_REGS
 
-// High-level functions
+/**
+ * AES-128/192/256 (ECB, CBC, CTR) and DES/TDES (ECB, CBC) encryption:
+ *
+ *   CRYP::enableClock();
+ *   CRYP::setAesKey(key, cryp::cr::keysize::_128_BITS);
+ *   CRYP::setInitializationVector(counter, 16);
+ *   CRYP::start(cryp::cr::algomode::AES_CTR, cryp::cr::algodir::ENCRYPT);
+ *   CRYP::process(frame, frame, size);  // In place
+ *   CRYP::stop();
+ *
+ * The keys and the IV are byte arrays, as in the standards. The ECB/CBC
+ * sizes must be multiples of the block size (16 bytes AES, 8 bytes DES),
+ * the last CTR block may be partial. The chaining state is kept between
+ * process() calls, and between stop() and start() as long as the key and
+ * IV aren't set again.
+ *
+ * The AES decryption key schedule is prepared by start().
+ *
+ * Bulk data is better moved by the DMA (DMA2 streams 6 and 5, channel 2),
+ * the output stream writes the blocks behind the input one, so the input
+ * buffer can be overwritten in place:
+ *
+ *   CRYP_DMA::initialize();
+ *   CRYP_DMA::start(buffer, buffer, size);
+ *   while (CRYP_DMA::isBusy()) { ... }
+ */
 namespace cryp {
+  enum {
+    AES_BLOCK_SIZE = 16,
+    DES_BLOCK_SIZE = 8
+  };
+
   class Functions {
     public:
       static inline void enableClock();
       static inline void disableClock();
 
+      static inline void setAesKey(
+          void const* const,
+          cryp::cr::keysize::States);
+      static inline void setDesKey(void const* const);
+      static inline void setTripleDesKey(void const* const);
+      static inline void setInitializationVector(void const* const, u8 const);
+
+      static inline void start(
+          cryp::cr::algomode::States,
+          cryp::cr::algodir::States);
+      static inline void process(void const* const, void* const, u32);
+      static inline void stop();
+
+      static inline u8 getBlockSize();
+
     private:
       Functions();
+
+      static inline void setKey(u8 const, u8 const* const, u8 const);
+      static inline void processBlock(u8 const* const, u8* const);
+  };
+
+  class Dma {
+    public:
+      static inline void initialize();
+
+      static inline void start(u32 const* const, u32* const, u32 const);
+      static inline bool isBusy();
+
+    private:
+      Dma();
+
+      typedef dma::stream::Functions<
+          dma::common::DMA2,
+          dma::stream::STREAM_6
+      > InStream;
+      typedef dma::stream::Functions<
+          dma::common::DMA2,
+          dma::stream::STREAM_5
+      > OutStream;
+
+      struct Transfer {
+          u32 const* input;
+          u32* output;
+          u32 remaining;  // In words
+      };
+
+      static inline Transfer& transfer();
+      static inline void startChunk();
   };
 }  // namespace cryp
 
 // High-level access to the peripheral
 typedef cryp::Functions CRYP;
+typedef cryp::Dma CRYP_DMA;
 
 #include "../../bits/cryp.tcc"
 
@@ -29,6 +29,7 @@
 
 #include "../device_select.hpp"
 #include "../defs.hpp"
+#include "../memory.hpp"
 
 #include "../../memorymap/dma.hpp"
 
@@ -191,6 +192,12 @@ namespace dma {
         static inline void setPeripheralAddress(void* const);
         static inline void setMemory0Address(void* const);
         static inline void setMemory1Address(void* const);
+        template<typename T>
+        static inline void setPeripheralAddress(memory::Ccm<T>* const);
+        template<typename T>
+        static inline void setMemory0Address(memory::Ccm<T>* const);
+        template<typename T>
+        static inline void setMemory1Address(memory::Ccm<T>* const);
         static inline void clearFifoErrorFlag();
         static inline bool hasFifoErrorOccurred();
         static inline void clearDirectModeErrorFlag();
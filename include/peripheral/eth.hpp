@@ -32,25 +32,249 @@
 #if not defined STM32F1XX || defined CONNECTIVITY_LINE
 
 #include "../defs.hpp"
+#include "../clock.hpp"
+#include "../critical.hpp"
+#include "../memory.hpp"
 #include "../../memorymap/eth.hpp"
 
-// Low-level access to the registers
+#ifndef ETH_BUFFER_SIZE
+#define ETH_BUFFER_SIZE 1536
+#endif // ETH_BUFFER_SIZE
+
+// Low-level access to the registers, the host tests define it beforehand to
+// point to a model of the peripheral
+#ifndef ETH_REGS
 #define ETH_REGS reinterpret_cast<eth::Registers *>(eth::ADDRESS)
+#endif // ETH_REGS
 
 // High-level functions
 namespace eth {
+  enum Interface {
+    MII,
+    RMII
+  };
+
+  // DMA descriptor, the F2/F4 use the enhanced format
+  struct Descriptor {
+      u32 volatile status;  // TDES0/RDES0
+      u32 volatile control;  // TDES1/RDES1
+      u32 volatile buffer1;  // TDES2/RDES2
+      u32 volatile next;  // TDES3/RDES3, chained mode
+#ifndef STM32F1XX
+      u32 volatile extended;  // RDES4
+      u32 _RESERVED;
+      u32 volatile timestampLow;  // TDES6/RDES6
+      u32 volatile timestampHigh;  // TDES7/RDES7
+#endif // !STM32F1XX
+  };
+
+#ifndef STM32F1XX
+  // PTP time, the nanoseconds roll over at 1 second
+  struct Timestamp {
+      u32 seconds;
+      u32 nanoseconds;
+  };
+
+#endif // !STM32F1XX
+  // Received frame, the data lives in one of the driver RX buffers
+  struct Frame {
+      u8* data;
+      u16 size;
+#ifndef STM32F1XX
+      bool timestamped;
+      Timestamp timestamp;  // PTP time of the frame reception
+#endif // !STM32F1XX
+  };
+
+  // Piece of a frame to send
+  struct Segment {
+      void const* data;
+      u16 size;
+  };
+
+  // IEEE 802.3 PHY registers, common to every PHY
+  namespace phy {
+    enum {
+      BMCR = 0,
+      BMSR = 1,
+      ANAR = 4,
+      ANLPAR = 5
+    };
+
+    namespace bmcr {
+      enum {
+        RESTART_AUTONEGOTIATION = 1 << 9,
+        AUTONEGOTIATION = 1 << 12,
+        RESET = 1 << 15
+      };
+    }  // namespace bmcr
+
+    namespace bmsr {
+      enum {
+        LINK = 1 << 2,
+        AUTONEGOTIATION_COMPLETE = 1 << 5
+      };
+    }  // namespace bmsr
+
+    namespace anar {
+      enum {
+        _10_HALF_DUPLEX = 1 << 5,
+        _10_FULL_DUPLEX = 1 << 6,
+        _100_HALF_DUPLEX = 1 << 7,
+        _100_FULL_DUPLEX = 1 << 8
+      };
+    }  // namespace anar
+  }  // namespace phy
+
   class Functions {
     public:
       static inline void enableClocks();
       static inline void disableClocks();
+      static inline void selectInterface(Interface const);
+      static inline void reset();
+      static inline void setMacAddress(u8 const (&)[6]);
+      static inline void configureLink(bool const, bool const);
+
+      static inline u16 readPhyRegister(u8 const, u8 const);
+      static inline void writePhyRegister(u8 const, u8 const, u16 const);
+      static inline void resetPhy(u8 const);
+      static inline void startAutoNegotiation(u8 const);
+      static inline bool updateLink(u8 const);
 
     private:
       Functions();
+
+      static constexpr macmiiar::cr::States getMdcDivider();
+  };
+
+#ifndef STM32F1XX
+  /**
+   * IEEE 1588 clock of the MAC, in digital rollover mode. The clock is
+   * updated INCREMENT nanoseconds at a time, at the rate set by the addend
+   * accumulator (fine correction), around half the AHB frequency:
+   *
+   *   rate = AHB * ADDEND / 2^32
+   *
+   * The frames are timestamped on the PTP clock, see Frame::timestamp and
+   * Driver::getSent(). The PPS output (PB5 or PG8) ticks at a power of 2
+   * of 1 Hz.
+   *
+   * The clock isn't disciplined by itself, see ptp::Servo.
+   */
+  class Ptp {
+    public:
+      enum {
+        INCREMENT = (2000000000u + clk::AHB - 1) / clk::AHB
+      };
+
+      static inline void initialize();
+      static inline void getTime(Timestamp&);
+      static inline void setTime(Timestamp const&);
+      static inline u64 getNanoseconds();
+      static inline void adjustTime(s64 const);
+      static inline void adjustFrequency(s32 const);
+      static inline void setPpsFrequency(u8 const);
+
+    private:
+      Ptp();
+
+      static constexpr u32 getAddend();
+
+      static inline void waitUntilClear(u32 const);
+  };
+
+#endif // !STM32F1XX
+  /**
+   * Descriptor ring driver, in chained mode. The frames are never copied:
+   *
+   *  - RX: RX_BUFFERS buffers of ETH_BUFFER_SIZE bytes, RX_DESCRIPTORS of
+   *    them are armed in the ring. receive() hands the buffer of a frame to
+   *    the stack and arms a spare one in its place, the stack gives it back
+   *    with release(), from an interrupt handler if needed (the spare
+   *    buffers are handled in LOCK sections). While no spare buffer is
+   *    left, the frames wait in the ring.
+   *  - TX: each Segment of a frame takes a descriptor that points to the
+   *    caller's data (scatter-gather), the data must stay untouched until
+   *    getSent() returns the frame tag.
+   *
+   *   typedef eth::Driver<8, 16, 16> ETH0;
+   *
+   *   void interrupt::ETH() { ETH0::onInterrupt(); }
+   *
+   *   ETH0::initialize(mac, eth::RMII);
+   *
+   *   while (ETH0::receive(frame)) {
+   *     stack.input(frame.data, frame.size);  // then ETH0::release(data)
+   *   }
+   *
+   * The MAC checks the IPv4 header and TCP/UDP/ICMP checksums of the
+   * received frames, and fills them in the sent ones (store and forward
+   * mode), the stack must leave the checksum fields zeroed.
+   *
+   * The MAC has no link change interrupt: wire the PHY interrupt pin to an
+   * EXTI line (after enabling it in the vendor specific PHY registers) and
+   * call ETH::updateLink() from its handler, it adjusts the MAC speed and
+   * duplex to the negotiated ones.
+   *
+   * The descriptors and RX buffers are placed in the .dmaram section, the
+   * TX segments must be DMA reachable too.
+   */
+  template<
+      u8 RX_DESCRIPTORS,
+      u8 TX_DESCRIPTORS,
+      u8 RX_BUFFERS,
+      typename LOCK = critical::Section
+  >
+  class Driver {
+      static_assert(RX_BUFFERS > RX_DESCRIPTORS,
+          "Spare RX buffers are needed to hand frames without copying.");
+      static_assert(ETH_BUFFER_SIZE % 4 == 0,
+          "The RX buffers must be word aligned.");
+
+    public:
+      static inline void initialize(u8 const (&)[6], Interface const);
+      static inline void stop();
+      static inline u32 onInterrupt();
+
+      static inline bool receive(Frame&);
+      static inline bool release(u8* const);
+
+      static inline bool send(
+          Segment const* const,
+          u8 const,
+          void* const,
+          bool const = false);
+      static inline bool getSent(void*&);
+#ifndef STM32F1XX
+      static inline bool getSent(void*&, bool&, Timestamp&);
+#endif // !STM32F1XX
+      static inline u8 getFreeTxDescriptors();
+
+    private:
+      Driver();
+
+      static inline void arm(Descriptor&, u8* const);
+      static inline Descriptor const* reclaim(void*&);
+      static inline bool takeSpare(u8&);
+
+      static Descriptor rx[RX_DESCRIPTORS];
+      static Descriptor tx[TX_DESCRIPTORS];
+      static u8 buffers[RX_BUFFERS][ETH_BUFFER_SIZE];
+      static void* tags[TX_DESCRIPTORS];
+      static u8 spares[RX_BUFFERS];
+      static u8 spareCount;
+      static u8 rxHead;
+      static u8 txHead;
+      static u8 txTail;
+      static u8 txFree;
   };
 }  // namespace eth
 
 // High-level access to the peripherals
 typedef eth::Functions ETH;
+#ifndef STM32F1XX
+typedef eth::Ptp PTP;
+#endif // !STM32F1XX
 
 #include "../../bits/eth.tcc"
 
@@ -35,10 +35,83 @@
 // Low-level access to the registers
 #define FLASH_REGS reinterpret_cast<flash::Registers*>(flash::ADDRESS)
 
+#ifdef STM32F1XX
+#ifndef FLASH_PAGE_SIZE
+#if defined CONNECTIVITY_LINE || \
+    defined XL_DENSITY
+#define FLASH_PAGE_SIZE 2048
+#else // CONNECTIVITY_LINE || XL_DENSITY
+#define FLASH_PAGE_SIZE 1024  // High density devices must define it as 2048
+#endif // CONNECTIVITY_LINE || XL_DENSITY
+#endif // !FLASH_PAGE_SIZE
+#endif // STM32F1XX
+
 // High-level functions
 namespace flash {
+  enum {
+    MEMORY = 0x08000000,
+#ifdef STM32F1XX
+    PAGE_SIZE = FLASH_PAGE_SIZE
+#else // STM32F1XX
+    BANK_SIZE = 0x100000,
+    SECTORS_PER_BANK = 12
+#endif // STM32F1XX
+  };
+
+  /**
+   * The program/erase functions stall the CPU on any fetch from the flash
+   * while the memory is busy, code that must keep running (interrupt
+   * handlers included) has to be placed in RAM with __RAMFUNC.
+   *
+   * The blocking functions return false if the operation ended with an
+   * error, the error flags can be read with getErrors().
+   */
   class Functions {
     public:
+      static inline void unlock();
+      static inline void lock();
+      static inline bool isLocked();
+      static inline bool isBusy();
+      static inline bool hasOperationEnded();
+      static inline u32 getErrors();
+      static inline void clearFlags();
+      static inline bool wait();
+      static inline void enableInterrupts();
+      static inline void disableInterrupts();
+
+      static inline u8 getProgrammingUnit();
+      static inline void beginProgramming();
+      static inline void writeUnit(u32 const, u8 const* const);
+      static inline void endOperation();
+      static inline bool program(u32 const, void const* const, u32 const);
+
+      static inline void startMassErase();
+      static inline bool eraseAll();
+
+#ifdef STM32F1XX
+      static inline void startPageErase(u32 const);
+      static inline bool erasePage(u32 const);
+
+      static inline void unlockOptionBytes();
+      static inline bool eraseOptionBytes();
+      static inline bool programOptionByte(u8 const, u8 const);
+      static inline u8 getOptionByte(u8 const);
+#else // STM32F1XX
+      static inline void setParallelism(cr::psize::States const);
+      static inline cr::psize::States getParallelism();
+
+      static inline void startSectorErase(u8 const);
+      static inline bool eraseSector(u8 const);
+      static constexpr u8 getSector(u32 const);
+      static constexpr u32 getSectorAddress(u8 const);
+      static constexpr u32 getSectorSize(u8 const);
+
+      static inline void unlockOptionBytes();
+      static inline void lockOptionBytes();
+      static inline u32 getOptionBytes();
+      static inline bool programOptionBytes(u32 const);
+#endif // STM32F1XX
+
 #ifndef VALUE_LINE
       static inline void setLatency(flash::acr::latency::States);
 #endif // VALUE_LINE
@@ -65,6 +138,8 @@ namespace flash {
       static inline void disableDataCache();
       static inline void enableInstructionCache();
       static inline void disableInstructionCache();
+      static inline void resetDataCache();
+      static inline void resetInstructionCache();
 
       static inline void configure(
           flash::acr::latency::States,
@@ -75,6 +150,13 @@ namespace flash {
 #endif // STM32F1XX
     private:
       Functions();
+
+#ifndef STM32F1XX
+      static constexpr u8 getSectorInBank(u32 const);
+      static constexpr u32 getSectorOffset(u8 const);
+
+      static inline cr::psize::States& parallelism();
+#endif // !STM32F1XX
   };
 }  // namespace flash
 
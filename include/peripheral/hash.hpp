@@ -33,24 +33,125 @@
 
 #include "../defs.hpp"
 #include "../../memorymap/hash.hpp"
+#ifdef STM32F4XX
+#include "dma.hpp"
+#endif // STM32F4XX
 
-// Low-level access to the registers
+// Low-level access to the registers, the host tests define it beforehand to
+// point to a model of the peripheral
+#ifndef HASH_REGS
 #define HASH_REGS reinterpret_cast<hash::Registers *>(hash::ADDRESS)
+#endif // HASH_REGS
 
-// High-level functions
+/**
+ * Streaming SHA-1/MD5 digests and HMACs, the message can be fed in pieces of
+ * any size:
+ *
+ *   u8 result[hash::SHA1_SIZE];
+ *
+ *   HASH::enableClock();
+ *   HASH::init(hash::cr::algo::SHA1);
+ *   HASH::update(header, sizeof(header));
+ *   HASH::update(payload, size);
+ *   HASH::final(result);
+ *
+ *   HASH::init(hash::cr::algo::SHA1, key, sizeof(key));  // HMAC
+ *
+ * The peripheral computes one digest at a time, save() and restore() swap
+ * its context to interleave several digests. The HMAC key isn't copied, it
+ * must outlive the digest.
+ *
+ * Large buffers can be fed by the DMA (F4 only, DMA2 stream 7 channel 2),
+ * the CPU being free meanwhile:
+ *
+ *   HASH_DMA::initialize();
+ *   HASH_DMA::start(image, size);
+ *   while (HASH_DMA::isBusy()) { ... }
+ *   HASH::final(result);
+ *
+ * The HASH peripheral is only present on the F215/F217, F415/F417 and
+ * F437/F439 devices, see digest.hpp for the software implementation.
+ */
 namespace hash {
+  enum {
+    SHA1_SIZE = 20,
+    MD5_SIZE = 16
+  };
+
+  struct State {
+      u32 partial;  // Bytes of the next word, not yet written
+      u8 partialSize;
+      u8 const* key;
+      u32 keySize;
+  };
+
+  struct Context {
+      u32 imr;
+      u32 str;
+      u32 cr;
+      u32 csr[csr::SIZE];
+      State state;
+  };
+
   class Functions {
     public:
       static inline void enableClock();
       static inline void disableClock();
 
+      static inline void init(hash::cr::algo::States);
+      static inline void init(
+          hash::cr::algo::States,
+          void const* const,
+          u32 const);
+      static inline void update(void const* const, u32);
+      static inline void final(u8* const);
+
+      static inline void save(Context&);
+      static inline void restore(Context const&);
+
     private:
       Functions();
+
+      static inline State& state();
+      static inline void calculate();
+      static inline void waitWhileBusy();
+
+      friend class Dma;
+  };
+
+#ifdef STM32F4XX
+  class Dma {
+    public:
+      static inline void initialize();
+
+      static inline void start(void const* const, u32 const);
+      static inline bool isBusy();
+
+    private:
+      Dma();
+
+      typedef dma::stream::Functions<
+          dma::common::DMA2,
+          dma::stream::STREAM_7
+      > Stream;
+
+      struct Transfer {
+          u8 const* position;
+          u32 remaining;
+          u8 trailing;
+      };
+
+      static inline Transfer& transfer();
+      static inline void startChunk();
   };
+#endif // STM32F4XX
 }  // namespace hash
 
 // High-level access to the peripheral
 typedef hash::Functions HASH;
+#ifdef STM32F4XX
+typedef hash::Dma HASH_DMA;
+#endif // STM32F4XX
 
 #include "../../bits/hash.tcc"
 
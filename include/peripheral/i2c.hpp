@@ -89,6 +89,20 @@ namespace i2c {
       static inline bool canSendData();
       static inline bool hasTranferFinished();
       static inline bool isTheBusBusy();
+      static inline bool isStopPending();
+      static inline bool hasAcknowledgeFailed();
+      static inline void clearAcknowledgeFailedFlag();
+      static inline void clearAddressFlag();
+      static inline void enableDmaRequests();
+      static inline void disableDmaRequests();
+      static inline void enableEventInterrupt();
+      static inline void disableEventInterrupt();
+      static inline void enableErrorInterrupt();
+      static inline void disableErrorInterrupt();
+      static inline void enableBufferInterrupt();
+      static inline void disableBufferInterrupt();
+      static inline void unmaskInterrupts();
+      static inline void maskInterrupts();
       static void writeSlaveRegister(
           u8 const slaveAddress,
           u8 const registerAddress,
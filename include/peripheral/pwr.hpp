@@ -44,6 +44,17 @@ namespace pwr {
 
       static inline void enableBackupDomainWriteProtection();
       static inline void disableBackupDomainWriteProtection();
+      static inline void enterStopMode(pwr::cr::ldps::States);
+#ifndef STM32F1XX
+      static inline void enableBackupRegulator();
+      static inline void disableBackupRegulator();
+#endif // !STM32F1XX
+#ifdef STM32F4XX
+
+      static inline void setVoltageScaling(pwr::cr::vos::States);
+      static inline pwr::cr::vos::States getVoltageScaling();
+      static inline bool isVoltageScalingReady();
+#endif // STM32F4XX
     private:
       Functions();
   };
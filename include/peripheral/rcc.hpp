@@ -238,6 +238,13 @@ namespace rcc {
       >
       static inline void configurePll();
 
+      static inline void configurePll(
+          rcc::pllcfgr::pllsrc::States,
+          u8 const,
+          u16 const,
+          u8 const,
+          u8 const);
+
       template<
       u16 PLLI2SN,
       u8 PLLI2SR
@@ -252,6 +259,11 @@ namespace rcc {
       >
       static inline void configurePrescalers();
 
+      static inline void configurePrescalers(
+          u8 const,
+          u8 const,
+          u8 const);
+
       template<
       rcc::cfgr::mco1::States,
       rcc::cfgr::mco2::States,
@@ -54,6 +54,8 @@ namespace rng {
       static inline bool isDataReady(void);
       static inline bool isSeedValid(void);
       static inline bool isClockValid(void);
+      static inline bool hasSeedErrorOccurred();
+      static inline bool hasClockErrorOccurred();
       static inline void clearSeedErrorFlag(void);
       static inline void clearClockErrorFlag(void);
 
@@ -102,6 +102,15 @@ namespace rtc {
 	  static inline void setDST(cr::dst::States);
 
 //	  static inline void setAlarm(); //TODO
+
+	  static inline void startWakeupTimer(cr::wucksel::Selections, u16 const);
+	  static inline void stopWakeupTimer();
+	  static inline bool hasWakeupTimerExpired();
+	  static inline void clearWakeupTimerFlag();
+
+	  static inline void waitForSynchronization();
+	  static inline u32 getTimestamp();
+	  static inline u32 getTimestampFrequency();
     private:
       Functions();
 	  template<isr::Flags F>
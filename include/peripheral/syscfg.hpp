@@ -50,6 +50,11 @@ namespace syscfg {
           syscfg::exticr::States
       >
       static inline void selectExtiPin();
+      static inline void remapMemory(syscfg::memrmp::mem_mode::States);
+#ifdef STM32F4XX
+      static inline void swapFlashBanks();
+      static inline bool areFlashBanksSwapped();
+#endif // STM32F4XX
 
     private:
       Functions();
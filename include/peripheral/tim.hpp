@@ -75,6 +75,8 @@ namespace tim {
       static inline bool isCounting();
       static inline void setMicroSecondResolution();
       static inline void setMiliSecondResolution();
+      static inline void setMicroSecondResolution(u32 const);
+      static inline void setMiliSecondResolution(u32 const);
       static void delay(u16 const);
       static inline void setPrescaler(u16 const);
       static inline void setAutoReload(u16 const);
@@ -89,6 +91,12 @@ namespace tim {
       static inline void enableUpdateDma();
       static inline void disableUpdateDma();
       static inline bool hasUpdateEventOccurred();
+      static inline void setCompare1(u16 const);
+      static inline void enableCompare1Interrupt();
+      static inline void disableCompare1Interrupt();
+      static inline void clearCompare1Flag();
+      static inline bool hasCompare1EventOccurred();
+      static inline void generateCompare1Event();
 
       template<
           u32
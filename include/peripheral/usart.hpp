@@ -73,6 +73,7 @@ namespace usart {
       static inline u32 getStatus();
       template<u32 BAUD_RATE>
       static inline void setBaudRate();
+      static inline void setBaudRate(u32 const, u32 const);
 
       static inline void clearCTSflag();
       static inline void clearLineBreakFlag();
@@ -0,0 +1,473 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *
+ *                     Compile-time PLL configuration solver
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+/**
+ * These functions search, at compile time, the legal PLL divider/multiplier
+ * combinations of the selected family, and return the combination whose
+ * output is the closest (or equal) to a target frequency.
+ *
+ * A solution is packed in a single u32, a solution of 0 means that the
+ * target can't be reached. The solution fields are extracted with the
+ * accessor functions.
+ *
+ * See the USING_PLL_SOLVER option in clock.hpp.
+ */
+namespace pll {
+  enum {
+    USB = 48000000
+  };
+
+  /**
+   * @brief Returns |a - b|.
+   */
+  constexpr u64 distance(u64 const a, u64 const b)
+  {
+    return a > b ? a - b : b - a;
+  }
+
+  /**
+   * @brief Returns the smallest power of 2 exponent (0 - 4) that brings
+   *        <frequency> to <maximum> or below.
+   */
+  constexpr u8 prescaler(
+      u32 const frequency,
+      u32 const maximum,
+      u8 const exponent = 0)
+  {
+    return ((frequency >> exponent) <= maximum) || (exponent == 4) ?
+        exponent :
+        prescaler(frequency, maximum, exponent + 1);
+  }
+
+#ifdef STM32F1XX
+  enum {
+#ifdef CONNECTIVITY_LINE
+    PLLMUL_MIN = 4,
+    PLLMUL_MAX = 9,
+    // Stands for x6.5, the only fractional multiplier (PLLMUL = 0b1101)
+    PLLMUL_6_5 = 13,
+#else // CONNECTIVITY_LINE
+    PLLMUL_MIN = 2,
+    PLLMUL_MAX = 16,
+#endif // CONNECTIVITY_LINE
+#ifdef VALUE_LINE
+    SYSTEM_MAX = 24000000,
+    APB1_MAX = 24000000,
+    APB2_MAX = 24000000,
+#else // VALUE_LINE
+    SYSTEM_MAX = 72000000,
+    APB1_MAX = 36000000,
+    APB2_MAX = 72000000,
+#endif // VALUE_LINE
+  };
+
+  /*
+   * Solution layout:
+   *
+   * [4:0]  PLL input divider (PREDIV1 or PLLXTPRE + 1)
+   * [9:5]  PLL multiplier (PLLMUL)
+   */
+
+  constexpr u32 pack(u32 const div, u32 const mul)
+  {
+    return div + (mul << 5);
+  }
+
+  /**
+   * @brief Returns the PLL input divider of the solution.
+   */
+  constexpr u8 divider(u32 const solution)
+  {
+    return solution & 0x1F;
+  }
+
+  /**
+   * @brief Returns the PLL multiplier of the solution.
+   * @note  PLLMUL_6_5 stands for x6.5 on connectivity line devices.
+   */
+  constexpr u8 multiplier(u32 const solution)
+  {
+    return (solution >> 5) & 0x1F;
+  }
+
+  /**
+   * @brief Returns twice the PLL multiplier of the solution.
+   */
+  constexpr u8 halfSteps(u32 const solution)
+  {
+#ifdef CONNECTIVITY_LINE
+    return multiplier(solution) == PLLMUL_6_5 ? 13 : 2 * multiplier(solution);
+#else // CONNECTIVITY_LINE
+    return 2 * multiplier(solution);
+#endif // CONNECTIVITY_LINE
+  }
+
+  /**
+   * @brief Returns the PLL output frequency of the solution.
+   */
+  constexpr u32 output(u32 const in, u32 const solution)
+  {
+    return u64(in) * halfSteps(solution) / (2 * divider(solution));
+  }
+
+  /**
+   * @brief Returns the USB prescaler needed to get a 48 MHz clock.
+   * @note  USB = PLL * 2 / (2 + USBPRE)
+   */
+  constexpr u8 usbPrescaler(u32 const pll)
+  {
+    return pll == USB ? 0 : 1;
+  }
+
+  /**
+   * @brief Returns the flash wait states required at <system> Hz.
+   */
+  constexpr u8 latency(u32 const system)
+  {
+    return system <= 24000000 ? 0 : (system <= 48000000 ? 1 : 2);
+  }
+
+  constexpr bool isValid(u32 const in, bool const usb, u32 const solution)
+  {
+    return (output(in, solution) <= SYSTEM_MAX) &&
+        (!usb ||
+            (u64(in) * halfSteps(solution) ==
+                u64(USB) * 2 * divider(solution)) ||
+            (u64(in) * halfSteps(solution) ==
+                u64(USB) * 3 * divider(solution)));
+  }
+
+  constexpr u32 validate(u32 const in, bool const usb, u32 const solution)
+  {
+    return isValid(in, usb, solution) ? solution : 0;
+  }
+
+  constexpr u32 better(
+      u32 const in,
+      u32 const target,
+      u32 const best,
+      u32 const candidate)
+  {
+    return (candidate != 0) &&
+        ((best == 0) ||
+            (distance(output(in, candidate), target) <
+                distance(output(in, best), target))) ?
+        candidate :
+        best;
+  }
+
+  constexpr u32 searchMul(
+      u32 const in,
+      u32 const target,
+      bool const usb,
+      u32 const div,
+      u32 const mul,
+      u32 const best)
+  {
+#ifdef CONNECTIVITY_LINE
+    return mul > PLLMUL_MAX ?
+        better(in, target, best, validate(in, usb, pack(div, PLLMUL_6_5))) :
+        searchMul(in, target, usb, div, mul + 1,
+            better(in, target, best, validate(in, usb, pack(div, mul))));
+#else // CONNECTIVITY_LINE
+    return mul > PLLMUL_MAX ?
+        best :
+        searchMul(in, target, usb, div, mul + 1,
+            better(in, target, best, validate(in, usb, pack(div, mul))));
+#endif // CONNECTIVITY_LINE
+  }
+
+  constexpr u32 searchDiv(
+      u32 const in,
+      u32 const target,
+      bool const usb,
+      u32 const maxDiv,
+      u32 const div,
+      u32 const best)
+  {
+    return div > maxDiv ?
+        best :
+        searchDiv(in, target, usb, maxDiv, div + 1,
+            searchMul(in, target, usb, div, PLLMUL_MIN, best));
+  }
+
+  /**
+   * @brief Searches the PLL configuration closest to <target> Hz.
+   * @note  <in> is the PLL source frequency before the input divider, the
+   *        divider is searched between 1 and <maxDiv> (inclusive).
+   * @note  If <usb> is true, only the configurations that can provide an
+   *        exact 48 MHz USB clock are considered.
+   */
+  constexpr u32 solve(
+      u32 const in,
+      u32 const target,
+      u32 const maxDiv,
+      bool const usb)
+  {
+    return searchDiv(in, target, usb, maxDiv, 1, 0);
+  }
+#else // STM32F1XX
+  enum {
+    PLLM_MIN = 2,
+    PLLM_MAX = 63,
+    PLLN_MIN = 64,
+    PLLN_MAX = 432,
+    PLLP_MAX = 8,
+    PLLQ_MIN = 2,
+    PLLQ_MAX = 15,
+    VCO_IN_MIN = 1000000,
+    VCO_IN_MAX = 2000000,
+    VCO_OUT_MIN = 64000000,
+    VCO_OUT_MAX = 432000000,
+#ifdef STM32F2XX
+    SYSTEM_MAX = 120000000,
+    APB1_MAX = 30000000,
+    APB2_MAX = 60000000,
+#else // STM32F2XX
+    SYSTEM_MAX = 168000000,
+    APB1_MAX = 42000000,
+    APB2_MAX = 84000000,
+#endif // STM32F2XX
+    // Flash access time per wait state, for a 2.7V - 3.6V supply
+    WAIT_STATE = 30000000,
+  };
+
+  /*
+   * Solution layout:
+   *
+   * [5:0]   PLLM
+   * [14:6]  PLLN
+   * [18:15] PLLP
+   * [22:19] PLLQ
+   */
+
+  constexpr u32 pack(u32 const m, u32 const n, u32 const p, u32 const q)
+  {
+    return m + (n << 6) + (p << 15) + (q << 19);
+  }
+
+  /**
+   * @brief Returns the PLLM divider of the solution.
+   */
+  constexpr u8 m(u32 const solution)
+  {
+    return solution & 0x3F;
+  }
+
+  /**
+   * @brief Returns the PLLN multiplier of the solution.
+   */
+  constexpr u16 n(u32 const solution)
+  {
+    return (solution >> 6) & 0x1FF;
+  }
+
+  /**
+   * @brief Returns the PLLP divider of the solution.
+   */
+  constexpr u8 p(u32 const solution)
+  {
+    return (solution >> 15) & 0xF;
+  }
+
+  /**
+   * @brief Returns the PLLQ divider of the solution.
+   */
+  constexpr u8 q(u32 const solution)
+  {
+    return (solution >> 19) & 0xF;
+  }
+
+  /**
+   * @brief Returns the VCO output frequency of the solution.
+   */
+  constexpr u64 vco(u32 const in, u32 const solution)
+  {
+    return u64(in) * n(solution) / m(solution);
+  }
+
+  /**
+   * @brief Returns the PLL (system) output frequency of the solution.
+   */
+  constexpr u32 output(u32 const in, u32 const solution)
+  {
+    return u64(in) * n(solution) / (u64(m(solution)) * p(solution));
+  }
+
+  /**
+   * @brief Returns the USB/SDIO/RNG output frequency of the solution.
+   */
+  constexpr u32 usb(u32 const in, u32 const solution)
+  {
+    return u64(in) * n(solution) / (u64(m(solution)) * q(solution));
+  }
+
+  /**
+   * @brief Returns the flash wait states required at <system> Hz.
+   */
+  constexpr u8 latency(u32 const system)
+  {
+    return system == 0 ? 0 : (system - 1) / WAIT_STATE;
+  }
+
+  constexpr bool isValid(u32 const in, u32 const solution)
+  {
+    return (u64(in) >= u64(VCO_IN_MIN) * m(solution)) &&
+        (u64(in) <= u64(VCO_IN_MAX) * m(solution)) &&
+        (n(solution) >= PLLN_MIN) &&
+        (n(solution) <= PLLN_MAX) &&
+        (q(solution) >= PLLQ_MIN) &&
+        (q(solution) <= PLLQ_MAX) &&
+        (vco(in, solution) >= VCO_OUT_MIN) &&
+        (vco(in, solution) <= VCO_OUT_MAX) &&
+        (output(in, solution) <= SYSTEM_MAX) &&
+        (usb(in, solution) <= USB);
+  }
+
+  constexpr u32 validate(u32 const in, u32 const solution)
+  {
+    return isValid(in, solution) ? solution : 0;
+  }
+
+  constexpr u32 better(
+      u32 const in,
+      u32 const target,
+      u32 const best,
+      u32 const candidate)
+  {
+    return (candidate != 0) &&
+        ((best == 0) ||
+            (distance(output(in, candidate), target) <
+                distance(output(in, best), target))) ?
+        candidate :
+        best;
+  }
+
+  /**
+   * @brief PLLN that brings the output closer to <target>, without exceeding
+   *        the maximum system frequency.
+   */
+  constexpr u32 closestN(u32 const in, u32 const target, u32 m, u32 p)
+  {
+    return (u64(target) * m * p + in / 2) / in <
+        u64(SYSTEM_MAX) * m * p / in ?
+        (u64(target) * m * p + in / 2) / in :
+        u64(SYSTEM_MAX) * m * p / in;
+  }
+
+  /**
+   * @brief Smallest PLLQ that keeps the USB/SDIO/RNG clock below 48 MHz.
+   */
+  constexpr u32 smallestQ(u32 const in, u32 const m, u32 const n)
+  {
+    return (u64(in) * n + u64(USB) * m - 1) / (u64(USB) * m) < PLLQ_MIN ?
+        u32(PLLQ_MIN) :
+        (u64(in) * n + u64(USB) * m - 1) / (u64(USB) * m);
+  }
+
+  /**
+   * @brief Candidate with a free USB clock (48 MHz or below).
+   */
+  constexpr u32 freeCandidate(u32 const in, u32 const target, u32 m, u32 p)
+  {
+    return validate(in,
+        pack(m, closestN(in, target, m, p), p,
+            smallestQ(in, m, closestN(in, target, m, p))));
+  }
+
+  /**
+   * @brief Candidate with an exact 48 MHz USB clock, VCO = 48 MHz * PLLQ.
+   */
+  constexpr u32 exactCandidate(u32 const in, u32 m, u32 p, u32 q)
+  {
+    return (u64(USB) * q * m) % in != 0 ?
+        0 :
+        validate(in, pack(m, u64(USB) * q * m / in, p, q));
+  }
+
+  constexpr u32 searchQ(
+      u32 const in,
+      u32 const target,
+      u32 const m,
+      u32 const p,
+      u32 const q,
+      u32 const best)
+  {
+    return q > PLLQ_MAX ?
+        best :
+        searchQ(in, target, m, p, q + 1,
+            better(in, target, best, exactCandidate(in, m, p, q)));
+  }
+
+  constexpr u32 searchP(
+      u32 const in,
+      u32 const target,
+      bool const usb,
+      u32 const m,
+      u32 const p,
+      u32 const best)
+  {
+    return p > PLLP_MAX ?
+        best :
+        searchP(in, target, usb, m, p + 2,
+            usb ?
+                searchQ(in, target, m, p, PLLQ_MIN, best) :
+                better(in, target, best, freeCandidate(in, target, m, p)));
+  }
+
+  constexpr u32 searchM(
+      u32 const in,
+      u32 const target,
+      bool const usb,
+      u32 const m,
+      u32 const best)
+  {
+    return m > PLLM_MAX ?
+        best :
+        searchM(in, target, usb, m + 1,
+            searchP(in, target, usb, m, 2, best));
+  }
+
+  /**
+   * @brief Searches the PLL configuration closest to <target> Hz.
+   * @note  <in> is the PLL source frequency (HSE or HSI).
+   * @note  If <usb> is true, only the configurations that provide an exact
+   *        48 MHz USB/SDIO/RNG clock are considered, otherwise this clock is
+   *        only kept at or below 48 MHz.
+   */
+  constexpr u32 solve(u32 const in, u32 const target, bool const usb)
+  {
+    return searchM(in, target, usb, PLLM_MIN, 0);
+  }
+#endif // STM32F1XX
+}  // namespace pll
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                     Interrupt latency and duration profiling
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+#include "text.hpp"
+
+#include "../memorymap/nvic.hpp"
+
+/**
+ * Records, per IRQ, the timestamp of the last entry, the duration of the
+ * last execution, the minimum and maximum durations, the number of
+ * executions and the latency between a request (marked by the application) and the entry.
+ *
+ * The profiler is templated on its cycle counter, any class with a static
+ * u32 getCycleCount() function will do. On the target use the DWT:
+ *
+ *   DWT::enableCycleCounter();
+ *   typedef profile::Profiler<DWT, 82> PROFILER;
+ *
+ * Handlers are instrumented by defining them with PROFILE_INTERRUPT:
+ *
+ *   PROFILE_INTERRUPT(PROFILER, DMA2_Stream7)
+ *   {
+ *     // Handler body
+ *   }
+ *
+ * The latency is only known if the application marks the request, e.g.
+ * right before starting the DMA transfer:
+ *
+ *   PROFILER::markRequest<nvic::irqn::DMA2_Stream7>();
+ *
+ * Durations are inclusive, the time spent in a preempting ISR is counted in
+ * the preempted ISR too. All values are in counter cycles.
+ *
+ * The table logic doesn't touch any register, and can be exercised on a host
+ * with a fake counter.
+ */
+
+// Defines the interrupt handler <VECTOR>, and records its execution in
+// <PROFILER>. The handler body must follow the macro.
+#define PROFILE_INTERRUPT(PROFILER, VECTOR) \
+  static inline void profiled##VECTOR(); \
+  void interrupt::VECTOR() \
+  { \
+    PROFILER::template enter<nvic::irqn::VECTOR>(); \
+    profiled##VECTOR(); \
+    PROFILER::template exit<nvic::irqn::VECTOR>(); \
+  } \
+  static inline void profiled##VECTOR()
+
+namespace profile {
+  struct Record {
+      u32 request;  // Timestamp of the last request
+      u32 entry;  // Timestamp of the last entry
+      u32 latency;  // Last request to entry delay
+      u32 duration;  // Last execution time
+      u32 minimum;  // Minimum execution time
+      u32 maximum;  // Maximum execution time
+      u32 count;  // Number of executions
+      bool pending;  // A request was marked, the handler hasn't entered yet
+  };
+
+  template<typename COUNTER, u8 SLOTS>
+  class Profiler {
+    public:
+      template<nvic::irqn::E IRQ>
+      static inline void markRequest();
+
+      template<nvic::irqn::E IRQ>
+      static inline void enter();
+
+      template<nvic::irqn::E IRQ>
+      static inline void exit();
+
+      static inline Record const& getRecord(u8 const);
+      static inline void clear();
+
+      template<typename OUTPUT>
+      static inline void dump();
+
+    private:
+      Profiler();
+
+      static Record records[SLOTS];
+  };
+}  // namespace profile
+
+#include "../bits/profile.tcc"
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                        PTP (IEEE 1588) clock discipline
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "defs.hpp"
+
+#include "critical.hpp"
+
+/**
+ * The PTP protocol itself (Sync/Follow_Up/Delay_Req exchange) runs over the
+ * eth::Driver, with the frames timestamped by the MAC (F2/F4). For each
+ * exchange, the offset of the local clock is:
+ *
+ *   offset = ((t2 - t1) - (t4 - t3)) / 2  // Local minus master
+ *
+ * which the servo turns into clock corrections:
+ *
+ *   ptp::Servo servo;
+ *
+ *   if (servo.sample(offset) == ptp::Servo::STEP) {
+ *     PTP::adjustTime(-offset);
+ *     DISCIPLINE::reset();
+ *   }
+ *
+ *   PTP::adjustFrequency(servo.getFrequency());
+ *
+ * The servo doesn't touch any register, so it builds and runs on the host.
+ *
+ * The system time (systime::Functions) keeps ticking from the SysTick, the
+ * discipline maps it onto the PTP clock, so timestamps taken from interrupt
+ * handlers line up across the nodes:
+ *
+ *   typedef ptp::Discipline<SYSTIME, PTP> DISCIPLINE;
+ *
+ *   // Periodically, e.g. from a systime::Timer every second
+ *   DISCIPLINE::sample();
+ *
+ *   u64 const when = DISCIPLINE::getNanoseconds();
+ */
+namespace ptp {
+  /**
+   * Proportional-integral servo. The gains are in 1/1024 units per
+   * nanosecond of offset, tuned for one sample per second.
+   */
+  class Servo {
+    public:
+      enum Action {
+        STEP,  // The offset is too large, jump the clock by -offset
+        ADJUST  // Only adjust the frequency
+      };
+
+      inline Servo(
+          u32 const stepThreshold = 1000000,
+          s32 const maxFrequency = 500000,
+          s32 const kp = 717,
+          s32 const ki = 307);
+
+      inline Action sample(s64 const);
+      inline s32 getFrequency() const;
+      inline void reset();
+
+    private:
+      u32 const stepThreshold;  // In ns
+      s32 const maxFrequency;  // In ppb
+      s32 const kp;
+      s32 const ki;
+      s64 integral;  // In ppb / 1024
+      s32 frequency;  // In ppb
+      bool started;
+  };
+
+  /**
+   * Maps the SYSTIME microseconds onto the nanoseconds of the CLOCK
+   * (eth::Ptp), through the last reference point and the measured rate of
+   * the CLOCK relative to the SYSTIME. Both clocks are read in a LOCK
+   * section.
+   */
+  template<
+      typename SYSTIME,
+      typename CLOCK,
+      typename LOCK = critical::Section
+  >
+  class Discipline {
+    public:
+      static inline void sample();
+      static inline void reset();
+
+      static inline bool isSynchronized();
+      static inline s32 getRate();
+      static inline u64 convert(u64 const);
+      static inline u64 getNanoseconds();
+
+    private:
+      Discipline();
+
+      static u64 referenceMicroseconds;
+      static u64 referenceNanoseconds;
+      static s32 rate;  // In ppb
+      static u8 samples;
+  };
+}  // namespace ptp
+
+#include "../bits/ptp.tcc"
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                     Stack watermarking and overflow guard
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "core/mpu.hpp"
+#include "core/scb.hpp"
+
+/**
+ * Without an RTOS the main program and the exception handlers share the main
+ * stack (MSP). The linker script must provide its bounds, the guard occupies
+ * the lowest GUARD_SIZE bytes and __stack_start__ must be aligned to it:
+ *
+ *   __stack_start__, __stack_end__
+ *
+ * e.g. (GNU ld, 4 KB stack, 32 bytes guard):
+ *
+ *   .stack (NOLOAD) : ALIGN(32) {
+ *     __stack_start__ = .; . += 4096; __stack_end__ = .;
+ *   } > ram
+ *
+ * Usage:
+ *
+ *   typedef stack::Functions<32> STACK;
+ *
+ *   STACK_GUARD_HANDLER(MemManage_Handler, STACK)  // Startup vector name
+ *
+ *   void stack::guardViolationHandler(u32 pc, u32 address, u8 status)
+ *   {
+ *     // Log and reset, the main stack has been discarded
+ *   }
+ *
+ *   STACK::paint();  // First thing in main()
+ *   STACK::installGuard(7);
+ *   ...
+ *   STACK::getHighWaterMark();  // Deepest usage since paint(), in bytes
+ *
+ * The painted pattern is overwritten as the stack grows, the high-water mark
+ * is found by scanning up from the guard for the first overwritten word. A
+ * local buffer that is allocated but never written is missed, so leave some
+ * margin.
+ *
+ * With the fault records of fault.hpp, define
+ * FAULT_STACK_GUARD_HANDLER(MemManage_Handler, STACK) instead of
+ * STACK_GUARD_HANDLER(), only one of them can own the vector. It stores the
+ * record and then reports the violation here.
+ *
+ * Stacks owned by the user (e.g. process stacks) can be measured with the
+ * paint(begin, end) and getUnused(begin, end) overloads.
+ */
+
+// Defines the MemManage exception handler <VECTOR>. The faulting PC is read
+// from the exception frame unless the frame itself couldn't be stacked, then
+// the MSP is moved back to the top of the stack and the report is made from
+// a fresh stack.
+#define STACK_GUARD_HANDLER(VECTOR, STACK) \
+  extern "C" __attribute__((naked)) void VECTOR() \
+  { \
+    asm volatile ( \
+        "tst lr, #4\n\t" \
+        "ite eq\n\t" \
+        "mrseq r0, msp\n\t" \
+        "mrsne r0, psp\n\t" \
+        "ldr r1, =%c1\n\t" \
+        "ldr r1, [r1]\n\t" \
+        "tst r1, %2\n\t" \
+        "ite eq\n\t" \
+        "ldreq r0, [r0, #24]\n\t" \
+        "movne r0, #0\n\t" \
+        "ldr r1, =__stack_end__\n\t" \
+        "msr msp, r1\n\t" \
+        "b %c0\n\t" \
+        ".ltorg" \
+        : \
+        : "i" (&STACK::onMemoryManagementFault), \
+          "i" (scb::ADDRESS + scb::cfsr::OFFSET), \
+          "i" (scb::cfsr::mstkerr::MASK)); \
+  }
+
+namespace stack {
+  enum {
+    PATTERN = 0xA5A5A5A5
+  };
+
+  /**
+   * @brief This function is called when an MPU region is violated, <pc> is 0
+   *        if the exception frame couldn't be stacked (<status> has the
+   *        cfsr::mstkerr bit set), <address> is 0 unless cfsr::mmarvalid is
+   *        set.
+   * @note  The user must define this function, it must not return.
+   */
+  void guardViolationHandler(u32 pc, u32 address, u8 status);
+
+  template<u32 GUARD_SIZE>
+  class Functions {
+      static_assert(GUARD_SIZE >= 32,
+          "The smallest MPU region is 32 bytes.");
+      static_assert((GUARD_SIZE & (GUARD_SIZE - 1)) == 0,
+          "The MPU region size must be a power of 2.");
+
+    public:
+      static inline void paint();
+      static inline u32 getSize();
+      static inline u32 getHighWaterMark();
+      static inline u32 getUnused();
+
+      static inline void installGuard(u8 const);
+
+      static inline void paint(u32* const, u32* const);
+      static inline u32 getUnused(u32 const*, u32 const* const);
+
+      static void onMemoryManagementFault(u32 const);
+
+    private:
+      Functions();
+
+      static inline u32* getBottom();
+  };
+}  // namespace stack
+
+#include "../bits/stack.tcc"
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                    System time base and software timers
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "clock.hpp"
+#include "critical.hpp"
+#include "core/scb.hpp"
+#include "core/stk.hpp"
+
+/**
+ * The SysTick interrupts at TICK_FREQUENCY, each interrupt increments a 64
+ * bit tick counter. Microsecond timestamps are derived from the tick count
+ * and the SysTick current value, so their resolution is 8 / AHB seconds.
+ *
+ * Many software timers (one-shot or periodic) can be scheduled on top of the
+ * tick. They live in a 4 level x 64 slot hierarchical timer wheel: insertion
+ * and cancellation are O(1), each tick only visits one slot of the first
+ * level (plus one slot of the upper levels every 64, 4096, ... ticks). The
+ * timers are allocated by the user, the wheel only links them.
+ *
+ *   typedef systime::Functions<1000> SYSTIME;  // 1 ms tick
+ *
+ *   systime::Timer timeout;
+ *
+ *   void onTimeout(void* context) { ... }
+ *
+ *   SYSTIME::initialize();
+ *   SYSTIME::schedule(timeout, 250, 0, onTimeout, 0);  // In 250 ticks
+ *
+ * The user must call SYSTIME::onSysTickInterrupt() from the SysTick
+ * exception handler. The callbacks run in that context.
+ */
+namespace systime {
+  enum {
+    LEVELS = 4,
+    SLOT_BITS = 6,
+    SLOTS = 1 << SLOT_BITS,
+    SLOT_MASK = SLOTS - 1
+  };
+
+  typedef void (*Callback)(void*);
+
+  class Timer {
+    public:
+      inline Timer();
+
+      inline bool isScheduled() const;
+      inline u64 getExpiry() const;
+
+    private:
+      template<u32> friend class Functions;
+
+      Timer* next;
+      Timer** previous;  // Pointer that points to this timer
+      u64 expiry;  // In ticks
+      u32 period;  // In ticks, 0 = one-shot
+      Callback callback;
+      void* context;
+  };
+
+  template<u32 TICK_FREQUENCY>
+  class Functions {
+      static_assert(1000000 % TICK_FREQUENCY == 0,
+          "The tick frequency must divide 1 MHz.");
+      static_assert(stk::Functions::TICKERCLOCK / TICK_FREQUENCY <= 0xFFFFFF,
+          "The tick frequency is too low for the SysTick reload register.");
+
+    public:
+      enum {
+        MICROSECONDS_PER_TICK = 1000000 / TICK_FREQUENCY
+      };
+
+      static inline void initialize();
+      static inline void onSysTickInterrupt();
+
+      static inline u64 getTicks();
+      static inline u64 getMicroseconds();
+
+      static inline void schedule(
+          Timer&,
+          u32 const,
+          u32 const,
+          Callback const,
+          void* const);
+      static inline void cancel(Timer&);
+
+      static inline u32 getIdleTicks(u32 const);
+      static inline void advance(u32);
+
+    private:
+      Functions();
+
+      static inline void insert(Timer&);
+      static inline void unlink(Timer&);
+      static inline void cascade(u8 const);
+
+      static u64 volatile ticks;
+      static Timer* wheel[LEVELS][SLOTS];
+  };
+}  // namespace systime
+
+#include "../bits/systime.tcc"
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                        Minimal text output (no printf)
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "defs.hpp"
+
+/**
+ * Writes strings, decimal and hexadecimal numbers through OUTPUT, any class
+ * with the static functions canSendDataYet() and sendData(u8), e.g. USART1.
+ */
+namespace text {
+  template<typename OUTPUT>
+  class Writer {
+    public:
+      static inline void print(char const*);
+      static inline void print(u32);
+      static inline void printHex(u32);
+
+    private:
+      Writer();
+  };
+}  // namespace text
+
+#include "../bits/text.tcc"
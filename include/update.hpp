@@ -0,0 +1,171 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ *                          A/B firmware update engine
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "device_select.hpp"
+#include "defs.hpp"
+
+#include "async.hpp"
+#include "core/scb.hpp"
+#include "peripheral/crc.hpp"
+#include "peripheral/flash.hpp"
+#ifndef STM32F1XX
+#include "peripheral/syscfg.hpp"
+#endif // !STM32F1XX
+
+#ifndef UPDATE_BUFFER_SIZE
+#define UPDATE_BUFFER_SIZE 256
+#endif // UPDATE_BUFFER_SIZE
+
+/**
+ * The flash holds two image slots of SLOT_SIZE bytes. A new image is
+ * streamed into the slot that isn't running, while the previous chunk is
+ * programmed by the FLASH interrupt (async::Flash):
+ *
+ *   typedef update::Engine<0x08000000, 0x08100000, 0x100000> UPDATE;
+ *
+ *   void interrupt::FLASH() { async::Flash::onInterrupt(); }
+ *
+ *   UPDATE::begin(size);
+ *
+ *   while (remaining != 0) {
+ *     // Any byte source, e.g. a USART ring or the USB CDC endpoint
+ *     remaining -= UPDATE::write(chunk, available);
+ *   }
+ *
+ *   if (UPDATE::finish(crc32)) {
+ *     SCB::resetSystem();
+ *   }
+ *
+ * Two buffers of UPDATE_BUFFER_SIZE bytes are used in turn, so the data of
+ * one can arrive while the other is being programmed. write() only accepts
+ * what fits in a free buffer, the caller applies the back pressure.
+ *
+ * The slot sectors (pages on the F1) are erased in the background after
+ * begin(), the last one first. Each slot ends with a trailer:
+ *
+ *   | sequence | size | CRC-32 of the image | MAGIC |
+ *
+ * which is only programmed once the CRC-32 (zlib) of the image, computed by
+ * the CRC unit, matches the one provided by the sender. The MAGIC word goes
+ * last, so the trailer commits the image atomically. The slot with a valid
+ * trailer and the highest sequence number is the boot slot.
+ *
+ * boot() must run first thing after reset, before any interrupt is
+ * enabled:
+ *
+ *  - F4 dual bank devices, with the slots set to the two banks: both
+ *    images are linked at 0x08000000. The bank the device boots from is
+ *    selected by the BFB2 option bit, the system memory boot loader maps
+ *    the bank 2 at 0x08000000 (syscfg::memrmp::ufb_mode) before starting
+ *    it. The running bank is always slot 0, the other one appears at
+ *    0x08100000. If the boot slot is slot 1, BFB2 is flipped and the
+ *    device is reset, otherwise BFB2 is made to select the running bank.
+ *    begin() checks BFB2 as well, so the bank being erased is never the one
+ *    the device boots from, and finish() points BFB2 at the new image.
+ *  - Otherwise: each image is linked at the address of its slot, and
+ *    boot() belongs to a bootloader that jumps to the boot slot.
+ */
+namespace update {
+  enum {
+    MAGIC = 0xB007AB1E,
+    TRAILER_SIZE = 16
+  };
+
+  static_assert(UPDATE_BUFFER_SIZE % 8 == 0,
+      "The buffer size must be a multiple of the largest programming unit.");
+
+  template<u32 SLOT0, u32 SLOT1, u32 SLOT_SIZE>
+  class Engine {
+    public:
+      static inline bool boot();
+      static inline u8 getRunningSlot();
+      static inline u32 getSlotAddress(u8 const);
+      static inline bool isValid(u8 const);
+
+      static inline bool begin(u32 const);
+      static inline u32 write(void const* const, u32 const);
+      static inline bool isBusy();
+      static inline bool hasFailed();
+      static inline bool finish(u32 const);
+      static inline void abort();
+
+    private:
+      Engine();
+
+      enum {
+#ifdef STM32F4XX
+        SWAP = (SLOT0 == flash::MEMORY) &&
+            (SLOT1 == flash::MEMORY + flash::BANK_SIZE) &&
+            (SLOT_SIZE == flash::BANK_SIZE)
+#else // STM32F4XX
+        SWAP = false
+#endif // STM32F4XX
+      };
+
+      enum Step {
+        IDLE,
+        ERASING,
+        RECEIVING,
+        FAILED
+      };
+
+      struct Trailer {
+          u32 sequence;
+          u32 size;
+          u32 crc;
+          u32 magic;
+      };
+
+      static inline Trailer const volatile& getTrailer(u8 const);
+      static inline bool isIntact(u8 const);
+      static inline s8 getNewestSlot(bool const);
+      static inline u32 getSectorStart(u32 const);
+      static inline u32 getSectorSize(u32 const);
+      static inline async::Operation& startErase(u32 const);
+      static inline bool setBootBank(bool const);
+      static inline void start(u32 const) __attribute__((noreturn));
+      static inline void queue();
+      static inline void poll();
+
+      static Step volatile step;
+      static async::Operation* operation;
+      static u32 target;
+      static u32 size;
+      static u32 received;
+      static u32 address;
+      static u32 erasing;
+      static u8 buffers[2][UPDATE_BUFFER_SIZE];
+      static u16 queued[2];
+      static u8 head;
+      static u8 filling;
+      static u16 filled;
+  };
+}  // namespace update
+
+#include "../bits/update.tcc"
@@ -41,6 +41,23 @@ namespace afio {
       u32 MAPR2;      // 0x1C: Remap and debug configuration 2
   };
 
+  namespace mapr {
+    enum {
+      OFFSET = 0x04
+    };
+    // Connectivity line only
+    namespace mii_rmii_sel {
+      enum {
+        POSITION = 23,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        MII = 0 << POSITION,
+        RMII = 1 << POSITION
+      };
+    }  // namespace mii_rmii_sel
+  }  // namespace mapr
+
   namespace exticr {
     enum {
       MASK = 0b1111,
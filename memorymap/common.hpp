@@ -38,6 +38,7 @@ namespace alias {
     AHB = PERIPH + 0x00020000,
 
 #elif defined (STM32F2XX)
+    BKPSRAM = 0x40024000,
     AHB1 = PERIPH + 0x00020000,
     AHB2 = PERIPH + 0x10000000,
 
@@ -59,5 +59,11 @@ namespace crc {
     enum {
       OFFSET = 0x08
     };
+    namespace reset {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace reset
   }  // namespace cr
 }  // namespace crc
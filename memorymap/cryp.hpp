@@ -63,12 +63,112 @@ namespace cryp {
     enum {
       OFFSET = 0x00
     };
+    namespace algodir {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        ENCRYPT = 0 << POSITION,
+        DECRYPT = 1 << POSITION
+      };
+    }  // namespace algodir
+
+    namespace algomode {
+      enum {
+        POSITION = 3,
+        MASK = 0b111 << POSITION
+      };
+      enum States {
+        TDES_ECB = 0b000 << POSITION,
+        TDES_CBC = 0b001 << POSITION,
+        DES_ECB = 0b010 << POSITION,
+        DES_CBC = 0b011 << POSITION,
+        AES_ECB = 0b100 << POSITION,
+        AES_CBC = 0b101 << POSITION,
+        AES_CTR = 0b110 << POSITION,
+        AES_KEY_PREPARATION = 0b111 << POSITION
+      };
+    }  // namespace algomode
+
+    namespace datatype {
+      enum {
+        POSITION = 6,
+        MASK = 0b11 << POSITION
+      };
+      enum States {
+        _32_BIT_DATA = 0b00 << POSITION,
+        _16_BIT_DATA = 0b01 << POSITION,
+        _8_BIT_DATA = 0b10 << POSITION,
+        BIT_STRING = 0b11 << POSITION
+      };
+    }  // namespace datatype
+
+    namespace keysize {
+      enum {
+        POSITION = 8,
+        MASK = 0b11 << POSITION
+      };
+      enum States {
+        _128_BITS = 0b00 << POSITION,
+        _192_BITS = 0b01 << POSITION,
+        _256_BITS = 0b10 << POSITION
+      };
+    }  // namespace keysize
+
+    namespace fflush {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fflush
+
+    namespace crypen {
+      enum {
+        POSITION = 15,
+        MASK = 1 << POSITION
+      };
+    }  // namespace crypen
   }  // namespace cr
 
   namespace sr {
     enum {
       OFFSET = 0x04
     };
+    namespace ifem {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ifem
+
+    namespace ifnf {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ifnf
+
+    namespace ofne {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ofne
+
+    namespace offu {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace offu
+
+    namespace busy {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace busy
   }  // namespace sr
 
   namespace dr {
@@ -87,6 +187,19 @@ namespace cryp {
     enum {
       OFFSET = 0x10
     };
+    namespace dien {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dien
+
+    namespace doen {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace doen
   }  // namespace dmacr
 
   namespace imscr {
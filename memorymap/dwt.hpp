@@ -0,0 +1,137 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "common.hpp"
+
+namespace dwt {
+  enum {
+    ADDRESS = 0xE0001000,
+    COMPARATORS = 4
+  };
+
+  struct Comparator {
+      __RW
+      u32 COMP;  // 0x00: Comparator
+      __RW
+      u32 MASK;  // 0x04: Mask
+      __RW
+      u32 FUNCTION;  // 0x08: Function
+      u32 _RESERVED;
+  };
+
+  struct Registers {
+      __RW
+      u32 CTRL;  // 0x00: Control
+      __RW
+      u32 CYCCNT;  // 0x04: Cycle count
+      __RW
+      u32 CPICNT;  // 0x08: CPI count
+      __RW
+      u32 EXCCNT;  // 0x0C: Exception overhead count
+      __RW
+      u32 SLEEPCNT;  // 0x10: Sleep count
+      __RW
+      u32 LSUCNT;  // 0x14: LSU count
+      __RW
+      u32 FOLDCNT;  // 0x18: Folded instruction count
+      __R
+      u32 PCSR;  // 0x1C: Program counter sample
+      Comparator COMPARATOR[COMPARATORS];  // 0x20: Comparators
+  };
+
+  namespace ctrl {
+    enum {
+      OFFSET = 0x00
+    };
+    namespace cyccntena {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        CYCLE_COUNTER_DISABLED = 0 << POSITION,
+        CYCLE_COUNTER_ENABLED = 1 << POSITION
+      };
+    }  // namespace cyccntena
+
+    namespace numcomp {
+      enum {
+        POSITION = 28,
+        MASK = 0b1111 << POSITION
+      };
+    }  // namespace numcomp
+  }  // namespace ctrl
+
+  namespace function {
+    namespace function {
+      enum {
+        POSITION = 0,
+        MASK = 0b1111 << POSITION
+      };
+      enum States {
+        DISABLED = 0b0000 << POSITION,
+        PC_SAMPLE = 0b0001 << POSITION,
+        DATA_ADDRESS_SAMPLE = 0b0010 << POSITION,
+        WATCHPOINT_ON_PC_MATCH = 0b0100 << POSITION,
+        WATCHPOINT_ON_READ = 0b0101 << POSITION,
+        WATCHPOINT_ON_WRITE = 0b0110 << POSITION,
+        WATCHPOINT_ON_READ_OR_WRITE = 0b0111 << POSITION
+      };
+    }  // namespace function
+
+    namespace cycmatch {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        COMPARE_ADDRESS = 0 << POSITION,
+        COMPARE_CYCLE_COUNTER = 1 << POSITION
+      };
+    }  // namespace cycmatch
+
+    namespace matched {
+      enum {
+        POSITION = 24,
+        MASK = 1 << POSITION
+      };
+    }  // namespace matched
+  }  // namespace function
+
+  // Debug exception and monitor control register (core debug block)
+  namespace demcr {
+    enum {
+      ADDRESS = 0xE000EDFC
+    };
+    namespace trcena {
+      enum {
+        POSITION = 24,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        DWT_AND_ITM_DISABLED = 0 << POSITION,
+        DWT_AND_ITM_ENABLED = 1 << POSITION
+      };
+    }  // namespace trcena
+  }  // namespace demcr
+}  // namespace dwt
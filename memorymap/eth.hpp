@@ -279,5 +279,1419 @@ namespace eth {
 #endif
   };
 
-// TODO ETH register bits
+  namespace maccr {
+    enum {
+      OFFSET = 0x0000
+    };
+    namespace re {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace re
+
+    namespace te {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace te
+
+    namespace dc {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dc
+
+    namespace bl {
+      enum {
+        POSITION = 5,
+        MASK = 0b11 << POSITION
+      };
+    }  // namespace bl
+
+    namespace apcs {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace apcs
+
+    namespace rd {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rd
+
+    // IPv4 header and TCP/UDP/ICMP payload checksum check
+    namespace ipco {
+      enum {
+        POSITION = 10,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ipco
+
+    namespace dm {
+      enum {
+        POSITION = 11,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dm
+
+    namespace lm {
+      enum {
+        POSITION = 12,
+        MASK = 1 << POSITION
+      };
+    }  // namespace lm
+
+    namespace rod {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rod
+
+    namespace fes {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fes
+
+    namespace csd {
+      enum {
+        POSITION = 16,
+        MASK = 1 << POSITION
+      };
+    }  // namespace csd
+
+    namespace ifg {
+      enum {
+        POSITION = 17,
+        MASK = 0b111 << POSITION
+      };
+    }  // namespace ifg
+
+    namespace jd {
+      enum {
+        POSITION = 22,
+        MASK = 1 << POSITION
+      };
+    }  // namespace jd
+
+    namespace wd {
+      enum {
+        POSITION = 23,
+        MASK = 1 << POSITION
+      };
+    }  // namespace wd
+
+#ifndef STM32F1XX
+    namespace cstf {
+      enum {
+        POSITION = 25,
+        MASK = 1 << POSITION
+      };
+    }  // namespace cstf
+#endif // !STM32F1XX
+  }  // namespace maccr
+
+  namespace macffr {
+    enum {
+      OFFSET = 0x0004
+    };
+    namespace pm {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pm
+
+    namespace hu {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace hu
+
+    namespace hm {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace hm
+
+    namespace daif {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace daif
+
+    namespace pam {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pam
+
+    namespace bfd {
+      enum {
+        POSITION = 5,
+        MASK = 1 << POSITION
+      };
+    }  // namespace bfd
+
+    namespace ra {
+      enum {
+        POSITION = 31,
+        MASK = 1u << POSITION
+      };
+    }  // namespace ra
+  }  // namespace macffr
+
+  namespace macmiiar {
+    enum {
+      OFFSET = 0x0010
+    };
+    namespace mb {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace mb
+
+    namespace mw {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace mw
+
+    // MDC = HCLK / 42 (60-100 MHz), 62 (100-150 MHz), 16 (20-35 MHz),
+      // 26 (35-60 MHz) or 102 (150-168 MHz)
+    namespace cr {
+      enum {
+        POSITION = 2,
+        MASK = 0b111 << POSITION
+      };
+      enum States {
+        HCLK_DIV_42 = 0b000 << POSITION,
+        HCLK_DIV_62 = 0b001 << POSITION,
+        HCLK_DIV_16 = 0b010 << POSITION,
+        HCLK_DIV_26 = 0b011 << POSITION,
+        HCLK_DIV_102 = 0b100 << POSITION
+      };
+    }  // namespace cr
+
+    namespace mr {
+      enum {
+        POSITION = 6,
+        MASK = 0b11111 << POSITION
+      };
+    }  // namespace mr
+
+    namespace pa {
+      enum {
+        POSITION = 11,
+        MASK = 0b11111 << POSITION
+      };
+    }  // namespace pa
+  }  // namespace macmiiar
+
+  namespace macmiidr {
+    enum {
+      OFFSET = 0x0014
+    };
+    namespace md {
+      enum {
+        POSITION = 0,
+        MASK = 0xFFFF << POSITION
+      };
+    }  // namespace md
+  }  // namespace macmiidr
+
+  namespace macsr {
+    enum {
+      OFFSET = 0x0038
+    };
+    namespace pmts {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pmts
+
+    namespace mmcs {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace mmcs
+
+    namespace tsts {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsts
+  }  // namespace macsr
+
+  namespace macimr {
+    enum {
+      OFFSET = 0x003C
+    };
+    namespace pmtim {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pmtim
+
+    namespace tstim {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tstim
+  }  // namespace macimr
+
+  namespace maca0hr {
+    enum {
+      OFFSET = 0x0040
+    };
+    namespace maca0h {
+      enum {
+        POSITION = 0,
+        MASK = 0xFFFF << POSITION
+      };
+    }  // namespace maca0h
+
+    namespace mo {
+      enum {
+        POSITION = 31,
+        MASK = 1u << POSITION
+      };
+    }  // namespace mo
+  }  // namespace maca0hr
+
+  namespace maca0lr {
+    enum {
+      OFFSET = 0x0044
+    };
+  }  // namespace maca0lr
+
+#ifndef STM32F1XX
+  namespace ptptscr {
+    enum {
+      OFFSET = 0x0700
+    };
+    namespace tse {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tse
+
+    namespace tsfcu {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsfcu
+
+    namespace tssti {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tssti
+
+    namespace tsstu {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsstu
+
+    namespace tsite {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsite
+
+    namespace ttsaru {
+      enum {
+        POSITION = 5,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ttsaru
+
+    namespace tssarfe {
+      enum {
+        POSITION = 8,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tssarfe
+
+    // Digital rollover, the subsecond register counts nanoseconds
+    namespace tsssr {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsssr
+
+    namespace tsptppsv2e {
+      enum {
+        POSITION = 10,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsptppsv2e
+
+    namespace tssptpoefe {
+      enum {
+        POSITION = 11,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tssptpoefe
+
+    namespace tssipv6fe {
+      enum {
+        POSITION = 12,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tssipv6fe
+
+    namespace tssipv4fe {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tssipv4fe
+
+    namespace tsseme {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsseme
+
+    namespace tssmrme {
+      enum {
+        POSITION = 15,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tssmrme
+
+    namespace tscnt {
+      enum {
+        POSITION = 16,
+        MASK = 0b11 << POSITION
+      };
+    }  // namespace tscnt
+
+    namespace tspffmae {
+      enum {
+        POSITION = 18,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tspffmae
+  }  // namespace ptptscr
+
+  namespace ptpssir {
+    enum {
+      OFFSET = 0x0704
+    };
+    namespace stssi {
+      enum {
+        POSITION = 0,
+        MASK = 0xFF << POSITION
+      };
+    }  // namespace stssi
+  }  // namespace ptpssir
+
+  namespace ptptslr {
+    enum {
+      OFFSET = 0x070C
+    };
+    namespace stss {
+      enum {
+        POSITION = 0,
+        MASK = 0x7FFFFFFF << POSITION
+      };
+    }  // namespace stss
+
+    namespace stpns {
+      enum {
+        POSITION = 31,
+        MASK = 1u << POSITION
+      };
+    }  // namespace stpns
+  }  // namespace ptptslr
+
+  namespace ptptslur {
+    enum {
+      OFFSET = 0x0714
+    };
+    namespace tsuss {
+      enum {
+        POSITION = 0,
+        MASK = 0x7FFFFFFF << POSITION
+      };
+    }  // namespace tsuss
+
+    namespace tsupns {
+      enum {
+        POSITION = 31,
+        MASK = 1u << POSITION
+      };
+    }  // namespace tsupns
+  }  // namespace ptptslur
+
+  namespace ptptssr {
+    enum {
+      OFFSET = 0x0728
+    };
+    namespace tsso {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsso
+
+    namespace tsttr {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsttr
+  }  // namespace ptptssr
+
+  namespace ptpppscr {
+    enum {
+      OFFSET = 0x072C
+    };
+    namespace ppsfreq {
+      enum {
+        POSITION = 0,
+        MASK = 0b1111 << POSITION
+      };
+    }  // namespace ppsfreq
+  }  // namespace ptpppscr
+#endif // !STM32F1XX
+
+  namespace dmabmr {
+    enum {
+      OFFSET = 0x1000
+    };
+    namespace sr {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace sr
+
+    namespace da {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace da
+
+    namespace dsl {
+      enum {
+        POSITION = 2,
+        MASK = 0b11111 << POSITION
+      };
+    }  // namespace dsl
+
+#ifndef STM32F1XX
+    // Enhanced (8 words) descriptors, required by the PTP v2 timestamps
+    namespace edfe {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace edfe
+#endif // !STM32F1XX
+
+    namespace pbl {
+      enum {
+        POSITION = 8,
+        MASK = 0b111111 << POSITION
+      };
+    }  // namespace pbl
+
+    namespace rtpr {
+      enum {
+        POSITION = 14,
+        MASK = 0b11 << POSITION
+      };
+    }  // namespace rtpr
+
+    namespace fb {
+      enum {
+        POSITION = 16,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fb
+
+    namespace rdp {
+      enum {
+        POSITION = 17,
+        MASK = 0b111111 << POSITION
+      };
+    }  // namespace rdp
+
+    namespace usp {
+      enum {
+        POSITION = 23,
+        MASK = 1 << POSITION
+      };
+    }  // namespace usp
+
+    namespace fpm {
+      enum {
+        POSITION = 24,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fpm
+
+    namespace aab {
+      enum {
+        POSITION = 25,
+        MASK = 1 << POSITION
+      };
+    }  // namespace aab
+  }  // namespace dmabmr
+
+  namespace dmatpdr {
+    enum {
+      OFFSET = 0x1004
+    };
+  }  // namespace dmatpdr
+
+  namespace dmarpdr {
+    enum {
+      OFFSET = 0x1008
+    };
+  }  // namespace dmarpdr
+
+  namespace dmasr {
+    enum {
+      OFFSET = 0x1014
+    };
+    namespace ts {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ts
+
+    namespace tpss {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tpss
+
+    namespace tbus {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tbus
+
+    namespace tjts {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tjts
+
+    namespace ros {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ros
+
+    namespace tus {
+      enum {
+        POSITION = 5,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tus
+
+    namespace rs {
+      enum {
+        POSITION = 6,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rs
+
+    namespace rbus {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rbus
+
+    namespace rpss {
+      enum {
+        POSITION = 8,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rpss
+
+    namespace rwts {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rwts
+
+    namespace ets {
+      enum {
+        POSITION = 10,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ets
+
+    namespace fbes {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fbes
+
+    namespace ers {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ers
+
+    namespace ais {
+      enum {
+        POSITION = 15,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ais
+
+    namespace nis {
+      enum {
+        POSITION = 16,
+        MASK = 1 << POSITION
+      };
+    }  // namespace nis
+
+    namespace rps {
+      enum {
+        POSITION = 17,
+        MASK = 0b111 << POSITION
+      };
+    }  // namespace rps
+
+    namespace tps {
+      enum {
+        POSITION = 20,
+        MASK = 0b111 << POSITION
+      };
+    }  // namespace tps
+
+    namespace ebs {
+      enum {
+        POSITION = 23,
+        MASK = 0b111 << POSITION
+      };
+    }  // namespace ebs
+
+    namespace mmcs {
+      enum {
+        POSITION = 27,
+        MASK = 1 << POSITION
+      };
+    }  // namespace mmcs
+
+    namespace pmts {
+      enum {
+        POSITION = 28,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pmts
+
+    namespace tsts {
+      enum {
+        POSITION = 29,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsts
+
+    enum {
+      // Write 1 to clear flags
+      FLAGS = 0x1E7FF
+    };
+  }  // namespace dmasr
+
+  namespace dmaomr {
+    enum {
+      OFFSET = 0x1018
+    };
+    namespace sr {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace sr
+
+    namespace osf {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace osf
+
+    namespace rtc {
+      enum {
+        POSITION = 3,
+        MASK = 0b11 << POSITION
+      };
+    }  // namespace rtc
+
+    namespace fugf {
+      enum {
+        POSITION = 6,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fugf
+
+    namespace fef {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fef
+
+    namespace st {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace st
+
+    namespace ttc {
+      enum {
+        POSITION = 14,
+        MASK = 0b111 << POSITION
+      };
+    }  // namespace ttc
+
+    namespace ftf {
+      enum {
+        POSITION = 20,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ftf
+
+    namespace tsf {
+      enum {
+        POSITION = 21,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsf
+
+    namespace dfrf {
+      enum {
+        POSITION = 24,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dfrf
+
+    namespace rsf {
+      enum {
+        POSITION = 25,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rsf
+
+    namespace dtcefd {
+      enum {
+        POSITION = 26,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dtcefd
+  }  // namespace dmaomr
+
+  namespace dmaier {
+    enum {
+      OFFSET = 0x101C
+    };
+    namespace tie {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tie
+
+    namespace tpsie {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tpsie
+
+    namespace tbuie {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tbuie
+
+    namespace tjtie {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tjtie
+
+    namespace roie {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace roie
+
+    namespace tuie {
+      enum {
+        POSITION = 5,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tuie
+
+    namespace rie {
+      enum {
+        POSITION = 6,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rie
+
+    namespace rbuie {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rbuie
+
+    namespace rpsie {
+      enum {
+        POSITION = 8,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rpsie
+
+    namespace rwtie {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rwtie
+
+    namespace etie {
+      enum {
+        POSITION = 10,
+        MASK = 1 << POSITION
+      };
+    }  // namespace etie
+
+    namespace fbeie {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fbeie
+
+    namespace erie {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace erie
+
+    namespace aise {
+      enum {
+        POSITION = 15,
+        MASK = 1 << POSITION
+      };
+    }  // namespace aise
+
+    namespace nise {
+      enum {
+        POSITION = 16,
+        MASK = 1 << POSITION
+      };
+    }  // namespace nise
+  }  // namespace dmaier
+
+  // DMA descriptor words, see eth::Descriptor
+  namespace tdes0 {
+    namespace db {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace db
+
+    namespace uf {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace uf
+
+    namespace ed {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ed
+
+    namespace cc {
+      enum {
+        POSITION = 3,
+        MASK = 0b1111 << POSITION
+      };
+    }  // namespace cc
+
+    namespace vf {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace vf
+
+    namespace ec {
+      enum {
+        POSITION = 8,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ec
+
+    namespace lco {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace lco
+
+    namespace nc {
+      enum {
+        POSITION = 10,
+        MASK = 1 << POSITION
+      };
+    }  // namespace nc
+
+    namespace lca {
+      enum {
+        POSITION = 11,
+        MASK = 1 << POSITION
+      };
+    }  // namespace lca
+
+    namespace ipe {
+      enum {
+        POSITION = 12,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ipe
+
+    namespace ff {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ff
+
+    namespace jt {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace jt
+
+    namespace es {
+      enum {
+        POSITION = 15,
+        MASK = 1 << POSITION
+      };
+    }  // namespace es
+
+    namespace ihe {
+      enum {
+        POSITION = 16,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ihe
+
+    namespace ttss {
+      enum {
+        POSITION = 17,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ttss
+
+    namespace tch {
+      enum {
+        POSITION = 20,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tch
+
+    namespace ter {
+      enum {
+        POSITION = 21,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ter
+
+    // Checksum insertion
+    namespace cic {
+      enum {
+        POSITION = 22,
+        MASK = 0b11 << POSITION
+      };
+      enum States {
+        BYPASS = 0b00 << POSITION,
+        IP_HEADER = 0b01 << POSITION,
+        IP_HEADER_AND_PAYLOAD = 0b10 << POSITION,
+        IP_HEADER_PAYLOAD_AND_PSEUDO_HEADER = 0b11 << POSITION
+      };
+    }  // namespace cic
+
+    namespace ttse {
+      enum {
+        POSITION = 25,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ttse
+
+    namespace dp {
+      enum {
+        POSITION = 26,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dp
+
+    namespace dc {
+      enum {
+        POSITION = 27,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dc
+
+    namespace fs {
+      enum {
+        POSITION = 28,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fs
+
+    namespace ls {
+      enum {
+        POSITION = 29,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ls
+
+    namespace ic {
+      enum {
+        POSITION = 30,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ic
+
+    namespace own {
+      enum {
+        POSITION = 31,
+        MASK = 1u << POSITION
+      };
+    }  // namespace own
+  }  // namespace tdes0
+
+  namespace tdes1 {
+    namespace tbs1 {
+      enum {
+        POSITION = 0,
+        MASK = 0x1FFF << POSITION
+      };
+    }  // namespace tbs1
+
+    namespace tbs2 {
+      enum {
+        POSITION = 16,
+        MASK = 0x1FFF << POSITION
+      };
+    }  // namespace tbs2
+  }  // namespace tdes1
+
+  namespace rdes0 {
+    // Payload checksum error (F1), extended status available (F2/F4)
+    namespace pce {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pce
+
+    namespace ce {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ce
+
+    namespace dbe {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dbe
+
+    namespace re {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace re
+
+    namespace rwt {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rwt
+
+    namespace ft {
+      enum {
+        POSITION = 5,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ft
+
+    namespace lco {
+      enum {
+        POSITION = 6,
+        MASK = 1 << POSITION
+      };
+    }  // namespace lco
+
+    // IP header checksum error (F1), timestamp valid (F2/F4)
+    namespace iphce {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace iphce
+#ifndef STM32F1XX
+
+    // Timestamp valid, with the enhanced descriptors
+    namespace tsv {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tsv
+#endif // !STM32F1XX
+
+    namespace ls {
+      enum {
+        POSITION = 8,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ls
+
+    namespace fs {
+      enum {
+        POSITION = 9,
+        MASK = 1 << POSITION
+      };
+    }  // namespace fs
+
+    namespace vlan {
+      enum {
+        POSITION = 10,
+        MASK = 1 << POSITION
+      };
+    }  // namespace vlan
+
+    namespace oe {
+      enum {
+        POSITION = 11,
+        MASK = 1 << POSITION
+      };
+    }  // namespace oe
+
+    namespace le {
+      enum {
+        POSITION = 12,
+        MASK = 1 << POSITION
+      };
+    }  // namespace le
+
+    namespace saf {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace saf
+
+    namespace de {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace de
+
+    namespace es {
+      enum {
+        POSITION = 15,
+        MASK = 1 << POSITION
+      };
+    }  // namespace es
+
+    namespace fl {
+      enum {
+        POSITION = 16,
+        MASK = 0x3FFF << POSITION
+      };
+    }  // namespace fl
+
+    namespace afm {
+      enum {
+        POSITION = 30,
+        MASK = 1 << POSITION
+      };
+    }  // namespace afm
+
+    namespace own {
+      enum {
+        POSITION = 31,
+        MASK = 1u << POSITION
+      };
+    }  // namespace own
+  }  // namespace rdes0
+
+  namespace rdes1 {
+    namespace rbs1 {
+      enum {
+        POSITION = 0,
+        MASK = 0x1FFF << POSITION
+      };
+    }  // namespace rbs1
+
+    namespace rch {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rch
+
+    namespace rer {
+      enum {
+        POSITION = 15,
+        MASK = 1 << POSITION
+      };
+    }  // namespace rer
+
+    namespace rbs2 {
+      enum {
+        POSITION = 16,
+        MASK = 0x1FFF << POSITION
+      };
+    }  // namespace rbs2
+
+    namespace dic {
+      enum {
+        POSITION = 31,
+        MASK = 1u << POSITION
+      };
+    }  // namespace dic
+  }  // namespace rdes1
+
+  namespace rdes4 {
+    namespace ippt {
+      enum {
+        POSITION = 0,
+        MASK = 0b111 << POSITION
+      };
+    }  // namespace ippt
+
+    namespace iphe {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace iphe
+
+    namespace ippe {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ippe
+
+    namespace ipcb {
+      enum {
+        POSITION = 5,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ipcb
+
+    namespace ipv4pr {
+      enum {
+        POSITION = 6,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ipv4pr
+
+    namespace ipv6pr {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace ipv6pr
+
+    namespace pmt {
+      enum {
+        POSITION = 8,
+        MASK = 0b1111 << POSITION
+      };
+    }  // namespace pmt
+
+    namespace pft {
+      enum {
+        POSITION = 12,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pft
+
+    namespace pv {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pv
+
+    namespace tspd {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+    }  // namespace tspd
+  }  // namespace rdes4
 }// namespace eth
@@ -35,6 +35,33 @@ namespace flash {
 struct Registers {
     __RW
     u32 ACR;  // 0x00: Access control
+    __RW
+    u32 KEYR;  // 0x04: Key
+    __RW
+    u32 OPTKEYR;  // 0x08: Option key
+    __RW
+    u32 SR;  // 0x0C: Status
+    __RW
+    u32 CR;  // 0x10: Control
+#ifdef STM32F1XX
+    __RW
+    u32 AR;  // 0x14: Address
+    u32 _RESERVED;
+    __RW
+    u32 OBR;  // 0x1C: Option byte
+    __RW
+    u32 WRPR;  // 0x20: Write protection
+#else // STM32F1XX
+    __RW
+    u32 OPTCR;  // 0x14: Option control
+#endif // STM32F1XX
+};
+
+enum {
+  KEY1 = 0x45670123,
+  KEY2 = 0xCDEF89AB,
+  OPTKEY1 = 0x08192A3B,
+  OPTKEY2 = 0x4C5D6E7F
 };
 
 #ifdef STM32F1XX
@@ -78,6 +105,132 @@ namespace acr {
   }  // namespace prftbe
 #endif
 }  // namespace acr
+
+namespace sr {
+  enum {
+    OFFSET = 0x0C
+  };
+  namespace bsy {
+    enum {
+      POSITION = 0,
+      MASK = 1 << POSITION
+    };
+  }  // namespace bsy
+
+  namespace pgerr {
+    enum {
+      POSITION = 2,
+      MASK = 1 << POSITION
+    };
+  }  // namespace pgerr
+
+  namespace wrprterr {
+    enum {
+      POSITION = 4,
+      MASK = 1 << POSITION
+    };
+  }  // namespace wrprterr
+
+  namespace eop {
+    enum {
+      POSITION = 5,
+      MASK = 1 << POSITION
+    };
+  }  // namespace eop
+
+  enum {
+    ERRORS = pgerr::MASK + wrprterr::MASK
+  };
+}  // namespace sr
+
+namespace cr {
+  enum {
+    OFFSET = 0x10
+  };
+  namespace pg {
+    enum {
+      POSITION = 0,
+      MASK = 1 << POSITION
+    };
+  }  // namespace pg
+
+  namespace per {
+    enum {
+      POSITION = 1,
+      MASK = 1 << POSITION
+    };
+  }  // namespace per
+
+  namespace mer {
+    enum {
+      POSITION = 2,
+      MASK = 1 << POSITION
+    };
+  }  // namespace mer
+
+  namespace optpg {
+    enum {
+      POSITION = 4,
+      MASK = 1 << POSITION
+    };
+  }  // namespace optpg
+
+  namespace opter {
+    enum {
+      POSITION = 5,
+      MASK = 1 << POSITION
+    };
+  }  // namespace opter
+
+  namespace strt {
+    enum {
+      POSITION = 6,
+      MASK = 1 << POSITION
+    };
+  }  // namespace strt
+
+  namespace lock {
+    enum {
+      POSITION = 7,
+      MASK = 1 << POSITION
+    };
+  }  // namespace lock
+
+  namespace optwre {
+    enum {
+      POSITION = 9,
+      MASK = 1 << POSITION
+    };
+  }  // namespace optwre
+
+  namespace errie {
+    enum {
+      POSITION = 10,
+      MASK = 1 << POSITION
+    };
+  }  // namespace errie
+
+  namespace eopie {
+    enum {
+      POSITION = 12,
+      MASK = 1 << POSITION
+    };
+  }  // namespace eopie
+}  // namespace cr
+
+namespace ar {
+  enum {
+    OFFSET = 0x14
+  };
+}  // namespace ar
+
+namespace ob {
+  enum {
+    // Option bytes, one per half-word, the upper byte is the complement
+    ADDRESS = 0x1FFFF800,
+    SIZE = 8
+  };
+}  // namespace ob
 #else /* STM32F2XX || STM32F4XX */
 namespace acr {
   enum {
@@ -132,6 +285,223 @@ namespace acr {
       DATA_CACHE_ENABLED = 1 << POSITION,
     };
   }  // namespace dcen
+
+  namespace icrst {
+    enum {
+      POSITION = 11,
+      MASK = 1 << POSITION
+    };
+    enum States {
+      INSTRUCTION_CACHE_NOT_RESET = 0 << POSITION,
+      INSTRUCTION_CACHE_RESET = 1 << POSITION,
+    };
+  }  // namespace icrst
+
+  namespace dcrst {
+    enum {
+      POSITION = 12,
+      MASK = 1 << POSITION
+    };
+    enum States {
+      DATA_CACHE_NOT_RESET = 0 << POSITION,
+      DATA_CACHE_RESET = 1 << POSITION,
+    };
+  }  // namespace dcrst
 }  // namespace acr
+
+namespace sr {
+  enum {
+    OFFSET = 0x0C
+  };
+  namespace eop {
+    enum {
+      POSITION = 0,
+      MASK = 1 << POSITION
+    };
+  }  // namespace eop
+
+  namespace operr {
+    enum {
+      POSITION = 1,
+      MASK = 1 << POSITION
+    };
+  }  // namespace operr
+
+  namespace wrperr {
+    enum {
+      POSITION = 4,
+      MASK = 1 << POSITION
+    };
+  }  // namespace wrperr
+
+  namespace pgaerr {
+    enum {
+      POSITION = 5,
+      MASK = 1 << POSITION
+    };
+  }  // namespace pgaerr
+
+  namespace pgperr {
+    enum {
+      POSITION = 6,
+      MASK = 1 << POSITION
+    };
+  }  // namespace pgperr
+
+  namespace pgserr {
+    enum {
+      POSITION = 7,
+      MASK = 1 << POSITION
+    };
+  }  // namespace pgserr
+
+  namespace bsy {
+    enum {
+      POSITION = 16,
+      MASK = 1 << POSITION
+    };
+  }  // namespace bsy
+
+  enum {
+    ERRORS = operr::MASK + wrperr::MASK + pgaerr::MASK + pgperr::MASK +
+        pgserr::MASK
+  };
+}  // namespace sr
+
+namespace cr {
+  enum {
+    OFFSET = 0x10
+  };
+  namespace pg {
+    enum {
+      POSITION = 0,
+      MASK = 1 << POSITION
+    };
+  }  // namespace pg
+
+  namespace ser {
+    enum {
+      POSITION = 1,
+      MASK = 1 << POSITION
+    };
+  }  // namespace ser
+
+  namespace mer {
+    enum {
+      POSITION = 2,
+      MASK = 1 << POSITION
+    };
+  }  // namespace mer
+
+  namespace snb {
+    enum {
+      POSITION = 3,
+      MASK = 0b11111 << POSITION
+    };
+  }  // namespace snb
+
+  namespace psize {
+    enum {
+      POSITION = 8,
+      MASK = 0b11 << POSITION
+    };
+    // Program/erase parallelism, bounded by the supply voltage
+    enum States {
+      X8 = 0b00 << POSITION,  // 1.8 V - 2.1 V
+      X16 = 0b01 << POSITION,  // 2.1 V - 2.7 V
+      X32 = 0b10 << POSITION,  // 2.7 V - 3.6 V
+      X64 = 0b11 << POSITION  // 2.7 V - 3.6 V, with VPP
+    };
+  }  // namespace psize
+
+  namespace strt {
+    enum {
+      POSITION = 16,
+      MASK = 1 << POSITION
+    };
+  }  // namespace strt
+
+  namespace eopie {
+    enum {
+      POSITION = 24,
+      MASK = 1 << POSITION
+    };
+  }  // namespace eopie
+
+  namespace errie {
+    enum {
+      POSITION = 25,
+      MASK = 1 << POSITION
+    };
+  }  // namespace errie
+
+  namespace lock {
+    enum {
+      POSITION = 31,
+      MASK = 1u << POSITION
+    };
+  }  // namespace lock
+}  // namespace cr
+
+namespace optcr {
+  enum {
+    OFFSET = 0x14
+  };
+  namespace optlock {
+    enum {
+      POSITION = 0,
+      MASK = 1 << POSITION
+    };
+  }  // namespace optlock
+
+  namespace optstrt {
+    enum {
+      POSITION = 1,
+      MASK = 1 << POSITION
+    };
+  }  // namespace optstrt
+
+  namespace bor_lev {
+    enum {
+      POSITION = 2,
+      MASK = 0b11 << POSITION
+    };
+  }  // namespace bor_lev
+
+#ifdef STM32F4XX
+  namespace bfb2 {
+    enum {
+      POSITION = 4,  // STM32F42x/STM32F43x only
+      MASK = 1 << POSITION
+    };
+  }  // namespace bfb2
+#endif // STM32F4XX
+
+  namespace user {
+    enum {
+      POSITION = 5,
+      MASK = 0b111 << POSITION
+    };
+  }  // namespace user
+
+  namespace rdp {
+    enum {
+      POSITION = 8,
+      MASK = 0xFF << POSITION
+    };
+    enum States {
+      LEVEL_0 = 0xAA << POSITION,
+      LEVEL_1 = 0x55 << POSITION,  // Any value but 0xAA and 0xCC
+      LEVEL_2 = 0xCC << POSITION  // Irreversible
+    };
+  }  // namespace rdp
+
+  namespace nwrp {
+    enum {
+      POSITION = 16,
+      MASK = 0xFFF << POSITION
+    };
+  }  // namespace nwrp
+}  // namespace optcr
 #endif /* STM32F1XX */
 }  // namespace flash
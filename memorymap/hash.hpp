@@ -50,6 +50,89 @@ namespace hash {
     enum {
       OFFSET = 0x00
     };
+    namespace init {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace init
+
+    namespace dmae {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        DMA_TRANSFERS_DISABLED = 0 << POSITION,
+        DMA_TRANSFERS_ENABLED = 1 << POSITION
+      };
+    }  // namespace dmae
+
+    namespace datatype {
+      enum {
+        POSITION = 4,
+        MASK = 0b11 << POSITION
+      };
+      enum States {
+        _32_BIT_DATA = 0b00 << POSITION,
+        _16_BIT_DATA = 0b01 << POSITION,
+        _8_BIT_DATA = 0b10 << POSITION,
+        BIT_STRING = 0b11 << POSITION
+      };
+    }  // namespace datatype
+
+    namespace mode {
+      enum {
+        POSITION = 6,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        HASH_MODE = 0 << POSITION,
+        HMAC_MODE = 1 << POSITION
+      };
+    }  // namespace mode
+
+    namespace algo {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        SHA1 = 0 << POSITION,
+        MD5 = 1 << POSITION
+      };
+    }  // namespace algo
+
+    namespace dinne {
+      enum {
+        POSITION = 12,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dinne
+#ifdef STM32F4XX
+
+    namespace mdmat {
+      enum {
+        POSITION = 13,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        DCAL_AT_THE_END_OF_THE_DMA_TRANSFER = 0 << POSITION,
+        NO_DCAL_AT_THE_END_OF_THE_DMA_TRANSFER = 1 << POSITION
+      };
+    }  // namespace mdmat
+#endif // STM32F4XX
+
+    namespace lkey {
+      enum {
+        POSITION = 16,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        SHORT_KEY = 0 << POSITION,
+        LONG_KEY = 1 << POSITION
+      };
+    }  // namespace lkey
   }  // namespace cr
 
   namespace din {
@@ -62,11 +145,84 @@ namespace hash {
     enum {
       OFFSET = 0x08
     };
+    namespace nblw {
+      enum {
+        POSITION = 0,
+        MASK = 0x1F << POSITION
+      };
+    }  // namespace nblw
+
+    namespace dcal {
+      enum {
+        POSITION = 8,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dcal
   }  // namespace str
 
+  namespace hr {
+    enum {
+      OFFSET = 0x0C
+    };
+  }  // namespace hr
+
   namespace imr {
     enum {
       OFFSET = 0x20
     };
+    namespace dinie {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dinie
+
+    namespace dcie {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dcie
   }  // namespace imr
+
+  namespace sr {
+    enum {
+      OFFSET = 0x24
+    };
+    namespace dinis {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dinis
+
+    namespace dcis {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dcis
+
+    namespace dmas {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace dmas
+
+    namespace busy {
+      enum {
+        POSITION = 3,
+        MASK = 1 << POSITION
+      };
+    }  // namespace busy
+  }  // namespace sr
+
+  namespace csr {
+    enum {
+      OFFSET = 0xF8,
+      // Context swap registers of the SHA-1/MD5 processor
+      SIZE = 51
+    };
+  }  // namespace csr
 }  // namespace hash
@@ -45,29 +45,176 @@ namespace mpu {
     enum {
       OFFSET = 0x00
     };
+    namespace dregion {
+      enum {
+        POSITION = 8,
+        MASK = 0xFF << POSITION
+      };
+    }  // namespace dregion
   }  // namespace typer
 
   namespace control {
+    enum {
+      OFFSET = 0x04
+    };
+    namespace enable {
+      enum {
+        POSITION = 0
+      };
+      enum States {
+        MPU_DISABLED = 0 << POSITION,
+        MPU_ENABLED = 1 << POSITION
+      };
+    }  // namespace enable
+
+    namespace hfnmiena {
       enum {
-        OFFSET = 0x04
+        POSITION = 1
+      };
+      enum States {
+        MPU_DISABLED_DURING_FAULTS = 0 << POSITION,
+        MPU_ENABLED_DURING_FAULTS = 1 << POSITION
       };
-    }  // namespace control
+    }  // namespace hfnmiena
+
+    namespace privdefena {
+      enum {
+        POSITION = 2
+      };
+      enum States {
+        DEFAULT_MAP_DISABLED = 0 << POSITION,
+        DEFAULT_MAP_ENABLED_FOR_PRIVILEGED = 1 << POSITION
+      };
+    }  // namespace privdefena
+  }  // namespace control
 
   namespace rnr {
+    enum {
+      OFFSET = 0x08
+    };
+    namespace region {
       enum {
-        OFFSET = 0x08
+        POSITION = 0,
+        MASK = 0xFF << POSITION
       };
-    }  // namespace rnr
+    }  // namespace region
+  }  // namespace rnr
 
   namespace rbar {
+    enum {
+      OFFSET = 0x0C
+    };
+    namespace region {
+      enum {
+        POSITION = 0,
+        MASK = 0xF << POSITION
+      };
+    }  // namespace region
+
+    namespace valid {
+      enum {
+        POSITION = 4
+      };
+      enum States {
+        USE_RNR = 0 << POSITION,
+        USE_REGION_FIELD = 1 << POSITION
+      };
+    }  // namespace valid
+
+    namespace addr {
       enum {
-        OFFSET = 0x0C
+        POSITION = 5,
+        MASK = 0x7FFFFFFu << POSITION
       };
-    }  // namespace rbar
+    }  // namespace addr
+  }  // namespace rbar
 
   namespace rasr {
+    enum {
+      OFFSET = 0x10
+    };
+    namespace enable {
+      enum {
+        POSITION = 0
+      };
+      enum States {
+        REGION_DISABLED = 0 << POSITION,
+        REGION_ENABLED = 1 << POSITION
+      };
+    }  // namespace enable
+
+    namespace size {
+      enum {
+        POSITION = 1,
+        MASK = 0x1F << POSITION
+      };
+      // Region size = 2^(SIZE + 1) bytes
+      enum States {
+        _32B = 4 << POSITION,
+        _64B = 5 << POSITION,
+        _128B = 6 << POSITION,
+        _256B = 7 << POSITION,
+        _512B = 8 << POSITION,
+        _1KB = 9 << POSITION,
+        _2KB = 10 << POSITION,
+        _4KB = 11 << POSITION,
+        _8KB = 12 << POSITION,
+        _16KB = 13 << POSITION,
+        _32KB = 14 << POSITION,
+        _64KB = 15 << POSITION,
+        _128KB = 16 << POSITION,
+        _256KB = 17 << POSITION,
+        _512KB = 18 << POSITION,
+        _1MB = 19 << POSITION,
+        _4GB = 31 << POSITION
+      };
+    }  // namespace size
+
+    namespace srd {
       enum {
-        OFFSET = 0x10
+        POSITION = 8,
+        MASK = 0xFF << POSITION
+      };
+    }  // namespace srd
+
+    namespace attributes {
+      enum {
+        POSITION = 16,
+        MASK = 0x3F << POSITION
+      };
+      // TEX, C, B and S bits
+      enum States {
+        STRONGLY_ORDERED = 0b000000 << POSITION,
+        DEVICE = 0b000101 << POSITION,
+        NORMAL_WT = 0b000110 << POSITION,
+        NORMAL_WB = 0b000111 << POSITION,
+        NORMAL_NON_CACHEABLE = 0b001000 << POSITION
+      };
+    }  // namespace attributes
+
+    namespace ap {
+      enum {
+        POSITION = 24,
+        MASK = 0x7 << POSITION
+      };
+      enum States {
+        NO_ACCESS = 0b000 << POSITION,
+        PRIVILEGED_READ_WRITE = 0b001 << POSITION,
+        UNPRIVILEGED_READ_ONLY = 0b010 << POSITION,
+        FULL_ACCESS = 0b011 << POSITION,
+        PRIVILEGED_READ_ONLY = 0b101 << POSITION,
+        READ_ONLY = 0b110 << POSITION
+      };
+    }  // namespace ap
+
+    namespace xn {
+      enum {
+        POSITION = 28
+      };
+      enum States {
+        EXECUTION_ALLOWED = 0 << POSITION,
+        EXECUTE_NEVER = 1 << POSITION
       };
-    }  // namespace rasr
+    }  // namespace xn
+  }  // namespace rasr
 }  // namespace mpu
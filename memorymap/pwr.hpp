@@ -135,10 +135,23 @@ namespace pwr {
       };
     }  // namespace fpds
 #endif // !STM32F1XX
+#ifdef STM32F4XX
+
+    namespace vos {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        SCALE_2_MODE = 0 << POSITION,
+        SCALE_1_MODE = 1 << POSITION
+      };
+    }  // namespace vos
+#endif // STM32F4XX
   }  // namespace cr
   namespace csr {
     enum {
-      OFFSET = 0x00
+      OFFSET = 0x04
     };
     namespace wuf {
       enum {
@@ -206,5 +219,18 @@ namespace pwr {
       };
     }  // namespace bre
 #endif // !STM32F1XX
+#ifdef STM32F4XX
+
+    namespace vosrdy {
+      enum {
+        POSITION = 14,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        REGULATOR_VOLTAGE_SCALING_NOT_READY = 0 << POSITION,
+        REGULATOR_VOLTAGE_SCALING_READY = 1 << POSITION
+      };
+    }  // namespace vosrdy
+#endif // STM32F4XX
   }  // namespace cr
 }  // namespace pwr
@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "common.hpp"
+
 namespace scb {
   enum {
     ADDRESS = alias::PPB + 0xD00
@@ -59,6 +61,210 @@ namespace scb {
       u32 AFSR;  // 0x38: Auxiliary fault status
   };
 
+  namespace icsr {
+    enum {
+      OFFSET = 0x04
+    };
+    namespace pendstclr {
+      enum {
+        POSITION = 25,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pendstclr
+
+    namespace pendstset {
+      enum {
+        POSITION = 26,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pendstset
+
+    namespace pendsvclr {
+      enum {
+        POSITION = 27,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pendsvclr
+
+    namespace pendsvset {
+      enum {
+        POSITION = 28,
+        MASK = 1 << POSITION
+      };
+    }  // namespace pendsvset
+  }  // namespace icsr
+
+  namespace vtor {
+    enum {
+      OFFSET = 0x08
+    };
+    namespace tbloff {
+      enum {
+        POSITION = 7,
+        MASK = 0x7FFFFF << POSITION
+      };
+    }  // namespace tbloff
+  }  // namespace vtor
+
+  namespace aircr {
+    enum {
+      OFFSET = 0x0C
+    };
+    namespace vectkey {
+      enum {
+        POSITION = 16,
+        MASK = 0xFFFF << POSITION
+      };
+      enum States {
+        KEY = 0x05FA << POSITION
+      };
+    }  // namespace vectkey
+
+    namespace sysresetreq {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+    }  // namespace sysresetreq
+
+    namespace prigroup {
+      enum {
+        POSITION = 8,
+        MASK = 0b111 << POSITION
+      };
+      enum States {
+        FOUR_BITS_OF_PREEMPTION_PRIORITY = 3 << POSITION,
+        THREE_BITS_OF_PREEMPTION_PRIORITY = 4 << POSITION,
+        TWO_BITS_OF_PREEMPTION_PRIORITY = 5 << POSITION,
+        ONE_BIT_OF_PREEMPTION_PRIORITY = 6 << POSITION,
+        NO_PREEMPTION_PRIORITY = 7 << POSITION
+      };
+    }  // namespace prigroup
+  }  // namespace aircr
+
+  namespace scr {
+    enum {
+      OFFSET = 0x10
+    };
+    namespace sleepdeep {
+      enum {
+        POSITION = 2,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        SLEEP = 0 << POSITION,
+        DEEP_SLEEP = 1 << POSITION
+      };
+    }  // namespace sleepdeep
+  }  // namespace scr
+
+  namespace shpr3 {
+    enum {
+      OFFSET = 0x20
+    };
+    namespace pri_14 {  // PendSV
+      enum {
+        POSITION = 16,
+        MASK = 0xFF << POSITION
+      };
+    }  // namespace pri_14
+
+    namespace pri_15 {  // SysTick
+      enum {
+        POSITION = 24,
+        MASK = 0xFFu << POSITION
+      };
+    }  // namespace pri_15
+  }  // namespace shpr3
+
+  namespace shcsr {
+    enum {
+      OFFSET = 0x24
+    };
+    namespace memfaultena {
+      enum {
+        POSITION = 16
+      };
+    }  // namespace memfaultena
+
+    namespace busfaultena {
+      enum {
+        POSITION = 17
+      };
+    }  // namespace busfaultena
+
+    namespace usgfaultena {
+      enum {
+        POSITION = 18
+      };
+    }  // namespace usgfaultena
+  }  // namespace shcsr
+
+  namespace cfsr {
+    enum {
+      OFFSET = 0x28
+    };
+    namespace iaccviol {
+      enum {
+        POSITION = 0,
+        MASK = 1 << POSITION
+      };
+    }  // namespace iaccviol
+
+    namespace daccviol {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+    }  // namespace daccviol
+
+    namespace mstkerr {
+      enum {
+        POSITION = 4,
+        MASK = 1 << POSITION
+      };
+    }  // namespace mstkerr
+
+    namespace mmarvalid {
+      enum {
+        POSITION = 7,
+        MASK = 1 << POSITION
+      };
+    }  // namespace mmarvalid
+
+    namespace mmfsr {
+      enum {
+        POSITION = 0,
+        MASK = 0xFF << POSITION
+      };
+    }  // namespace mmfsr
+
+    namespace stkerr {
+      enum {
+        POSITION = 12,
+        MASK = 1 << POSITION
+      };
+    }  // namespace stkerr
+  }  // namespace cfsr
+
+  namespace hfsr {
+    enum {
+      OFFSET = 0x2C
+    };
+  }  // namespace hfsr
+
+  namespace mmar {
+    enum {
+      OFFSET = 0x30
+    };
+  }  // namespace mmar
+
+  namespace bfar {
+    enum {
+      OFFSET = 0x34
+    };
+  }  // namespace bfar
+
 // TODO SCB register bits
 }// namespace scb
 
@@ -44,14 +44,48 @@ namespace syscfg {
     enum {
       OFFSET = 0x00
     };
-  // TODO SYSCFG MEMRMP bits
+    namespace mem_mode {
+      enum {
+        POSITION = 0,
+        MASK = 0b11 << POSITION
+      };
+      enum States {
+        MAIN_FLASH = 0b00 << POSITION,
+        SYSTEM_FLASH = 0b01 << POSITION,
+        FSMC_BANK1 = 0b10 << POSITION,
+        EMBEDDED_SRAM = 0b11 << POSITION
+      };
+    }  // namespace mem_mode
+#ifdef STM32F4XX
+
+    // Dual bank devices only (F42x/F43x)
+    namespace ufb_mode {
+      enum {
+        POSITION = 8,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        BANK1_AT_0x08000000 = 0 << POSITION,
+        BANK2_AT_0x08000000 = 1 << POSITION
+      };
+    }  // namespace ufb_mode
+#endif // STM32F4XX
   }// namespace memrmp
 
   namespace pmc {
     enum {
       OFFSET = 0x04
     };
-  // TODO SYSCFG PMC bits
+    namespace mii_rmii_sel {
+      enum {
+        POSITION = 23,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        MII = 0 << POSITION,
+        RMII = 1 << POSITION
+      };
+    }  // namespace mii_rmii_sel
   }// namespace pmc
 
   namespace exticr1 {
@@ -207,6 +207,17 @@ namespace tim {
       };
     }  // namespace uie
 
+    namespace cc1ie {
+      enum {
+        POSITION = 1,
+        MASK = 1 << POSITION
+      };
+      enum States {
+        INTERRUPT_DISABLED = 0 << POSITION,
+        INTERUPT_ENABLED = 1 << POSITION,
+      };
+    }  // namespace cc1ie
+
     namespace ude {
       enum {
         POSITION = 8,
@@ -238,6 +249,21 @@ namespace tim {
         };
       }  // namespace states
     }  // namespace uif
+
+    namespace cc1if {
+      enum {
+        POSITION = 1
+      };
+      enum {
+        MASK = 1 << POSITION
+      };
+      namespace states {
+        enum E {
+          NO_MATCH = 0 << POSITION,
+          CAPTURE_COMPARE_INTERRUPT_PENDING = 1 << POSITION,
+        };
+      }  // namespace states
+    }  // namespace cc1if
   }  // namespace sr
 
   namespace egr {
@@ -256,6 +282,19 @@ namespace tim {
         GENERATE_AN_UPDATE = 1 << POSITION,
       };
     }  // namespace ug
+
+    namespace cc1g {
+      enum {
+        POSITION = 1
+      };
+      enum {
+        MASK = 1 << POSITION
+      };
+      enum States {
+        NO_ACTION = 0 << POSITION,
+        GENERATE_A_CAPTURE_COMPARE_EVENT = 1 << POSITION,
+      };
+    }  // namespace cc1g
   }  // namespace egr
 
   namespace iccmr1 {
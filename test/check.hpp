@@ -0,0 +1,58 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *
+ *                          Host unit test helpers
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+
+namespace check {
+  static unsigned failures = 0;
+
+  /**
+   * @brief Returns the exit status of the test program.
+   */
+  inline int report(char const* name)
+  {
+    if (failures != 0) {
+      std::printf("%s: %u check(s) failed\n", name, failures);
+      return 1;
+    }
+
+    std::printf("%s: ok\n", name);
+    return 0;
+  }
+}  // namespace check
+
+#define CHECK(CONDITION)                                                      \
+  do {                                                                        \
+    if (!(CONDITION)) {                                                       \
+      std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,           \
+                  #CONDITION);                                                \
+      check::failures++;                                                      \
+    }                                                                         \
+  } while (0)
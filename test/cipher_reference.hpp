@@ -0,0 +1,423 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *             Software AES and DES block ciphers, host reference
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "defs.hpp"
+
+/**
+ * Straightforward implementations of FIPS 197 and FIPS 46-3, slow but easy
+ * to check. The tables that can be derived are computed instead of typed.
+ */
+namespace reference {
+  class Aes {
+    public:
+      enum {
+        BLOCK_SIZE = 16
+      };
+
+      /**
+       * @brief Expands the 16, 24 or 32 bytes <key>.
+       */
+      void setKey(u8 const* const key, u8 const size)
+      {
+        u8 const words = size / 4;
+        u8 rcon = 1;
+
+        rounds = words + 6;
+
+        for (u8 i = 0; i < size; i++) {
+          schedule[i] = key[i];
+        }
+
+        for (u8 i = words; i < 4 * (rounds + 1); i++) {
+          u8 word[4];
+
+          for (u8 j = 0; j < 4; j++) {
+            word[j] = schedule[4 * (i - 1) + j];
+          }
+
+          if (i % words == 0) {
+            u8 const first = word[0];
+
+            word[0] = getSbox(word[1]) ^ rcon;
+            word[1] = getSbox(word[2]);
+            word[2] = getSbox(word[3]);
+            word[3] = getSbox(first);
+            rcon = multiply(rcon, 2);
+          } else if ((words > 6) && (i % words == 4)) {
+            for (u8 j = 0; j < 4; j++) {
+              word[j] = getSbox(word[j]);
+            }
+          }
+
+          for (u8 j = 0; j < 4; j++) {
+            schedule[4 * i + j] = schedule[4 * (i - words) + j] ^ word[j];
+          }
+        }
+      }
+
+      void encrypt(u8 const* const input, u8* const output) const
+      {
+        u8 state[BLOCK_SIZE];
+
+        addRoundKey(input, state, 0);
+
+        for (u8 round = 1; round <= rounds; round++) {
+          u8 shifted[BLOCK_SIZE];
+
+          for (u8 i = 0; i < BLOCK_SIZE; i++) {
+            // Row i % 4 rotates left by its number
+            shifted[i] = getSbox(state[(i + 4 * (i % 4)) % BLOCK_SIZE]);
+          }
+
+          if (round != rounds) {
+            mixColumns(shifted, 2, 3, 1, 1);
+          }
+
+          addRoundKey(shifted, state, round);
+        }
+
+        for (u8 i = 0; i < BLOCK_SIZE; i++) {
+          output[i] = state[i];
+        }
+      }
+
+      void decrypt(u8 const* const input, u8* const output) const
+      {
+        u8 state[BLOCK_SIZE];
+
+        addRoundKey(input, state, rounds);
+
+        for (u8 round = rounds; round > 0; round--) {
+          u8 shifted[BLOCK_SIZE];
+
+          for (u8 i = 0; i < BLOCK_SIZE; i++) {
+            shifted[(i + 4 * (i % 4)) % BLOCK_SIZE] = getInverseSbox(state[i]);
+          }
+
+          addRoundKey(shifted, state, round - 1);
+
+          if (round != 1) {
+            mixColumns(state, 14, 11, 13, 9);
+          }
+        }
+
+        for (u8 i = 0; i < BLOCK_SIZE; i++) {
+          output[i] = state[i];
+        }
+      }
+
+    private:
+      u8 schedule[240];
+      u8 rounds;
+
+      static u8 multiply(u8 a, u8 b)
+      {
+        u8 product = 0;
+
+        while (b != 0) {
+          if (b & 1) {
+            product ^= a;
+          }
+
+          a = (a << 1) ^ (a & 0x80 ? 0x1B : 0);
+          b >>= 1;
+        }
+
+        return product;
+      }
+
+      static u8 getSbox(u8 const x)
+      {
+        u8 inverse = 0;
+        u8 s;
+
+        for (u16 y = 1; (x != 0) && (y < 256); y++) {
+          if (multiply(x, y) == 1) {
+            inverse = y;
+          }
+        }
+
+        s = inverse;
+
+        for (u8 i = 1; i < 5; i++) {
+          s ^= (inverse << i) | (inverse >> (8 - i));
+        }
+
+        return s ^ 0x63;
+      }
+
+      static u8 getInverseSbox(u8 const y)
+      {
+        u16 x = 0;
+
+        while (getSbox(x) != y) {
+          x++;
+        }
+
+        return x;
+      }
+
+      /**
+       * @brief Multiplies each column by the circulant matrix (a, b, c, d).
+       */
+      static void mixColumns(u8* const state, u8 a, u8 b, u8 c, u8 d)
+      {
+        for (u8 column = 0; column < 4; column++) {
+          u8* const s = state + 4 * column;
+          u8 const x[4] = { s[0], s[1], s[2], s[3] };
+
+          for (u8 row = 0; row < 4; row++) {
+            s[row] = multiply(x[row], a) ^ multiply(x[(row + 1) % 4], b) ^
+                multiply(x[(row + 2) % 4], c) ^ multiply(x[(row + 3) % 4], d);
+          }
+        }
+      }
+
+      void addRoundKey(u8 const* const in, u8* const out, u8 const round) const
+      {
+        for (u8 i = 0; i < BLOCK_SIZE; i++) {
+          out[i] = in[i] ^ schedule[BLOCK_SIZE * round + i];
+        }
+      }
+  };
+
+  class Des {
+    public:
+      enum {
+        BLOCK_SIZE = 8
+      };
+
+      /**
+       * @brief Computes the 16 round keys of the 8 bytes <key>, the parity
+       *        bits are ignored.
+       */
+      void setKey(u8 const* const key)
+      {
+        static u8 const PC1[] = {
+            57, 49, 41, 33, 25, 17, 9, 1, 58, 50, 42, 34, 26, 18,
+            10, 2, 59, 51, 43, 35, 27, 19, 11, 3, 60, 52, 44, 36,
+            63, 55, 47, 39, 31, 23, 15, 7, 62, 54, 46, 38, 30, 22,
+            14, 6, 61, 53, 45, 37, 29, 21, 13, 5, 28, 20, 12, 4
+        };
+        static u8 const PC2[] = {
+            14, 17, 11, 24, 1, 5, 3, 28, 15, 6, 21, 10,
+            23, 19, 12, 4, 26, 8, 16, 7, 27, 20, 13, 2,
+            41, 52, 31, 37, 47, 55, 30, 40, 51, 45, 33, 48,
+            44, 49, 39, 56, 34, 53, 46, 42, 50, 36, 29, 32
+        };
+        static u8 const SHIFTS[] = {
+            1, 1, 2, 2, 2, 2, 2, 2, 1, 2, 2, 2, 2, 2, 2, 1
+        };
+        u64 const cd = permute(load(key), 64, PC1, sizeof(PC1));
+        u32 c = cd >> 28;
+        u32 d = cd & 0xFFFFFFF;
+
+        for (u8 round = 0; round < 16; round++) {
+          for (u8 i = 0; i < SHIFTS[round]; i++) {
+            c = ((c << 1) | (c >> 27)) & 0xFFFFFFF;
+            d = ((d << 1) | (d >> 27)) & 0xFFFFFFF;
+          }
+
+          keys[round] = permute((u64(c) << 28) | d, 56, PC2, sizeof(PC2));
+        }
+      }
+
+      void encrypt(u8 const* const input, u8* const output) const
+      {
+        crypt(input, output, false);
+      }
+
+      void decrypt(u8 const* const input, u8* const output) const
+      {
+        crypt(input, output, true);
+      }
+
+    private:
+      u64 keys[16];
+
+      static u64 load(u8 const* const bytes)
+      {
+        u64 value = 0;
+
+        for (u8 i = 0; i < 8; i++) {
+          value = (value << 8) | bytes[i];
+        }
+
+        return value;
+      }
+
+      /**
+       * @brief Bit i of the result is the bit table[i] of <input>, the bits
+       *        being numbered from 1, most significant first.
+       */
+      static u64 permute(
+          u64 const input,
+          u8 const bits,
+          u8 const* const table,
+          u8 const size)
+      {
+        u64 output = 0;
+
+        for (u8 i = 0; i < size; i++) {
+          output = (output << 1) | ((input >> (bits - table[i])) & 1);
+        }
+
+        return output;
+      }
+
+      static u32 f(u32 const r, u64 const key)
+      {
+        static u8 const S[8][64] = {
+            { 14, 4, 13, 1, 2, 15, 11, 8, 3, 10, 6, 12, 5, 9, 0, 7,
+              0, 15, 7, 4, 14, 2, 13, 1, 10, 6, 12, 11, 9, 5, 3, 8,
+              4, 1, 14, 8, 13, 6, 2, 11, 15, 12, 9, 7, 3, 10, 5, 0,
+              15, 12, 8, 2, 4, 9, 1, 7, 5, 11, 3, 14, 10, 0, 6, 13 },
+            { 15, 1, 8, 14, 6, 11, 3, 4, 9, 7, 2, 13, 12, 0, 5, 10,
+              3, 13, 4, 7, 15, 2, 8, 14, 12, 0, 1, 10, 6, 9, 11, 5,
+              0, 14, 7, 11, 10, 4, 13, 1, 5, 8, 12, 6, 9, 3, 2, 15,
+              13, 8, 10, 1, 3, 15, 4, 2, 11, 6, 7, 12, 0, 5, 14, 9 },
+            { 10, 0, 9, 14, 6, 3, 15, 5, 1, 13, 12, 7, 11, 4, 2, 8,
+              13, 7, 0, 9, 3, 4, 6, 10, 2, 8, 5, 14, 12, 11, 15, 1,
+              13, 6, 4, 9, 8, 15, 3, 0, 11, 1, 2, 12, 5, 10, 14, 7,
+              1, 10, 13, 0, 6, 9, 8, 7, 4, 15, 14, 3, 11, 5, 2, 12 },
+            { 7, 13, 14, 3, 0, 6, 9, 10, 1, 2, 8, 5, 11, 12, 4, 15,
+              13, 8, 11, 5, 6, 15, 0, 3, 4, 7, 2, 12, 1, 10, 14, 9,
+              10, 6, 9, 0, 12, 11, 7, 13, 15, 1, 3, 14, 5, 2, 8, 4,
+              3, 15, 0, 6, 10, 1, 13, 8, 9, 4, 5, 11, 12, 7, 2, 14 },
+            { 2, 12, 4, 1, 7, 10, 11, 6, 8, 5, 3, 15, 13, 0, 14, 9,
+              14, 11, 2, 12, 4, 7, 13, 1, 5, 0, 15, 10, 3, 9, 8, 6,
+              4, 2, 1, 11, 10, 13, 7, 8, 15, 9, 12, 5, 6, 3, 0, 14,
+              11, 8, 12, 7, 1, 14, 2, 13, 6, 15, 0, 9, 10, 4, 5, 3 },
+            { 12, 1, 10, 15, 9, 2, 6, 8, 0, 13, 3, 4, 14, 7, 5, 11,
+              10, 15, 4, 2, 7, 12, 9, 5, 6, 1, 13, 14, 0, 11, 3, 8,
+              9, 14, 15, 5, 2, 8, 12, 3, 7, 0, 4, 10, 1, 13, 11, 6,
+              4, 3, 2, 12, 9, 5, 15, 10, 11, 14, 1, 7, 6, 0, 8, 13 },
+            { 4, 11, 2, 14, 15, 0, 8, 13, 3, 12, 9, 7, 5, 10, 6, 1,
+              13, 0, 11, 7, 4, 9, 1, 10, 14, 3, 5, 12, 2, 15, 8, 6,
+              1, 4, 11, 13, 12, 3, 7, 14, 10, 15, 6, 8, 0, 5, 9, 2,
+              6, 11, 13, 8, 1, 4, 10, 7, 9, 5, 0, 15, 14, 2, 3, 12 },
+            { 13, 2, 8, 4, 6, 15, 11, 1, 10, 9, 3, 14, 5, 0, 12, 7,
+              1, 15, 13, 8, 10, 3, 7, 4, 12, 5, 6, 11, 0, 14, 9, 2,
+              7, 11, 4, 1, 9, 12, 14, 2, 0, 6, 10, 13, 15, 3, 5, 8,
+              2, 1, 14, 7, 4, 10, 8, 13, 15, 12, 9, 0, 3, 5, 6, 11 }
+        };
+        static u8 const P[] = {
+            16, 7, 20, 21, 29, 12, 28, 17, 1, 15, 23, 26, 5, 18, 31, 10,
+            2, 8, 24, 14, 32, 27, 3, 9, 19, 13, 30, 6, 22, 11, 4, 25
+        };
+        u8 E[48];
+        u64 expanded;
+        u32 output = 0;
+
+        // Each group of 4 bits with its 2 neighbours
+        for (u8 i = 0; i < sizeof(E); i++) {
+          E[i] = (i / 6 * 4 + i % 6 + 31) % 32 + 1;
+        }
+
+        expanded = permute(r, 32, E, sizeof(E)) ^ key;
+
+        for (u8 i = 0; i < 8; i++) {
+          u8 const bits = (expanded >> (42 - 6 * i)) & 0x3F;
+          u8 const row = ((bits >> 4) & 2) | (bits & 1);
+
+          output = (output << 4) | S[i][16 * row + ((bits >> 1) & 0xF)];
+        }
+
+        return permute(output, 32, P, sizeof(P));
+      }
+
+      void crypt(u8 const* const input, u8* const output, bool inverse) const
+      {
+        static u8 const IP[] = {
+            58, 50, 42, 34, 26, 18, 10, 2, 60, 52, 44, 36, 28, 20, 12, 4,
+            62, 54, 46, 38, 30, 22, 14, 6, 64, 56, 48, 40, 32, 24, 16, 8,
+            57, 49, 41, 33, 25, 17, 9, 1, 59, 51, 43, 35, 27, 19, 11, 3,
+            61, 53, 45, 37, 29, 21, 13, 5, 63, 55, 47, 39, 31, 23, 15, 7
+        };
+        u8 FP[sizeof(IP)];
+        u64 const block = permute(load(input), 64, IP, sizeof(IP));
+        u32 l = block >> 32;
+        u32 r = block;
+        u64 result;
+
+        for (u8 i = 0; i < sizeof(IP); i++) {
+          FP[IP[i] - 1] = i + 1;
+        }
+
+        for (u8 round = 0; round < 16; round++) {
+          u32 const next = l ^ f(r, keys[inverse ? 15 - round : round]);
+
+          l = r;
+          r = next;
+        }
+
+        result = permute((u64(r) << 32) | l, 64, FP, sizeof(FP));
+
+        for (u8 i = 0; i < 8; i++) {
+          output[i] = result >> (56 - 8 * i);
+        }
+      }
+  };
+
+  /**
+   * Keying option 1 of SP 800-67: E(K3, D(K2, E(K1, x))).
+   */
+  class TripleDes {
+    public:
+      enum {
+        BLOCK_SIZE = 8
+      };
+
+      void setKey(u8 const* const key)
+      {
+        for (u8 i = 0; i < 3; i++) {
+          des[i].setKey(key + 8 * i);
+        }
+      }
+
+      void encrypt(u8 const* const input, u8* const output) const
+      {
+        des[0].encrypt(input, output);
+        des[1].decrypt(output, output);
+        des[2].encrypt(output, output);
+      }
+
+      void decrypt(u8 const* const input, u8* const output) const
+      {
+        des[2].decrypt(input, output);
+        des[1].encrypt(output, output);
+        des[0].decrypt(output, output);
+      }
+
+    private:
+      Des des[3];
+  };
+}  // namespace reference
@@ -0,0 +1,707 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *        CRYP driver on a model of the peripheral, known answer tests
+ *
+ ******************************************************************************/
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+#include "cipher_reference.hpp"
+
+#include "../memorymap/cryp.hpp"
+
+/**
+ * Behaves like the CRYP peripheral as seen through its registers: the FIFOs,
+ * the data type swapping, the key and IV register layout, the AES key
+ * preparation and the update of the IV registers with the chaining state.
+ * The blocks are processed as soon as they are complete, it's never busy.
+ */
+class CrypModel {
+  public:
+    struct Control {
+        u32 value;
+
+        operator u32() const
+        {
+          return value;
+        }
+
+        Control& operator=(u32 const cr)
+        {
+          CrypModel::write(cr);
+          return *this;
+        }
+
+        Control& operator|=(u32 const mask)
+        {
+          CrypModel::write(value | mask);
+          return *this;
+        }
+
+        Control& operator&=(u32 const mask)
+        {
+          CrypModel::write(value & mask);
+          return *this;
+        }
+    };
+
+    struct Status {
+        operator u32() const
+        {
+          return CrypModel::getStatus();
+        }
+    };
+
+    struct Input {
+        Input& operator=(u32 const word)
+        {
+          CrypModel::push(word);
+          return *this;
+        }
+    };
+
+    struct Output {
+        operator u32()
+        {
+          return CrypModel::pop();
+        }
+    };
+
+    struct Pair {
+        u32 L;
+        u32 R;
+    };
+
+    struct Registers {
+        Control CR;
+        Status SR;
+        Input DR;
+        Output DOUT;
+        u32 DMACR;
+        u32 IMSCR;
+        u32 RISR;
+        u32 MISR;
+        Pair KR[4];
+        Pair IVR[2];
+    };
+
+    enum {
+      FIFO_DEPTH = 8
+    };
+
+    static Registers registers;
+    static u32 preparations;
+    static u32 overruns;
+    static u32 underruns;
+
+    static void reset()
+    {
+      registers = Registers();
+      input.clear();
+      output.clear();
+      prepared = false;
+      preparations = 0;
+      overruns = 0;
+      underruns = 0;
+    }
+
+  private:
+    static std::deque<u32> input;
+    static std::deque<u32> output;
+    static bool prepared;
+    static Pair preparedKey[4];
+
+    static u32 getField(u32 const mask)
+    {
+      return registers.CR.value & mask;
+    }
+
+    static u32* getKeyWords()
+    {
+      return &registers.KR[0].L;
+    }
+
+    static u32* getIvWords()
+    {
+      return &registers.IVR[0].L;
+    }
+
+    static void write(u32 cr)
+    {
+      if (cr & cryp::cr::fflush::MASK) {
+        input.clear();
+        output.clear();
+        cr &= ~cryp::cr::fflush::MASK;
+      }
+
+      if ((cr & cryp::cr::crypen::MASK) &&
+          ((cr & cryp::cr::algomode::MASK) ==
+              cryp::cr::algomode::AES_KEY_PREPARATION)) {
+        // Done at once, the processor disables itself
+        for (u8 i = 0; i < 4; i++) {
+          preparedKey[i] = registers.KR[i];
+        }
+
+        prepared = true;
+        preparations++;
+        cr &= ~cryp::cr::crypen::MASK;
+      }
+
+      registers.CR.value = cr;
+      run();
+    }
+
+    static u32 getStatus()
+    {
+      return (input.empty() ? cryp::sr::ifem::MASK : 0) +
+          (input.size() < FIFO_DEPTH ? cryp::sr::ifnf::MASK : 0) +
+          (output.empty() ? 0 : cryp::sr::ofne::MASK) +
+          (output.size() == FIFO_DEPTH ? cryp::sr::offu::MASK : 0);
+    }
+
+    /**
+     * @brief Converts between the DR/DOUT words and the big endian words of
+     *        the cipher blocks.
+     */
+    static u32 swap(u32 const word)
+    {
+      u32 swapped = 0;
+
+      switch (getField(cryp::cr::datatype::MASK)) {
+        case cryp::cr::datatype::_16_BIT_DATA:
+          return (word << 16) | (word >> 16);
+        case cryp::cr::datatype::_8_BIT_DATA:
+          return (word << 24) | ((word << 8) & 0xFF0000) |
+              ((word >> 8) & 0xFF00) | (word >> 24);
+        case cryp::cr::datatype::BIT_STRING:
+          for (u8 i = 0; i < 32; i++) {
+            swapped |= ((word >> i) & 1) << (31 - i);
+          }
+          return swapped;
+        default:
+          return word;
+      }
+    }
+
+    static void push(u32 const word)
+    {
+      if (input.size() == FIFO_DEPTH) {
+        overruns++;
+        return;
+      }
+
+      input.push_back(swap(word));
+      run();
+    }
+
+    static u32 pop()
+    {
+      u32 word;
+
+      if (output.empty()) {
+        underruns++;
+        return 0;
+      }
+
+      word = output.front();
+      output.pop_front();
+      run();
+
+      return swap(word);
+    }
+
+    static void toBytes(u32 const* const words, u8 const count, u8* bytes)
+    {
+      for (u8 i = 0; i < count; i++) {
+        for (u8 j = 0; j < 4; j++) {
+          *bytes++ = words[i] >> (24 - 8 * j);
+        }
+      }
+    }
+
+    static void run()
+    {
+      u32 const mode = getField(cryp::cr::algomode::MASK);
+      bool const aes = mode >= cryp::cr::algomode::AES_ECB;
+      u8 const words = aes ? 4 : 2;
+
+      while (getField(cryp::cr::crypen::MASK) &&
+          (input.size() >= words) &&
+          (output.size() + words <= FIFO_DEPTH)) {
+        u32 block[4];
+
+        for (u8 i = 0; i < words; i++) {
+          block[i] = input.front();
+          input.pop_front();
+        }
+
+        if (aes) {
+          processAes(mode, block);
+        } else {
+          processDes(mode, block);
+        }
+
+        for (u8 i = 0; i < words; i++) {
+          output.push_back(block[i]);
+        }
+      }
+    }
+
+    /**
+     * @brief Runs the mode of operation on the <words> words of <block>.
+     */
+    template<typename CIPHER>
+    static void chain(
+        CIPHER const& cipher,
+        u32 const mode,
+        u8 const words,
+        u32* const block)
+    {
+      bool const decrypt =
+          getField(cryp::cr::algodir::MASK) == cryp::cr::algodir::DECRYPT;
+      u32 const chaining = mode & (1 << cryp::cr::algomode::POSITION);
+      u32* const iv = getIvWords();
+      u8 in[16];
+      u8 out[16];
+
+      toBytes(block, words, in);
+
+      if (mode == cryp::cr::algomode::AES_CTR) {
+        u8 counter[16];
+
+        toBytes(iv, words, counter);
+        cipher.encrypt(counter, out);
+
+        for (u8 i = 0; i < 4 * words; i++) {
+          out[i] ^= in[i];
+        }
+
+        // Only the last word of the counter block is incremented
+        iv[3]++;
+      } else if (decrypt) {
+        cipher.decrypt(in, out);
+
+        if (chaining) {
+          u8 previous[16];
+
+          toBytes(iv, words, previous);
+
+          for (u8 i = 0; i < 4 * words; i++) {
+            out[i] ^= previous[i];
+            iv[i / 4] = block[i / 4];
+          }
+        }
+      } else {
+        if (chaining) {
+          u8 previous[16];
+
+          toBytes(iv, words, previous);
+
+          for (u8 i = 0; i < 4 * words; i++) {
+            in[i] ^= previous[i];
+          }
+        }
+
+        cipher.encrypt(in, out);
+      }
+
+      for (u8 i = 0; i < words; i++) {
+        block[i] = (u32(out[4 * i]) << 24) + (out[4 * i + 1] << 16) +
+            (out[4 * i + 2] << 8) + out[4 * i + 3];
+
+        if (chaining && !decrypt) {
+          iv[i] = block[i];
+        }
+      }
+    }
+
+    static void processAes(u32 const mode, u32* const block)
+    {
+      u8 const keyWords =
+          4 + 2 * (getField(cryp::cr::keysize::MASK) >>
+              cryp::cr::keysize::POSITION);
+      bool const decrypt =
+          getField(cryp::cr::algodir::MASK) == cryp::cr::algodir::DECRYPT;
+      u8 key[32];
+      reference::Aes aes;
+
+      // The shorter keys are right aligned
+      toBytes(getKeyWords() + 8 - keyWords, keyWords, key);
+      aes.setKey(key, 4 * keyWords);
+
+      if (decrypt && (mode != cryp::cr::algomode::AES_CTR)) {
+        bool valid = prepared;
+
+        for (u8 i = 0; i < 4; i++) {
+          valid = valid && (preparedKey[i].L == registers.KR[i].L) &&
+              (preparedKey[i].R == registers.KR[i].R);
+        }
+
+        // Without the key preparation the result is garbage
+        if (!valid) {
+          aes.setKey(key + 1, 16);
+        }
+      }
+
+      chain(aes, mode, 4, block);
+    }
+
+    static void processDes(u32 const mode, u32* const block)
+    {
+      u8 key[24];
+
+      // K1 (DES), K1 to K3 (TDES)
+      toBytes(getKeyWords() + 2, 6, key);
+
+      if (mode >= cryp::cr::algomode::DES_ECB) {
+        reference::Des des;
+
+        des.setKey(key);
+        chain(des, mode - cryp::cr::algomode::DES_ECB, 2, block);
+      } else {
+        reference::TripleDes tdes;
+
+        tdes.setKey(key);
+        chain(tdes, mode, 2, block);
+      }
+    }
+};
+
+CrypModel::Registers CrypModel::registers;
+u32 CrypModel::preparations;
+u32 CrypModel::overruns;
+u32 CrypModel::underruns;
+std::deque<u32> CrypModel::input;
+std::deque<u32> CrypModel::output;
+bool CrypModel::prepared;
+CrypModel::Pair CrypModel::preparedKey[4];
+
+#define CRYP_REGS (&CrypModel::registers)
+
+#include "peripheral/cryp.hpp"
+
+typedef std::vector<u8> Bytes;
+
+static Bytes fromHex(std::string const& hex)
+{
+  Bytes bytes;
+
+  for (u32 i = 0; i + 1 < hex.size(); i += 2) {
+    bytes.push_back(std::stoul(hex.substr(i, 2), 0, 16));
+  }
+
+  return bytes;
+}
+
+/**
+ * @brief Runs the driver on <data>, <chunk> bytes per process() call, in
+ *        place if asked.
+ */
+static Bytes crypt(
+    cryp::cr::algomode::States const ALGOMODE,
+    cryp::cr::algodir::States const ALGODIR,
+    Bytes const& key,
+    Bytes const& iv,
+    Bytes const& data,
+    u32 const chunk = 0,
+    bool const inPlace = false)
+{
+  Bytes output(data.size());
+  Bytes buffer = data;
+
+  CrypModel::reset();
+
+  if (ALGOMODE >= cryp::cr::algomode::AES_ECB) {
+    CRYP::setAesKey(key.data(), cryp::cr::keysize::States(
+        (key.size() / 8 - 2) << cryp::cr::keysize::POSITION));
+  } else if (key.size() == 8) {
+    CRYP::setDesKey(key.data());
+  } else {
+    CRYP::setTripleDesKey(key.data());
+  }
+
+  if (!iv.empty()) {
+    CRYP::setInitializationVector(iv.data(), iv.size());
+  }
+
+  CRYP::start(ALGOMODE, ALGODIR);
+
+  for (u32 offset = 0; offset < data.size();) {
+    u32 const size = (chunk == 0) || (data.size() - offset < chunk) ?
+        data.size() - offset : chunk;
+
+    if (inPlace) {
+      CRYP::process(&buffer[offset], &buffer[offset], size);
+    } else {
+      CRYP::process(&data[offset], &output[offset], size);
+    }
+
+    offset += size;
+  }
+
+  CRYP::stop();
+
+  CHECK(CrypModel::overruns == 0);
+  CHECK(CrypModel::underruns == 0);
+
+  return inPlace ? buffer : output;
+}
+
+// NIST SP 800-38A appendix F
+static std::string const PLAINTEXT =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+static std::string const AES128_KEY = "2b7e151628aed2a6abf7158809cf4f3c";
+static std::string const AES192_KEY =
+    "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b";
+static std::string const AES256_KEY =
+    "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4";
+static std::string const CBC_IV = "000102030405060708090a0b0c0d0e0f";
+static std::string const CTR_IV = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+static std::string const ECB128 =
+    "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf"
+    "43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4";
+static std::string const CBC128 =
+    "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+    "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7";
+static std::string const CTR128 =
+    "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+    "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee";
+static std::string const CTR192 =
+    "1abc932417521ca24f2b0459fe7e6e0b090339ec0aa6faefd5ccc2c6f4ce8e94"
+    "1e36b26bd1ebc670d1bd1d665620abf74f78a7f6d29809585a97daec58c6b050";
+static std::string const CBC256 =
+    "f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d"
+    "39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b";
+
+// FIPS 81 appendix C, SP 800-67 appendix B
+static std::string const DES_KEY = "0123456789abcdef";
+static std::string const DES_IV = "1234567890abcdef";
+static std::string const DES_PLAINTEXT =
+    "4e6f77206973207468652074696d6520666f7220616c6c20";
+static std::string const DES_CBC =
+    "e5c7cdde872bf27c43e934008c389c0f683788499a7c05f6";
+static std::string const TDES_KEY =
+    "0123456789abcdef23456789abcdef01456789abcdef0123";
+static std::string const TDES_PLAINTEXT =
+    "54686520717566636b2062726f776e20666f78206a756d70";
+static std::string const TDES_ECB =
+    "a826fd8ce53b855fcce21c8112256fe668d5c05dd9b6b900";
+
+static void testReference()
+{
+  // FIPS 197 appendix C
+  Bytes const plaintext = fromHex("00112233445566778899aabbccddeeff");
+  std::string const expected[] = {
+      "69c4e0d86a7b0430d8cdb78070b4c55a",
+      "dda97ca4864cdfe06eaf70a0ec0d7191",
+      "8ea2b7ca516745bfeafc49904b496089"
+  };
+  Bytes key;
+
+  for (u8 i = 0; i < 32; i++) {
+    key.push_back(i);
+  }
+
+  for (u8 i = 0; i < 3; i++) {
+    reference::Aes aes;
+    u8 block[16];
+
+    aes.setKey(key.data(), 16 + 8 * i);
+    aes.encrypt(plaintext.data(), block);
+    CHECK(Bytes(block, block + 16) == fromHex(expected[i]));
+    aes.decrypt(block, block);
+    CHECK(Bytes(block, block + 16) == plaintext);
+  }
+
+  reference::Des des;
+  u8 block[8];
+
+  des.setKey(fromHex("133457799bbcdff1").data());
+  des.encrypt(fromHex("0123456789abcdef").data(), block);
+  CHECK(Bytes(block, block + 8) == fromHex("85e813540f0ab405"));
+
+  reference::TripleDes tdes;
+
+  tdes.setKey(fromHex(TDES_KEY).data());
+  tdes.encrypt(fromHex(TDES_PLAINTEXT).data(), block);
+  CHECK(Bytes(block, block + 8) == fromHex(TDES_ECB.substr(0, 16)));
+}
+
+static void testAes()
+{
+  using namespace cryp::cr;
+
+  Bytes const plaintext = fromHex(PLAINTEXT);
+  Bytes const none;
+
+  CHECK(crypt(algomode::AES_ECB, algodir::ENCRYPT, fromHex(AES128_KEY), none,
+              plaintext) == fromHex(ECB128));
+  CHECK(crypt(algomode::AES_ECB, algodir::DECRYPT, fromHex(AES128_KEY), none,
+              fromHex(ECB128)) == plaintext);
+  CHECK(crypt(algomode::AES_CBC, algodir::ENCRYPT, fromHex(AES128_KEY),
+              fromHex(CBC_IV), plaintext) == fromHex(CBC128));
+  CHECK(crypt(algomode::AES_CBC, algodir::DECRYPT, fromHex(AES128_KEY),
+              fromHex(CBC_IV), fromHex(CBC128)) == plaintext);
+  CHECK(crypt(algomode::AES_CTR, algodir::ENCRYPT, fromHex(AES128_KEY),
+              fromHex(CTR_IV), plaintext) == fromHex(CTR128));
+  CHECK(crypt(algomode::AES_CTR, algodir::DECRYPT, fromHex(AES128_KEY),
+              fromHex(CTR_IV), fromHex(CTR128)) == plaintext);
+  CHECK(crypt(algomode::AES_CTR, algodir::ENCRYPT, fromHex(AES192_KEY),
+              fromHex(CTR_IV), plaintext) == fromHex(CTR192));
+  CHECK(crypt(algomode::AES_CBC, algodir::ENCRYPT, fromHex(AES256_KEY),
+              fromHex(CBC_IV), plaintext) == fromHex(CBC256));
+  CHECK(crypt(algomode::AES_CBC, algodir::DECRYPT, fromHex(AES256_KEY),
+              fromHex(CBC_IV), fromHex(CBC256)) == plaintext);
+}
+
+static void testDes()
+{
+  using namespace cryp::cr;
+
+  Bytes const none;
+  Bytes const tdesPlaintext = fromHex(TDES_PLAINTEXT);
+
+  CHECK(crypt(algomode::DES_ECB, algodir::ENCRYPT, fromHex("133457799bbcdff1"),
+              none, fromHex("0123456789abcdef")) ==
+      fromHex("85e813540f0ab405"));
+  CHECK(crypt(algomode::DES_CBC, algodir::ENCRYPT, fromHex(DES_KEY),
+              fromHex(DES_IV), fromHex(DES_PLAINTEXT)) == fromHex(DES_CBC));
+  CHECK(crypt(algomode::DES_CBC, algodir::DECRYPT, fromHex(DES_KEY),
+              fromHex(DES_IV), fromHex(DES_CBC)) == fromHex(DES_PLAINTEXT));
+  CHECK(crypt(algomode::TDES_ECB, algodir::ENCRYPT, fromHex(TDES_KEY), none,
+              tdesPlaintext) == fromHex(TDES_ECB));
+  CHECK(crypt(algomode::TDES_ECB, algodir::DECRYPT, fromHex(TDES_KEY), none,
+              fromHex(TDES_ECB)) == tdesPlaintext);
+
+  // TDES CBC, against the reference chaining
+  reference::TripleDes tdes;
+  Bytes expected = tdesPlaintext;
+  Bytes const iv = fromHex(DES_IV);
+
+  tdes.setKey(fromHex(TDES_KEY).data());
+
+  for (u32 offset = 0; offset < expected.size(); offset += 8) {
+    for (u8 i = 0; i < 8; i++) {
+      expected[offset + i] ^= offset == 0 ? iv[i] : expected[offset - 8 + i];
+    }
+
+    tdes.encrypt(&expected[offset], &expected[offset]);
+  }
+
+  CHECK(crypt(algomode::TDES_CBC, algodir::ENCRYPT, fromHex(TDES_KEY), iv,
+              tdesPlaintext) == expected);
+  CHECK(crypt(algomode::TDES_CBC, algodir::DECRYPT, fromHex(TDES_KEY), iv,
+              expected) == tdesPlaintext);
+}
+
+/**
+ * The chaining state survives between process() calls, the buffers can be
+ * processed in place, and the last CTR block may be partial.
+ */
+static void testStreaming()
+{
+  using namespace cryp::cr;
+
+  Bytes const plaintext = fromHex(PLAINTEXT);
+  Bytes const key = fromHex(AES128_KEY);
+
+  CHECK(crypt(algomode::AES_CBC, algodir::ENCRYPT, key, fromHex(CBC_IV),
+              plaintext, 16) == fromHex(CBC128));
+  CHECK(crypt(algomode::AES_CBC, algodir::DECRYPT, key, fromHex(CBC_IV),
+              fromHex(CBC128), 32, true) == plaintext);
+  CHECK(crypt(algomode::AES_CTR, algodir::ENCRYPT, key, fromHex(CTR_IV),
+              plaintext, 0, true) == fromHex(CTR128));
+
+  Bytes const partial(plaintext.begin(), plaintext.begin() + 40);
+  Bytes const expected = fromHex(CTR128.substr(0, 80));
+
+  CHECK(crypt(algomode::AES_CTR, algodir::ENCRYPT, key, fromHex(CTR_IV),
+              partial) == expected);
+  CHECK(crypt(algomode::AES_CTR, algodir::ENCRYPT, key, fromHex(CTR_IV),
+              partial, 0, true) == expected);
+
+  // The IV registers hold the last ciphertext block, stop() and start()
+  // resume the chain
+  Bytes const ciphertext = fromHex(CBC128);
+  Bytes output(32);
+
+  CrypModel::reset();
+  CRYP::setAesKey(key.data(), keysize::_128_BITS);
+  CRYP::setInitializationVector(fromHex(CBC_IV).data(), 16);
+  CRYP::start(algomode::AES_CBC, algodir::ENCRYPT);
+  CRYP::process(plaintext.data(), output.data(), 32);
+  CRYP::stop();
+  CHECK(Bytes(output.begin(), output.begin() + 32) ==
+      Bytes(ciphertext.begin(), ciphertext.begin() + 32));
+  CHECK(CrypModel::registers.IVR[1].R == 0x917678B2);
+
+  CRYP::start(algomode::AES_CBC, algodir::ENCRYPT);
+  CRYP::process(&plaintext[32], output.data(), 32);
+  CRYP::stop();
+  CHECK(output == Bytes(ciphertext.begin() + 32, ciphertext.end()));
+}
+
+/**
+ * Only the AES ECB/CBC decryption needs the key preparation.
+ */
+static void testKeyPreparation()
+{
+  using namespace cryp::cr;
+
+  Bytes const key = fromHex(AES128_KEY);
+
+  CrypModel::reset();
+  CRYP::setAesKey(key.data(), keysize::_128_BITS);
+  CRYP::start(algomode::AES_ECB, algodir::ENCRYPT);
+  CHECK(CrypModel::preparations == 0);
+  CRYP::start(algomode::AES_CTR, algodir::DECRYPT);
+  CHECK(CrypModel::preparations == 0);
+  CRYP::start(algomode::AES_CBC, algodir::DECRYPT);
+  CHECK(CrypModel::preparations == 1);
+  CHECK(CRYP::getBlockSize() == cryp::AES_BLOCK_SIZE);
+  CRYP::stop();
+
+  CRYP::setDesKey(fromHex(DES_KEY).data());
+  CRYP::start(algomode::DES_ECB, algodir::DECRYPT);
+  CHECK(CrypModel::preparations == 1);
+  CHECK(CRYP::getBlockSize() == cryp::DES_BLOCK_SIZE);
+  CRYP::stop();
+}
+
+int main()
+{
+  testReference();
+  testAes();
+  testDes();
+  testStreaming();
+  testKeyPreparation();
+
+  return check::report("cryp");
+}
@@ -0,0 +1,195 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *        Software digests, known answer tests (FIPS 180, RFC 1321/2202)
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "check.hpp"
+
+#include "digest.hpp"
+
+static std::string toHex(u8 const* bytes, u32 const size)
+{
+  std::string hex;
+
+  for (u32 i = 0; i < size; i++) {
+    char digits[3];
+
+    std::snprintf(digits, sizeof(digits), "%02x", bytes[i]);
+    hex += digits;
+  }
+
+  return hex;
+}
+
+template<typename ALGORITHM>
+static std::string hash(std::string const& message)
+{
+  digest::Hash<ALGORITHM> hash;
+  u8 result[ALGORITHM::SIZE];
+
+  hash.init();
+  hash.update(message.data(), message.size());
+  hash.final(result);
+
+  return toHex(result, sizeof(result));
+}
+
+template<typename ALGORITHM>
+static std::string hmac(std::string const& key, std::string const& message)
+{
+  digest::Hmac<ALGORITHM> hmac;
+  u8 result[ALGORITHM::SIZE];
+
+  hmac.init(key.data(), key.size());
+  hmac.update(message.data(), message.size());
+  hmac.final(result);
+
+  return toHex(result, sizeof(result));
+}
+
+static void testSha1()
+{
+  // FIPS 180-2 appendix A, and the empty message
+  CHECK(hash<digest::Sha1>("abc") ==
+      "a9993e364706816aba3e25717850c26c9cd0d89d");
+  CHECK(hash<digest::Sha1>(
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+      "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+  CHECK(hash<digest::Sha1>(std::string(1000000, 'a')) ==
+      "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+  CHECK(hash<digest::Sha1>("") ==
+      "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+}
+
+static void testMd5()
+{
+  // RFC 1321 appendix A.5
+  CHECK(hash<digest::Md5>("") == "d41d8cd98f00b204e9800998ecf8427e");
+  CHECK(hash<digest::Md5>("a") == "0cc175b9c0f1b6a831c399e269772661");
+  CHECK(hash<digest::Md5>("abc") == "900150983cd24fb0d6963f7d28e17f72");
+  CHECK(hash<digest::Md5>("message digest") ==
+      "f96b697d7cb7938d525a2f31aaf161d0");
+  CHECK(hash<digest::Md5>("abcdefghijklmnopqrstuvwxyz") ==
+      "c3fcd3d76192e4007dfb496cca67e13b");
+  CHECK(hash<digest::Md5>(
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789") ==
+      "d174ab98d277d9f5a5611c2c9f419d9f");
+  CHECK(hash<digest::Md5>(
+      "1234567890123456789012345678901234567890"
+      "1234567890123456789012345678901234567890") ==
+      "57edf4a22be3c955ac49da2e2107b67a");
+}
+
+static void testHmac()
+{
+  std::string key25;
+
+  for (char i = 1; i <= 25; i++) {
+    key25 += i;
+  }
+
+  // RFC 2202 section 3, HMAC-SHA-1
+  CHECK(hmac<digest::Sha1>(std::string(20, 0x0B), "Hi There") ==
+      "b617318655057264e28bc0b6fb378c8ef146be00");
+  CHECK(hmac<digest::Sha1>("Jefe", "what do ya want for nothing?") ==
+      "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79");
+  CHECK(hmac<digest::Sha1>(std::string(20, '\xAA'),
+                           std::string(50, '\xDD')) ==
+      "125d7342b9ac11cd91a39af48aa17b4f63f175d3");
+  CHECK(hmac<digest::Sha1>(key25, std::string(50, '\xCD')) ==
+      "4c9007f4026250c6bc8414f9bf50c86c2d7235da");
+  CHECK(hmac<digest::Sha1>(std::string(20, 0x0C), "Test With Truncation") ==
+      "4c1a03424b55e07fe7f27be1d58bb9324a9a5a04");
+  CHECK(hmac<digest::Sha1>(std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key - Hash Key First") ==
+      "aa4ae5e15272d00e95705637ce8a3b55ed402112");
+  CHECK(hmac<digest::Sha1>(std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key and Larger Than One "
+      "Block-Size Data") ==
+      "e8e99d0f45237d786d6bbaa7965c7808bbff1a91");
+
+  // RFC 2202 section 2, HMAC-MD5
+  CHECK(hmac<digest::Md5>(std::string(16, 0x0B), "Hi There") ==
+      "9294727a3638bb1c13f48ef8158bfc9d");
+  CHECK(hmac<digest::Md5>("Jefe", "what do ya want for nothing?") ==
+      "750c783e6ab0b503eaa86e310a5db738");
+  CHECK(hmac<digest::Md5>(std::string(16, '\xAA'),
+                          std::string(50, '\xDD')) ==
+      "56be34521d144c88dbb8c733f0e8b3f6");
+  CHECK(hmac<digest::Md5>(key25, std::string(50, '\xCD')) ==
+      "697eaf0aca3a3aea3a75164746ffaa79");
+  CHECK(hmac<digest::Md5>(std::string(16, 0x0C), "Test With Truncation") ==
+      "56461ef2342edc00f9bab995690efd4c");
+  CHECK(hmac<digest::Md5>(std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key - Hash Key First") ==
+      "6b1ab7fe4bd7bf8f0b62e6ce61b9d0cd");
+  CHECK(hmac<digest::Md5>(std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key and Larger Than One "
+      "Block-Size Data") ==
+      "6f630fad67cda0ee1fb1f562db3aa53e");
+}
+
+/**
+ * Feeding the message in pieces must not change the digest, whatever the
+ * split point relative to the 64 byte blocks.
+ */
+static void testSplitUpdates()
+{
+  std::string message;
+
+  for (u32 i = 0; i < 200; i++) {
+    message += char(i * 7);
+  }
+
+  std::string const expected = hash<digest::Sha1>(message);
+
+  for (u32 split = 0; split <= message.size(); split++) {
+    digest::Hash<digest::Sha1> sha1;
+    u8 result[digest::Sha1::SIZE];
+
+    sha1.init();
+    sha1.update(message.data(), split);
+    sha1.update(message.data() + split, message.size() - split);
+    sha1.final(result);
+
+    CHECK(toHex(result, sizeof(result)) == expected);
+  }
+}
+
+int main()
+{
+  testSha1();
+  testMd5();
+  testHmac();
+  testSplitUpdates();
+
+  return check::report("digest");
+}
@@ -0,0 +1,684 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *
+ *       Ethernet descriptor rings on a model of the MAC and its DMA
+ *
+ ******************************************************************************/
+
+#include <sys/mman.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "check.hpp"
+#include "defs.hpp"
+
+#include "../memorymap/eth.hpp"
+#include "../memorymap/rcc.hpp"
+#include "../memorymap/syscfg.hpp"
+
+namespace eth {
+  struct Descriptor;
+}  // namespace eth
+
+typedef std::vector<u8> Bytes;
+
+/**
+ * Behaves like the MAC and its DMA as seen through the registers and the
+ * descriptor rings: the resets and FIFO flushes complete right away, the
+ * transmit DMA sends the frames of the descriptors it owns when told to (or
+ * on each poll demand with autoTransmit), and the frames delivered to the
+ * receive DMA land in the buffers of the descriptors it owns.
+ */
+class EthModel {
+  public:
+    typedef void (*Hook)(u32&);
+
+    template<Hook HOOK>
+    struct Register {
+        u32 value;
+
+        operator u32() const
+        {
+          return value;
+        }
+
+        Register& operator=(u32 const word)
+        {
+          value = word;
+          HOOK(value);
+          return *this;
+        }
+
+        Register& operator|=(u32 const mask)
+        {
+          return *this = value | mask;
+        }
+
+        Register& operator&=(u32 const mask)
+        {
+          return *this = value & mask;
+        }
+    };
+
+    static void onBusMode(u32& value)
+    {
+      value &= ~u32(eth::dmabmr::sr::MASK);
+    }
+
+    static void onOperationMode(u32& value)
+    {
+      value &= ~u32(eth::dmaomr::ftf::MASK);
+    }
+
+    static void onTransmitPoll(u32&)
+    {
+      if (autoTransmit) {
+        transmit(~0u);
+      }
+    }
+
+    static void onReceivePoll(u32&)
+    {
+      resumes++;
+    }
+
+    static void onTimestampControl(u32& value)
+    {
+      if (value & eth::ptptscr::tssti::MASK) {
+        registers.PTPTSHR = registers.PTPTSHUR;
+        registers.PTPTSLR = registers.PTPTSLUR;
+      }
+
+      if (value & eth::ptptscr::tsstu::MASK) {
+        updateTime();
+      }
+
+      value &= ~u32(eth::ptptscr::tssti::MASK + eth::ptptscr::tsstu::MASK +
+          eth::ptptscr::ttsaru::MASK);
+    }
+
+    struct Registers {
+        u32 MACCR;
+        u32 MACFFR;
+        u32 MACMIIAR;
+        u32 MACMIIDR;
+        u32 MACIMR;
+        u32 MACA0HR;
+        u32 MACA0LR;
+        Register<onTimestampControl> PTPTSCR;
+        u32 PTPSSIR;
+        u32 PTPTSHR;
+        u32 PTPTSLR;
+        u32 PTPTSHUR;
+        u32 PTPTSLUR;
+        u32 PTPTSAR;
+        u32 PTPPPSCR;
+        Register<onBusMode> DMABMR;
+        Register<onTransmitPoll> DMATPDR;
+        Register<onReceivePoll> DMARPDR;
+        u32 DMARDLAR;
+        u32 DMATDLAR;
+        u32 DMASR;
+        Register<onOperationMode> DMAOMR;
+        u32 DMAIER;
+    };
+
+    static Registers registers;
+    static bool autoTransmit;
+    static std::vector<Bytes> sent;
+    static u32 missed;
+    static u32 resumes;
+
+    static void reset()
+    {
+      registers = Registers();
+      autoTransmit = false;
+      sent.clear();
+      missed = 0;
+      resumes = 0;
+      txCurrent = 0;
+      rxCurrent = 0;
+      partial.clear();
+    }
+
+    static u32 transmit(u32 const);
+    static bool deliver(Bytes const&, bool const = false);
+    static u8* getArmedBuffer();
+
+    /**
+     * @brief Backs the registers of the other peripherals touched by the
+     *        driver (RCC, SYSCFG) with plain memory.
+     */
+    static void mapPeripherals()
+    {
+      map(rcc::ADDRESS);
+      map(syscfg::ADDRESS);
+    }
+
+  private:
+    static u32 txCurrent;
+    static u32 rxCurrent;
+    static Bytes partial;
+
+    static eth::Descriptor& getDescriptor(u32 const);
+
+    /**
+     * @brief Adds the update registers to the system time, in digital
+     *        rollover mode. When subtracting, the nanoseconds are given as
+     *        their complement to 1 s, 0 meaning none.
+     */
+    static void updateTime()
+    {
+      u32 const update = registers.PTPTSLUR;
+      u32 const nanoseconds = update & ~u32(eth::ptptslur::tsupns::MASK);
+      u32 seconds = registers.PTPTSHR;
+      u32 now = registers.PTPTSLR;
+
+      CHECK(nanoseconds < 1000000000);
+
+      if (update & eth::ptptslur::tsupns::MASK) {
+        seconds -= registers.PTPTSHUR;
+
+        if (nanoseconds != 0) {
+          now += nanoseconds;
+
+          if (now >= 1000000000) {
+            now -= 1000000000;
+          } else {
+            seconds--;
+          }
+        }
+      } else {
+        seconds += registers.PTPTSHUR;
+        now += nanoseconds;
+
+        if (now >= 1000000000) {
+          now -= 1000000000;
+          seconds++;
+        }
+      }
+
+      registers.PTPTSHR = seconds;
+      registers.PTPTSLR = now;
+    }
+
+    static u8* getPointer(u32 const address)
+    {
+      return reinterpret_cast<u8*>(uintptr_t(address));
+    }
+
+    static void map(u32 const address)
+    {
+      void* const page = reinterpret_cast<void*>(uintptr_t(address & ~0xFFF));
+
+      if (mmap(page, 0x1000, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) !=
+          page) {
+        std::printf("Can't map the registers at 0x%08X\n", unsigned(address));
+        std::exit(1);
+      }
+    }
+};
+
+EthModel::Registers EthModel::registers;
+bool EthModel::autoTransmit;
+std::vector<Bytes> EthModel::sent;
+u32 EthModel::missed;
+u32 EthModel::resumes;
+u32 EthModel::txCurrent;
+u32 EthModel::rxCurrent;
+Bytes EthModel::partial;
+
+#define ETH_REGS (&EthModel::registers)
+
+#include "peripheral/eth.hpp"
+
+/**
+ * @brief Processes up to <limit> TX descriptors, returns how many were
+ *        owned by the DMA.
+ */
+u32 EthModel::transmit(u32 const limit)
+{
+  u32 consumed = 0;
+
+  if (!(registers.DMAOMR & eth::dmaomr::st::MASK)) {
+    return 0;
+  }
+
+  if (txCurrent == 0) {
+    txCurrent = registers.DMATDLAR;
+  }
+
+  while (consumed < limit) {
+    eth::Descriptor& descriptor = getDescriptor(txCurrent);
+
+    if (!(descriptor.status & eth::tdes0::own::MASK)) {
+      break;
+    }
+
+    u8 const* const data = getPointer(descriptor.buffer1);
+
+    if (descriptor.status & eth::tdes0::fs::MASK) {
+      partial.clear();
+    }
+
+    partial.insert(
+        partial.end(),
+        data,
+        data + (descriptor.control & eth::tdes1::tbs1::MASK));
+
+    if (descriptor.status & eth::tdes0::ls::MASK) {
+      sent.push_back(partial);
+    }
+
+    descriptor.status &= ~u32(eth::tdes0::own::MASK);
+    txCurrent = descriptor.next;
+    consumed++;
+  }
+
+  return consumed;
+}
+
+/**
+ * @brief Receives <frame>, with a CRC or alignment error if <error> is
+ *        true. Returns false if the DMA owns no descriptor.
+ */
+bool EthModel::deliver(Bytes const& frame, bool const error)
+{
+  if (!(registers.DMAOMR & eth::dmaomr::sr::MASK)) {
+    return false;
+  }
+
+  if (rxCurrent == 0) {
+    rxCurrent = registers.DMARDLAR;
+  }
+
+  eth::Descriptor& descriptor = getDescriptor(rxCurrent);
+
+  if (!(descriptor.status & eth::rdes0::own::MASK)) {
+    missed++;
+    return false;
+  }
+
+  CHECK(frame.size() + 4 <=
+      (descriptor.control & eth::rdes1::rbs1::MASK));
+
+  std::memcpy(getPointer(descriptor.buffer1), frame.data(), frame.size());
+
+  descriptor.status = eth::rdes0::fs::MASK + eth::rdes0::ls::MASK +
+      ((frame.size() + 4) << eth::rdes0::fl::POSITION) +
+      (error ? u32(eth::rdes0::es::MASK) : 0);
+  rxCurrent = descriptor.next;
+
+  return true;
+}
+
+/**
+ * @brief Returns the buffer the next received frame will land in.
+ */
+u8* EthModel::getArmedBuffer()
+{
+  if (rxCurrent == 0) {
+    rxCurrent = registers.DMARDLAR;
+  }
+
+  return getPointer(getDescriptor(rxCurrent).buffer1);
+}
+
+eth::Descriptor& EthModel::getDescriptor(u32 const address)
+{
+  return *reinterpret_cast<eth::Descriptor*>(uintptr_t(address));
+}
+
+/**
+ * Stands for critical::Section, checks that the sections don't nest.
+ */
+struct Lock {
+    static bool held;
+    static u32 taken;
+
+    Lock()
+    {
+      CHECK(!held);
+      held = true;
+      taken++;
+    }
+
+    ~Lock()
+    {
+      held = false;
+    }
+};
+
+bool Lock::held;
+u32 Lock::taken;
+
+enum {
+  RX_DESCRIPTORS = 4,
+  TX_DESCRIPTORS = 4,
+  RX_BUFFERS = 8,
+  FRAMES = 60,
+  SEGMENT_SIZE = 32
+};
+
+typedef eth::Driver<RX_DESCRIPTORS, TX_DESCRIPTORS, RX_BUFFERS, Lock> ETH0;
+
+static u8 const MAC[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+// The TX segments must stay untouched until sent, and below 4 GiB
+static u8 segmentData[FRAMES][3][SEGMENT_SIZE];
+
+static u32 random(u32& seed)
+{
+  seed = seed * 1664525 + 1013904223;
+
+  return seed >> 8;
+}
+
+static void* toTag(u32 const frame)
+{
+  return reinterpret_cast<void*>(uintptr_t(frame));
+}
+
+static void start()
+{
+  EthModel::reset();
+  ETH0::initialize(MAC, eth::RMII);
+}
+
+/**
+ * @brief Reclaims the sent frames, checks they come in order.
+ */
+static void reclaim(std::deque<u32>& pending)
+{
+  void* tag;
+
+  while (ETH0::getSent(tag)) {
+    CHECK(!pending.empty() && (tag == toTag(pending.front())));
+
+    if (!pending.empty()) {
+      pending.pop_front();
+    }
+  }
+}
+
+/**
+ * @brief Frames of 1 to 3 segments, sent faster than the MAC consumes the
+ *        descriptors, so the ring wraps around many times.
+ */
+static void testTransmitRing()
+{
+  std::vector<Bytes> expected;
+  std::deque<u32> pending;
+  u32 queued = 0;
+  u32 consumed = 0;
+
+  start();
+
+  CHECK(ETH0::getFreeTxDescriptors() == TX_DESCRIPTORS);
+
+  for (u32 frame = 0; frame < FRAMES; frame++) {
+    u8 const count = 1 + frame % 3;
+    eth::Segment segments[3];
+    Bytes whole;
+
+    for (u8 i = 0; i < count; i++) {
+      u16 const size = 8 + (frame * 5 + i * 3) % (SEGMENT_SIZE - 8);
+
+      for (u16 j = 0; j < size; j++) {
+        segmentData[frame][i][j] = frame * 7 + i * 31 + j;
+      }
+
+      segments[i].data = segmentData[frame][i];
+      segments[i].size = size;
+      whole.insert(whole.end(), segmentData[frame][i],
+                   segmentData[frame][i] + size);
+    }
+
+    while (!ETH0::send(segments, count, toTag(frame))) {
+      CHECK(ETH0::getFreeTxDescriptors() < count);
+
+      // One descriptor at a time, the frames may be half sent
+      consumed += EthModel::transmit(1);
+      reclaim(pending);
+
+      CHECK(ETH0::getFreeTxDescriptors() ==
+          TX_DESCRIPTORS - (queued - consumed));
+    }
+
+    pending.push_back(frame);
+    expected.push_back(whole);
+    queued += count;
+  }
+
+  while (!pending.empty() && (EthModel::transmit(1) != 0)) {
+    reclaim(pending);
+  }
+
+  CHECK(pending.empty());
+  CHECK(ETH0::getFreeTxDescriptors() == TX_DESCRIPTORS);
+  CHECK(EthModel::sent == expected);
+  CHECK(queued > 10 * TX_DESCRIPTORS);
+
+  // Sent on the poll demand
+  EthModel::sent.clear();
+  EthModel::autoTransmit = true;
+
+  for (u32 frame = 0; frame < 10; frame++) {
+    eth::Segment const segment = { segmentData[frame][0], 8 };
+    void* tag = 0;
+
+    CHECK(ETH0::send(&segment, 1, toTag(frame)));
+    CHECK(ETH0::getSent(tag) && (tag == toTag(frame)));
+    CHECK(!ETH0::getSent(tag));
+  }
+
+  CHECK(EthModel::sent.size() == 10);
+
+  // Nothing is queued on error
+  eth::Segment const large = { segmentData[0][0], 0x2000 };
+
+  CHECK(!ETH0::send(&large, 1, 0));
+  CHECK(!ETH0::send(&large, 0, 0));
+  CHECK(ETH0::getFreeTxDescriptors() == TX_DESCRIPTORS);
+}
+
+/**
+ * @brief Frames arrive in bursts, the stack holds on to some buffers and
+ *        gives them back out of order. Every 5th frame has a CRC error.
+ */
+static void testReceiveRing()
+{
+  std::deque<Bytes> expected;
+  std::vector<u8*> held;
+  eth::Frame frame;
+  u32 seed = 1;
+  u32 delivered = 0;
+  u32 received = 0;
+  u32 starved = 0;
+
+  start();
+
+  CHECK(!ETH0::receive(frame));
+
+  for (u32 round = 0; round < 300; round++) {
+    u32 const burst = random(seed) % 4;
+
+    for (u32 i = 0; i < burst; i++) {
+      Bytes bytes(60 + random(seed) % 1400);
+      bool const error = delivered % 5 == 4;
+
+      for (u32 j = 0; j < bytes.size(); j++) {
+        bytes[j] = delivered + j;
+      }
+
+      if (EthModel::deliver(bytes, error)) {
+        if (!error) {
+          expected.push_back(bytes);
+        }
+
+        delivered++;
+      }
+    }
+
+    while (ETH0::receive(frame)) {
+      CHECK(!expected.empty());
+
+      if (expected.empty()) {
+        break;
+      }
+
+      CHECK(frame.size == expected.front().size());
+      CHECK(std::memcmp(frame.data, expected.front().data(), frame.size) ==
+          0);
+
+      expected.pop_front();
+      held.push_back(frame.data);
+      received++;
+    }
+
+    // The frames wait in the ring while the stack holds every spare buffer
+    CHECK(expected.empty() || (held.size() == RX_BUFFERS - RX_DESCRIPTORS));
+
+    if (!expected.empty()) {
+      starved++;
+    }
+
+    for (u32 i = random(seed) % (held.size() + 1); i != 0; i--) {
+      u32 const index = random(seed) % held.size();
+
+      CHECK(ETH0::release(held[index]));
+
+      held.erase(held.begin() + index);
+    }
+  }
+
+  CHECK(delivered > 100 * RX_DESCRIPTORS);
+  CHECK(received > 50 * RX_DESCRIPTORS);
+  CHECK(starved != 0);
+  CHECK(EthModel::missed != 0);
+  CHECK(EthModel::resumes != 0);
+  CHECK(!Lock::held);
+}
+
+/**
+ * @brief Only the buffers handed by receive() are taken back, once.
+ */
+static void testRelease()
+{
+  static u8 other[ETH_BUFFER_SIZE];
+  eth::Frame frames[RX_BUFFERS - RX_DESCRIPTORS];
+  eth::Frame frame;
+
+  start();
+
+  for (u8 i = 0; i < RX_BUFFERS - RX_DESCRIPTORS; i++) {
+    CHECK(EthModel::deliver(Bytes(64, i)));
+    CHECK(ETH0::receive(frames[i]));
+  }
+
+  CHECK(EthModel::deliver(Bytes(64, 0xFF)));
+  CHECK(!ETH0::receive(frame));
+
+  u32 const taken = Lock::taken;
+
+  CHECK(!ETH0::release(0));
+  CHECK(!ETH0::release(other));
+  CHECK(!ETH0::release(frames[0].data + 1));
+  CHECK(!ETH0::release(frames[0].data + ETH_BUFFER_SIZE / 2));
+  CHECK(!ETH0::release(EthModel::getArmedBuffer()));
+
+  CHECK(ETH0::release(frames[0].data));
+  CHECK(!ETH0::release(frames[0].data));
+  CHECK(Lock::taken > taken);
+
+  // The spare buffer count didn't move on the rejected calls
+  CHECK(ETH0::receive(frame) && (frame.data[0] == 0xFF));
+  CHECK(!ETH0::receive(frame));
+  CHECK(!ETH0::release(frame.data + ETH_BUFFER_SIZE * RX_BUFFERS));
+
+  for (u8 i = 1; i < RX_BUFFERS - RX_DESCRIPTORS; i++) {
+    CHECK(ETH0::release(frames[i].data));
+  }
+
+  CHECK(ETH0::release(frame.data));
+  CHECK(!Lock::held);
+}
+
+/**
+ * @brief Coarse corrections both ways, with and without a borrow or a
+ *        carry, and whole seconds.
+ */
+static void testAdjustTime()
+{
+  struct Case {
+      s64 offset;
+      u32 seconds;
+      u32 nanoseconds;
+  };
+
+  // From 100.000000500 s
+  static Case const cases[] = {
+    { 250, 100, 750 },
+    { -250, 100, 250 },
+    { -500, 100, 0 },
+    { -501, 99, 999999999 },
+    { 999999600, 101, 100 },
+    { -2000000000, 98, 500 },
+    { 3000000000ll, 103, 500 },
+    { -1000000600, 98, 999999900 },
+    { -100000000500ll, 0, 0 },
+  };
+
+  start();
+  PTP::initialize();
+
+  for (u8 i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    eth::Timestamp const origin = { 100, 500 };
+    eth::Timestamp time;
+
+    PTP::setTime(origin);
+    PTP::adjustTime(cases[i].offset);
+    PTP::getTime(time);
+
+    CHECK((time.seconds == cases[i].seconds) &&
+        (time.nanoseconds == cases[i].nanoseconds));
+    CHECK(s64(PTP::getNanoseconds()) == 100000000500ll + cases[i].offset);
+  }
+}
+
+int main()
+{
+  EthModel::mapPeripherals();
+
+  testTransmitRing();
+  testReceiveRing();
+  testRelease();
+  testAdjustTime();
+
+  return check::report("eth");
+}
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *                    Fault record decoder, host unit test
+ *
+ ******************************************************************************/
+
+#include <cstring>
+#include <string>
+
+#include "check.hpp"
+
+#include "fault_record.hpp"
+
+struct Console {
+    static std::string text;
+
+    static bool canSendDataYet()
+    {
+      return true;
+    }
+
+    static void sendData(u8 const data)
+    {
+      text += char(data);
+    }
+};
+
+std::string Console::text;
+
+static fault::Record makeRecord()
+{
+  fault::Record record;
+
+  std::memset(&record, 0, sizeof(record));
+
+  record.exception = 4;
+  record.pc = 0x08000ABC;
+  record.lr = 0x08000123;
+  record.xpsr = 0x21000000;
+  record.sp = 0x2001FFA0;
+  record.excReturn = 0xFFFFFFF9;
+  // MSTKERR + MMARVALID + DIVBYZERO
+  record.cfsr = (1 << 4) | (1 << 7) | (1 << 25);
+  // FORCED
+  record.hfsr = 1u << 30;
+  record.mmfar = 0x2001FF00;
+  record.r0 = 1;
+  record.r12 = 12;
+  record.depth = 2;
+  record.backtrace[0] = 0x08000200;
+  record.backtrace[1] = 0x08000300;
+
+  return record;
+}
+
+static void testRoundTrip()
+{
+  fault::Record record = makeRecord();
+  fault::Record decoded;
+
+  fault::Decoder::seal(record, fault::RECORD_WORDS);
+
+  CHECK(record.magic == u32(fault::MAGIC));
+  CHECK(record.words == u32(fault::RECORD_WORDS));
+  CHECK(fault::Decoder::decode(
+      reinterpret_cast<u32 const*>(&record), fault::RECORD_WORDS, decoded));
+  CHECK(std::memcmp(&record, &decoded, sizeof(record)) == 0);
+}
+
+static void testCorruption()
+{
+  fault::Record record = makeRecord();
+  fault::Record decoded;
+  u32* const words = reinterpret_cast<u32*>(&record);
+
+  fault::Decoder::seal(record, fault::RECORD_WORDS);
+
+  // Any flipped bit is caught by the checksum
+  for (u32 i = 0; i < fault::RECORD_WORDS; i++) {
+    words[i] ^= u32(1) << (i % 32);
+    CHECK(!fault::Decoder::decode(words, fault::RECORD_WORDS, decoded));
+    CHECK(decoded.magic == 0);
+    words[i] ^= u32(1) << (i % 32);
+  }
+
+  CHECK(fault::Decoder::decode(words, fault::RECORD_WORDS, decoded));
+
+  // Fewer words available than stored
+  CHECK(!fault::Decoder::decode(words, fault::RECORD_WORDS - 1, decoded));
+  CHECK(!fault::Decoder::decode(words, 2, decoded));
+
+  // Erased backup memory
+  std::memset(words, 0xFF, sizeof(record));
+  CHECK(!fault::Decoder::decode(words, fault::RECORD_WORDS, decoded));
+}
+
+static void testTruncated()
+{
+  // e.g. the F1 backup registers, which don't hold the whole record
+  u32 const capacity = 16;
+  fault::Record record = makeRecord();
+  fault::Record decoded;
+
+  fault::Decoder::seal(record, capacity);
+
+  CHECK(fault::Decoder::decode(
+      reinterpret_cast<u32 const*>(&record), capacity, decoded));
+  CHECK(decoded.words == capacity);
+  CHECK(decoded.pc == record.pc);
+  CHECK(decoded.r2 == record.r2);
+  // Not stored
+  CHECK(decoded.r12 == 0);
+  CHECK(decoded.depth == 0);
+}
+
+static void testCauses()
+{
+  fault::Record const record = makeRecord();
+  u32 const causes = fault::Decoder::getCauses(record);
+
+  CHECK(causes == ((1u << 4) | (1u << 25) | (1u << 31)));
+  CHECK(std::strcmp(fault::Decoder::getCauseName(4), "MSTKERR") == 0);
+  CHECK(std::strcmp(fault::Decoder::getCauseName(25), "DIVBYZERO") == 0);
+  CHECK(std::strcmp(fault::Decoder::getCauseName(30), "VECTTBL") == 0);
+  CHECK(std::strcmp(fault::Decoder::getCauseName(31), "FORCED") == 0);
+  CHECK(fault::Decoder::getCauseName(7) == 0);
+  CHECK(fault::Decoder::getCauseName(32) == 0);
+
+  CHECK(std::strcmp(fault::Decoder::getExceptionName(3), "HardFault") == 0);
+  CHECK(std::strcmp(fault::Decoder::getExceptionName(6), "UsageFault") == 0);
+  CHECK(std::strcmp(fault::Decoder::getExceptionName(0), "?") == 0);
+  CHECK(std::strcmp(fault::Decoder::getExceptionName(7), "?") == 0);
+}
+
+static void testDump()
+{
+  fault::Record const record = makeRecord();
+
+  Console::text.clear();
+  fault::Decoder::dump<Console>(record);
+
+  CHECK(Console::text ==
+      "MemManage\r\n"
+      "pc 0x08000ABC\r\n"
+      "lr 0x08000123\r\n"
+      "xpsr 0x21000000\r\n"
+      "sp 0x2001FFA0\r\n"
+      "exc_return 0xFFFFFFF9\r\n"
+      "cfsr 0x02000090\r\n"
+      "hfsr 0x40000000\r\n"
+      "mmfar 0x2001FF00\r\n"
+      "bfar 0x00000000\r\n"
+      "r0 0x00000001\r\n"
+      "r1 0x00000000\r\n"
+      "r2 0x00000000\r\n"
+      "r3 0x00000000\r\n"
+      "r12 0x0000000C\r\n"
+      "cause MSTKERR\r\n"
+      "cause DIVBYZERO\r\n"
+      "cause FORCED\r\n"
+      "#0 0x08000200\r\n"
+      "#1 0x08000300\r\n");
+}
+
+int main()
+{
+  testRoundTrip();
+  testCorruption();
+  testTruncated();
+  testCauses();
+  testDump();
+
+  return check::report("fault");
+}
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *               Flash sector layout and flash model, host unit test
+ *
+ ******************************************************************************/
+
+#include "check.hpp"
+#include "flash_model.hpp"
+
+/**
+ * The sector layout of RM0090, both banks.
+ */
+static void testSectors()
+{
+  static u32 const addresses[] = {
+      0x08000000, 0x08004000, 0x08008000, 0x0800C000, 0x08010000, 0x08020000,
+      0x08040000, 0x08060000, 0x08080000, 0x080A0000, 0x080C0000, 0x080E0000
+  };
+
+  for (u8 bank = 0; bank < 2; bank++) {
+    for (u8 i = 0; i < 12; i++) {
+      u8 const sector = 12 * bank + i;
+      u32 const address = addresses[i] + bank * 0x100000;
+      u32 const size = i < 4 ? 0x4000 : i == 4 ? 0x10000 : 0x20000;
+
+      CHECK(FLASH::getSectorAddress(sector) == address);
+      CHECK(FLASH::getSectorSize(sector) == size);
+      CHECK(FLASH::getSector(address) == sector);
+      CHECK(FLASH::getSector(address + size - 1) == sector);
+    }
+  }
+
+  static_assert(FLASH::getSector(0x08008000) == 2,
+      "The layout is usable in constant expressions.");
+}
+
+static void testParallelism()
+{
+  CHECK(FLASH::getParallelism() == flash::cr::psize::X32);
+  CHECK(FLASH::getProgrammingUnit() == 4);
+
+  FLASH::setParallelism(flash::cr::psize::X8);
+  CHECK(FLASH::getProgrammingUnit() == 1);
+  FLASH::setParallelism(flash::cr::psize::X64);
+  CHECK(FLASH::getProgrammingUnit() == 8);
+  FLASH::setParallelism(flash::cr::psize::X32);
+}
+
+static void testModel()
+{
+  u32 const address = FLASH::getSectorAddress(2);
+  u8 const* const memory = FlashModel::getPointer(address);
+  u8 const data[] = { 0x12, 0x34, 0x56, 0x78, 0xF0, 0xF0, 0xF0, 0xF0 };
+  u8 const more[] = { 0x0F, 0x0F, 0x0F, 0x0F };
+
+  FlashModel::initialize();
+
+  CHECK(memory[0] == 0xFF);
+  CHECK(!FlashModel::program(address, data, sizeof(data)));
+  FlashModel::unlock();
+  CHECK(!FlashModel::program(address + 2, data, 4));
+  CHECK(!FlashModel::program(address, data, 6));
+  CHECK(FlashModel::program(address, data, sizeof(data)));
+  CHECK(std::memcmp(memory, data, sizeof(data)) == 0);
+  CHECK(FlashModel::getViolations() == 0);
+
+  // Only clears bits
+  CHECK(FlashModel::program(address + 4, more, sizeof(more)));
+  CHECK(memory[4] == 0x00);
+  CHECK(FlashModel::getViolations() == 4);
+
+  CHECK(FlashModel::eraseSector(2));
+  CHECK(memory[0] == 0xFF);
+  CHECK(memory[FLASH::getSectorSize(2) - 1] == 0xFF);
+  CHECK(FlashModel::getErases(2) == 1);
+  CHECK(FlashModel::getOperations() == 4);
+
+  // Torn program
+  bool cut = false;
+
+  FlashModel::cutPowerAfter(2);
+
+  try {
+    FlashModel::program(address, data, sizeof(data));
+  } catch (FlashModel::PowerCut const&) {
+    cut = true;
+  }
+
+  CHECK(cut);
+  CHECK(std::memcmp(memory, data, 4) == 0);
+  CHECK(memory[4] == 0xF0);
+  CHECK(memory[5] == 0xFF);
+
+  // Torn erase
+  cut = false;
+  FlashModel::cutPowerAfter(1);
+
+  try {
+    FlashModel::eraseSector(2);
+  } catch (FlashModel::PowerCut const&) {
+    cut = true;
+  }
+
+  CHECK(cut);
+  CHECK(memory[0] == 0xFF);
+
+  FlashModel::lock();
+  CHECK(!FlashModel::eraseSector(2));
+}
+
+int main()
+{
+  testSectors();
+  testParallelism();
+  testModel();
+
+  return check::report("flash");
+}
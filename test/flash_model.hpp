@@ -0,0 +1,267 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *                   Model of the internal flash, for host tests
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <sys/mman.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "peripheral/flash.hpp"
+
+/**
+ * Stands in for FLASH in the code that programs the flash (F2/F4 layout):
+ *
+ *   typedef kvstore::Store<0x08008000, 0x4000, 2, 64, FlashModel> STORE;
+ *
+ * The memory is mapped at its real address, so it's read as on the device.
+ * As a NOR flash, programming can only clear bits and erasing sets a whole
+ * sector to 0xFF. Writing a 1 over a 0 is counted as a violation, the
+ * programmed value is still the AND of both.
+ *
+ * A power cut can be scheduled after a number of unit programs and sector
+ * erases. The operation that is interrupted is left half done, and
+ * FlashModel::PowerCut is thrown, the test then "reboots" the code under
+ * test:
+ *
+ *   FlashModel::cutPowerAfter(100);
+ *
+ *   try {
+ *     ...
+ *   } catch (FlashModel::PowerCut const&) {
+ *     STORE::initialize();
+ *   }
+ */
+class FlashModel {
+  public:
+    enum {
+      SIZE = flash::BANK_SIZE,
+      SECTORS = flash::SECTORS_PER_BANK
+    };
+
+    struct PowerCut {
+    };
+
+    /**
+     * @brief Maps the memory on the first use, and erases it.
+     */
+    static void initialize()
+    {
+      static void* const memory = map();
+
+      std::memset(memory, 0xFF, SIZE);
+      std::memset(erases, 0, sizeof(erases));
+      locked = true;
+      countdown = 0;
+      operations = 0;
+      violations = 0;
+    }
+
+    static void unlock()
+    {
+      locked = false;
+    }
+
+    static void lock()
+    {
+      locked = true;
+    }
+
+    static bool isLocked()
+    {
+      return locked;
+    }
+
+    static u8 getProgrammingUnit()
+    {
+      return FLASH::getProgrammingUnit();
+    }
+
+    /**
+     * @brief Same contract as FLASH::program(), fails if the flash is locked
+     *        or the access misaligned.
+     */
+    static bool program(u32 const address, void const* const data, u32 size)
+    {
+      u8 const unit = getProgrammingUnit();
+      u8 const* source = static_cast<u8 const*>(data);
+
+      if (locked || (address % unit != 0) || (size % unit != 0) ||
+          !contains(address, size)) {
+        return false;
+      }
+
+      for (u32 offset = 0; offset < size; offset += unit) {
+        u8* const target = getPointer(address + offset);
+        bool const cut = tick();
+
+        for (u8 i = 0; i < unit; i++) {
+          if (source[offset + i] & ~target[i]) {
+            violations++;
+          }
+
+          // A torn unit only gets some of its bits cleared
+          if (!cut || (i % 2 == 0)) {
+            target[i] &= source[offset + i];
+          }
+        }
+
+        if (cut) {
+          throw PowerCut();
+        }
+      }
+
+      return true;
+    }
+
+    /**
+     * @brief Erases the sector number <sector>, fails if the flash is
+     *        locked.
+     */
+    static bool eraseSector(u8 const sector)
+    {
+      u32 const size = getSectorSize(sector);
+      u8* const target = getPointer(getSectorAddress(sector));
+
+      if (locked || (sector >= SECTORS)) {
+        return false;
+      }
+
+      erases[sector]++;
+
+      if (tick()) {
+        // Interrupted halfway
+        std::memset(target, 0xFF, size / 2);
+        throw PowerCut();
+      }
+
+      std::memset(target, 0xFF, size);
+
+      return true;
+    }
+
+    static constexpr u8 getSector(u32 const address)
+    {
+      return FLASH::getSector(address);
+    }
+
+    static constexpr u32 getSectorAddress(u8 const sector)
+    {
+      return FLASH::getSectorAddress(sector);
+    }
+
+    static constexpr u32 getSectorSize(u8 const sector)
+    {
+      return FLASH::getSectorSize(sector);
+    }
+
+    /**
+     * @brief Cuts the power during the <count>th next operation, 0 never.
+     */
+    static void cutPowerAfter(u32 const count)
+    {
+      countdown = count;
+    }
+
+    /**
+     * @brief Returns the number of unit programs and erases done so far.
+     */
+    static u32 getOperations()
+    {
+      return operations;
+    }
+
+    static u32 getErases(u8 const sector)
+    {
+      return erases[sector];
+    }
+
+    static u32 getViolations()
+    {
+      return violations;
+    }
+
+    static u8* getPointer(u32 const address)
+    {
+      return reinterpret_cast<u8*>(uintptr_t(address));
+    }
+
+  private:
+    FlashModel();
+
+    static bool locked;
+    static u32 countdown;
+    static u32 operations;
+    static u32 violations;
+    static u32 erases[SECTORS];
+
+    static void* map()
+    {
+      void* const memory = mmap(
+          getPointer(flash::MEMORY), SIZE, PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+      if (memory != getPointer(flash::MEMORY)) {
+        std::printf("The flash model can't be mapped at 0x%08X\n",
+                    unsigned(flash::MEMORY));
+        std::exit(1);
+      }
+
+      return memory;
+    }
+
+    static bool contains(u32 const address, u32 const size)
+    {
+      return (address >= flash::MEMORY) &&
+          (address + size <= flash::MEMORY + SIZE);
+    }
+
+    /**
+     * @brief Counts an operation, returns true if the power is cut during
+     *        it.
+     */
+    static bool tick()
+    {
+      operations++;
+
+      if (countdown == 0) {
+        return false;
+      }
+
+      return --countdown == 0;
+    }
+};
+
+bool FlashModel::locked;
+u32 FlashModel::countdown;
+u32 FlashModel::operations;
+u32 FlashModel::violations;
+u32 FlashModel::erases[SECTORS];
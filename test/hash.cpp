@@ -0,0 +1,693 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *     HASH driver on a model of the peripheral (FIPS 180, RFC 1321/2202)
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+#include "digest.hpp"
+#include "../memorymap/hash.hpp"
+
+/**
+ * Behaves like the HASH peripheral as seen through its registers, the digests
+ * being computed by the software implementation: the 8-bit data swapping,
+ * the number of valid bits of the last word, the HMAC inner key, message and
+ * outer key steps, and the context swap registers, which hold the whole
+ * state of the digest. The calculations are immediate, it's never busy.
+ *
+ * The misuses of the peripheral are counted in <errors>.
+ */
+class HashModel {
+  public:
+    struct Control {
+        u32 value;
+
+        operator u32() const
+        {
+          return value;
+        }
+
+        Control& operator=(u32 const cr)
+        {
+          HashModel::write(cr);
+          return *this;
+        }
+
+        Control& operator|=(u32 const mask)
+        {
+          HashModel::write(value | mask);
+          return *this;
+        }
+
+        Control& operator&=(u32 const mask)
+        {
+          HashModel::write(value & mask);
+          return *this;
+        }
+    };
+
+    struct Input {
+        Input& operator=(u32 const word)
+        {
+          HashModel::push(word);
+          return *this;
+        }
+    };
+
+    struct Start {
+        u32 value;
+
+        operator u32() const
+        {
+          return value;
+        }
+
+        Start& operator=(u32 const str)
+        {
+          value = str & hash::str::nblw::MASK;
+
+          if (str & hash::str::dcal::MASK) {
+            HashModel::calculate();
+          }
+
+          return *this;
+        }
+    };
+
+    struct Status {
+        operator u32()
+        {
+          return HashModel::getStatus();
+        }
+    };
+
+    struct Registers {
+        Control CR;
+        Input DIN;
+        Start STR;
+        u32 HR[5];
+        u32 IMR;
+        Status SR;
+        u32 _RESERVED[52];
+        u32 CSR[hash::csr::SIZE];
+    };
+
+    enum {
+      // Polls of SR without a digest before giving up
+      MAX_POLLS = 1000
+    };
+
+    static Registers registers;
+    static u32 errors;
+
+    static void reset()
+    {
+      registers = Registers();
+      received.clear();
+      complete = false;
+      polls = 0;
+      errors = 0;
+    }
+
+  private:
+    enum Phase {
+      KEY,
+      MESSAGE,
+      OUTER_KEY,
+      DONE
+    };
+
+    struct Digest {
+        u32 phase;
+        u32 held;  // Last word written to DIN
+        u32 holding;
+        u8 key[digest::BLOCK_SIZE];
+        u8 inner[digest::Sha1::SIZE];
+        union {
+            digest::Hash<digest::Sha1> sha1;
+            digest::Hash<digest::Md5> md5;
+        };
+    };
+
+    static_assert(sizeof(Digest) <= sizeof(u32) * hash::csr::SIZE,
+        "The digest must fit in the context swap registers.");
+
+    // Key bytes being received, only between two DCAL of the same call
+    static std::vector<u8> received;
+    static bool complete;
+    static u32 polls;
+
+    static Digest load()
+    {
+      Digest current;
+
+      std::memcpy(&current, registers.CSR, sizeof(current));
+
+      return current;
+    }
+
+    static void store(Digest const& current)
+    {
+      std::memcpy(registers.CSR, &current, sizeof(current));
+    }
+
+    static bool isMd5()
+    {
+      return (registers.CR.value & hash::cr::algo::MASK) ==
+          hash::cr::algo::MD5;
+    }
+
+    static bool isHmac()
+    {
+      return (registers.CR.value & hash::cr::mode::MASK) ==
+          hash::cr::mode::HMAC_MODE;
+    }
+
+    static u8 getSize()
+    {
+      return isMd5() ? u8(digest::Md5::SIZE) : u8(digest::Sha1::SIZE);
+    }
+
+    static void begin(Digest& current)
+    {
+      if (isMd5()) {
+        current.md5.init();
+      } else {
+        current.sha1.init();
+      }
+    }
+
+    static void feed(Digest& current, void const* const data, u32 const size)
+    {
+      if (isMd5()) {
+        current.md5.update(data, size);
+      } else {
+        current.sha1.update(data, size);
+      }
+    }
+
+    static void end(Digest& current, u8* const result)
+    {
+      if (isMd5()) {
+        current.md5.final(result);
+      } else {
+        current.sha1.final(result);
+      }
+    }
+
+    static void write(u32 const cr)
+    {
+      registers.CR.value = cr & ~hash::cr::init::MASK;
+
+      if (cr & hash::cr::init::MASK) {
+        Digest current = Digest();
+
+        current.phase = isHmac() ? KEY : MESSAGE;
+
+        if (current.phase == MESSAGE) {
+          begin(current);
+        }
+
+        store(current);
+        received.clear();
+        complete = false;
+        polls = 0;
+      }
+    }
+
+    static u32 getStatus()
+    {
+      if (complete) {
+        return hash::sr::dcis::MASK;
+      }
+
+      // Waiting for a digest that will never come
+      if (++polls == MAX_POLLS) {
+        errors++;
+        complete = true;
+      }
+
+      return 0;
+    }
+
+    static void push(u32 const word)
+    {
+      Digest current = load();
+
+      if ((registers.CR.value & hash::cr::datatype::MASK) !=
+          hash::cr::datatype::_8_BIT_DATA) {
+        errors++;
+      }
+
+      if (current.holding) {
+        accept(current, 4);
+      }
+
+      current.held = word;
+      current.holding = 1;
+      store(current);
+    }
+
+    /**
+     * @brief Takes the first <size> bytes of the held word, the first byte
+     *        being the least significant one in 8-bit data mode.
+     */
+    static void accept(Digest& current, u8 const size)
+    {
+      u8 bytes[4];
+
+      for (u8 i = 0; i < 4; i++) {
+        bytes[i] = current.held >> (8 * i);
+      }
+
+      current.holding = 0;
+
+      switch (current.phase) {
+        case MESSAGE:
+          feed(current, bytes, size);
+          break;
+        case KEY:
+        case OUTER_KEY:
+          received.insert(received.end(), bytes, bytes + size);
+          break;
+        default:
+          errors++;
+          break;
+      }
+    }
+
+    /**
+     * @brief Pads the received key to a block, a key longer than a block is
+     *        hashed first.
+     */
+    static void toKeyBlock(u8* const block)
+    {
+      bool const longKey = received.size() > digest::BLOCK_SIZE;
+
+      if (longKey !=
+          ((registers.CR.value & hash::cr::lkey::MASK) ==
+              hash::cr::lkey::LONG_KEY)) {
+        errors++;
+      }
+
+      std::memset(block, 0, digest::BLOCK_SIZE);
+
+      if (longKey) {
+        Digest key;
+
+        begin(key);
+        feed(key, received.data(), received.size());
+        end(key, block);
+      } else {
+        std::memcpy(block, received.data(), received.size());
+      }
+
+      received.clear();
+    }
+
+    static void feedKeyBlock(Digest& current, u8 const pad)
+    {
+      u8 block[digest::BLOCK_SIZE];
+
+      for (u8 i = 0; i < digest::BLOCK_SIZE; i++) {
+        block[i] = current.key[i] ^ pad;
+      }
+
+      feed(current, block, sizeof(block));
+    }
+
+    static void publish(Digest& current)
+    {
+      u8 result[digest::Sha1::SIZE];
+
+      end(current, result);
+
+      for (u8 i = 0; i < getSize() / 4; i++) {
+        registers.HR[i] = (u32(result[4 * i]) << 24) +
+            (result[4 * i + 1] << 16) + (result[4 * i + 2] << 8) +
+            result[4 * i + 3];
+      }
+
+      current.phase = DONE;
+      complete = true;
+    }
+
+    static void calculate()
+    {
+      Digest current = load();
+      u32 const nblw = registers.STR.value & hash::str::nblw::MASK;
+      u8 key[digest::BLOCK_SIZE];
+
+      if (nblw % 8 != 0) {
+        errors++;
+      }
+
+      if (current.holding) {
+        accept(current, nblw == 0 ? 4 : nblw / 8);
+      } else if (nblw != 0) {
+        errors++;
+      }
+
+      switch (current.phase) {
+        case KEY:
+          toKeyBlock(current.key);
+          begin(current);
+          feedKeyBlock(current, 0x36);
+          current.phase = MESSAGE;
+          break;
+        case MESSAGE:
+          if (isHmac()) {
+            end(current, current.inner);
+            current.phase = OUTER_KEY;
+          } else {
+            publish(current);
+          }
+          break;
+        case OUTER_KEY:
+          // Must be the key of the inner hash
+          toKeyBlock(key);
+
+          if (std::memcmp(key, current.key, sizeof(key)) != 0) {
+            errors++;
+          }
+
+          begin(current);
+          feedKeyBlock(current, 0x5C);
+          feed(current, current.inner, getSize());
+          publish(current);
+          break;
+        default:
+          errors++;
+          break;
+      }
+
+      store(current);
+    }
+};
+
+HashModel::Registers HashModel::registers;
+u32 HashModel::errors;
+std::vector<u8> HashModel::received;
+bool HashModel::complete;
+u32 HashModel::polls;
+
+#define HASH_REGS (&HashModel::registers)
+
+#include "peripheral/hash.hpp"
+
+static std::string toHex(u8 const* bytes, u32 const size)
+{
+  std::string hex;
+
+  for (u32 i = 0; i < size; i++) {
+    char digits[3];
+
+    std::snprintf(digits, sizeof(digits), "%02x", bytes[i]);
+    hex += digits;
+  }
+
+  return hex;
+}
+
+/**
+ * @brief Feeds <message> to the driver, <chunk> bytes per update() call.
+ */
+static void feed(std::string const& message, u32 const chunk)
+{
+  for (u32 offset = 0; offset < message.size();) {
+    u32 const size = (chunk == 0) || (message.size() - offset < chunk) ?
+        message.size() - offset : chunk;
+
+    HASH::update(message.data() + offset, size);
+    offset += size;
+  }
+}
+
+static std::string finish(hash::cr::algo::States const ALGO)
+{
+  u8 result[hash::SHA1_SIZE];
+
+  HASH::final(result);
+
+  CHECK(HashModel::errors == 0);
+
+  return toHex(result,
+      ALGO == hash::cr::algo::MD5 ? hash::MD5_SIZE : hash::SHA1_SIZE);
+}
+
+static std::string digestOf(
+    hash::cr::algo::States const ALGO,
+    std::string const& message,
+    u32 const chunk = 0)
+{
+  HashModel::reset();
+  HASH::init(ALGO);
+  feed(message, chunk);
+
+  return finish(ALGO);
+}
+
+static std::string hmacOf(
+    hash::cr::algo::States const ALGO,
+    std::string const& key,
+    std::string const& message,
+    u32 const chunk = 0)
+{
+  HashModel::reset();
+  HASH::init(ALGO, key.data(), key.size());
+  feed(message, chunk);
+
+  return finish(ALGO);
+}
+
+template<typename ALGORITHM>
+static std::string reference(std::string const& message)
+{
+  digest::Hash<ALGORITHM> hash;
+  u8 result[ALGORITHM::SIZE];
+
+  hash.init();
+  hash.update(message.data(), message.size());
+  hash.final(result);
+
+  return toHex(result, sizeof(result));
+}
+
+template<typename ALGORITHM>
+static std::string reference(
+    std::string const& key,
+    std::string const& message)
+{
+  digest::Hmac<ALGORITHM> hmac;
+  u8 result[ALGORITHM::SIZE];
+
+  hmac.init(key.data(), key.size());
+  hmac.update(message.data(), message.size());
+  hmac.final(result);
+
+  return toHex(result, sizeof(result));
+}
+
+static void testSha1()
+{
+  // FIPS 180-2 appendix A, and the empty message
+  CHECK(digestOf(hash::cr::algo::SHA1, "abc") ==
+      "a9993e364706816aba3e25717850c26c9cd0d89d");
+  CHECK(digestOf(hash::cr::algo::SHA1,
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+      "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+  CHECK(digestOf(hash::cr::algo::SHA1, std::string(1000000, 'a'), 1000) ==
+      "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+  CHECK(digestOf(hash::cr::algo::SHA1, "") ==
+      "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+}
+
+static void testMd5()
+{
+  // RFC 1321 appendix A.5
+  CHECK(digestOf(hash::cr::algo::MD5, "") ==
+      "d41d8cd98f00b204e9800998ecf8427e");
+  CHECK(digestOf(hash::cr::algo::MD5, "a") ==
+      "0cc175b9c0f1b6a831c399e269772661");
+  CHECK(digestOf(hash::cr::algo::MD5, "abc") ==
+      "900150983cd24fb0d6963f7d28e17f72");
+  CHECK(digestOf(hash::cr::algo::MD5, "message digest") ==
+      "f96b697d7cb7938d525a2f31aaf161d0");
+  CHECK(digestOf(hash::cr::algo::MD5, "abcdefghijklmnopqrstuvwxyz") ==
+      "c3fcd3d76192e4007dfb496cca67e13b");
+  CHECK(digestOf(hash::cr::algo::MD5,
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789") ==
+      "d174ab98d277d9f5a5611c2c9f419d9f");
+  CHECK(digestOf(hash::cr::algo::MD5,
+      "1234567890123456789012345678901234567890"
+      "1234567890123456789012345678901234567890") ==
+      "57edf4a22be3c955ac49da2e2107b67a");
+}
+
+/**
+ * Every length of the last word (NBLW), reached by updates of every size
+ * relative to the words.
+ */
+static void testPartialWords()
+{
+  std::string message;
+
+  for (u32 i = 0; i < 70; i++) {
+    message += char(i * 7);
+  }
+
+  for (u32 size = 0; size <= message.size(); size++) {
+    std::string const part = message.substr(0, size);
+
+    for (u32 chunk = 0; chunk <= 5; chunk++) {
+      CHECK(digestOf(hash::cr::algo::SHA1, part, chunk) ==
+          reference<digest::Sha1>(part));
+      CHECK(digestOf(hash::cr::algo::MD5, part, chunk) ==
+          reference<digest::Md5>(part));
+    }
+  }
+}
+
+static void testHmac()
+{
+  std::string key25;
+
+  for (char i = 1; i <= 25; i++) {
+    key25 += i;
+  }
+
+  // RFC 2202 section 3, HMAC-SHA-1
+  CHECK(hmacOf(hash::cr::algo::SHA1, std::string(20, 0x0B), "Hi There") ==
+      "b617318655057264e28bc0b6fb378c8ef146be00");
+  CHECK(hmacOf(hash::cr::algo::SHA1, "Jefe",
+      "what do ya want for nothing?", 3) ==
+      "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79");
+  CHECK(hmacOf(hash::cr::algo::SHA1, std::string(20, '\xAA'),
+      std::string(50, '\xDD')) ==
+      "125d7342b9ac11cd91a39af48aa17b4f63f175d3");
+  CHECK(hmacOf(hash::cr::algo::SHA1, key25, std::string(50, '\xCD'), 7) ==
+      "4c9007f4026250c6bc8414f9bf50c86c2d7235da");
+  CHECK(hmacOf(hash::cr::algo::SHA1, std::string(20, 0x0C),
+      "Test With Truncation") ==
+      "4c1a03424b55e07fe7f27be1d58bb9324a9a5a04");
+  CHECK(hmacOf(hash::cr::algo::SHA1, std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key - Hash Key First") ==
+      "aa4ae5e15272d00e95705637ce8a3b55ed402112");
+  CHECK(hmacOf(hash::cr::algo::SHA1, std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key and Larger Than One "
+      "Block-Size Data", 5) ==
+      "e8e99d0f45237d786d6bbaa7965c7808bbff1a91");
+
+  // RFC 2202 section 2, HMAC-MD5
+  CHECK(hmacOf(hash::cr::algo::MD5, std::string(16, 0x0B), "Hi There") ==
+      "9294727a3638bb1c13f48ef8158bfc9d");
+  CHECK(hmacOf(hash::cr::algo::MD5, "Jefe",
+      "what do ya want for nothing?", 3) ==
+      "750c783e6ab0b503eaa86e310a5db738");
+  CHECK(hmacOf(hash::cr::algo::MD5, std::string(16, '\xAA'),
+      std::string(50, '\xDD')) ==
+      "56be34521d144c88dbb8c733f0e8b3f6");
+  CHECK(hmacOf(hash::cr::algo::MD5, key25, std::string(50, '\xCD'), 7) ==
+      "697eaf0aca3a3aea3a75164746ffaa79");
+  CHECK(hmacOf(hash::cr::algo::MD5, std::string(16, 0x0C),
+      "Test With Truncation") ==
+      "56461ef2342edc00f9bab995690efd4c");
+  CHECK(hmacOf(hash::cr::algo::MD5, std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key - Hash Key First") ==
+      "6b1ab7fe4bd7bf8f0b62e6ce61b9d0cd");
+  CHECK(hmacOf(hash::cr::algo::MD5, std::string(80, '\xAA'),
+      "Test Using Larger Than Block-Size Key and Larger Than One "
+      "Block-Size Data", 5) ==
+      "6f630fad67cda0ee1fb1f562db3aa53e");
+
+  // Both sides of the long key limit, and keys that don't fill a word
+  for (u32 size = 61; size <= 67; size++) {
+    std::string const key(size, char(size));
+
+    CHECK(hmacOf(hash::cr::algo::SHA1, key, "message", 2) ==
+        reference<digest::Sha1>(key, "message"));
+    CHECK(hmacOf(hash::cr::algo::MD5, key, "message", 2) ==
+        reference<digest::Md5>(key, "message"));
+  }
+}
+
+/**
+ * Two digests interleaved by swapping the context between updates that leave
+ * bytes held in the driver.
+ */
+static void testSaveRestore()
+{
+  std::string const message =
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  std::string const data = "what do ya want for nothing?";
+  hash::Context sha1;
+  hash::Context hmac;
+
+  HashModel::reset();
+
+  HASH::init(hash::cr::algo::SHA1);
+  HASH::save(sha1);
+  HASH::init(hash::cr::algo::MD5, "Jefe", 4);
+  HASH::save(hmac);
+
+  for (u32 offset = 0; offset < message.size(); offset += 3) {
+    HASH::restore(sha1);
+    HASH::update(message.data() + offset,
+        message.size() - offset < 3 ? message.size() - offset : 3);
+    HASH::save(sha1);
+
+    if (offset < data.size()) {
+      HASH::restore(hmac);
+      HASH::update(data.data() + offset,
+          data.size() - offset < 3 ? data.size() - offset : 3);
+      HASH::save(hmac);
+    }
+  }
+
+  HASH::restore(hmac);
+  CHECK(finish(hash::cr::algo::MD5) == "750c783e6ab0b503eaa86e310a5db738");
+
+  HASH::restore(sha1);
+  CHECK(finish(hash::cr::algo::SHA1) ==
+      "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+}
+
+int main()
+{
+  testSha1();
+  testMd5();
+  testPartialWords();
+  testHmac();
+  testSaveRestore();
+
+  return check::report("hash");
+}
@@ -0,0 +1,162 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *
+ *                   Tickless idle deadline arithmetic
+ *
+ ******************************************************************************/
+
+#include "check.hpp"
+
+#include "idle.hpp"
+
+enum {
+  TICK_FREQUENCY = 1000,
+  WAKEUP_FREQUENCY = 32768 / 16,
+  MIN_SLEEP_TICKS = 10
+};
+
+/**
+ * @brief The wakeup timer never fires after the deadline, and saturates at
+ *        its reload range.
+ */
+static void testWakeupCounts()
+{
+  // 2.048 counts per tick
+  CHECK(idle::toWakeupCounts(0, TICK_FREQUENCY, WAKEUP_FREQUENCY) == 0);
+  CHECK(idle::toWakeupCounts(1, TICK_FREQUENCY, WAKEUP_FREQUENCY) == 2);
+  CHECK(idle::toWakeupCounts(9, TICK_FREQUENCY, WAKEUP_FREQUENCY) == 18);
+  CHECK(idle::toWakeupCounts(1000, TICK_FREQUENCY, WAKEUP_FREQUENCY) == 2048);
+
+  for (u32 ticks = 0; ticks <= 32000; ticks += 7) {
+    u32 const counts =
+        idle::toWakeupCounts(ticks, TICK_FREQUENCY, WAKEUP_FREQUENCY);
+
+    // Rounded down: within one count of the deadline, never past it
+    CHECK(u64(counts) * TICK_FREQUENCY <= u64(ticks) * WAKEUP_FREQUENCY);
+    CHECK(u64(counts + 1) * TICK_FREQUENCY > u64(ticks) * WAKEUP_FREQUENCY);
+  }
+
+  CHECK(idle::toWakeupCounts(32000, TICK_FREQUENCY, WAKEUP_FREQUENCY) ==
+      idle::MAX_WAKEUP_COUNTS);
+  CHECK(idle::toWakeupCounts(0xFFFFFFFF, TICK_FREQUENCY, WAKEUP_FREQUENCY) ==
+      idle::MAX_WAKEUP_COUNTS);
+
+  // Units of another clock, e.g. the RTC subseconds at 256 Hz
+  CHECK(idle::toCounts(256, 256, WAKEUP_FREQUENCY) == WAKEUP_FREQUENCY);
+  CHECK(idle::toCounts(1, 256, WAKEUP_FREQUENCY) == 8);
+  CHECK(idle::toCounts(3, 1000, WAKEUP_FREQUENCY) == 6);
+}
+
+/**
+ * @brief Below MIN_SLEEP_TICKS the core doesn't enter STOP, from there on
+ *        it sleeps at least one count, and one tick is kept.
+ */
+static void testMinimumSleep()
+{
+  CHECK(idle::toSleepCounts(0, MIN_SLEEP_TICKS, TICK_FREQUENCY,
+      WAKEUP_FREQUENCY) == 0);
+  CHECK(idle::toSleepCounts(MIN_SLEEP_TICKS - 1, MIN_SLEEP_TICKS,
+      TICK_FREQUENCY, WAKEUP_FREQUENCY) == 0);
+  CHECK(idle::toSleepCounts(MIN_SLEEP_TICKS, MIN_SLEEP_TICKS,
+      TICK_FREQUENCY, WAKEUP_FREQUENCY) == 18);
+
+  // With a coarse wakeup timer, the smallest legal minimum
+  CHECK(idle::toSleepCounts(2, 2, TICK_FREQUENCY, 1024) == 1);
+  CHECK(idle::toSleepCounts(1, 2, TICK_FREQUENCY, 1024) == 0);
+
+  for (u32 ticks = MIN_SLEEP_TICKS; ticks < 20000; ticks += 13) {
+    u32 const counts = idle::toSleepCounts(ticks, MIN_SLEEP_TICKS,
+        TICK_FREQUENCY, WAKEUP_FREQUENCY);
+
+    CHECK(counts != 0);
+    CHECK(u64(counts) * TICK_FREQUENCY <=
+        u64(ticks - 1) * WAKEUP_FREQUENCY);
+  }
+}
+
+/**
+ * @brief The calendar timestamp wraps around at midnight.
+ */
+static void testElapsed()
+{
+  u32 const period = 86400 * 256;
+
+  CHECK(idle::elapsed(100, 100, period) == 0);
+  CHECK(idle::elapsed(100, 350, period) == 250);
+  CHECK(idle::elapsed(period - 10, 0, period) == 10);
+  CHECK(idle::elapsed(period - 10, 25, period) == 35);
+  CHECK(idle::elapsed(period - 1, period - 2, period) == period - 1);
+}
+
+/**
+ * @brief The time base advances by whole ticks, the fractions are carried
+ *        so repeated naps don't drift.
+ */
+static void testCompensation()
+{
+  u32 residue = 0;
+  u64 ticks = 0;
+  u64 counts = 0;
+
+  CHECK(idle::toTicks(2048, TICK_FREQUENCY, WAKEUP_FREQUENCY, residue) ==
+      1000);
+  CHECK(residue == 0);
+
+  // 3 counts are 1.46 ticks
+  CHECK(idle::toTicks(3, TICK_FREQUENCY, WAKEUP_FREQUENCY, residue) == 1);
+  CHECK(residue == 952);
+  CHECK(idle::toTicks(3, TICK_FREQUENCY, WAKEUP_FREQUENCY, residue) == 1);
+  CHECK(residue == 1904);
+  CHECK(idle::toTicks(3, TICK_FREQUENCY, WAKEUP_FREQUENCY, residue) == 2);
+  CHECK(residue == 808);
+
+  residue = 0;
+
+  for (u32 nap = 0; nap < 5000; nap++) {
+    u32 const slept = 1 + (nap * 37) % 700;
+
+    ticks += idle::toTicks(slept, TICK_FREQUENCY, WAKEUP_FREQUENCY, residue);
+    counts += slept;
+
+    CHECK(residue < WAKEUP_FREQUENCY);
+    CHECK(ticks * WAKEUP_FREQUENCY + residue == counts * TICK_FREQUENCY);
+  }
+
+  // The longest nap fits
+  residue = WAKEUP_FREQUENCY - 1;
+
+  CHECK(idle::toTicks(idle::MAX_WAKEUP_COUNTS, TICK_FREQUENCY,
+      WAKEUP_FREQUENCY, residue) == 32000);
+  CHECK(residue == WAKEUP_FREQUENCY - 1);
+}
+
+int main()
+{
+  testWakeupCounts();
+  testMinimumSleep();
+  testElapsed();
+  testCompensation();
+
+  return check::report("idle");
+}
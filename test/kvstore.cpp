@@ -0,0 +1,292 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *
+ *           Key-value store on the flash model, with power cuts
+ *
+ ******************************************************************************/
+
+#include <map>
+#include <vector>
+
+#include "check.hpp"
+#include "flash_model.hpp"
+
+#include "kvstore.hpp"
+
+enum {
+  KEYS = 12,
+  UPDATES = 600
+};
+
+// Sectors 2 and 3, or 1 to 3
+typedef kvstore::Store<0x08008000, 0x4000, 2, 16, FlashModel> STORE;
+typedef kvstore::Store<0x08004000, 0x4000, 3, 16, FlashModel> STORE3;
+
+typedef std::vector<u8> Bytes;
+typedef std::map<u16, Bytes> Values;
+
+struct Update {
+    u16 key;
+    bool remove;
+    Bytes value;
+};
+
+static u32 random(u32& seed)
+{
+  seed = seed * 1664525 + 1013904223;
+
+  return seed >> 8;
+}
+
+static Update makeUpdate(u32& seed)
+{
+  Update update;
+
+  update.key = 1 + random(seed) % KEYS;
+  update.remove = random(seed) % 10 == 0;
+
+  for (u32 size = random(seed) % 61; size != 0; size--) {
+    update.value.push_back(random(seed));
+  }
+
+  return update;
+}
+
+template<typename S>
+static bool apply(Update const& update)
+{
+  if (update.remove) {
+    return S::remove(update.key);
+  }
+
+  return S::set(update.key, update.value.data(), update.value.size());
+}
+
+static void apply(Values& values, Update const& update)
+{
+  if (update.remove) {
+    values.erase(update.key);
+  } else {
+    values[update.key] = update.value;
+  }
+}
+
+/**
+ * @brief Returns true if the store holds exactly <values>.
+ */
+template<typename S>
+static bool matches(Values const& values)
+{
+  for (u16 key = 1; key <= KEYS; key++) {
+    Values::const_iterator const value = values.find(key);
+    u8 buffer[64];
+
+    if (value == values.end()) {
+      if (S::has(key)) {
+        return false;
+      }
+
+      continue;
+    }
+
+    if (!S::has(key) || (S::getSize(key) != value->second.size()) ||
+        (S::get(key, buffer, sizeof(buffer)) != value->second.size()) ||
+        !std::equal(value->second.begin(), value->second.end(), buffer)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Powers the device back on, the store reloads its log.
+ */
+template<typename S>
+static void reboot()
+{
+  FlashModel::cutPowerAfter(0);
+  FlashModel::lock();
+  CHECK(S::initialize());
+}
+
+/**
+ * @brief Runs the update sequence of <seed>, compacting when the store asks
+ *        for it, as an idle loop would.
+ */
+template<typename S>
+static void run(u32 seed, u32 const updates, Values& values)
+{
+  for (u32 i = 0; i < updates; i++) {
+    Update const update = makeUpdate(seed);
+
+    CHECK(apply<S>(update));
+    apply(values, update);
+
+    if (S::needsCompaction()) {
+      CHECK(S::compact());
+    }
+  }
+}
+
+static void testBasics()
+{
+  u8 const gain[] = { 1, 2, 3 };
+  u8 buffer[8] = { 0 };
+
+  FlashModel::initialize();
+  CHECK(STORE::initialize());
+  CHECK(FlashModel::isLocked());
+  CHECK(!STORE::has(1));
+  CHECK(STORE::getSize(1) == 0);
+
+  CHECK(STORE::set(1, gain, sizeof(gain)));
+  CHECK(STORE::set(2, 0, 0));
+  CHECK(STORE::has(1));
+  CHECK(STORE::has(2));
+  CHECK(STORE::getSize(1) == sizeof(gain));
+  CHECK(STORE::get(1, buffer, 2) == 2);
+  CHECK(STORE::get(1, buffer, sizeof(buffer)) == sizeof(gain));
+  CHECK(std::equal(gain, gain + sizeof(gain), buffer));
+
+  CHECK(!STORE::set(kvstore::ERASED, gain, sizeof(gain)));
+  CHECK(!STORE::set(3, gain, kvstore::REMOVED));
+
+  CHECK(STORE::remove(2));
+  CHECK(!STORE::has(2));
+  CHECK(STORE::remove(2));
+
+  reboot<STORE>();
+  CHECK(STORE::has(1));
+  CHECK(!STORE::has(2));
+  CHECK(STORE::get(1, buffer, sizeof(buffer)) == sizeof(gain));
+  CHECK(FlashModel::getViolations() == 0);
+}
+
+/**
+ * The updates wrap around the regions several times, the erases are spread
+ * over all the sectors.
+ */
+static void testCompaction()
+{
+  Values values;
+
+  FlashModel::initialize();
+  CHECK(STORE3::initialize());
+  run<STORE3>(1, 20 * UPDATES, values);
+  CHECK(matches<STORE3>(values));
+
+  reboot<STORE3>();
+  CHECK(matches<STORE3>(values));
+
+  // Forced, and when the region is full
+  CHECK(STORE3::compact());
+  CHECK(matches<STORE3>(values));
+
+  u32 const erases = FlashModel::getErases(1);
+
+  CHECK(erases > 3);
+  CHECK(FlashModel::getErases(2) + 1 >= erases);
+  CHECK(FlashModel::getErases(3) + 1 >= erases);
+  CHECK(FlashModel::getErases(2) <= erases);
+  CHECK(FlashModel::getErases(3) <= erases);
+  CHECK(FlashModel::getViolations() == 0);
+}
+
+/**
+ * Cuts the power during every few flash operations of the update sequence.
+ * After the reboot the store holds either the values before the update that
+ * was interrupted or after it, and keeps working.
+ */
+static void testPowerCuts()
+{
+  Values expected;
+  u32 total;
+
+  FlashModel::initialize();
+  CHECK(STORE::initialize());
+  run<STORE>(2, UPDATES, expected);
+  total = FlashModel::getOperations();
+
+  for (u32 cut = 1; cut <= total; cut += 7) {
+    Values values;
+    Update pending;
+    bool interrupted = false;
+    u32 seed = 2;
+
+    FlashModel::initialize();
+    FlashModel::cutPowerAfter(cut);
+
+    try {
+      STORE::initialize();
+
+      for (u32 i = 0; i < UPDATES; i++) {
+        pending = makeUpdate(seed);
+        interrupted = true;
+        apply<STORE>(pending);
+        apply(values, pending);
+        interrupted = false;
+
+        if (STORE::needsCompaction()) {
+          STORE::compact();
+        }
+      }
+    } catch (FlashModel::PowerCut const&) {
+    }
+
+    reboot<STORE>();
+
+    Values after = values;
+
+    if (interrupted) {
+      apply(after, pending);
+    }
+
+    if (matches<STORE>(values)) {
+      after = values;
+    }
+
+    CHECK(matches<STORE>(after));
+
+    run<STORE>(cut, 50, after);
+    reboot<STORE>();
+    CHECK(matches<STORE>(after));
+    CHECK(FlashModel::getViolations() == 0);
+
+    if (check::failures != 0) {
+      std::printf("power cut during operation %u of %u\n", cut, total);
+      break;
+    }
+  }
+}
+
+int main()
+{
+  testBasics();
+  testCompaction();
+  testPowerCuts();
+
+  return check::report("kvstore");
+}
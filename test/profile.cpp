@@ -0,0 +1,197 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *
+ *                 IRQ profiler table on a fake cycle counter
+ *
+ ******************************************************************************/
+
+#include <string>
+
+#include "check.hpp"
+
+#include "profile.hpp"
+
+/**
+ * Cycle counter moved by hand.
+ */
+struct FakeCounter {
+    static u32 cycles;
+
+    static u32 getCycleCount()
+    {
+      return cycles;
+    }
+};
+
+u32 FakeCounter::cycles;
+
+/**
+ * Collects the text sent by dump().
+ */
+struct FakeOutput {
+    static std::string text;
+
+    static bool canSendDataYet()
+    {
+      return true;
+    }
+
+    static void sendData(u8 const data)
+    {
+      text += char(data);
+    }
+};
+
+std::string FakeOutput::text;
+
+typedef profile::Profiler<FakeCounter, 82> PROFILER;
+
+enum {
+  DMA = nvic::irqn::DMA2_Stream7,
+  UART = nvic::irqn::USART1
+};
+
+/**
+ * @brief Runs the handler of <IRQ> from <entry> for <duration> cycles.
+ */
+template<nvic::irqn::E IRQ>
+static void run(u32 const entry, u32 const duration)
+{
+  FakeCounter::cycles = entry;
+  PROFILER::enter<IRQ>();
+
+  FakeCounter::cycles = entry + duration;
+  PROFILER::exit<IRQ>();
+}
+
+/**
+ * @brief Last, minimum and maximum durations, and the execution count.
+ */
+static void testDuration()
+{
+  PROFILER::clear();
+
+  run<nvic::irqn::DMA2_Stream7>(1000, 100);
+  run<nvic::irqn::DMA2_Stream7>(2000, 50);
+  run<nvic::irqn::DMA2_Stream7>(3000, 300);
+  run<nvic::irqn::DMA2_Stream7>(4000, 120);
+
+  profile::Record const& record = PROFILER::getRecord(DMA);
+
+  CHECK(record.count == 4);
+  CHECK(record.entry == 4000);
+  CHECK(record.duration == 120);
+  CHECK(record.minimum == 50);
+  CHECK(record.maximum == 300);
+
+  // Without a marked request, the latency stays unknown
+  CHECK(record.latency == 0);
+  CHECK(PROFILER::getRecord(UART).count == 0);
+}
+
+/**
+ * @brief Request to entry delay, including a request marked when the
+ *        counter reads 0.
+ */
+static void testLatency()
+{
+  PROFILER::clear();
+
+  FakeCounter::cycles = 500;
+  PROFILER::markRequest<nvic::irqn::DMA2_Stream7>();
+  run<nvic::irqn::DMA2_Stream7>(740, 10);
+
+  CHECK(PROFILER::getRecord(DMA).latency == 240);
+
+  FakeCounter::cycles = 0;
+  PROFILER::markRequest<nvic::irqn::DMA2_Stream7>();
+  run<nvic::irqn::DMA2_Stream7>(35, 10);
+
+  CHECK(PROFILER::getRecord(DMA).latency == 35);
+
+  // An unmarked execution keeps the last latency
+  run<nvic::irqn::DMA2_Stream7>(5000, 10);
+
+  CHECK(PROFILER::getRecord(DMA).latency == 35);
+  CHECK(!PROFILER::getRecord(DMA).pending);
+}
+
+/**
+ * @brief The counter wraps around between the request, the entry and the
+ *        exit.
+ */
+static void testWraparound()
+{
+  PROFILER::clear();
+
+  FakeCounter::cycles = 0xFFFFFFF0;
+  PROFILER::markRequest<nvic::irqn::USART1>();
+  run<nvic::irqn::USART1>(0xFFFFFFFC, 0x104);
+
+  profile::Record const& record = PROFILER::getRecord(UART);
+
+  CHECK(record.latency == 0xC);
+  CHECK(record.duration == 0x104);
+  CHECK(record.minimum == 0x104);
+  CHECK(record.maximum == 0x104);
+
+  FakeCounter::cycles = 0xFFFFFF00;
+  PROFILER::markRequest<nvic::irqn::USART1>();
+  run<nvic::irqn::USART1>(0x100, 0x10);
+
+  CHECK(record.latency == 0x200);
+  CHECK(record.minimum == 0x10);
+  CHECK(record.maximum == 0x104);
+}
+
+/**
+ * @brief One line per executed IRQ.
+ */
+static void testDump()
+{
+  PROFILER::clear();
+
+  FakeCounter::cycles = 100;
+  PROFILER::markRequest<nvic::irqn::USART1>();
+  run<nvic::irqn::USART1>(130, 20);
+  run<nvic::irqn::DMA2_Stream7>(200, 7);
+
+  FakeOutput::text.clear();
+  PROFILER::dump<FakeOutput>();
+
+  CHECK(FakeOutput::text ==
+      "irq count duration minimum maximum latency\r\n"
+      "37 1 20 20 20 30\r\n"
+      "70 1 7 7 7 0\r\n");
+}
+
+int main()
+{
+  testDuration();
+  testLatency();
+  testWraparound();
+  testDump();
+
+  return check::report("profile");
+}
@@ -0,0 +1,271 @@
+/*******************************************************************************
+ *
+ * Copyright (C) 2012 Jorge Aparicio <jorge.aparicio.r@gmail.com>
+ *
+ * This file is part of libstm32pp.
+ *
+ * libstm32pp is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libstm32pp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libstm32pp. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *
+ *          PTP servo and discipline on simulated drifting clocks
+ *
+ ******************************************************************************/
+
+#include "check.hpp"
+
+#include "ptp.hpp"
+
+/**
+ * Stands for critical::Section.
+ */
+struct Lock {
+    static u32 taken;
+
+    Lock()
+    {
+      taken++;
+    }
+};
+
+u32 Lock::taken;
+
+/**
+ * SysTick based system time, moved by hand.
+ */
+struct FakeSystime {
+    static u64 microseconds;
+
+    static u64 getMicroseconds()
+    {
+      return microseconds;
+    }
+};
+
+u64 FakeSystime::microseconds;
+
+/**
+ * PTP clock running <rate> ppb faster than FakeSystime, from <origin>.
+ */
+struct FakeClock {
+    static u64 origin;
+    static s32 rate;
+
+    static u64 getNanoseconds()
+    {
+      s64 const elapsed = FakeSystime::microseconds * 1000;
+
+      return origin + elapsed + elapsed * rate / 1000000000;
+    }
+};
+
+u64 FakeClock::origin;
+s32 FakeClock::rate;
+
+typedef ptp::Discipline<FakeSystime, FakeClock, Lock> DISCIPLINE;
+
+static s64 absolute(s64 const value)
+{
+  return value < 0 ? -value : value;
+}
+
+/**
+ * @brief The first sample and the samples beyond the threshold step the
+ *        clock, and keep the frequency correction.
+ */
+static void testStep()
+{
+  ptp::Servo servo(1000, 500000);
+
+  CHECK(servo.sample(10) == ptp::Servo::STEP);
+  CHECK(servo.getFrequency() == 0);
+
+  CHECK(servo.sample(1000) == ptp::Servo::ADJUST);
+  CHECK(servo.sample(-1000) == ptp::Servo::ADJUST);
+
+  s32 const frequency = servo.getFrequency();
+
+  CHECK(servo.sample(1001) == ptp::Servo::STEP);
+  CHECK(servo.sample(-1001) == ptp::Servo::STEP);
+  CHECK(servo.getFrequency() == frequency);
+
+  servo.reset();
+
+  CHECK(servo.getFrequency() == 0);
+  CHECK(servo.sample(0) == ptp::Servo::STEP);
+}
+
+/**
+ * @brief A local clock ahead of the master is slowed down, and the other
+ *        way around.
+ */
+static void testSign()
+{
+  ptp::Servo ahead;
+  ptp::Servo behind;
+
+  ahead.sample(0);
+  behind.sample(0);
+
+  CHECK(ahead.sample(500) == ptp::Servo::ADJUST);
+  CHECK(behind.sample(-500) == ptp::Servo::ADJUST);
+
+  CHECK(ahead.getFrequency() < 0);
+  CHECK(behind.getFrequency() > 0);
+  CHECK(ahead.getFrequency() == -behind.getFrequency());
+
+  // The integral term keeps pushing while the offset lasts
+  s32 const first = ahead.getFrequency();
+
+  ahead.sample(500);
+
+  CHECK(ahead.getFrequency() < first);
+}
+
+/**
+ * @brief The output and the integral stay within maxFrequency, so the
+ *        servo recovers quickly once the offset changes sign.
+ */
+static void testClamping()
+{
+  ptp::Servo servo(1000000, 1000, 717, 307);
+  u32 samples = 0;
+
+  servo.sample(0);
+
+  for (u32 i = 0; i < 1000; i++) {
+    servo.sample(-900000);
+
+    CHECK(servo.getFrequency() == 1000);
+  }
+
+  for (u32 i = 0; i < 1000; i++) {
+    servo.sample(900000);
+
+    CHECK(servo.getFrequency() == -1000);
+  }
+
+  // Without wind up, a small opposite offset turns the correction around
+  // in a couple of samples
+  do {
+    servo.sample(-1000);
+    samples++;
+  } while ((servo.getFrequency() <= 0) && (samples < 100));
+
+  CHECK(samples <= 3);
+  CHECK(servo.getFrequency() <= 1000);
+}
+
+/**
+ * @brief One sample per second of a clock drifting <drift> ppb from the
+ *        master, the servo cancels the drift and the offset.
+ */
+static void testConvergence(s32 const drift)
+{
+  ptp::Servo servo;
+  s64 offset = 250000;  // In ns
+  u32 steps = 0;
+
+  for (u32 second = 0; second < 120; second++) {
+    if (servo.sample(offset) == ptp::Servo::STEP) {
+      offset = 0;
+      steps++;
+    }
+
+    // Over 1 s, 1 ppb is 1 ns
+    offset += drift + servo.getFrequency();
+  }
+
+  CHECK(steps == 1);
+  CHECK(absolute(offset) < 10);
+  CHECK(absolute(servo.getFrequency() + drift) < 10);
+}
+
+/**
+ * @brief The rate of the PTP clock is measured against the system time,
+ *        and the system timestamps are converted to PTP time.
+ */
+static void testDiscipline()
+{
+  u32 const taken = Lock::taken;
+
+  FakeSystime::microseconds = 5000000;
+  FakeClock::origin = 1000000000000ull;
+  FakeClock::rate = 25000;
+
+  DISCIPLINE::reset();
+
+  CHECK(!DISCIPLINE::isSynchronized());
+
+  DISCIPLINE::sample();
+
+  CHECK(!DISCIPLINE::isSynchronized());
+  CHECK(DISCIPLINE::convert(FakeSystime::microseconds) ==
+      FakeClock::getNanoseconds());
+
+  FakeSystime::microseconds += 1000000;
+  DISCIPLINE::sample();
+
+  CHECK(DISCIPLINE::isSynchronized());
+  CHECK(absolute(DISCIPLINE::getRate() - 25000) <= 1);
+  CHECK(Lock::taken == taken + 2);
+
+  // Between and past the samples
+  for (u32 step = 1; step <= 10; step++) {
+    FakeSystime::microseconds += 150000;
+
+    CHECK(absolute(DISCIPLINE::getNanoseconds() -
+        FakeClock::getNanoseconds()) <= 2);
+  }
+
+  // A rate change is followed over a few samples
+  u64 const now = FakeClock::getNanoseconds();
+
+  FakeClock::rate = -10000;
+  FakeClock::origin += now - FakeClock::getNanoseconds();
+
+  for (u32 second = 0; second < 40; second++) {
+    FakeSystime::microseconds += 1000000;
+    DISCIPLINE::sample();
+  }
+
+  CHECK(absolute(DISCIPLINE::getRate() + 10000) <= 4);
+
+  FakeSystime::microseconds += 500000;
+
+  CHECK(absolute(DISCIPLINE::getNanoseconds() -
+      FakeClock::getNanoseconds()) <= 5);
+
+  // Stepping the clock drops the reference point
+  DISCIPLINE::reset();
+
+  CHECK(!DISCIPLINE::isSynchronized());
+  CHECK(DISCIPLINE::getRate() == 0);
+}
+
+int main()
+{
+  testStep();
+  testSign();
+  testClamping();
+  testConvergence(0);
+  testConvergence(20000);
+  testConvergence(-150000);
+  testDiscipline();
+
+  return check::report("ptp");
+}